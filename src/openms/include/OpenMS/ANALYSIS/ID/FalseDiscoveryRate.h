@@ -235,17 +235,34 @@ private:
     /// Not implemented
     FalseDiscoveryRate& operator=(const FalseDiscoveryRate&);
 
+    /// target/decoy status of a score for calculateFDRsColumnar_
+    enum class TargetDecoyLabel : char
+    {
+      TARGET,
+      DECOY,
+      NONE ///< neither target nor decoy (does not contribute to the FDR)
+    };
+
     /// calculates the FDR, given two vectors of scores
     void calculateFDRs_(std::map<double, double>& score_to_fdr, std::vector<double>& target_scores, std::vector<double>& decoy_scores, bool q_value, bool higher_score_better) const;
 
+    /**
+      @brief calculates the FDR for every entry of a score column
+
+      Gives bit-identical results to calling calculateFDRs_ and looking up every score in the resulting map,
+      but sorts all entries once (in parallel) and uses flat arrays instead of a map. The FDRs are written to
+      @p fdrs in the order of @p scores. Entries labeled NONE receive the value of an equal target/decoy score or 0.
+    */
+    void calculateFDRsColumnar_(const std::vector<double>& scores, const std::vector<TargetDecoyLabel>& labels, std::vector<double>& fdrs, bool q_value, bool higher_score_better) const;
+
     /// Helper function for applyToObservationMatches()
     void handleObservationMatch_(
         IdentificationData::ObservationMatchRef match_ref,
         IdentificationData::ScoreTypeRef score_ref,
-        std::vector<double>& target_scores,
-        std::vector<double>& decoy_scores,
-        std::map<IdentificationData::IdentifiedMolecule, bool>& molecule_to_decoy,
-        std::map<IdentificationData::ObservationMatchRef, double>& match_to_score) const;
+        std::vector<double>& scores,
+        std::vector<TargetDecoyLabel>& labels,
+        std::vector<IdentificationData::ObservationMatchRef>& matches,
+        std::map<IdentificationData::IdentifiedMolecule, bool>& molecule_to_decoy) const;
 
     /// calculates an estimated FDR (based on P(E)Ps) given a vector of score value pairs and fills a map for lookup
     /// in scores_to_FDR
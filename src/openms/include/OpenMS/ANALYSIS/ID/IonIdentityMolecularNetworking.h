@@ -34,6 +34,7 @@
 
 #pragma once
 
+#include <OpenMS/COMPARISON/SPECTRA/PairwiseSpectralSimilarity.h>
 #include <OpenMS/KERNEL/ConsensusMap.h>
 
 namespace OpenMS
@@ -58,5 +59,11 @@ namespace OpenMS
       /// The table contains the columns "ID 1" (row ID of first feature), "ID 2" (row ID of second feature), "EdgeType" (MS1/2 annotation),
       /// "Score" (the number of direct partners from both connected features) and "Annotation" (adducts and delta m/z between two connected features).
       static void writeSupplementaryPairTable(const ConsensusMap& consensus_map, const String& output_file);
+
+      /// Write molecular network edges (csv file) from MS2 spectral similarity, in the same format as the supplementary pair table.
+      /// @p spectra are the exported MS2 spectra, one per consensus feature in ConsensusMap order (spectrum i has the row ID i+1),
+      /// @p edges the similar pairs of these spectra (see PairwiseSpectralSimilarity). The "EdgeType" is "MS2 cosine", the "Score" the cosine similarity
+      /// and the "Annotation" contains the number of matched peaks and the precursor delta m/z.
+      static void writeSpectralNetworkTable(const std::vector<MSSpectrum>& spectra, const std::vector<PairwiseSpectralSimilarity::Edge>& edges, const String& output_file);
   };
 } // closing namespace OpenMS
\ No newline at end of file
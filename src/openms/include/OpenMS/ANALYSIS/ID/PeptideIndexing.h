@@ -183,6 +183,8 @@ public:
   
     Runtime: PeptideIndexer is usually very fast (loading and storing the data takes the most time) and search speed can be further improved (linearly), but using more threads. 
     Avoid allowing too many (>=4) ambiguous amino acids if your database contains long stretches of 'X' (exponential search space).
+    For very large numbers of distinct peptides, the default Aho-Corasick trie over the peptides becomes expensive to build. Set 'backend' to 'suffix_array'
+    to index the database instead (see ProteinSuffixArray); it searches all peptides in parallel and produces the same peptide evidences.
 
     @param proteins A list of proteins -- either read piecewise from a FASTA file or as existing vector of FASTAEntries.
     @param prot_ids Resulting protein identifications associated to pep_ids (will be re-written completely)
@@ -195,6 +197,9 @@ public:
     /// Same as run() with TFI_File, but for proteins which are already in memory
     ExitCodes run(FASTAContainer<TFI_Vector>& proteins, std::vector<ProteinIdentification>& prot_ids, std::vector<PeptideIdentification>& pep_ids);
 
+    /// Same as run() with TFI_File, but for a compiled, memory-mapped database (see FASTAIndexFile)
+    ExitCodes run(FASTAContainer<TFI_MMap>& proteins, std::vector<ProteinIdentification>& prot_ids, std::vector<PeptideIdentification>& pep_ids);
+
     /// Which string is used to determine if a protein is a decoy or not
     const String& getDecoyString() const;
 
@@ -221,6 +226,9 @@ public:
 
     Int aaa_max_{0};
     Int mm_max_{0};
+
+    bool use_suffix_array_{ false };
+    String suffix_array_file_{};
  };
 }
 
@@ -0,0 +1,143 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Suffix array over a protein database, for finding (many) peptides with ambiguous amino acids and mismatches
+
+    All proteins are concatenated into one text (separated by a character which matches nothing), and the suffixes
+    of this text are sorted once (prefix doubling, multi-threaded). A peptide is then found by successively narrowing
+    the interval of suffixes which share its prefix, i.e. in O(|peptide| * log(text)), independent of the number of
+    other peptides searched. This is the preferred approach if the number of peptides is large compared to the database;
+    the Aho-Corasick trie (see AhoCorasickAmbiguous) is built over the peptides instead and is better suited for few peptides.
+
+    Matching is case-insensitive and uses the same rules as ACTrie:
+      - ambiguous amino acids in a protein (B = D|N, J = I|L, Z = E|Q, X = any unambiguous AA) match the respective
+        peptide amino acids at the cost of one ambiguous AA (or of one mismatch once the ambiguous AA budget is exhausted)
+      - any other differing amino acid costs one mismatch
+      - identical characters (including identical ambiguous AAs) are free
+    Characters which are not letters (e.g. '[' of a modification) never match. Callers are expected to normalize sequences
+    beforehand (e.g. remove '*' or substitute 'L' by 'I').
+
+    The sorted suffixes can be stored to disk and loaded again for the same database (checked via a fingerprint of the text),
+    which saves the construction for repeated searches.
+
+    @note All const member functions are thread-safe.
+  */
+  class OPENMS_DLLAPI ProteinSuffixArray
+  {
+  public:
+    /// type of positions into the text (limits the total size of the database to 4 G residues)
+    using T = uint32_t;
+
+    /// Appends a protein to the text; invalidates the suffix array (call build() or load() afterwards)
+    void addProtein(const std::string& sequence);
+
+    /// Sorts all suffixes of the text
+    /// @throw Exception::InvalidSize if the text is too large to be indexed with 32-bit positions
+    void build();
+
+    /**
+      @brief Loads the suffix array from @p filename, if it was built from the same text (see store())
+
+      @return true if the suffix array matched the text and was loaded; false if it was built from a different text
+      @throw Exception::FileNotFound if the file does not exist
+      @throw Exception::ParseError if the file is not a stored suffix array or is truncated
+    */
+    bool load(const String& filename);
+
+    /**
+      @brief Stores the suffix array (and a fingerprint of the text) to @p filename
+
+      @throw Exception::UnableToCreateFile if the file cannot be written
+    */
+    void store(const String& filename) const;
+
+    /// Is the suffix array built (or loaded) for the current text?
+    bool isBuilt() const;
+
+    /// Number of proteins added so far
+    Size size() const;
+
+    /// Length of the text (all proteins including separators)
+    Size textSize() const;
+
+    /**
+      @brief Appends the text positions of all occurrences of @p peptide to @p positions
+
+      Requires build() or load() beforehand. The order of positions is unspecified, but each position is reported once.
+      An empty peptide has no occurrences.
+
+      @param peptide Peptide sequence (see class documentation for matching rules)
+      @param max_aaa Maximal number of ambiguous amino acids in the protein
+      @param max_mm Maximal number of mismatches
+      @param positions Text positions where the peptide starts (use proteinIndex() and proteinStart() to convert)
+    */
+    void findAll(const std::string& peptide, uint32_t max_aaa, uint32_t max_mm, std::vector<T>& positions) const;
+
+    /// Index of the protein which contains the text position @p pos
+    Size proteinIndex(T pos) const;
+
+    /// Text position of the first residue of protein @p index
+    T proteinStart(Size index) const;
+
+    /// Sequence of protein @p index (as given to addProtein())
+    String proteinSequence(Size index) const;
+
+  protected:
+    /// 64-bit fingerprint of the text and protein boundaries (used to validate stored suffix arrays)
+    uint64_t fingerprint_() const;
+
+    /// matching code of the character at @p depth of the suffix starting at @p suffix; -1 if beyond the end of the text
+    int codeAt_(T suffix, size_t depth) const;
+
+    /// recursive search for @p peptide within the suffix interval [@p l, @p r) whose suffixes share the first @p depth characters
+    void search_(const std::string& peptide, size_t depth, T l, T r, uint32_t aaa_left, uint32_t mm_left, std::vector<T>& positions) const;
+
+    std::string text_; ///< concatenated proteins, each followed by a separator
+    std::vector<T> starts_; ///< text position of the first residue of each protein
+    std::vector<T> sa_; ///< sorted suffixes (text positions)
+  };
+
+} // namespace OpenMS
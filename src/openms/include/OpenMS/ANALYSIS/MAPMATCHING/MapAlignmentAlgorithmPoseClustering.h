@@ -57,6 +57,9 @@ namespace OpenMS
     computation, smaller values might lead to no or unstable trafos. Set to -1
     to use all features (might take very long for large maps).
 
+    The reference is preprocessed for the superimposer once in
+    setReference(), so aligning many maps to it does not repeat that work.
+
     For further details see:
     @n Eva Lange et al.
     @n A Geometric Approach for the Alignment of Liquid Chromatography-Mass Spectrometry Data
@@ -88,6 +91,7 @@ public:
     {
       MapType map2 = map; // todo: avoid copy (MSExperiment version of convert() demands non-const version)
       MapConversion::convert(0, map2, reference_, max_num_peaks_considered_);
+      superimposer_.prepareMap(reference_, prepared_reference_);
     }
 
 protected:
@@ -100,6 +104,9 @@ protected:
 
     ConsensusMap reference_;
 
+    /// The reference, as used by the superimposer
+    PoseClusteringAffineSuperimposer::PreparedMap prepared_reference_;
+
     Int max_num_peaks_considered_;
 
 private:
@@ -35,16 +35,28 @@
 #pragma once
 
 #include <OpenMS/ANALYSIS/MAPMATCHING/TransformationDescription.h>
+#include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrum.h>
 #include <OpenMS/COMPARISON/SPECTRA/PeakSpectrumCompareFunctor.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 #include <OpenMS/DATASTRUCTURES/String.h>
 
+#include <memory>
+
 namespace OpenMS
 {
   /**
       @brief A map alignment algorithm based on spectrum similarity (dynamic programming).
 
+      The similarity scores of all spectrum pairs inside the band of the
+      (banded) dynamic programming are computed in parallel (OpenMP) before
+      each alignment pass.  Setting 'rt_band' restricts scoring to spectrum
+      pairs with similar retention times; all other pairs count as mismatches.
+      With 'scorefunction' set to 'BinnedSpectralContrastAngle', every
+      spectrum is binned only once and pairs are scored by the normalized dot
+      product of the binned spectra, which is much cheaper than the peak-based
+      score functions.
+
       @htmlinclude OpenMS_MapAlignmentAlgorithmSpectrumAlignment.parameters
 
       @experimental This algorithm is work in progress and might change.
@@ -222,10 +234,49 @@ private:
                             const std::vector<MSSpectrum*>& pattern, std::vector<MSSpectrum*>& aligned,
                             std::map<Size, std::map<Size, float> >& buffer, bool column_row_orientation);
 
+    /**
+        @brief Scores all cells of the band of the alignment matrix that are not yet contained in @p buffer
+
+        The scores are computed in parallel and then stored in @p buffer (see scoreCalculation_()).
+
+        @param n size of column
+        @param m size of row
+        @param k_ size of k_
+        @param patternbegin indicate the beginning of the template sequence
+        @param alignbegin indicate the beginning of the aligned sequence
+        @param pattern vector of pointers of the template sequence
+        @param aligned vector of pointers of the aligned sequence
+        @param buffer holds the calculated score of index i,j.
+        @param column_row_orientation indicate the order of the matrix
+    */
+    void scoreBand_(Size n, Size m, Int k_, Size patternbegin, Size alignbegin,
+                    const std::vector<MSSpectrum*>& pattern, const std::vector<MSSpectrum*>& aligned,
+                    std::map<Size, std::map<Size, float> >& buffer, bool column_row_orientation);
+
+    /**
+        @brief Converts a similarity (see scoring_()) into the score used in the alignment matrix
+    */
+    float matchScore_(float score);
+
     /**
         @brief return the score of two given MSSpectra by calling the scorefunction
+
+        @p pattern_index and @p aligned_index refer to the spectra of the reference map and of the map that is aligned.
+        Pairs outside of the RT band (parameter 'rt_band') get a score of zero without being compared.
+        Thread-safe.
+    */
+    float scoring_(Size pattern_index, Size aligned_index,
+                   const std::vector<MSSpectrum*>& pattern, const std::vector<MSSpectrum*>& aligned) const;
+
+    /**
+        @brief Bins the given spectra for scoring with the binned score function (in parallel)
+
+        @param spectra the spectra to bin
+        @param binned output: binned spectra
+        @param norms output: Euclidean norms of the binned spectra
     */
-    float scoring_(const MSSpectrum& a, MSSpectrum& b);
+    void binSpectra_(const std::vector<MSSpectrum*>& spectra,
+                     std::vector<std::unique_ptr<BinnedSpectrum> >& binned, std::vector<double>& norms) const;
 
     /**
         @brief affine gap cost Alignment
@@ -306,8 +357,22 @@ private:
     float gap_;
     ///Extension cost after a gap is open
     float e_;
-    ///Pointer holds the scoring function, which can be selected
+    ///Pointer holds the scoring function, which can be selected (null for the binned score)
     PeakSpectrumCompareFunctor* c1_;
+    ///Score by the normalized dot product of binned spectra instead of using c1_
+    bool binned_;
+    ///Bin width used for the binned score
+    float bin_size_;
+    ///Bin offset used for the binned score
+    float bin_offset_;
+    ///Binned spectra (and their norms) of the reference map
+    std::vector<std::unique_ptr<BinnedSpectrum> > binned_pattern_;
+    std::vector<double> norms_pattern_;
+    ///Binned spectra (and their norms) of the map that is currently aligned
+    std::vector<std::unique_ptr<BinnedSpectrum> > binned_aligned_;
+    std::vector<double> norms_aligned_;
+    ///Maximal RT difference of two spectra to be compared (0 = no restriction)
+    double rt_band_;
     ///This is the minimal score to be count as a mismatch(range 0.0 - 1.0)
     float cutoffScore_;
     ///Defines the size of one bucket
@@ -57,6 +57,13 @@ namespace OpenMS
     The affine transformation is then computed from this
     cluster of potential poses, hence the name pose clustering.
 
+    Hashing of the pairs of pairs is parallelised with OpenMP (if enabled);
+    each thread votes into its own copy of the hash tables, which are summed
+    up afterwards.  When aligning many maps to the same reference, prepare the
+    reference once using prepareMap() and pass it to
+    run(const PreparedMap&, const PreparedMap&, TransformationDescription&),
+    so that it is not truncated and sorted again for each scene map.
+
     @sa PoseClusteringShiftSuperimposer
 
     @htmlinclude OpenMS_PoseClusteringAffineSuperimposer.parameters
@@ -68,6 +75,28 @@ namespace OpenMS
   {
 public:
 
+    /**
+      @brief A map in the form used for hashing.
+
+      Contains the most abundant elements of a map (see parameter
+      'num_used_points'), sorted by ascending m/z, together with the RT range
+      of the complete map and the total intensity of the selected elements.
+
+      @note A prepared map is only valid for the parameters of the
+      superimposer that prepared it.
+    */
+    struct OPENMS_DLLAPI PreparedMap
+    {
+      /// Selected elements (sorted by m/z)
+      std::vector<Peak2D> points;
+      /// Minimal RT of the complete map
+      double min_rt = 0.0;
+      /// Maximal RT of the complete map
+      double max_rt = 0.0;
+      /// Total intensity of the selected elements
+      double total_intensity = 0.0;
+    };
+
     /// Default ctor
     PoseClusteringAffineSuperimposer();
 
@@ -100,6 +129,19 @@ public:
     /// Perform alignment on vector of 1D peaks
     virtual void run(const std::vector<Peak2D> & map_model, const std::vector<Peak2D> & map_scene, TransformationDescription & transformation);
 
+    /**
+      @brief Perform alignment on maps that were prepared using prepareMap()
+
+      @exception IllegalArgument is thrown if one of the maps is empty.
+    */
+    void run(const PreparedMap & map_model, const PreparedMap & map_scene, TransformationDescription & transformation);
+
+    /// Selects and sorts the elements of @p map that are used for hashing
+    void prepareMap(const std::vector<Peak2D> & map, PreparedMap & prepared) const;
+
+    /// Selects and sorts the elements of @p map that are used for hashing
+    void prepareMap(const ConsensusMap & map, PreparedMap & prepared) const;
+
     /// Returns an instance of this class
     static BaseSuperimposer * create()
     {
@@ -0,0 +1,157 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/OPENSWATHALGO/DATAACCESS/ISpectrumAccess.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <list>
+#include <map>
+
+namespace OpenMS
+{
+  /**
+   * @brief An implementation of the OpenSWATH Spectrum Access interface which keeps all data numpress-compressed in memory
+   *
+   * Like SpectrumAccessOpenMSInMemory, this class can be generated from any
+   * object implementing the Spectrum Access interface and holds all data in
+   * system memory. However, the binary data arrays are stored numpress
+   * encoded and are only decoded on access. The encoding is chosen per array
+   * (see useSlof_()): intensity arrays use slof, m/z, retention time and other
+   * arrays (e.g. ion mobility) use the linear scheme. This reduces the
+   * memory footprint of a full SWATH run to a fraction, at the cost of
+   * decoding spectra when they are requested.
+   *
+   * To avoid repeated decoding of the same spectra (e.g. when extracting
+   * many transitions from one RT window), the most recently decoded spectra
+   * are held in a small LRU cache. Each instance (and thus each lightClone())
+   * has its own cache, while the compressed data is shared between clones. It
+   * is therefore safe to use one clone per thread without locking.
+   *
+   * @note The compression is lossy: m/z values are encoded with a fixed
+   * point chosen for the given mass accuracy and intensities with a relative
+   * error of about 2e-4 (see MSNumpressCoder).
+   *
+  */
+  class OPENMS_DLLAPI SpectrumAccessNumpressCompressed :
+    public OpenSwath::ISpectrumAccess
+  {
+public:
+
+    /**
+     * @brief Constructor
+     *
+     * @param origin The data to be compressed (read completely)
+     * @param cache_size Number of decoded spectra kept in the LRU cache (0 disables caching)
+     * @param linear_fp_mass_acc Desired absolute mass accuracy of the linear encoding (-1 lets numpress choose the fixed point)
+     */
+    explicit SpectrumAccessNumpressCompressed(OpenSwath::ISpectrumAccess & origin, Size cache_size = 32, double linear_fp_mass_acc = -1);
+
+    /// Destructor
+    ~SpectrumAccessNumpressCompressed() override;
+
+    /// Copy constructor (shares the compressed data, the cache of @p rhs is not copied)
+    SpectrumAccessNumpressCompressed(const SpectrumAccessNumpressCompressed & rhs);
+
+    /// Light clone operator (actual data will not get copied)
+    boost::shared_ptr<OpenSwath::ISpectrumAccess> lightClone() const override;
+
+    OpenSwath::SpectrumPtr getSpectrumById(int id) override;
+
+    OpenSwath::SpectrumMeta getSpectrumMetaById(int id) const override;
+
+    std::vector<std::size_t> getSpectraByRT(double RT, double deltaRT) const override;
+
+    size_t getNrSpectra() const override;
+
+    OpenSwath::ChromatogramPtr getChromatogramById(int id) override;
+
+    size_t getNrChromatograms() const override;
+
+    std::string getChromatogramNativeID(int id) const override;
+
+    /// Number of decoded spectra currently held in the cache of this instance
+    Size getNrCachedSpectra() const;
+
+    /// Total size of the compressed binary data (in bytes)
+    Size getCompressedSize() const;
+
+protected:
+
+    /// A numpress encoded binary data array
+    struct CompressedArray
+    {
+      std::string data; ///< raw numpress bytes
+      std::string description; ///< description of the array (for non-standard arrays)
+      bool slof = false; ///< true if encoded with slof, otherwise linear
+    };
+
+    /// All arrays of a spectrum or chromatogram
+    typedef std::vector<CompressedArray> CompressedArrays;
+
+    /**
+     * @brief Should @p array (at position @p index) be encoded using slof (instead of linear)?
+     *
+     * True for intensity arrays, i.e. the second standard (unnamed) array and all
+     * arrays whose description contains 'intensity'. Arrays with negative values
+     * are always encoded linear, since slof cannot represent them.
+     */
+    static bool useSlof_(const OpenSwath::BinaryDataArray& array, Size index);
+
+    /// encode all data arrays (encoding chosen by useSlof_())
+    static void compress_(const std::vector<OpenSwath::BinaryDataArrayPtr>& arrays, CompressedArrays& result, double linear_fp_mass_acc);
+
+    /// decode all arrays
+    static void decompress_(const CompressedArrays& arrays, std::vector<OpenSwath::BinaryDataArrayPtr>& result);
+
+    /// compressed data (shared between light clones)
+    boost::shared_ptr<const std::vector<CompressedArrays> > spectra_;
+    boost::shared_ptr<const std::vector<OpenSwath::SpectrumMeta> > spectra_meta_;
+    boost::shared_ptr<const std::vector<CompressedArrays> > chromatograms_;
+    boost::shared_ptr<const std::vector<std::string> > chromatogram_ids_;
+
+    /// maximal number of decoded spectra in the cache
+    Size cache_size_;
+
+    /// LRU cache of decoded spectra (most recently used first)
+    std::list<std::pair<int, OpenSwath::SpectrumPtr> > cache_;
+    std::map<int, std::list<std::pair<int, OpenSwath::SpectrumPtr> >::iterator> cache_index_;
+  };
+
+} //end namespace OpenMS
+
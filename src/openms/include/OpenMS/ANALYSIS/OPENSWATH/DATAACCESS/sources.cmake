@@ -9,6 +9,7 @@ SimpleOpenMSSpectraAccessFactory.h
 SpectrumAccessOpenMS.h
 SpectrumAccessOpenMSCached.h
 SpectrumAccessOpenMSInMemory.h
+SpectrumAccessNumpressCompressed.h
 SpectrumAccessSqMass.h
 SpectrumAccessTransforming.h
 SpectrumAccessQuadMZTransforming.h
@@ -65,6 +65,7 @@
 #include <OpenMS/FILTERING/TRANSFORMERS/LinearResamplerAlign.h>
 
 #include <cassert>
+#include <functional>
 #include <limits>
 
 // #define OPENSWATH_WORKFLOW_DEBUG
@@ -410,6 +411,9 @@ protected:
 
   public:
 
+    /// Loads all assays with a precursor m/z strictly between the first two arguments (lower, upper) into the third
+    typedef std::function<void (double, double, OpenSwath::LightTargetedExperiment&)> WindowLibraryLoader;
+
     /** @brief Constructor
      *
      *  @param use_ms1_traces Whether to use MS1 data
@@ -469,8 +473,114 @@ protected:
                            int ms1_isotopes,
                            bool load_into_memory);
 
+    /** @brief Load the assays of each SWATH window on demand
+     *
+     * If a loader is set, performExtraction() does not select the assays of a
+     * SWATH window from the assay library passed to it, but calls @p loader
+     * with the window boundaries when the window is processed (e.g. using
+     * TransitionPQPFile::convertPQPToTargetedExperiment() with an m/z range).
+     * Only the assays of the windows currently processed are kept in memory.
+     *
+     * @note The loader is called concurrently from multiple threads.
+     * @note Not supported for PRM, diaPASEF or MS1-only data, which need the full assay library.
+     *
+    */
+    void setWindowLibraryLoader(const WindowLibraryLoader& loader)
+    {
+      window_library_loader_ = loader;
+    }
+
+    /** @brief Execute OpenSWATH analysis while the SWATH maps are being loaded.
+     *
+     * Same analysis as performExtraction(), but the maps are requested one at
+     * a time from @p load_swath_map (e.g. one file of a split run each, see
+     * SwathFile::loadSplitFile()) by a single reading thread. All other
+     * threads extract and score each SWATH window as soon as it has been
+     * loaded, so reading the data overlaps with the computation. The data of
+     * a window is released once the window has been scored.
+     *
+     * At most @p max_windows_in_flight SWATH windows are loaded but not yet
+     * scored at any time. When this limit is reached, the reading thread
+     * scores windows itself (or waits for the other threads) until there is
+     * room again. Peak memory is thus
+     * bounded by the number of windows in flight instead of the size of the
+     * run.
+     *
+     * @param nr_swath_maps Number of maps (MS1 and SWATH windows) to load
+     * @param load_swath_map Loads map number i (0 <= i < nr_swath_maps); maps without spectrum access pointer are skipped
+     * @param max_windows_in_flight Maximal number of SWATH windows held in memory (at least 1)
+     *
+     * The remaining parameters are the same as for performExtraction().
+     *
+     * @note If MS1 traces are used, windows loaded before the MS1 map are
+     * held back until the MS1 map is available. They count against
+     * @p max_windows_in_flight; further windows are dropped and requested
+     * again from @p load_swath_map later, so the MS1 map should be loaded
+     * first.
+     *
+     * @note Not supported for PRM or diaPASEF data (where the best window
+     * for each precursor is chosen among all windows) and MS1-only data.
+     *
+    */
+    void performExtractionPipelined(Size nr_swath_maps,
+                                    const std::function<OpenSwath::SwathMap (Size)>& load_swath_map,
+                                    Size max_windows_in_flight,
+                                    const TransformationDescription trafo,
+                                    const ChromExtractParams & chromatogram_extraction_params,
+                                    const ChromExtractParams & ms1_chromatogram_extraction_params,
+                                    const Param & feature_finder_param,
+                                    const OpenSwath::LightTargetedExperiment& assay_library,
+                                    FeatureMap& result_featureFile,
+                                    bool store_features_in_featureFile,
+                                    OpenSwathTSVWriter & result_tsv,
+                                    OpenSwathOSWWriter & result_osw,
+                                    Interfaces::IMSDataConsumer * result_chromatograms,
+                                    int batchSize,
+                                    int ms1_isotopes,
+                                    bool load_into_memory);
+
   protected:
 
+    /// Loads the assays per SWATH window (unset: select from the full assay library)
+    WindowLibraryLoader window_library_loader_;
+
+    /// Total number of threads available for the outer and (nested) inner loop
+    int total_nr_threads_ = 1;
+
+    /** @brief Extract and score all assays of a single SWATH window
+     *
+     * Performs the per-window steps of performExtraction(): selects the
+     * transitions of the window, then extracts and scores them in batches
+     * and writes the results.
+     *
+     * @param swath_map The SWATH window (MS2 map)
+     * @param swath_idx Index of the window (used for PRM / PASEF window assignment and logging)
+     * @param tr_win_map Best window for each transition (PRM / PASEF data only)
+     * @param trafo_inverse Inverse of @p trafo
+     * @param ms1_only Whether only MS1 data is present
+     *
+     * The remaining parameters are the same as for performExtraction().
+     *
+    */
+    void processSwathWindow_(const OpenSwath::SwathMap& swath_map,
+                             SignedSize swath_idx,
+                             const OpenSwath::LightTargetedExperiment& transition_exp,
+                             const std::vector<int>& tr_win_map,
+                             const TransformationDescription& trafo,
+                             const TransformationDescription& trafo_inverse,
+                             const ChromExtractParams & cp,
+                             const ChromExtractParams & ms1_cp,
+                             const Param & feature_finder_param,
+                             FeatureMap& out_featureFile,
+                             bool store_features,
+                             OpenSwathTSVWriter & tsv_writer,
+                             OpenSwathOSWWriter & osw_writer,
+                             Interfaces::IMSDataConsumer * chromConsumer,
+                             int batchSize,
+                             int ms1_isotopes,
+                             bool load_into_memory,
+                             bool ms1_only);
+
 
     /** @brief Write output features and chromatograms
      *
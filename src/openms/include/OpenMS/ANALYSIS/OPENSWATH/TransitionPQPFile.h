@@ -36,8 +36,11 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/TransitionTSVFile.h>
 
+#include <functional>
+
 namespace OpenMS
 {
+  class SqliteConnector;
 
   /**
       @brief This class supports reading and writing of PQP files. 
@@ -227,6 +230,31 @@ private:
     */
     void readPQPInput_(const char* filename, std::vector<TSVTransition>& transition_list, bool legacy_traml_id = false);
 
+    /** @brief Read PQP SQLite file row by row
+     *
+     * Each transition is passed to @p consumer as soon as it has been read,
+     * so that the caller decides what to keep in memory.
+     *
+     * @param filename The input file
+     * @param consumer Called once for every transition read
+     * @param legacy_traml_id Should legacy TraML IDs be used (boolean)?
+     * @param lower_mz Only read transitions with a precursor m/z above this value (no restriction if negative)
+     * @param upper_mz Only read transitions with a precursor m/z below this value (no restriction if negative)
+     *
+    */
+    void streamPQPInput_(const char* filename,
+                         const std::function<void (TSVTransition&)>& consumer,
+                         bool legacy_traml_id = false,
+                         double lower_mz = -1,
+                         double upper_mz = -1);
+
+    /// Same as above, reading from the already opened database @p conn
+    void streamPQPInput_(SqliteConnector& conn,
+                         const std::function<void (TSVTransition&)>& consumer,
+                         bool legacy_traml_id = false,
+                         double lower_mz = -1,
+                         double upper_mz = -1);
+
     /** @brief Write a TargetedExperiment to a file
      *
      * @param filename Name of the output file
@@ -270,6 +298,39 @@ public:
     */
     void convertPQPToTargetedExperiment(const char* filename, OpenSwath::LightTargetedExperiment& targeted_exp, bool legacy_traml_id = false);
 
+    /** @brief Read in the assays of a precursor m/z window from a PQP file (Light transition structure)
+     *
+     * Only transitions whose precursor m/z lies strictly between @p lower_mz
+     * and @p upper_mz are read (the restriction is applied in the SQL query),
+     * together with their compounds and proteins. This allows processing one
+     * SWATH window at a time without loading the whole library.
+     *
+     * @param filename The input file
+     * @param lower_mz Lower bound of the precursor m/z window
+     * @param upper_mz Upper bound of the precursor m/z window
+     * @param targeted_exp The output targeted experiment
+     * @param legacy_traml_id Should legacy TraML IDs be used (boolean)?
+     *
+    */
+    void convertPQPToTargetedExperiment(const char* filename, double lower_mz, double upper_mz,
+                                        OpenSwath::LightTargetedExperiment& targeted_exp, bool legacy_traml_id = false);
+
+    /** @brief Read in the assays of a precursor m/z window from an opened PQP file (Light transition structure)
+     *
+     * Same as above, but reads through the connection @p conn, so that all
+     * windows of a run can be loaded without reopening the file. The
+     * connection must not be used by several threads at the same time.
+     *
+     * @note The assays are stored in the regular LightTargetedExperiment
+     * (string identifiers and references). A compact representation with
+     * interned integer IDs was not introduced, because the scoring, the
+     * feature output and the OSW/TSV writers all key on the string references;
+     * memory is bounded by loading one window at a time instead.
+     *
+    */
+    void convertPQPToTargetedExperiment(SqliteConnector& conn, double lower_mz, double upper_mz,
+                                        OpenSwath::LightTargetedExperiment& targeted_exp, bool legacy_traml_id = false);
+
   };
 }
 
@@ -43,6 +43,8 @@
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 
 #include <fstream>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace OpenMS
 {
@@ -195,6 +197,14 @@ protected:
       }
     };
 
+    /// Bookkeeping for converting transitions one at a time into a LightTargetedExperiment
+    struct LightConversionState
+    {
+      std::unordered_set<std::string> compounds; ///< Identifiers of the compounds added so far
+      std::unordered_set<std::string> proteins; ///< Identifiers of the proteins added so far
+      std::unordered_map<std::string, std::string> label_sequences; ///< Peptide sequence of the first transition seen per peptide group label
+    };
+
     /** @name  Conversion functions from TSVTransition objects to OpenMS datastructures
      *
      * These functions convert the relevant data from a TSVTransition to the
@@ -221,6 +231,20 @@ protected:
     */
     void TSVToTargetedExperiment_(std::vector<TSVTransition>& transition_list, OpenSwath::LightTargetedExperiment& exp);
 
+    /** @brief Add a single TSVTransition to a LightTargetedExperiment
+     *
+     * Appends the transition and, on first occurrence, its compound and
+     * proteins. Mixed sequence groups are resolved on the fly (see
+     * resolveMixedSequenceGroups_()). Used to convert transitions while they
+     * are read, without holding the complete list in memory.
+     *
+     * @param tr The transition to add (its peptide group label may be corrected)
+     * @param exp The output experiment
+     * @param state Compounds, proteins and group labels seen so far (use one state per output experiment)
+     *
+    */
+    void addLightTransition_(TSVTransition& tr, OpenSwath::LightTargetedExperiment& exp, LightConversionState& state);
+
     /// Convert an OpenMS transition to a TSVTransition for output writing
     TransitionTSVFile::TSVTransition convertTransition_(const ReactionMonitoringTransition* it, OpenMS::TargetedExperiment& targeted_exp);
     //@}
@@ -297,6 +321,9 @@ private:
      */
     void resolveMixedSequenceGroups_(std::vector<TSVTransition>& transition_list) const;
 
+    /// Resolve a mixed sequence group for a single transition, given the sequences seen so far per group label (see resolveMixedSequenceGroups_())
+    void resolveMixedSequenceGroup_(TSVTransition& tr, std::unordered_map<std::string, std::string>& label_sequences) const;
+
     /// Populate a new ReactionMonitoringTransition object from a row in the csv
     void createTransition_(std::vector<TSVTransition>::iterator& tr_it,
                            OpenMS::ReactionMonitoringTransition& rm_trans);
@@ -310,11 +337,11 @@ private:
                                  const OpenMS::DataValue rt_value);
 
     /// Populate a new TargetedExperiment::Peptide object from a row in the csv
-    void createPeptide_(std::vector<TSVTransition>::const_iterator tr_it,
+    void createPeptide_(const TSVTransition& tr,
                         OpenMS::TargetedExperiment::Peptide& peptide);
 
     /// Populate a new TargetedExperiment::Compound object (a metabolite) from a row in the csv
-    void createCompound_(std::vector<TSVTransition>::const_iterator tr_it,
+    void createCompound_(const TSVTransition& tr,
                          OpenMS::TargetedExperiment::Compound& compound);
 
     /// Add a modification at the specified location
@@ -95,8 +95,8 @@ namespace OpenMS
       /**
        * @brief Enumerates precursor masses for all candidates in an XL-MS search
 
-          Assumes the list of peptides and the list of spectrum precursor masses are sorted by mass in ascending order,
-          and the list of mono-link masses is sorted in descending order.
+          Assumes the list of peptides is sorted by mass in ascending order.
+          Calls enumerateCrossLinksInWindow for every precursor mass, so candidates fitting several precursor masses are reported once per precursor.
 
        * @param peptides The peptides with precomputed masses from the digestDatabase function
        * @param cross_link_mass_light Mass of the cross-linker, only the light one if a labeled linker is used
@@ -111,6 +111,25 @@ namespace OpenMS
        */
       static std::vector<OPXLDataStructs::XLPrecursor> enumerateCrossLinksAndMasses(const std::vector<OPXLDataStructs::AASeqWithMass>&  peptides, double cross_link_mass_light, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, const std::vector< double >& spectrum_precursors, std::vector< int >& precursor_correction_positions, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm);
 
+      /**
+       * @brief Enumerates all candidates fitting into a single precursor mass window
+
+          Only peptides and peptide pairs with a mass within precursor_mass +/- allowed_error (including the linker) are enumerated,
+          so the memory usage depends on the number of candidates for this window and not on the size of the database.
+          Mono-links and loop-links are found by binary search. The partners of cross-linked peptide pairs are found with a two-pointer scan
+          over the sorted peptide masses, parallelized over blocks of the lighter peptide. The order of the results does not depend on the number of threads.
+
+       * @param peptides The peptides with precomputed masses from the digestDatabase function, sorted by mass (ascending)
+       * @param cross_link_mass Mass of the cross-linker, only the light one if a labeled linker is used
+       * @param cross_link_mass_mono_link A list of possible masses for the cross-link, if it is attached to a peptide on one side
+       * @param cross_link_residue1 A list of residues, to which the first side of the linker can react
+       * @param cross_link_residue2 A list of residues, to which the second side of the linker can react
+       * @param precursor_mass The (corrected) precursor mass of the spectrum
+       * @param allowed_error The absolute precursor mass tolerance in Da
+       * @param candidates The vector the found candidates are appended to
+       */
+      static void enumerateCrossLinksInWindow(const std::vector<OPXLDataStructs::AASeqWithMass>& peptides, double cross_link_mass, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, double precursor_mass, double allowed_error, std::vector<OPXLDataStructs::XLPrecursor>& candidates);
+
       /**
        * @brief Digests a database with the given EnzymaticDigestion settings and precomputes masses for all peptides
 
@@ -0,0 +1,192 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Pre-calculated coarse isotope patterns of an averagine model, looked up by mass
+
+    Computing an isotope pattern from an averagine model
+    (e.g. CoarseIsotopePatternGenerator::estimateFromPeptideWeight) means
+    estimating a sum formula and convolving the element distributions. This
+    class does that once for masses on a regular grid (0, mass_step,
+    2*mass_step, ... max_mass) and answers queries by linear interpolation
+    between the two neighbouring grid points, i.e. by a table lookup.
+    Queries beyond the table (mass or number of isotopes) are computed
+    directly and are therefore slower, but still correct.
+
+    The table can be stored to and loaded from a file, so it does not have to
+    be computed at every program start. Lookups are const and thread-safe;
+    getDefault() provides shared instances for the built-in averagine models.
+
+    Callers which need the exact patterns use getExactIntensities() instead:
+    the averagine sum formula has integer atom counts, so neighbouring masses
+    share the same formula and its pattern is computed only once.
+
+    @note Intensities are the probabilities of the first isotopes,
+    renormalized to a sum of one, as returned by CoarseIsotopePatternGenerator
+    with the same maximal isotope (up to the interpolation error).
+
+    @ingroup Chemistry
+  */
+  class OPENMS_DLLAPI IsotopePatternCache
+  {
+public:
+    /// Built-in averagine models (see CoarseIsotopePatternGenerator)
+    enum class Averagine
+    {
+      PEPTIDE, ///< Senko's averagine (CoarseIsotopePatternGenerator::estimateFromPeptideWeight)
+      RNA,     ///< averagine for RNA (CoarseIsotopePatternGenerator::estimateFromRNAWeight)
+      DNA      ///< averagine for DNA (CoarseIsotopePatternGenerator::estimateFromDNAWeight)
+    };
+
+    /// Default constructor: empty table, all queries are computed directly (using the peptide averagine)
+    IsotopePatternCache();
+
+    /**
+      @brief Computes the table for a built-in averagine model
+
+      @param averagine The averagine model
+      @param max_mass Largest (average) mass in the table
+      @param mass_step Distance between the masses in the table
+      @param max_isotope Number of isotopes stored per mass
+
+      @exception Exception::InvalidValue if @p mass_step or @p max_isotope is not positive
+    */
+    IsotopePatternCache(Averagine averagine, double max_mass, double mass_step = 1.0, Size max_isotope = 20);
+
+    /**
+      @brief Computes the table for an arbitrary average composition (e.g. for metabolites)
+
+      The composition is given as relative stoichiometry, see CoarseIsotopePatternGenerator::estimateFromWeightAndComp.
+
+      @exception Exception::InvalidValue if @p mass_step or @p max_isotope is not positive
+    */
+    IsotopePatternCache(double C, double H, double N, double O, double S, double P,
+                        double max_mass, double mass_step = 1.0, Size max_isotope = 20);
+
+    /**
+      @brief Returns the probabilities of the first @p num_isotopes isotopes for the given average @p mass
+
+      @param mass Average mass (>= 0)
+      @param num_isotopes Number of isotopes to return
+      @param intensities Output: @p num_isotopes intensities (zero-filled if the distribution is shorter)
+    */
+    void getIntensities(double mass, Size num_isotopes, std::vector<double>& intensities) const;
+
+    /**
+      @brief Returns the probabilities of the first @p num_isotopes isotopes of the averagine formula for @p mass, without interpolation
+
+      The result is identical to CoarseIsotopePatternGenerator(@p num_isotopes) applied to the averagine sum formula
+      estimated for @p mass. Patterns are memoized per sum formula and number of isotopes (independently of the table),
+      so a query for an already seen formula only estimates the formula.
+
+      @param mass Average mass (>= 0)
+      @param num_isotopes Number of isotopes to return
+      @param intensities Output: @p num_isotopes intensities (zero-filled if the distribution is shorter)
+    */
+    void getExactIntensities(double mass, Size num_isotopes, std::vector<double>& intensities) const;
+
+    /// Largest mass covered by the table
+    double getMaxMass() const;
+
+    /// Distance between the masses in the table
+    double getMassStep() const;
+
+    /// Number of isotopes stored per mass
+    Size getMaxIsotope() const;
+
+    /**
+      @brief Writes the table to a (text) file
+
+      @exception Exception::UnableToCreateFile if the file cannot be written
+    */
+    void store(const String& filename) const;
+
+    /**
+      @brief Reads a table written by store(), replacing the current one
+
+      @exception Exception::FileNotFound if the file does not exist
+      @exception Exception::ParseError if the file is not a valid isotope pattern table
+    */
+    void load(const String& filename);
+
+    /**
+      @brief Returns a shared table for a built-in averagine model
+
+      The table covers masses up to 10 kDa in steps of 1 Da with 20 isotopes. It
+      is computed on first use (thread-safe) and kept for the lifetime of the
+      program.
+    */
+    static const IsotopePatternCache& getDefault(Averagine averagine);
+
+protected:
+    /// computes the pattern for @p mass directly
+    void compute_(double mass, Size num_isotopes, std::vector<double>& intensities) const;
+
+    /// fills the table
+    void build_(double max_mass);
+
+    /// average composition (C, H, N, O, S, P)
+    double composition_[6];
+
+    /// distance between the masses in the table
+    double mass_step_;
+
+    /// number of isotopes per mass
+    Size max_isotope_;
+
+    /// number of masses in the table
+    Size num_masses_;
+
+    /// isotope probabilities (num_masses_ rows of max_isotope_ values)
+    std::vector<double> table_;
+
+    /// exact patterns memoized by getExactIntensities(), keyed by sum formula and number of isotopes
+    mutable std::map<std::pair<String, Size>, std::vector<double> > exact_patterns_;
+
+    /// guards exact_patterns_
+    mutable std::mutex exact_patterns_mutex_;
+  };
+
+} // namespace OpenMS
@@ -0,0 +1,119 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <OpenMS/CONCEPT/ProgressLogger.h>
+#include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+    @brief All-vs-all cosine similarity of MS2 spectra (e.g. for molecular networking)
+
+    All spectra are packed once into a sparse matrix (one row per spectrum,
+    sorted by precursor m/z; each row holds the m/z-sorted peaks with
+    intensities normalized to unit length, stored contiguously for all
+    spectra). The upper triangle of the similarity matrix is then computed
+    in square blocks of 'block_size' spectra, distributed over all threads.
+
+    The similarity of two spectra is the cosine of their intensity vectors,
+    where peaks are paired if their m/z differ by at most
+    'fragment_mass_tolerance' (greedy one-to-one matching in m/z order).
+
+    Since rows are sorted by precursor m/z, the precursor filter
+    ('max_precursor_mz_difference') skips whole blocks and only the pairs
+    within the precursor window are scored. Only pairs with a score of at
+    least 'min_score' and at least 'min_matched_peaks' matched peaks are
+    reported.
+
+    @htmlinclude OpenMS_PairwiseSpectralSimilarity.parameters
+
+    @ingroup SpectraComparison
+  */
+  class OPENMS_DLLAPI PairwiseSpectralSimilarity :
+    public DefaultParamHandler,
+    public ProgressLogger
+  {
+public:
+    /// A pair of similar spectra
+    struct Edge
+    {
+      Size first; ///< index of the first spectrum (first < second)
+      Size second; ///< index of the second spectrum
+      double score; ///< cosine similarity
+      Size matched_peaks; ///< number of matched peak pairs
+    };
+
+    /// Default constructor
+    PairwiseSpectralSimilarity();
+
+    /**
+      @brief Computes all pairs of similar spectra
+
+      @param spectra The spectra (m/z does not need to be sorted); the precursor m/z is taken from the first precursor
+      @return Pairs passing all filters, sorted by (first, second)
+
+      @exception Exception::MissingInformation is thrown if the precursor filter is enabled and a spectrum has no precursor
+    */
+    std::vector<Edge> compute(const std::vector<MSSpectrum>& spectra) const;
+
+    /**
+      @brief Cosine similarity of two spectra with m/z tolerance
+
+      Peaks are prepared as in compute(): peaks with intensity <= 0 are ignored and the spectra do not need to be sorted by m/z.
+
+      @param a First spectrum
+      @param b Second spectrum
+      @param tolerance Maximal m/z difference of matching peaks (in Th)
+      @param matched_peaks The number of matched peak pairs
+    */
+    static double cosine(const MSSpectrum& a, const MSSpectrum& b, double tolerance, Size& matched_peaks);
+
+protected:
+    void updateMembers_() override;
+
+    double fragment_mass_tolerance_;
+    double max_precursor_mz_difference_;
+    double min_score_;
+    Size min_matched_peaks_;
+    Size block_size_;
+  };
+
+} // namespace OpenMS
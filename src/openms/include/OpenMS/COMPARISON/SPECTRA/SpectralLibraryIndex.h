@@ -0,0 +1,144 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <OpenMS/KERNEL/MSSpectrum.h>
+
+#include <utility>
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Precursor-sorted index of a spectral library with pre-binned, normalized peak vectors
+
+    Library spectra are added in order of increasing precursor m/z. Each
+    spectrum is binned (fixed bin width and offset, as in BinnedSpectrum with
+    spread 0), the intensities of each spectrum are normalized to unit
+    length and all spectra are stored contiguously (one array of bin indices
+    and one of intensities, plus offsets).
+
+    Searching a query then is
+    - getPrecursorRange() to find the candidates within a precursor window and
+    - prepareQuery() to bin the query into a dense vector (once per query), followed by
+    - scoreCandidates() which computes the cosine similarity (normalized dot
+      product) of the query to all candidates in a tight loop over the
+      contiguous library arrays.
+
+    All const member functions are thread-safe, i.e. many queries can be
+    scored in parallel against the same index.
+
+    @ingroup SpectraComparison
+  */
+  class OPENMS_DLLAPI SpectralLibraryIndex
+  {
+public:
+    /**
+      @brief Constructor
+
+      @param bin_size Bin width (in Th)
+      @param bin_offset Offset of the bin boundaries (as fraction of a bin, see BinnedSpectrum)
+    */
+    explicit SpectralLibraryIndex(double bin_size = 1.0005, double bin_offset = 0.4);
+
+    /**
+      @brief Adds a library spectrum (its index is the number of spectra added before)
+
+      @exception Exception::IllegalArgument is thrown if @p precursor_mz is smaller than the precursor m/z of the previously added spectrum
+    */
+    void addSpectrum(double precursor_mz, const MSSpectrum& spectrum);
+
+    /**
+      @brief Adds a library entry without peaks, if only the precursor lookup is needed (scoreCandidates() returns 0 for it)
+
+      @exception Exception::IllegalArgument is thrown if @p precursor_mz is smaller than the precursor m/z of the previously added spectrum
+    */
+    void addPrecursor(double precursor_mz);
+
+    /// Number of library spectra
+    Size size() const;
+
+    /// Removes all library spectra
+    void clear();
+
+    /// Precursor m/z of library spectrum @p index
+    double getPrecursorMZ(Size index) const;
+
+    /// Index range [first, last) of library spectra with precursor m/z in [@p mz_low, @p mz_high]
+    std::pair<Size, Size> getPrecursorRange(double mz_low, double mz_high) const;
+
+    /// Bin index of @p mz
+    Size getBinIndex(double mz) const;
+
+    /**
+      @brief Bins and normalizes @p query into the dense vector @p dense_query (input for scoreCandidates())
+
+      Bins beyond the largest bin of the library are not stored (they cannot contribute to a score).
+    */
+    void prepareQuery(const MSSpectrum& query, std::vector<float>& dense_query) const;
+
+    /**
+      @brief Computes the cosine similarity of a query to the library spectra [@p first, @p last)
+
+      @param dense_query The query, as prepared by prepareQuery()
+      @param first First library spectrum
+      @param last Past-the-end library spectrum
+      @param scores The resulting scores (one per candidate, in [0, 1])
+    */
+    void scoreCandidates(const std::vector<float>& dense_query, Size first, Size last, std::vector<float>& scores) const;
+
+protected:
+    /// bin and normalize a spectrum (bins are sorted, duplicates merged)
+    void binSpectrum_(const MSSpectrum& spectrum, std::vector<std::pair<UInt, float> >& bins) const;
+
+    double bin_size_;
+    double bin_offset_;
+
+    /// largest bin index of all library spectra
+    UInt max_bin_;
+
+    /// precursor m/z (sorted)
+    std::vector<double> precursor_mz_;
+    /// start of each spectrum in bins_ and intensities_ (size() + 1 entries)
+    std::vector<Size> offsets_;
+    /// bin indices of all spectra
+    std::vector<UInt> bins_;
+    /// normalized intensities of all spectra
+    std::vector<float> intensities_;
+  };
+
+} // namespace OpenMS
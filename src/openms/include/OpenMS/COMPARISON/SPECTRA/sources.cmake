@@ -8,8 +8,10 @@ BinnedSpectralContrastAngle.h
 BinnedSpectrum.h
 BinnedSpectrumCompareFunctor.h
 BinnedSumAgreeingIntensities.h
+PairwiseSpectralSimilarity.h
 PeakAlignment.h
 PeakSpectrumCompareFunctor.h
+SpectralLibraryIndex.h
 SpectraSTSimilarityScore.h
 SpectrumAlignment.h
 SpectrumAlignmentScore.h
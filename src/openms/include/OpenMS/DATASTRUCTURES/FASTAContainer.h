@@ -40,7 +40,9 @@
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
 #include <OpenMS/DATASTRUCTURES/StringUtilsSimple.h>
 #include <OpenMS/FORMAT/FASTAFile.h>
+#include <OpenMS/FORMAT/FASTAIndexFile.h>
 
+#include <algorithm>
 #include <functional>
 #include <fstream>
 #include <unordered_map>
@@ -55,6 +57,7 @@ namespace OpenMS
 
   struct TFI_File; ///< template parameter for file-based FASTA access
   struct TFI_Vector; ///< template parameter for vector-based FASTA access
+  struct TFI_MMap; ///< template parameter for access to a memory-mapped, compiled FASTA database (see FASTAIndexFile)
 
   /**
   @brief This class allows for a chunk-wise single linear read over a (large) FASTA file, 
@@ -63,7 +66,7 @@ namespace OpenMS
   
   Internally uses FASTAFile class to read single sequences.
 
-  FASTAContainer supports two template specializations FASTAContainer<TFI_File> and FASTAContainer<TFI_Vector>.
+  FASTAContainer supports three template specializations FASTAContainer<TFI_File>, FASTAContainer<TFI_Vector> and FASTAContainer<TFI_MMap>.
   
   FASTAContainer<TFI_File> will make FASTA entries available chunk-wise from start to end by loading it from a FASTA file.
   This avoids having to load the full file into memory. While loading, the container will
@@ -73,6 +76,10 @@ namespace OpenMS
   FASTAContainer<TFI_Vector> simply takes an existing vector of FASTAEntries and provides the same interface
   (with a potentially huge speed benefit over FASTAContainer<TFI_File> since it does not need disk access, but at the cost of memory).
 
+  FASTAContainer<TFI_MMap> reads a FASTA database which was compiled into a binary file (see FASTAIndexFile::compile()) and
+  memory-mapped read-only. It behaves like FASTAContainer<TFI_File>, but requires no parsing, knows the total number of entries
+  upfront and offers fast random access to all entries. Concurrent processes using the same database share its memory.
+
   If an algorithm searches through a FASTA file linearly, you can use FASTAContainer<TFI_File> to pre-load a small chunk
   and start working, while loading the next chunk in a background thread and swap it in when the active chunk 
   was processed.
@@ -88,6 +95,9 @@ class FASTAContainer; // prototype
   If possible, only entries from the currently cached chunk should be queried, otherwise access will be slow.
 
   Internally uses FASTAFile class to read single sequences.
+
+  Compressed (gzip/bzip2) FASTA files cannot be repositioned. For those, all entries read so far are kept in memory
+  (instead of their file offsets), so readAt() works for them as well.
 */
 template<>
 class FASTAContainer<TFI_File>
@@ -99,6 +109,7 @@ public:
   FASTAContainer(const String& FASTA_file)
     : f_(),
     offsets_(),
+    entries_(),
     data_fg_(),
     data_bg_(),
     chunk_offset_(0),
@@ -138,10 +149,12 @@ public:
     data_bg_.clear();
     data_bg_.reserve(suggested_size);
     FASTAFile::FASTAEntry p;
+    const bool seekable = f_.isSeekable();
     for (int i = 0; i < suggested_size; ++i)
     {
-      std::streampos spos = f_.position();
+      std::streampos spos = seekable ? f_.position() : std::streampos(-1);
       if (!f_.readNext(p)) break;
+      if (!seekable) entries_.push_back(p);
       data_bg_.push_back(std::move(p));
       offsets_.push_back(spos);
     }
@@ -192,6 +205,12 @@ public:
     {
       throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, pos, offsets_.size());
     }
+    // compressed input: entries are kept in memory
+    if (!f_.isSeekable())
+    {
+      protein = entries_[pos];
+      return true;
+    }
     std::streampos spos = f_.position(); // save old position
     if (!f_.setPosition(offsets_[pos])) return false;
     bool r = f_.readNext(protein);
@@ -209,6 +228,7 @@ public:
   void reset()
   {
     offsets_.clear();
+    entries_.clear();
     data_fg_.clear();
     data_bg_.clear();
     chunk_offset_ = 0;
@@ -229,6 +249,7 @@ public:
 private:
   FASTAFile f_; ///< FASTA file connection
   std::vector<std::streampos> offsets_; ///< internal byte offsets into FASTA file for random access reading of previous entries.
+  std::vector<FASTAFile::FASTAEntry> entries_; ///< all entries read so far (only for compressed input, which cannot be repositioned)
   std::vector<FASTAFile::FASTAEntry> data_fg_; ///< active (foreground) data
   std::vector<FASTAFile::FASTAEntry> data_bg_; ///< prefetched (background) data; will become the next active data
   size_t chunk_offset_; ///< number of entries before the current chunk
@@ -337,6 +358,135 @@ private:
   int cache_count_ = 0;
 };
 
+/**
+@brief
+FASTAContainer<TFI_MMap> makes the entries of a compiled FASTA database (see FASTAIndexFile) available chunk-wise,
+with the same interface as FASTAContainer<TFI_File>.
+
+The database is memory-mapped read-only, i.e. opening is instantaneous and the memory is shared between all
+processes using the same file. Entries of the active chunk are materialized as FASTAEntry (plain copies, no parsing).
+In contrast to FASTAContainer<TFI_File>, size() is the total number of entries from the start and readAt() is fast
+for any entry.
+*/
+template<>
+class FASTAContainer<TFI_MMap>
+{
+public:
+  FASTAContainer() = delete;
+
+  /** @brief C'tor with the filename of a compiled FASTA database (see FASTAIndexFile::compile())
+
+    @exception Exception::FileNotFound is thrown if the file does not exist
+    @exception Exception::ParseError is thrown if the file is not a compiled FASTA database
+  */
+  FASTAContainer(const String& compiled_FASTA_file)
+    : index_(compiled_FASTA_file)
+  {
+  }
+
+  /// how many entries were read and got swapped out already
+  size_t getChunkOffset() const
+  {
+    return chunk_offset_;
+  }
+
+  /** @brief Swaps in the background cache of entries, read previously via @p cacheChunk()
+
+      @return true if cache contains data; false if empty
+      @note Should be invoked by a single thread, followed by a barrier to sync access of subsequent calls to chunkAt()
+  */
+  bool activateCache()
+  {
+    chunk_offset_ += data_fg_.size();
+    data_fg_.swap(data_bg_);
+    data_bg_.clear();
+    return !data_fg_.empty();
+  }
+
+  /** @brief Prefetch a new cache in the background, with up to @p suggested_size entries (or fewer upon reaching the end)
+
+     @param suggested_size Number of entries to copy from the mapped file
+     @return true if new data is available; false if background data is empty
+  */
+  bool cacheChunk(int suggested_size)
+  {
+    const size_t start = next_entry_;
+    const size_t end = std::min(index_.size(), start + std::max(suggested_size, 0));
+    data_bg_.resize(end - start);
+    for (size_t i = start; i < end; ++i)
+    {
+      index_.getEntry(i, data_bg_[i - start]);
+    }
+    next_entry_ = end;
+    return !data_bg_.empty();
+  }
+
+  /// number of entries in active cache
+  size_t chunkSize() const
+  {
+    return data_fg_.size();
+  }
+
+  /** @brief Retrieve a FASTA entry at cache position @p pos (fast)
+
+      Requires prior call to activateCache().
+      Index @p pos must be smaller than chunkSize().
+
+      @note: can be used by multiple threads at a time (until activateCache() is called)
+  */
+  const FASTAFile::FASTAEntry& chunkAt(size_t pos) const
+  {
+    return data_fg_[pos];
+  }
+
+  /** @brief Retrieve a FASTA entry at global position @p pos (fast for any entry)
+
+    @param protein Return value
+    @param pos Absolute entry number in the database
+    @return always true
+    @throw Exception::IndexOverflow if @p pos is not smaller than size()
+    @note: thread-safe
+  */
+  bool readAt(FASTAFile::FASTAEntry& protein, size_t pos) const
+  {
+    if (chunk_offset_ <= pos && pos < chunk_offset_ + chunkSize())
+    {
+      protein = data_fg_[pos - chunk_offset_];
+      return true;
+    }
+    index_.getEntry(pos, protein);
+    return true;
+  }
+
+  /// is the database empty?
+  bool empty() const
+  {
+    return index_.size() == 0;
+  }
+
+  /// resets reading, enables fresh reading of the database from the beginning
+  void reset()
+  {
+    data_fg_.clear();
+    data_bg_.clear();
+    chunk_offset_ = 0;
+    next_entry_ = 0;
+  }
+
+  /// total number of entries in the database (known from the start)
+  size_t size() const
+  {
+    return index_.size();
+  }
+
+private:
+  FASTAIndexFile index_; ///< read-only mapping of the compiled database
+  std::vector<FASTAFile::FASTAEntry> data_fg_; ///< active (foreground) data
+  std::vector<FASTAFile::FASTAEntry> data_bg_; ///< prefetched (background) data; will become the next active data
+  size_t chunk_offset_ = 0; ///< number of entries before the current chunk
+  size_t next_entry_ = 0; ///< index of the next entry to be cached
+};
+
 /**
   @brief Helper class for calculations on decoy proteins
 */
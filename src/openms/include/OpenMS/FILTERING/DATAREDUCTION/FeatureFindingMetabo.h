@@ -331,6 +331,7 @@ private:
     bool report_summed_ints_;
     bool enable_RT_filtering_;
     String isotope_filtering_model_;
+    bool use_isotope_pattern_cache_;
     bool use_smoothed_intensities_;
     
     bool use_mz_scoring_C13_;
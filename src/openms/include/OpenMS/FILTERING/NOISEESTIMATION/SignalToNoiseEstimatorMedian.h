@@ -65,6 +65,14 @@ namespace OpenMS
     case you should increase <i>max_intensity</i> (and optionally the
     <i>bin_count</i>).
 
+    The median bin of each window is found either by summing up the histogram
+    from its first bin for every data point (param: <i>median_search</i> =
+    'scan'), or by moving the median bin of the previous window by as many
+    bins as the added and removed data points require ('incremental', the
+    default). Both modes yield identical results; the incremental search
+    avoids the O(<i>bin_count</i>) cost per data point, which dominates for
+    large profile spectra and fine histograms.
+
     Changing any of the parameters will invalidate the S/N values (which will invoke a recomputation on the next request).
 
     @note If more than 20 percent of windows have less than <i>min_required_elements</i> of elements, a warning is issued to <i>OPENMS_LOG_WARN</i> and noise estimates in those windows are set to the constant <i>noise_for_empty_window</i>.
@@ -133,6 +141,9 @@ public:
 
       defaults_.setValue("noise_for_empty_window", std::pow(10.0, 20), "noise value used for sparse windows", {"advanced"});
 
+      defaults_.setValue("median_search", "incremental", "how the median bin of each window is located: 'incremental' updates the median bin of the previous window as data points enter and leave it; 'scan' sums up the histogram from its first bin for every data point. Both give identical results.", {"advanced"});
+      defaults_.setValidStrings("median_search", {"incremental","scan"});
+
       defaults_.setValue("write_log_messages", "true", "Write out log messages in case of sparse windows or median in rightmost histogram bin");
       defaults_.setValidStrings("write_log_messages", {"true","false"});
 
@@ -286,13 +297,26 @@ protected:
         histogram[bin] = 0;
         bin_value[bin] = (bin + 0.5) * bin_size;
       }
-      // bin in which a datapoint would fall
-      int to_bin = 0;
+      // bin in which each datapoint falls; computed in a single pass, since
+      // every datapoint enters and leaves the window exactly once
+      std::vector<int> point_bin(c.size());
+      {
+        Size i = 0;
+        for (PeakIterator it = scan_first_; it != scan_last_; ++it, ++i)
+        {
+          point_bin[i] = std::max(std::min<int>((int)((*it).getIntensity() / bin_size), bin_count_minus_1), 0);
+        }
+      }
+      // index of the datapoints at the left and right window border
+      Size borderleft_idx = 0;
+      Size borderright_idx = 0;
 
       // index of bin where the median is located
       int median_bin = 0;
       // additive number of elements from left to x in histogram
       int element_inc_count = 0;
+      // for median_search == 'incremental': number of elements in bins [0, median_bin]
+      int elements_upto_median_bin = 0;
 
       // tracks elements in current window, which may vary because of unevenly spaced data
       int elements_in_window = 0;
@@ -314,21 +338,24 @@ protected:
         // erase all elements from histogram that will leave the window on the LEFT side
         while ((*window_pos_borderleft).getMZ() <  (*window_pos_center).getMZ() - window_half_size)
         {
-          to_bin = std::max(std::min<int>((int)((*window_pos_borderleft).getIntensity() / bin_size), bin_count_minus_1), 0);
+          const int to_bin = point_bin[borderleft_idx];
           --histogram[to_bin];
+          if (to_bin <= median_bin) --elements_upto_median_bin;
           --elements_in_window;
           ++window_pos_borderleft;
+          ++borderleft_idx;
         }
 
         // add all elements to histogram that will enter the window on the RIGHT side
         while ((window_pos_borderright != scan_last_)
               && ((*window_pos_borderright).getMZ() <= (*window_pos_center).getMZ() + window_half_size))
         {
-          //std::cerr << (*window_pos_borderright).getIntensity() << " " << bin_size << " " << bin_count_minus_1 << std::endl;
-          to_bin = std::max(std::min<int>((int)((*window_pos_borderright).getIntensity() / bin_size), bin_count_minus_1), 0);
+          const int to_bin = point_bin[borderright_idx];
           ++histogram[to_bin];
+          if (to_bin <= median_bin) ++elements_upto_median_bin;
           ++elements_in_window;
           ++window_pos_borderright;
+          ++borderright_idx;
         }
 
         if (elements_in_window < min_required_elements_)
@@ -339,13 +366,33 @@ protected:
         else
         {
           // find bin i where ceil[elements_in_window/2] <= sum_c(0..i){ histogram[c] }
-          median_bin = -1;
-          element_inc_count = 0;
           element_in_window_half = (elements_in_window + 1) / 2;
-          while (median_bin < bin_count_minus_1 && element_inc_count < element_in_window_half)
+          if (incremental_median_)
+          {
+            // the smallest such i: move right while too few elements are covered ...
+            while (median_bin < bin_count_minus_1 && elements_upto_median_bin < element_in_window_half)
+            {
+              ++median_bin;
+              elements_upto_median_bin += histogram[median_bin];
+            }
+            // ... and left while the bin below still covers enough of them
+            while (median_bin > 0 && elements_upto_median_bin - histogram[median_bin] >= element_in_window_half)
+            {
+              elements_upto_median_bin -= histogram[median_bin];
+              --median_bin;
+            }
+          }
+          else
           {
-            ++median_bin;
-            element_inc_count += histogram[median_bin];
+            median_bin = -1;
+            element_inc_count = 0;
+            while (median_bin < bin_count_minus_1 && element_inc_count < element_in_window_half)
+            {
+              ++median_bin;
+              element_inc_count += histogram[median_bin];
+            }
+            // keep the incremental bookkeeping consistent (unused in this mode)
+            elements_upto_median_bin = element_inc_count;
           }
 
           // increase the error count
@@ -405,6 +452,7 @@ protected:
       min_required_elements_   = param_.getValue("min_required_elements");
       noise_for_empty_window_  = (double)param_.getValue("noise_for_empty_window");
       write_log_messages_      = (bool)param_.getValue("write_log_messages").toBool();
+      incremental_median_      = param_.getValue("median_search").toString() == "incremental";
       stn_estimates_.clear();
     }
 
@@ -429,6 +477,9 @@ protected:
     // whether to write out log messages in the case of failure
     bool write_log_messages_;
 
+    // whether the median bin is tracked incrementally across windows (median_search == 'incremental')
+    bool incremental_median_;
+
     // counter for sparse windows
     double sparse_window_percent_;
     // counter for histogram overflow
@@ -40,6 +40,7 @@
 
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/KERNEL/SpectrumColumns.h>
 
 namespace OpenMS
 {
@@ -91,6 +92,14 @@ public:
       spectrum.select(indices);
     }
 
+    /**
+      @brief Column-wise variant of filterSpectrum()
+
+      Selects the n largest peaks via partial sorting of the intensity column.
+      The kept peaks are ordered by decreasing intensity (ties by original position), as for the template version.
+    */
+    void filterSpectrum(SpectrumColumns & spectrum);
+
     void filterPeakSpectrum(PeakSpectrum & spectrum);
 
     void filterPeakMap(PeakMap & exp);
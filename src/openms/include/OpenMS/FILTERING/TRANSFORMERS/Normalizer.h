@@ -40,6 +40,7 @@
 
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/KERNEL/SpectrumColumns.h>
 
 #include <vector>
 
@@ -123,6 +124,12 @@ public:
 
     }
 
+    /**
+      @brief Column-wise variant of filterSpectrum(), operating directly on the intensity column
+
+      @throws Exception::InvalidValue if 'method_' has unknown value
+    */
+    void filterSpectrum(SpectrumColumns& spectrum) const;
     ///
     void filterPeakSpectrum(PeakSpectrum & spectrum) const;
     ///
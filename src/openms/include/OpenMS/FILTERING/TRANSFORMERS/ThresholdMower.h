@@ -38,6 +38,7 @@
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/KERNEL/SpectrumColumns.h>
 
 namespace OpenMS
 {
@@ -86,6 +87,9 @@ public:
       spectrum.select(indices);
     }
 
+    /// Column-wise variant of filterSpectrum(), scanning only the intensity column
+    void filterSpectrum(SpectrumColumns & spectrum);
+
     void filterPeakSpectrum(PeakSpectrum & spectrum);
 
     void filterPeakMap(PeakMap & exp);
@@ -0,0 +1,182 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/DATASTRUCTURES/Param.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <map>
+
+namespace OpenMS
+{
+  /**
+    @brief Content-addressed cache for intermediate results (checkpoints) of long-running TOPP tools
+
+    A checkpoint is identified by a Key that collects everything the stored result depends on: the name of the
+    processing stage, the content hashes of its input files, the parameters used by the stage and the keys of
+    the checkpoints it was computed from. The result is stored in the cache directory under the hash of its key.
+    A changed input or parameter thus leads to a new checkpoint for all stages that depend on it, while the
+    checkpoints of unaffected stages are found again and can be reused.
+
+    Checkpoints are written whenever a cache directory is given, but only reused when resuming. Files are
+    written under a temporary name and renamed when complete, so an interrupted run never leaves a partial
+    checkpoint behind.
+
+    Content hashes (SHA-1) of input files are remembered in the cache directory together with file size and
+    modification time, so large inputs are not read again just to compute their hash when a run is resumed.
+
+    Usage:
+    @code
+    CheckpointCache cache(checkpoint_dir, resume);
+    CheckpointCache::Key key("features");
+    key.add("in", cache.hashFile(mz_file)).add("algorithm", param);
+    FeatureMap features;
+    if (!cache.load<FeatureXMLFile>(key, "featureXML", features))
+    {
+      // ... compute features
+      cache.store<FeatureXMLFile>(key, "featureXML", features);
+    }
+    @endcode
+
+    @ingroup FileIO
+  */
+  class OPENMS_DLLAPI CheckpointCache
+  {
+public:
+    /// Identifies a checkpoint by the processing stage and everything its result depends on
+    class OPENMS_DLLAPI Key
+    {
+public:
+      /// Constructor for a checkpoint of the processing stage @p stage (used as prefix of the file name)
+      explicit Key(const String& stage);
+
+      /// Add a named value (e.g. a tool option or a file hash) the result depends on
+      Key& add(const String& name, const String& value);
+
+      /// Add all entries of @p param (prefixed with @p name) the result depends on
+      Key& add(const String& name, const Param& param);
+
+      /// Add the key of a checkpoint the result was computed from
+      Key& add(const Key& upstream);
+
+      /// Name of the processing stage
+      const String& getStage() const;
+
+      /// SHA-1 (hex) of the stage and all values added so far
+      String getHash() const;
+
+protected:
+      String stage_; ///< name of the processing stage
+      String content_; ///< textual representation of all values added so far
+    };
+
+    /// Default constructor (disabled cache: nothing is stored or reused)
+    CheckpointCache();
+
+    /**
+      @brief Cache in @p directory (created if missing)
+
+      @param directory Cache directory; an empty string disables the cache
+      @param resume Reuse existing checkpoints? (otherwise they are only written)
+
+      @exception Exception::UnableToCreateFile is thrown if the directory cannot be created
+    */
+    CheckpointCache(const String& directory, bool resume);
+
+    /// Is a cache directory set?
+    bool isEnabled() const;
+
+    /// Are existing checkpoints reused?
+    bool isResuming() const;
+
+    /**
+      @brief SHA-1 (hex) of the content of @p filename
+
+      Hashes are remembered (in memory and, if enabled, in the cache directory) together with file size and
+      modification time and only recomputed if either changes. This function is thread-safe.
+
+      @exception Exception::FileNotFound is thrown if the file does not exist
+    */
+    String hashFile(const String& filename);
+
+    /// Path of the checkpoint for @p key stored as file type @p extension (e.g. "featureXML")
+    String getPath(const Key& key, const String& extension) const;
+
+    /// Is the checkpoint for @p key available for reuse? (only when resuming)
+    bool contains(const Key& key, const String& extension) const;
+
+    /**
+      @brief Load the checkpoint for @p key using @p FileType (e.g. FeatureXMLFile) into @p data
+
+      @return False (and @p data is left untouched) if the checkpoint is not available for reuse
+    */
+    template <typename FileType, typename... Data>
+    bool load(const Key& key, const String& extension, Data&... data) const
+    {
+      if (!contains(key, extension)) return false;
+      FileType().load(getPath(key, extension), data...);
+      reportReuse_(key, extension);
+      return true;
+    }
+
+    /// Store @p data as checkpoint for @p key using @p FileType (e.g. FeatureXMLFile); does nothing if disabled
+    template <typename FileType, typename... Data>
+    void store(const Key& key, const String& extension, const Data&... data) const
+    {
+      if (!isEnabled()) return;
+      const String tmp_path = getTemporaryPath_(key, extension);
+      FileType().store(tmp_path, data...);
+      commit_(tmp_path, getPath(key, extension));
+    }
+
+protected:
+    /// Log that the checkpoint for @p key is reused
+    void reportReuse_(const Key& key, const String& extension) const;
+
+    /// Temporary path the checkpoint for @p key is written to (unique per thread and process)
+    String getTemporaryPath_(const Key& key, const String& extension) const;
+
+    /// Move the completely written checkpoint from @p tmp_path to @p path
+    void commit_(const String& tmp_path, const String& path) const;
+
+    /// Name of the file in the cache directory that remembers file hashes
+    static const String FILE_HASHES;
+
+    String directory_; ///< cache directory (empty = disabled)
+    bool resume_ = false; ///< reuse existing checkpoints?
+    std::map<String, String> file_hashes_; ///< known file hashes ("size<TAB>modification time<TAB>absolute path" -> hash)
+  };
+}
+
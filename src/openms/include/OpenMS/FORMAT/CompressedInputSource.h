@@ -55,7 +55,7 @@ public:
     ~CompressedInputSource() override;
 
     /**
-       @brief Depending on the header in the Constructor a Bzip2InputStream or a GzipInputStream object is returned
+       @brief Returns a ReadAheadInputStream which decompresses the file (bzip2 or gzip, depending on the header in the Constructor) on a background thread
        @note InputSource interface implementation
     */
     xercesc::BinInputStream * makeStream() const override;
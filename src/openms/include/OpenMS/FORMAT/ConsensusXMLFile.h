@@ -39,6 +39,8 @@
 #include <OpenMS/KERNEL/ConsensusMap.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 
+#include <functional>
+
 namespace OpenMS
 {
   class ConsensusMap;
@@ -74,6 +76,29 @@ public:
     */
     void load(const String& filename, ConsensusMap& map);
 
+    /**
+    @brief Streams the consensus features of a file one at a time into @p consumer
+
+    Instead of collecting all consensus features in a map, each one is passed
+    to @p consumer as soon as it has been parsed and discarded afterwards, so
+    memory does not grow with the number of consensus features. @p meta_map
+    receives everything else (column headers, data processing, identification
+    runs, unassigned peptide identifications and meta values). These precede
+    the consensus features in the file, so @p meta_map is complete before the
+    first call of @p consumer.
+
+    The RT, m/z and intensity ranges of the options are applied as in load().
+
+    @param filename Input consensusXML file
+    @param meta_map Receives the map-level data (will not contain any consensus features)
+    @param consumer Called for each consensus feature; it may modify or move from the feature
+    @param load_peptide_ids Whether to parse assigned and unassigned peptide identifications
+
+    @exception Exception::FileNotFound is thrown if the file could not be opened
+    @exception Exception::ParseError is thrown if an error occurs during parsing
+    */
+    void transform(const String& filename, ConsensusMap& meta_map, const std::function<void (ConsensusFeature&)>& consumer, bool load_peptide_ids = true);
+
     /**
     @brief Stores a consensus map to file
 
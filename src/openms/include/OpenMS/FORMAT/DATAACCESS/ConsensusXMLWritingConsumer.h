@@ -0,0 +1,106 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/FORMAT/HANDLERS/ConsensusXMLHandler.h>
+
+#include <fstream>
+
+namespace OpenMS
+{
+  /**
+    @brief Writes consensus features to a consensusXML file as they come in, without holding them in a ConsensusMap.
+
+    This is the writing counterpart of ConsensusXMLFile::transform(). The
+    map-level data (column headers, meta values, data processing,
+    identification runs and unassigned peptide identifications) is taken from
+    @p meta_map, which is only read when the first consensus feature is
+    written (or on destruction, if none was written at all). It may thus
+    still be filled after construction, e.g. by ConsensusXMLFile::transform()
+    itself:
+
+    @code
+    ConsensusMap meta;
+    ConsensusXMLWritingConsumer writer(out, meta);
+    ConsensusXMLFile().transform(in, meta, [&writer](ConsensusFeature& f)
+    {
+      // [...] modify the consensus feature
+      writer.consumeConsensusFeature(f);
+    });
+    @endcode
+
+    The file is completed when the consumer is destroyed.
+
+    @note Unlike ConsensusXMLFile::store(), neither the uniqueness of ids
+    nor the consistency of map references can be checked, since the
+    consensus features are never held together.
+  */
+  class OPENMS_DLLAPI ConsensusXMLWritingConsumer :
+    public Internal::ConsensusXMLHandler
+  {
+public:
+    /**
+      @brief Constructor
+
+      @param filename Output consensusXML file
+      @param meta_map Map-level data to write (must outlive this object; consensus features contained in it are ignored)
+
+      @exception Exception::UnableToCreateFile is thrown if the file has no consensusXML extension or cannot be created
+    */
+    ConsensusXMLWritingConsumer(const String& filename, const ConsensusMap& meta_map);
+
+    /// Destructor (writes the closing tags)
+    ~ConsensusXMLWritingConsumer() override;
+
+    /// Writes a consensus feature to the file
+    void consumeConsensusFeature(const ConsensusFeature& feature);
+
+    /// Returns the number of consensus features written so far
+    Size getNrConsensusFeaturesWritten() const;
+
+protected:
+    /// Writes the header if it has not been written yet
+    void startWriting_();
+
+    /// File stream (to write consensusXML)
+    std::ofstream ofs_;
+    /// Whether the header has been written
+    bool started_writing_;
+    /// Number of consensus features written
+    Size features_written_;
+  };
+
+} // namespace OpenMS
+
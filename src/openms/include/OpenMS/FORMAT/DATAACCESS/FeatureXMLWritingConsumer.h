@@ -0,0 +1,112 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/FORMAT/HANDLERS/FeatureXMLHandler.h>
+
+#include <fstream>
+
+namespace OpenMS
+{
+  /**
+    @brief Writes features to a featureXML file as they come in, without holding them in a FeatureMap.
+
+    This is the writing counterpart of FeatureXMLFile::transform(). The
+    map-level data (meta values, data processing, identification runs and
+    unassigned peptide identifications) is taken from @p meta_map, which is
+    only read when the first feature is written (or on destruction, if no
+    feature was written at all). It may thus still be filled after
+    construction, e.g. by FeatureXMLFile::transform() itself:
+
+    @code
+    FeatureMap meta;
+    FeatureXMLWritingConsumer writer(out, meta, FeatureXMLFile().loadSize(in));
+    FeatureXMLFile().transform(in, meta, [&writer](Feature& f)
+    {
+      // [...] modify the feature
+      writer.consumeFeature(f);
+    });
+    @endcode
+
+    The file is completed when the consumer is destroyed.
+
+    @note The expected number of features is written to the count attribute
+    of the featureList tag before any feature and is not enforced. A wrong
+    value leads to a wrong count in the file (which is only used as a hint
+    for memory allocation during loading).
+
+    @note Unlike FeatureXMLFile::store(), the uniqueness of feature ids
+    cannot be checked, since the features are never held together.
+  */
+  class OPENMS_DLLAPI FeatureXMLWritingConsumer :
+    public Internal::FeatureXMLHandler
+  {
+public:
+    /**
+      @brief Constructor
+
+      @param filename Output featureXML file
+      @param meta_map Map-level data to write (must outlive this object; features contained in it are ignored)
+      @param expected_size Number of features that will be written
+
+      @exception Exception::UnableToCreateFile is thrown if the file has no featureXML extension or cannot be created
+    */
+    FeatureXMLWritingConsumer(const String& filename, const FeatureMap& meta_map, Size expected_size);
+
+    /// Destructor (writes the closing tags)
+    ~FeatureXMLWritingConsumer() override;
+
+    /// Writes a feature (and its subordinates) to the file
+    void consumeFeature(const Feature& feature);
+
+    /// Returns the number of features written so far
+    Size getNrFeaturesWritten() const;
+
+protected:
+    /// Writes the header if it has not been written yet
+    void startWriting_();
+
+    /// File stream (to write featureXML)
+    std::ofstream ofs_;
+    /// Whether the header has been written
+    bool started_writing_;
+    /// Number of features written
+    Size features_written_;
+    /// Number of features announced in the header
+    Size features_expected_;
+  };
+
+} // namespace OpenMS
+
@@ -0,0 +1,74 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+
+#include <OpenMS/KERNEL/ArenaMSExperiment.h>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Consumer class that stores the data in an ArenaMSExperiment.
+
+    Use with MzMLFile::transform() (or MzMLFile::load(const String&, ArenaMSExperiment&))
+    to load large runs without one heap allocation per spectrum for peaks and meta data.
+    The data is appended to the ArenaMSExperiment given in the constructor, which must outlive the consumer.
+
+    Consumed spectra are moved into the ArenaMSExperiment and left empty (do not combine with PeakFileOptions::setAlwaysAppendData()).
+
+  */
+  class OPENMS_DLLAPI MSDataArenaConsumer :
+    public Interfaces::IMSDataConsumer
+  {
+  public:
+
+    /// Constructor; spectra and chromatograms will be appended to @p exp
+    explicit MSDataArenaConsumer(ArenaMSExperiment& exp);
+
+    void setExperimentalSettings(const ExperimentalSettings & settings) override;
+
+    void setExpectedSize(Size s_size, Size c_size) override;
+
+    void consumeSpectrum(SpectrumType & s) override;
+
+    void consumeChromatogram(ChromatogramType & c) override;
+
+  private:
+    ArenaMSExperiment& exp_;
+  };
+} //end namespace OpenMS
@@ -39,6 +39,7 @@
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 
 #include <fstream>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -123,6 +124,9 @@ namespace OpenMS
 
         /**
           @brief Prepares a FASTA file given by 'filename' for streamed reading using readNext().
+
+          Files compressed with gzip or bzip2 are detected automatically and decompressed on
+          a background thread while reading.
           @exception Exception::FileNotFound is thrown if the file does not exists.
           @exception Exception::ParseError is thrown if the file does not suit to the standard.
         */
@@ -137,13 +141,25 @@ namespace OpenMS
         */
         bool readNext(FASTAEntry& protein);
 
-        /// current stream position
+        /**
+          @brief current stream position
+
+          @exception Exception::NotImplemented is thrown for compressed input (see isSeekable())
+        */
         std::streampos position();
 
+        /// can the input be repositioned (false for gzip/bzip2 compressed input)? Only valid after readStart().
+        bool isSeekable() const;
+
         /// is stream at EOF?
         bool atEnd();
 
-        /// seek stream to @p pos
+        /**
+          @brief seek stream to @p pos
+
+          @return false if @p pos is beyond the end of the file
+          @exception Exception::NotImplemented is thrown for compressed input (see isSeekable())
+        */
         bool setPosition(const std::streampos& pos);
 
         /**
@@ -188,7 +204,9 @@ namespace OpenMS
          */
         bool readEntry_(std::string& id, std::string& description, std::string& seq);
 
-        std::fstream infile_;       ///< filestream for reading; init using FastaFile::readStart()
+        std::filebuf filebuf_;      ///< buffer of uncompressed input files
+        std::unique_ptr<std::streambuf> compressed_buf_; ///< buffer of gzip/bzip2 compressed input files (decompressed on a background thread)
+        std::istream infile_{nullptr}; ///< stream for reading (uses filebuf_ or compressed_buf_); init using FastaFile::readStart()
         std::ofstream outfile_;     ///< filestream for writing; init using FastaFile::writeStart()
         Size entries_read_{0};      ///< some internal book-keeping during reading
         std::streampos fileSize_{}; ///< total number of characters of filestream
@@ -0,0 +1,167 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/FORMAT/FASTAFile.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace boost
+{
+  namespace iostreams
+  {
+    class mapped_file_source;
+  }
+}
+
+namespace OpenMS
+{
+  /**
+    @brief Compiled, memory-mappable binary representation of a FASTA database
+
+    Parsing a large FASTA file (e.g. a six-frame translation or a metaproteomics database)
+    takes considerable time and every process which reads it holds its own private copy in memory.
+    This class stores the database once in a binary layout, which can be memory-mapped read-only
+    afterwards. Opening the file is instantaneous (no parsing), entries can be accessed randomly
+    and several processes searching the same database share the pages via the OS page cache.
+
+    Layout (all integers in native byte order; the byte order is checked upon opening):
+    <pre>
+      header:       magic (uint32), version (uint32), entry count N (uint64), offset table position (uint64)
+      data:         identifier, description and sequence of each entry, as concatenated raw bytes
+      offset table: 3*N+1 byte offsets (uint64) into the file, i.e. entry i has its identifier at [3i, 3i+1),
+                    its description at [3i+1, 3i+2) and its sequence at [3i+2, 3i+3)
+    </pre>
+
+    Use compile() to convert a FASTA file (streamed, i.e. without holding it in memory) or store() for
+    entries already in memory. Reading is done via open() and getEntry(), or more conveniently via
+    FASTAContainer<TFI_MMap>; load() copies a whole database (compiled or plain) into a vector.
+
+    @note All const member functions are thread-safe.
+  */
+  class OPENMS_DLLAPI FASTAIndexFile
+  {
+  public:
+    /// Default constructor (no file is opened)
+    FASTAIndexFile();
+
+    /// Constructor which opens (maps) @p filename; see open()
+    explicit FASTAIndexFile(const String& filename);
+
+    /// Destructor (unmaps the file)
+    ~FASTAIndexFile();
+
+    /// No copies (the mapping is owned)
+    FASTAIndexFile(const FASTAIndexFile&) = delete;
+    FASTAIndexFile& operator=(const FASTAIndexFile&) = delete;
+
+    /**
+      @brief Maps the compiled database @p filename read-only into memory
+
+      A previously opened file is closed first.
+      @exception Exception::FileNotFound is thrown if the file does not exist
+      @exception Exception::ParseError is thrown if the file is not a compiled FASTA database (or is truncated)
+    */
+    void open(const String& filename);
+
+    /// Unmaps the current file (if any)
+    void close();
+
+    /// Is a file currently mapped?
+    bool isOpen() const;
+
+    /// Number of entries in the mapped database (0 if no file is open)
+    Size size() const;
+
+    /**
+      @brief Copies the entry at @p index into @p entry
+
+      @exception Exception::IndexOverflow is thrown if @p index is not smaller than size()
+    */
+    void getEntry(Size index, FASTAFile::FASTAEntry& entry) const;
+
+    /// Length of the sequence of entry @p index (without copying it)
+    Size getSequenceLength(Size index) const;
+
+    /**
+      @brief Writes @p data in the compiled binary format to @p filename
+
+      @exception Exception::UnableToCreateFile is thrown if the file cannot be written
+    */
+    static void store(const String& filename, const std::vector<FASTAFile::FASTAEntry>& data);
+
+    /**
+      @brief Converts the FASTA file @p fasta_file into the compiled binary format @p filename
+
+      The FASTA file is read entry by entry, i.e. only the offset table is held in memory.
+      @return Number of entries written
+      @exception Exception::FileNotFound is thrown if @p fasta_file does not exist
+      @exception Exception::ParseError is thrown if @p fasta_file is malformed
+      @exception Exception::UnableToCreateFile is thrown if @p filename cannot be written
+    */
+    static Size compile(const String& fasta_file, const String& filename);
+
+    /// Does @p filename start with the magic number of a compiled FASTA database?
+    static bool isCompiledFASTA(const String& filename);
+
+    /**
+      @brief Loads all entries of @p filename into @p data (previous content is removed)
+
+      @p filename may be a compiled database (copied from the mapping, i.e. without parsing) or a plain FASTA file
+      (parsed via FASTAFile::load). Use this in tools which need the whole database as a vector.
+
+      @exception Exception::FileNotFound is thrown if the file does not exist
+      @exception Exception::ParseError is thrown if the file is malformed
+    */
+    static void load(const String& filename, std::vector<FASTAFile::FASTAEntry>& data);
+
+  protected:
+    /// Returns the pointer to byte @p offset of the mapping
+    const char* at_(std::uint64_t offset) const;
+
+    /// Offset table entry @p i (see class documentation)
+    std::uint64_t offset_(Size i) const;
+
+    std::unique_ptr<boost::iostreams::mapped_file_source> file_; ///< read-only mapping of the file
+    Size size_ = 0; ///< number of entries
+    const char* offsets_ = nullptr; ///< start of the offset table within the mapping
+    String filename_; ///< name of the mapped file (for error messages)
+  };
+
+} // namespace OpenMS
@@ -38,6 +38,7 @@
 #include <OpenMS/FORMAT/XMLFile.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 
+#include <functional>
 #include <iosfwd>
 
 namespace OpenMS
@@ -84,6 +85,30 @@ public:
 
     Size loadSize(const String& filename);
 
+    /**
+        @brief Streams the features of a file one at a time into @p consumer
+
+        Instead of collecting all features in a map, each top-level feature
+        (including its subordinates) is passed to @p consumer as soon as it has
+        been parsed and discarded afterwards, so memory does not grow with the
+        number of features. @p feature_map receives everything else (meta
+        values, data processing, identification runs and unassigned peptide
+        identifications). These precede the features in the file, so
+        @p feature_map is complete before the first call of @p consumer.
+
+        The options apply as in load(); use them to skip convex hulls,
+        subordinates or peptide identifications, or to restrict the RT, m/z or
+        intensity range.
+
+        @param filename Input featureXML file
+        @param feature_map Receives the map-level data (will not contain any features)
+        @param consumer Called for each feature; it may modify or move from the feature
+
+        @exception Exception::FileNotFound is thrown if the file could not be opened
+        @exception Exception::ParseError is thrown if an error occurs during parsing
+    */
+    void transform(const String& filename, FeatureMap& feature_map, const std::function<void (Feature&)>& consumer);
+
     /**
         @brief stores the map @p feature_map in file with name @p filename.
 
@@ -54,8 +54,9 @@ namespace OpenMS
       * @param consensus_file_path path to consensusXML with spectrum references
       * @param mzml_file_paths path to mzML files referenced in consensusXML. Used to extract spectra as MGF.
       * @param out MGF file with MS2 peak data for molecular networking.
+      * @param exported_spectra If not null, receives the exported spectrum of every consensus feature (in ConsensusMap order, with precursor m/z and charge of the feature), e.g. for PairwiseSpectralSimilarity.
       */
-      void run(const String& consensus_file_path, const StringList& mzml_file_paths, const String& out) const;
+      void run(const String& consensus_file_path, const StringList& mzml_file_paths, const String& out, std::vector<MSSpectrum>* exported_spectra = nullptr) const;
 
     private:
       static constexpr double DEF_COSINE_SIMILARITY = 0.9;
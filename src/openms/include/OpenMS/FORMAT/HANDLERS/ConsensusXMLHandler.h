@@ -41,6 +41,7 @@
 #include <OpenMS/METADATA/PeptideEvidence.h>
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
+#include <functional>
 #include <unordered_map>
 #include <map>
 
@@ -83,8 +84,30 @@ public:
     /// Docu in base class XMLHandler::writeTo
     void writeTo(std::ostream& os) override;
 
+    /**
+      @brief Passes each consensus feature to @p consumer as soon as it has been parsed
+
+      The map then only receives the map-level data (column headers, meta
+      values, data processing, identification runs and unassigned peptide
+      identifications). Consensus features failing the range restrictions of
+      the options are not passed on.
+    */
+    void setConsensusFeatureConsumer(const std::function<void (ConsensusFeature&)>& consumer);
+
+    /// sets whether or not to load (assigned and unassigned) peptide identifications (default: true)
+    void setLoadPeptideIdentifications(bool load);
+
 protected:
 
+    /// Writes everything up to and including the opening consensusElementList tag
+    void writeHeader_(std::ostream& os, const ConsensusMap& consensus_map);
+
+    /// Writes a consensus feature to a stream
+    void writeConsensusElement_(std::ostream& os, const ConsensusFeature& elem);
+
+    /// Closes the consensusElementList and consensusXML tags
+    void writeFooter_(std::ostream& os);
+
     // Docu in base class
     void endElement(const XMLCh* const /*uri*/, const XMLCh* const /*local_name*/, const XMLCh* const qname) override;
 
@@ -143,6 +166,13 @@ protected:
     ProteinIdentification::SearchParameters search_param_;
 
     UInt progress_;
+
+    /// receives consensus features during parsing instead of the map (if set)
+    std::function<void (ConsensusFeature&)> consensus_consumer_;
+    /// whether peptide identifications are parsed
+    bool load_peptide_ids_;
+    /// >0 while inside a section that is skipped
+    Int disable_parsing_;
   };
 } // namespace Internal
 } // namespace OpenMS
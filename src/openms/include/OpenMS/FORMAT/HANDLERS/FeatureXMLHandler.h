@@ -43,6 +43,7 @@
 #include <OpenMS/DATASTRUCTURES/ConvexHull2D.h>
 #include <OpenMS/DATASTRUCTURES/Param.h>
 
+#include <functional>
 #include <iosfwd>
 #include <map>
 
@@ -107,6 +108,20 @@ public:
       return expected_size_;
     }
 
+    /**
+      @brief Passes each top-level feature to @p consumer as soon as it has been parsed
+
+      The feature is removed from the map again after the call, so the map
+      only keeps the map-level data (meta values, data processing,
+      identification runs and unassigned peptide identifications) and at most
+      one feature at a time. Features failing the range restrictions of the
+      options are not passed on.
+    */
+    void setFeatureConsumer(const std::function<void (Feature&)>& consumer)
+    {
+      feature_consumer_ = consumer;
+    }
+
 protected:
 
     // restore default state for next load/store operation
@@ -121,6 +136,12 @@ protected:
     // Docu in base class
     void characters(const XMLCh* const chars, const XMLSize_t length) override;
 
+    /// Writes everything up to and including the opening featureList tag, which announces @p feature_count features
+    void writeHeader_(std::ostream& os, const FeatureMap& feature_map, Size feature_count);
+
+    /// Closes the featureList and featureMap tags
+    void writeFooter_(std::ostream& os);
+
     /// Writes a feature to a stream
     void writeFeature_(const String& filename, std::ostream& os, const Feature& feat, const String& identifier_prefix, UInt64 identifier, UInt indentation_level);
 
@@ -151,6 +172,10 @@ protected:
     bool size_only_;
     /// holds the putative size given in count
     Size expected_size_;
+    /// receives top-level features during parsing instead of the map (if set)
+    std::function<void (Feature&)> feature_consumer_;
+    /// number of features passed to feature_consumer_
+    Size consumed_features_;
 
     /**@name temporary data structures to hold parsed data */
     //@{
@@ -56,17 +56,27 @@ namespace OpenMS
     @brief A class to decode input strings that contain an mzML chromatogram or
     spectrum tag.
 
-    It uses xercesc to parse a string containing either a exactly one mzML
+    It parses a string containing either a exactly one mzML
     spectrum or chromatogram (from <chromatogram> to </chromatogram> or
     <spectrum> to </spectrum> tag). It returns the data contained in the
     binaryDataArray for Intensity / mass-to-charge or Intensity / time.
 
+    By default, the string is scanned directly by a small tokenizer that only
+    knows the grammar of these two elements (attributes of the root tag,
+    cvParam and binary children of binaryDataArray). Whenever it encounters
+    content it does not handle (comments, CDATA sections, processing
+    instructions, non-ASCII characters, unknown entities or malformed tags),
+    the string is parsed again using a xercesc DOM parser, which also produces
+    the error messages for invalid input. See setUseDOMParser().
+
   */
   class OPENMS_DLLAPI MzMLSpectrumDecoder
   {
   protected:
 
     bool skip_xml_checks_; ///< Whether to skip some XML checks (e.g. removing whitespace inside base64 arrays) and be fast instead
+
+    bool use_dom_parser_; ///< Whether to always build a DOM tree instead of using the tokenizer
       
     typedef Internal::MzMLHandlerHelper::BinaryData BinaryData;
 
@@ -119,10 +129,31 @@ namespace OpenMS
     */
     std::string domParseString_(const std::string& in, std::vector<BinaryData>& data);
 
+    /**
+      @brief Extract data from a string containing multiple <binaryDataArray> tags without building a DOM tree.
+
+      Scans the characters of @p in directly and produces the same output as
+      domParseString_() for all input it accepts. Only the root tag and the
+      direct children of <binaryDataArray> are interpreted, all other elements
+      are skipped. Content following the closing root tag is ignored.
+
+      @param in Input string containing the raw XML
+      @param data Binary data extracted from the string
+      @param id The 'id' attribute of the root element
+
+      @return False if the input contains constructs which are not supported
+      (the output is then incomplete and domParseString_() needs to be used)
+    */
+    bool fastParseString_(const std::string& in, std::vector<BinaryData>& data, std::string& id) const;
+
+    /// Parse using fastParseString_() and fall back to domParseString_() if required (or requested)
+    std::string parseString_(const std::string& in, std::vector<BinaryData>& data);
+
   public:
 
     explicit MzMLSpectrumDecoder(bool skip_xml_checks = false) :
-      skip_xml_checks_(skip_xml_checks)
+      skip_xml_checks_(skip_xml_checks),
+      use_dom_parser_(false)
     {}
 
     /**
@@ -187,6 +218,9 @@ namespace OpenMS
 
     /// Whether to skip some XML checks (e.g. removing whitespace inside base64 arrays) and be fast instead
     void setSkipXMLChecks(bool only);
+
+    /// Whether to always parse the input with the xercesc DOM parser (slow, mainly useful for debugging)
+    void setUseDOMParser(bool use_dom);
   };
 }
 
@@ -220,6 +220,16 @@ public:
                   bool zlib_compression,
                   const NumpressConfig & config);
 
+    /**
+     * @brief decodeNP into a float vector (e.g. intensity buffers)
+     *
+     * Decodes directly into single precision, without an intermediate vector of doubles.
+    */
+    void decodeNP(const String & in,
+                  std::vector<float> & out,
+                  bool zlib_compression,
+                  const NumpressConfig & config);
+
     /**
      * @brief Encode the data vector "in" to a raw byte array
      *
@@ -266,9 +276,15 @@ public:
                      std::vector<double> & out,
                      const NumpressConfig & config);
 
+    /// decodeNPRaw into a float vector (no intermediate vector of doubles)
+    void decodeNPRaw(const std::string & in,
+                     std::vector<float> & out,
+                     const NumpressConfig & config);
+
 private:
 
     void decodeNPInternal_(const unsigned char* in, size_t in_size, std::vector<double>& out, const NumpressConfig & config);
+    void decodeNPInternal_(const unsigned char* in, size_t in_size, std::vector<float>& out, const NumpressConfig & config);
   };
 
 } //namespace OpenMS
@@ -47,6 +47,8 @@
 
 namespace OpenMS
 {
+  class ArenaMSExperiment;
+
   /**
     @brief File adapter for MzML files
 
@@ -76,6 +78,10 @@ public:
     /**
       @brief Loads a map from a MzML file. Spectra and chromatograms are sorted by default (this can be disabled using PeakFileOptions).
 
+      If PeakFileOptions::getParallelIndexedLoad() is set and @p filename is an
+      indexedmzML file, the spectra and chromatograms are parsed in parallel
+      (see loadIndexedParallel_()). The result is identical to a sequential load.
+
       @param filename The filename with the data
       @param map Is an MSExperiment
 
@@ -84,6 +90,21 @@ public:
     */
     void load(const String& filename, PeakMap& map);
 
+    /**
+      @brief Loads a map from a MzML file into a memory-compact ArenaMSExperiment.
+
+      Peaks are stored in large blocks and identical spectrum meta data is shared (see ArenaMSExperiment),
+      which reduces the number of heap allocations when loading (and freeing) runs with many spectra.
+      All PeakFileOptions are honored, except for parallel loading.
+
+      @param filename The filename with the data
+      @param map The result; previous spectra and chromatograms are removed
+
+      @exception Exception::FileNotFound is thrown if the file could not be opened
+      @exception Exception::ParseError is thrown if an error occurs during parsing
+    */
+    void load(const String& filename, ArenaMSExperiment& map);
+
     /**
       @brief Loads a map from a MzML file stored in a buffer (in memory).
 
@@ -212,6 +233,20 @@ protected:
     /// Safe parse that catches exceptions and handles them accordingly
     void safeParse_(const String & filename, Internal::XMLHandler * handler);
 
+    /**
+      @brief Load an indexedmzML file in parallel using the offsets of its index
+
+      The header (everything up to the first spectrum or chromatogram) is
+      parsed once to obtain the experimental settings. The offset list is then
+      split into consecutive blocks, and each block is wrapped into the header
+      and the closing tags to form a small, valid mzML document which is
+      parsed by its own MzMLHandler. The results are concatenated in file
+      order.
+
+      @return false if the file has no usable index (the map is untouched then)
+    */
+    bool loadIndexedParallel_(const String& filename, PeakMap& map);
+
 private:
 
     /// Options for loading / storing
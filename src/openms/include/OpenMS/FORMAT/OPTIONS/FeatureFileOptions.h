@@ -63,6 +63,12 @@ public:
     ///returns whether or not to load subordinates
     bool getLoadSubordinates() const;
 
+    ///@name peptide identification option
+    ///sets whether or not to load (assigned and unassigned) peptide identifications
+    void setLoadPeptideIdentifications(bool load);
+    ///returns whether or not to load peptide identifications
+    bool getLoadPeptideIdentifications() const;
+
     ///@name metadata option
     ///sets whether or not to load only meta data
     void setMetadataOnly(bool only);
@@ -102,6 +108,7 @@ public:
 private:
     bool loadConvexhull_;
     bool loadSubordinates_;
+    bool load_peptide_ids_;
     bool metadata_only_;
     bool has_rt_range_;
     bool has_mz_range_;
@@ -229,6 +229,20 @@ public:
     /// [mzML only!] Set whether to use the "selected ion m/z" value as the precursor m/z value (alternative: use the "isolation window target m/z" value)
     void setPrecursorMZSelectedIon(bool choice);
 
+    /**
+        @brief [mzML only!] Whether to load indexed mzML files in parallel
+
+        If enabled, the spectrum and chromatogram offsets of an indexedmzML file
+        are used to split the file into parts which are parsed concurrently.
+        Files without a valid index (or compressed files) are loaded sequentially.
+    */
+    //@{
+    /// Get whether indexed mzML files are loaded in parallel
+    bool getParallelIndexedLoad() const;
+    /// Set whether indexed mzML files are loaded in parallel
+    void setParallelIndexedLoad(bool parallel);
+    //@}
+
     /// do these options skip spectra or chromatograms due to RT or MSLevel filters?
     bool hasFilters() const;
 
@@ -258,6 +272,7 @@ private:
     MSNumpressCoder::NumpressConfig np_config_fda_;
     Size maximal_data_pool_size_;
     bool precursor_mz_selected_ion_;
+    bool parallel_indexed_load_;
   };
 
 } // namespace OpenMS
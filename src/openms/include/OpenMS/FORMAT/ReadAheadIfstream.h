@@ -0,0 +1,193 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <OpenMS/config.h>
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace OpenMS
+{
+  class GzipIfstream;
+  class Bzip2Ifstream;
+
+  /**
+    @brief Decompresses gzip or bzip2 compressed files on a background thread
+
+    Offers the same interface as GzipIfstream and Bzip2Ifstream, but
+    decompression runs ahead of the reader on a separate thread: the
+    decompressed data is handed over in chunks through a bounded queue (at
+    most @p max_chunks chunks of @p chunk_size bytes are buffered). Thus,
+    parsing the data (e.g. by Xerces or FASTAFile) and inflating it overlap,
+    and for most inputs the time spent on decompression is hidden completely.
+
+    Errors during decompression (e.g. corrupted files) are reported by
+    re-throwing the exception of the background thread from read().
+
+    @note The compressed stream itself is decoded sequentially; gzip and bzip2
+    files do not carry an index of independently decodable blocks.
+  */
+  class OPENMS_DLLAPI ReadAheadIfstream
+  {
+public:
+    /// Compression format of the input file
+    enum CompressionType
+    {
+      AUTO, ///< determine from the magic bytes of the file (bzip2 if it starts with 'BZ', gzip otherwise)
+      GZIP,
+      BZIP2
+    };
+
+    /// Default Constructor
+    ReadAheadIfstream();
+
+    /// Detailed constructor with filename
+    explicit ReadAheadIfstream(const char * filename, CompressionType type = AUTO);
+
+    /// Destructor (stops the background thread)
+    virtual ~ReadAheadIfstream();
+
+    /**
+      * @brief Reads n bytes from the compressed file into buffer s
+      *
+      * @param s Buffer to be filled with the output
+      * @param n The size of the buffer s
+      * @return The number of actually read bytes. If it is less than n, the end of the file was reached and the stream is closed
+      *
+      * @note This returns a raw byte stream that is *not* null-terminated. Be careful here.
+      * @note Closes the stream if the end of file is reached. Check isOpen before reading from the file again
+      *
+      * @exception Exception::ConversionError is thrown if decompression fails
+      * @exception Exception::IllegalArgument is thrown if no file for decompression is given.
+    */
+    size_t read(char * s, size_t n);
+
+    /**
+      * @brief indicates whether the read function can be used safely
+      *
+      * @return true if end of file was reached. Otherwise false.
+    */
+    bool streamEnd() const;
+
+    /// returns whether a file is open
+    bool isOpen() const;
+
+    /**
+      * @brief opens a file for reading (decompression) and starts the background thread
+      *
+      * @note any previous open files will be closed first!
+      * @exception Exception::FileNotFound is thrown if the file cannot be opened
+    */
+    void open(const char * filename, CompressionType type = AUTO);
+
+    /// closes the current file (stops the background thread)
+    void close();
+
+    /**
+      * @brief sets the size of the read-ahead buffer (takes effect with the next call to open())
+      *
+      * @param chunk_size Size of a single chunk of decompressed data (in bytes)
+      * @param max_chunks Maximal number of decompressed chunks buffered ahead of the reader
+    */
+    void setBufferSize(Size chunk_size, Size max_chunks);
+
+    /// returns true if @p filename starts with gzip or bzip2 magic bytes
+    static bool isCompressed(const char * filename);
+
+protected:
+    /// decompression loop of the background thread
+    void run_();
+
+    /// decompressor (only one of them is used)
+    std::unique_ptr<GzipIfstream> gzip_;
+    std::unique_ptr<Bzip2Ifstream> bzip2_;
+
+    /// background thread
+    std::thread worker_;
+
+    /// guards all members below (shared with the background thread)
+    std::mutex mutex_;
+    /// signalled when a chunk was added (or the producer finished)
+    std::condition_variable chunk_ready_;
+    /// signalled when a chunk was consumed (or the reader stops)
+    std::condition_variable chunk_consumed_;
+    /// decompressed chunks, in file order
+    std::deque<std::vector<char> > chunks_;
+    /// consumed chunks for re-use (avoids reallocation)
+    std::vector<std::vector<char> > free_chunks_;
+    /// true if the background thread is done (end of file or error)
+    bool producer_done_;
+    /// true if the reader requested the background thread to stop
+    bool stop_;
+    /// exception raised by the background thread
+    std::exception_ptr error_;
+
+    /// chunk currently read from (only accessed by the reader)
+    std::vector<char> current_;
+    /// read position in current_
+    Size current_pos_;
+
+    Size chunk_size_;
+    Size max_chunks_;
+
+    /// true if a file is open
+    bool is_open_;
+    /// true if end of file is reached
+    bool stream_at_end_;
+
+    ///not implemented
+    ReadAheadIfstream(const ReadAheadIfstream & rhs);
+    ReadAheadIfstream & operator=(const ReadAheadIfstream & rhs);
+  };
+
+  inline bool ReadAheadIfstream::isOpen() const
+  {
+    return is_open_;
+  }
+
+  inline bool ReadAheadIfstream::streamEnd() const
+  {
+    return stream_at_end_;
+  }
+
+} //namespace OpenMS
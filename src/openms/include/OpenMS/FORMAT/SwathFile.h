@@ -75,6 +75,28 @@ public:
                                                boost::shared_ptr<ExperimentalSettings>& exp_meta, 
                                                String readoptions = "normal");
 
+    /**
+      @brief Loads a single file of a split Swath run
+
+      The file is expected to contain only scans from one precursor isolation
+      window (one SWATH) or only MS1 scans. This allows loading the files of a
+      split run one at a time, e.g. to process each SWATH while the next one is
+      read (see OpenSwathWorkflow::performExtractionPipelined()).
+
+      @param[in] file Input filename
+      @param[in] tmp Temporary directory (for cached data)
+      @param[in] tmp_fname Filename for the cached data (in @p tmp)
+      @param[in] readoptions How are spectra accessed after reading ("normal" or "cache")
+      @return The SWATH map (MS1 or MS2); its spectrum access pointer is empty if the file contains no scans
+    */
+    OpenSwath::SwathMap loadSplitFile(const String& file,
+                                      const String& tmp,
+                                      const String& tmp_fname,
+                                      const String& readoptions = "normal");
+
+    /// Loads only the meta data (experimental settings) of an mzML file
+    boost::shared_ptr<ExperimentalSettings> loadMetaData(const String& file);
+
     /**
       @brief Loads a Swath run from a single mzML file
 
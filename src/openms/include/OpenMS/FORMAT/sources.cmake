@@ -23,6 +23,7 @@ Base64.h
 Bzip2Ifstream.h
 Bzip2InputStream.h
 CachedMzML.h
+CheckpointCache.h
 ChromeleonFile.h
 CompressedInputSource.h
 CVMappingFile.h
@@ -34,6 +35,7 @@ DTAFile.h
 EDTAFile.h
 ExperimentalDesignFile.h
 FASTAFile.h
+FASTAIndexFile.h
 FeatureXMLFile.h
 FileHandler.h
 GNPSMGFFile.h
@@ -86,6 +88,8 @@ PercolatorInfile.h
 PercolatorOutfile.h
 ProtXMLFile.h
 QcMLFile.h
+ReadAheadIfstream.h
+ReadAheadInputStream.h
 SequestInfile.h
 SequestOutfile.h
 SpecArrayFile.h
@@ -0,0 +1,227 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <OpenMS/KERNEL/MSChromatogram.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/Peak1D.h>
+#include <OpenMS/METADATA/ExperimentalSettings.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  class MSExperiment;
+
+  /**
+    @brief A memory-compact, read-mostly peak map, which keeps peaks in large blocks and shares identical spectrum meta data.
+
+    An MSExperiment holds every spectrum as an independent object: one peak vector per spectrum and a full copy of
+    SpectrumSettings (InstrumentSettings, SourceFile, ...). For runs with millions of spectra this results in millions of
+    small heap allocations during loading and on destruction, and fragments the heap of long-running processes.
+
+    ArenaMSExperiment is an opt-in alternative for this situation:
+    - peaks of all spectra are appended to a few large blocks (arenas) of @p block_size peaks each; a spectrum never spans two blocks
+    - spectrum meta data which is usually identical between spectra (spectrum type, comment, InstrumentSettings, SourceFile,
+      DataProcessing, peptide identifications) is stored once in a pool and referenced by index
+    - only truly per-spectrum data (RT, MS level, drift time, name, native ID, precursors, products, AcquisitionInfo, meta values,
+      data arrays) is stored for each spectrum
+
+    Spectra are added via addSpectrum() (e.g. by MSDataArenaConsumer while parsing a file using MzMLFile::transform())
+    and cannot be modified afterwards. Peaks can be accessed in place via getPeaks(); getSpectrum() and exportTo() reconstruct
+    regular MSSpectrum/MSExperiment objects.
+
+    Chromatograms are few and kept as regular MSChromatogram objects.
+
+    @ingroup Kernel
+  */
+  class OPENMS_DLLAPI ArenaMSExperiment :
+    public ExperimentalSettings
+  {
+public:
+    /// A range of peaks of one spectrum, stored in an arena block
+    struct PeakRange
+    {
+      const Peak1D* first;
+      const Peak1D* last;
+
+      const Peak1D* begin() const { return first; }
+      const Peak1D* end() const { return last; }
+      Size size() const { return last - first; }
+      bool empty() const { return first == last; }
+      const Peak1D& operator[](Size i) const { return first[i]; }
+    };
+
+    /// Default number of peaks per arena block (16 MB per block)
+    static const Size DEFAULT_BLOCK_SIZE = 1 << 20;
+
+    /// Constructor
+    explicit ArenaMSExperiment(Size block_size = DEFAULT_BLOCK_SIZE);
+    /// Copy constructor
+    ArenaMSExperiment(const ArenaMSExperiment&) = default;
+    /// Move constructor
+    ArenaMSExperiment(ArenaMSExperiment&&) = default;
+    /// Destructor
+    ~ArenaMSExperiment() override;
+
+    /// Assignment operator
+    ArenaMSExperiment& operator=(const ArenaMSExperiment&) = default;
+    /// Move assignment operator
+    ArenaMSExperiment& operator=(ArenaMSExperiment&&) = default;
+    /// Assignment of experimental settings (spectra and chromatograms are kept)
+    ArenaMSExperiment& operator=(const ExperimentalSettings& source);
+
+    /// @name Adding data
+    ///@{
+    /// Reserves space for @p n spectra (not their peaks)
+    void reserveSpaceSpectra(Size n);
+    /// Reserves space for @p n chromatograms
+    void reserveSpaceChromatograms(Size n);
+    /// Appends a copy of @p spectrum. Its peaks are copied into the current arena block and shared meta data is interned.
+    void addSpectrum(const MSSpectrum& spectrum);
+    /**
+      @brief Appends @p spectrum, moving its per-spectrum data (precursors, data arrays, meta values, ...) instead of copying it
+
+      The peaks are copied into the current arena block and the peak storage of @p spectrum is released right away,
+      so a parser handing over its spectra does not keep a second copy of the peaks alive. @p spectrum is left empty.
+    */
+    void addSpectrum(MSSpectrum&& spectrum);
+    /// Appends a copy of @p chromatogram
+    void addChromatogram(const MSChromatogram& chromatogram);
+    /// Removes all spectra, chromatograms and releases all blocks (experimental settings are kept)
+    void clear();
+    ///@}
+
+    /// @name Accessing data
+    ///@{
+    /// Number of spectra
+    Size size() const;
+    /// true if there are no spectra
+    bool empty() const;
+    /// Total number of peaks over all spectra
+    Size getNrPeaks() const;
+    /// Number of allocated arena blocks
+    Size getNrBlocks() const;
+    /// Number of distinct shared spectrum meta data records
+    Size getNrSharedSettings() const;
+
+    /**
+      @brief Peaks of spectrum @p index, in place (no copy)
+
+      @exception Exception::IndexOverflow if @p index is out of range
+    */
+    PeakRange getPeaks(Size index) const;
+    /// Retention time of spectrum @p index
+    double getRT(Size index) const;
+    /// MS level of spectrum @p index
+    UInt getMSLevel(Size index) const;
+    /// Native ID of spectrum @p index
+    const String& getNativeID(Size index) const;
+    /// Precursors of spectrum @p index
+    const std::vector<Precursor>& getPrecursors(Size index) const;
+
+    /**
+      @brief Reconstructs spectrum @p index into @p spectrum (all previous content is replaced)
+
+      Reusing @p spectrum for several calls avoids reallocations of its peak storage.
+
+      @exception Exception::IndexOverflow if @p index is out of range
+    */
+    void getSpectrum(Size index, MSSpectrum& spectrum) const;
+    /// Reconstructs spectrum @p index
+    MSSpectrum getSpectrum(Size index) const;
+
+    /// Chromatograms
+    const std::vector<MSChromatogram>& getChromatograms() const;
+
+    /// Converts all data into a regular MSExperiment (replaces its content)
+    void exportTo(MSExperiment& exp) const;
+    ///@}
+
+protected:
+    /// Per-spectrum data which is not shared
+    struct SpectrumEntry_
+    {
+      Size block = 0; ///< arena block index
+      Size offset = 0; ///< first peak within block
+      Size count = 0; ///< number of peaks
+      Size settings = 0; ///< index into settings_pool_
+      double rt = -1.0;
+      double drift_time = -1.0;
+      DriftTimeUnit drift_time_unit{};
+      UInt ms_level = 1;
+      String name;
+      String native_id;
+      std::vector<Precursor> precursors;
+      std::vector<Product> products;
+      AcquisitionInfo acquisition_info;
+      MetaInfoInterface meta;
+      MSSpectrum::FloatDataArrays float_data_arrays;
+      MSSpectrum::StringDataArrays string_data_arrays;
+      MSSpectrum::IntegerDataArrays integer_data_arrays;
+    };
+
+    /// Shared spectrum meta data
+    struct SharedSettings_
+    {
+      SpectrumSettings settings; ///< only the shared parts are set
+      std::vector<ConstDataProcessingPtr> data_processing; ///< same as in @p settings (kept for comparison without conversion)
+    };
+
+    /// copies the peaks of @p spectrum into the current arena block and sets all shared and non-movable parts of the returned entry
+    SpectrumEntry_ appendPeaks_(const MSSpectrum& spectrum);
+
+    /// returns the pool index for the shared meta data of @p spectrum (adding it if not yet present)
+    Size internSettings_(const SpectrumSettings& spectrum);
+
+    /// returns the entry of spectrum @p index (range checked)
+    const SpectrumEntry_& entry_(Size index) const;
+
+    /// peaks per block
+    Size block_size_;
+    /// arena blocks; capacity of each block is fixed once allocated, so pointers into blocks stay valid
+    std::vector<std::vector<Peak1D>> blocks_;
+    /// per-spectrum data
+    std::vector<SpectrumEntry_> spectra_;
+    /// shared spectrum meta data
+    std::vector<SharedSettings_> settings_pool_;
+    /// chromatograms
+    std::vector<MSChromatogram> chromatograms_;
+    /// total number of peaks
+    Size nr_peaks_ = 0;
+  };
+
+} // namespace OpenMS
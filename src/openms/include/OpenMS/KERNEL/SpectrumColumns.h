@@ -0,0 +1,198 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <OpenMS/KERNEL/MSSpectrum.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Columnar (structure-of-arrays) representation of the peaks of a spectrum.
+
+    MSSpectrum stores its peaks as an array of Peak1D, i.e. m/z and intensity are interleaved (16 bytes per peak).
+    Kernels which only look at one of both, e.g. a binary search on m/z or the sum of all intensities, thus
+    move twice (m/z) or four times (intensity) the memory they need, and cannot be vectorized by the compiler.
+    This class stores m/z and intensity in two separate contiguous arrays instead.
+
+    The per-peak data arrays (float, string and integer) are kept as well and are reordered together with the peaks.
+    Spectrum meta data (RT, MS level, precursors, ...) is not stored. Convert at the boundaries of a processing chain,
+    i.e. construct from an MSSpectrum, run the kernels and write the peaks back using exportTo().
+
+    Filters which process SpectrumColumns directly: Normalizer, NLargest and ThresholdMower.
+
+    @ingroup Kernel
+  */
+  class OPENMS_DLLAPI SpectrumColumns
+  {
+public:
+    typedef MSSpectrum::FloatDataArray FloatDataArray;
+    typedef MSSpectrum::StringDataArray StringDataArray;
+    typedef MSSpectrum::IntegerDataArray IntegerDataArray;
+    typedef MSSpectrum::FloatDataArrays FloatDataArrays;
+    typedef MSSpectrum::StringDataArrays StringDataArrays;
+    typedef MSSpectrum::IntegerDataArrays IntegerDataArrays;
+
+    /// Default constructor
+    SpectrumColumns() = default;
+    /// Converts the peaks and data arrays of @p spectrum
+    explicit SpectrumColumns(const MSSpectrum& spectrum);
+    /// Copy constructor
+    SpectrumColumns(const SpectrumColumns&) = default;
+    /// Move constructor
+    SpectrumColumns(SpectrumColumns&&) = default;
+    /// Assignment operator
+    SpectrumColumns& operator=(const SpectrumColumns&) = default;
+    /// Move assignment operator
+    SpectrumColumns& operator=(SpectrumColumns&&) = default;
+    /// Destructor
+    ~SpectrumColumns() = default;
+
+    /// Equality operator (compares peaks and data arrays)
+    bool operator==(const SpectrumColumns& rhs) const;
+    /// Inequality operator
+    bool operator!=(const SpectrumColumns& rhs) const;
+
+    ///@name Conversion
+    ///@{
+    /// Replaces the content with the peaks and data arrays of @p spectrum
+    void assign(const MSSpectrum& spectrum);
+    /// Replaces the peaks and data arrays of @p spectrum (its meta data is kept)
+    void exportTo(MSSpectrum& spectrum) const;
+    ///@}
+
+    ///@name Peak access
+    ///@{
+    /// Number of peaks
+    Size size() const;
+    /// Are there no peaks?
+    bool empty() const;
+    /// Removes all peaks and data arrays
+    void clear();
+    /// Reserves memory for @p n peaks
+    void reserve(Size n);
+    /// Appends a peak (data arrays are not extended)
+    void push_back(double mz, float intensity);
+    /// m/z of peak @p i
+    double getMZ(Size i) const
+    {
+      return mz_[i];
+    }
+    /// intensity of peak @p i
+    float getIntensity(Size i) const
+    {
+      return intensity_[i];
+    }
+    /// m/z column
+    const std::vector<double>& getMZArray() const;
+    /// mutable m/z column (keep it sorted, and of the same size as the intensity column)
+    std::vector<double>& getMZArray();
+    /// intensity column
+    const std::vector<float>& getIntensityArray() const;
+    /// mutable intensity column (keep it of the same size as the m/z column)
+    std::vector<float>& getIntensityArray();
+
+    /// float data arrays (one value per peak)
+    const FloatDataArrays& getFloatDataArrays() const;
+    /// mutable float data arrays
+    FloatDataArrays& getFloatDataArrays();
+    /// string data arrays (one value per peak)
+    const StringDataArrays& getStringDataArrays() const;
+    /// mutable string data arrays
+    StringDataArrays& getStringDataArrays();
+    /// integer data arrays (one value per peak)
+    const IntegerDataArrays& getIntegerDataArrays() const;
+    /// mutable integer data arrays
+    IntegerDataArrays& getIntegerDataArrays();
+    ///@}
+
+    ///@name Sorting and selection (also reorders the data arrays)
+    ///@{
+    /// Is the m/z column sorted ascendingly?
+    bool isSorted() const;
+    /// Sorts by ascending m/z (stable)
+    void sortByPosition();
+    /// Sorts by ascending intensity, or descending if @p reverse is true (stable)
+    void sortByIntensity(bool reverse = false);
+    /**
+      @brief Keeps only the peaks at @p indices (in the given order)
+
+      @exception Exception::Precondition if a non-empty data array does not have one value per peak
+    */
+    void select(const std::vector<Size>& indices);
+    ///@}
+
+    ///@name Searching (the m/z column must be sorted)
+    ///@{
+    /// Index of the first peak with m/z >= @p mz (size() if there is none)
+    Size MZBegin(double mz) const;
+    /// Index of the first peak with m/z > @p mz (size() if there is none)
+    Size MZEnd(double mz) const;
+    /**
+      @brief Index of the peak nearest to @p mz (see MSSpectrum::findNearest())
+
+      @exception Exception::Precondition if the spectrum is empty
+    */
+    Size findNearest(double mz) const;
+    /// Index of the peak nearest to @p mz within +/- @p tolerance, or -1 if there is none
+    Int findNearest(double mz, double tolerance) const;
+    /// Index of the peak nearest to @p mz within [mz - @p tolerance_left, mz + @p tolerance_right], or -1 if there is none
+    Int findNearest(double mz, double tolerance_left, double tolerance_right) const;
+    ///@}
+
+    ///@name Intensity statistics
+    ///@{
+    /// Sum of all intensities
+    double calculateTIC() const;
+    /// Highest intensity (0 for an empty spectrum)
+    float getMaxIntensity() const;
+    ///@}
+
+protected:
+    /// m/z of the peaks
+    std::vector<double> mz_;
+    /// intensities of the peaks
+    std::vector<float> intensity_;
+    /// float data arrays
+    FloatDataArrays float_data_arrays_;
+    /// string data arrays
+    StringDataArrays string_data_arrays_;
+    /// integer data arrays
+    IntegerDataArrays integer_data_arrays_;
+  };
+
+} // namespace OpenMS
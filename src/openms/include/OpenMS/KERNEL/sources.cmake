@@ -31,6 +31,8 @@ RichPeak2D.h
 StandardTypes.h
 StandardDeclarations.h
 SpectrumHelper.h
+SpectrumColumns.h
+ArenaMSExperiment.h
 )
 
 ### add path to the filenames
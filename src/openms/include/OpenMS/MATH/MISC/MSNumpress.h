@@ -166,6 +166,16 @@ namespace MSNumpress {
 		const unsigned char *data,
 		const size_t dataSize,
 		double *result);
+
+	/**
+	 * Decodes data encoded by encodeLinear directly into floats (no intermediate doubles).
+	 *
+	 * Same as decodeLinear above; only the final values are rounded to float.
+	 */
+	size_t decodeLinear(
+		const unsigned char *data,
+		const size_t dataSize,
+		float *result);
 	
 	/**
 	 * Calls lower level decodeLinear while handling vector sizes appropriately
@@ -267,6 +277,14 @@ namespace MSNumpress {
 		const unsigned char *data,
 		const size_t dataSize,
 		double *result);
+
+	/**
+	 * Decodes data encoded by encodePic directly into floats (no intermediate doubles).
+	 */
+	size_t decodePic(
+		const unsigned char *data,
+		const size_t dataSize,
+		float *result);
 	
 	/**
 	 * Calls lower level decodePic while handling vector sizes appropriately
@@ -335,6 +353,18 @@ namespace MSNumpress {
 		const unsigned char *data, 
 		const size_t dataSize, 
 		double *result);
+
+	/**
+	 * Decodes data encoded by encodeSlof directly into floats, e.g. intensity buffers.
+	 *
+	 * For larger arrays, exp() is evaluated via two 256-entry tables of the
+	 * fixed point (high and low byte of each value) instead of once per value.
+	 * Results agree with decodeSlof() above within float precision.
+	 */
+	size_t decodeSlof(
+		const unsigned char *data, 
+		const size_t dataSize, 
+		float *result);
 	
 	/**
 	 * Calls lower level decodeSlof while handling vector sizes appropriately
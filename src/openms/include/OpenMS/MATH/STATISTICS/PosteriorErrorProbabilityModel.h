@@ -147,6 +147,7 @@ public:
 
       /**
           @brief fits the distributions to the data points(search_engine_scores) and writes the computed probabilities into the given vector (the second one).
+          If the parameter 'max_fit_scores' is set, the model is fitted on a quantile subsample of the scores, but probabilities are computed for all of them.
           @param search_engine_scores a vector which holds the data points
           @param probabilities a vector which holds the probability for each data point after running this function. If it has some content it will be overwritten.
           @return true if algorithm has run through. Else false will be returned. In that case no plot and no probabilities are calculated.
@@ -0,0 +1,239 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/config.h>
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Records named, nested regions of a program run (wall time, CPU time, peak memory, item counts).
+
+    The Tracer is a process-wide singleton which is disabled by default. While disabled, a Tracer::Scope
+    costs a single (relaxed) atomic load, so instrumentation can stay in hot code paths.
+    Once enabled (e.g. via the '-profile' option of every TOPP tool), each Scope records its region when it ends.
+
+    Regions are hierarchical per thread: a Scope opened while another Scope is active on the same thread becomes
+    its child. Regions opened on OpenMP worker threads start a new hierarchy for that thread.
+
+    The peak memory of the process is only sampled for top-level regions (opened while no other region is
+    open on any thread) and for regions which request it via Scope::samplePeakMemory(), since reading it is
+    expensive on some platforms.
+
+    At most getMaxRecords() individual records are kept (e.g. for the Chrome trace); further regions are only
+    added to the summary, so getSummary(), storeFoldedStacks() and toString() always cover the whole run.
+
+    Use the OPENMS_TRACE_SCOPE macro to instrument a block:
+    @code
+      {
+        OPENMS_TRACE_SCOPE("FeatureFinding");
+        ...
+      }
+    @endcode
+
+    Collected records can be exported in Chrome trace event format (chrome://tracing, https://ui.perfetto.dev)
+    or as 'folded stacks' which can be rendered by flame graph tools (e.g. flamegraph.pl, speedscope).
+
+    @ingroup System
+  */
+  class OPENMS_DLLAPI Tracer
+  {
+public:
+    /// A single finished region
+    struct OPENMS_DLLAPI Record
+    {
+      String name; ///< name of the region
+      String path; ///< names of all enclosing regions on the same thread and this region, separated by ';'
+      Size thread = 0; ///< logical thread number (in order of first appearance)
+      Size depth = 0; ///< nesting depth (0 = top level)
+      double start = 0.0; ///< start time in seconds (relative to the time the Tracer was enabled)
+      double wall_time = 0.0; ///< wall time in seconds
+      double cpu_time = 0.0; ///< CPU time in seconds (of the recording thread only)
+      Size peak_memory = 0; ///< peak memory (KB) of the process at the end of the region (0 if not sampled)
+      Size items = 0; ///< number of items processed (see Scope::addItems())
+    };
+
+    /**
+      @brief RAII object which records a region from construction until destruction
+
+      If the Tracer is disabled at construction, the Scope remains inactive (even if the Tracer is enabled afterwards).
+    */
+    class OPENMS_DLLAPI Scope
+    {
+public:
+      /// Opens a region named @p name
+      explicit Scope(const char* name)
+      {
+        if (Tracer::isEnabled()) begin_(name);
+      }
+
+      /// Opens a region named @p name
+      explicit Scope(const String& name)
+      {
+        if (Tracer::isEnabled()) begin_(name.c_str());
+      }
+
+      /// Closes the region and records it
+      ~Scope()
+      {
+        if (active_) end_();
+      }
+
+      Scope() = delete;
+      Scope(const Scope&) = delete;
+      Scope& operator=(const Scope&) = delete;
+
+      /// Add @p n to the number of items processed in this region (e.g. spectra, features, PSMs)
+      void addItems(Size n)
+      {
+        items_ += n;
+      }
+
+      /// Sample the peak memory of the process when this region ends (done automatically for top-level regions)
+      void samplePeakMemory()
+      {
+        sample_memory_ = true;
+      }
+
+private:
+      void begin_(const char* name);
+      void end_();
+
+      bool active_ = false;
+      bool sample_memory_ = false;
+      Size items_ = 0;
+      Size path_length_ = 0; ///< length of the thread's path before this region was opened
+      double start_ = 0.0;
+      double cpu_start_ = 0.0;
+    };
+
+    /// Access to the process-wide instance
+    static Tracer& getInstance();
+
+    /// Is recording enabled? Cheap enough to be called in inner loops.
+    static bool isEnabled()
+    {
+      return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /// Enable or disable recording. Enabling resets the time origin; previous records are kept.
+    void setEnabled(bool enabled);
+
+    /// Remove all records (and the summary)
+    void clear();
+
+    /// Set the maximal number of individual records which are kept (default: 100000); further regions only enter the summary
+    void setMaxRecords(Size max_records);
+
+    /// Maximal number of individual records which are kept
+    Size getMaxRecords() const;
+
+    /// Number of regions which were only added to the summary because getMaxRecords() was reached
+    Size getNrDroppedRecords() const;
+
+    /// Get a copy of all records collected so far (in order of completion, at most getMaxRecords())
+    std::vector<Record> getRecords() const;
+
+    /**
+      @brief Aggregate records by their path
+
+      @return One record per distinct path, with summed times and items (start is the earliest start; peak_memory the maximum).
+      Sorted by path, such that child regions directly follow their parent. Includes regions beyond getMaxRecords().
+    */
+    std::vector<Record> getSummary() const;
+
+    /// Write all kept records (see getMaxRecords()) as Chrome trace events (JSON), viewable in chrome://tracing or Perfetto
+    /// @throws Exception::UnableToCreateFile if @p filename cannot be written
+    void storeChromeTrace(const String& filename) const;
+
+    /// Write folded stacks ('a;b;c <self time in microseconds>') as input for flame graph tools
+    /// @throws Exception::UnableToCreateFile if @p filename cannot be written
+    void storeFoldedStacks(const String& filename) const;
+
+    /**
+      @brief Write the profile to @p filename, choosing the format from its extension
+
+      Files ending in '.json' are written as Chrome trace, all others as folded stacks.
+    */
+    void store(const String& filename) const;
+
+    /// Summary table (one line per path, indented by depth) for logging
+    String toString() const;
+
+private:
+    Tracer() = default;
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    /// seconds since the time origin
+    double now_() const;
+
+    /// add a finished region (thread-safe)
+    void add_(Record&& r);
+
+    static std::atomic<bool> enabled_;
+
+    /// number of currently open regions (on all threads)
+    std::atomic<Size> open_regions_{0};
+    /// time origin (ticks of std::chrono::steady_clock); atomic, since it is read by all threads without locking
+    std::atomic<std::chrono::steady_clock::rep> origin_{std::chrono::steady_clock::now().time_since_epoch().count()};
+    mutable std::mutex mutex_;
+    std::vector<Record> records_;
+    /// all regions aggregated by path
+    std::map<String, Record> summary_;
+    Size max_records_ = 100000;
+    Size dropped_records_ = 0;
+  };
+
+} // namespace OpenMS
+
+/// helper for OPENMS_TRACE_SCOPE
+#define OPENMS_TRACE_CONCAT_IMPL_(a, b) a##b
+#define OPENMS_TRACE_CONCAT_(a, b) OPENMS_TRACE_CONCAT_IMPL_(a, b)
+
+/**
+  @brief Records the enclosing block as a region of the OpenMS::Tracer (no-op unless the Tracer is enabled)
+
+  @param name A region name (const char* or OpenMS::String)
+*/
+#define OPENMS_TRACE_SCOPE(name) OpenMS::Tracer::Scope OPENMS_TRACE_CONCAT_(openms_trace_scope_, __LINE__)(name)
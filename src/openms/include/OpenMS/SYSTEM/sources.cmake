@@ -29,6 +29,7 @@ PythonInfo.h
 RWrapper.h
 StopWatch.h
 SysInfo.h
+Tracer.h
 UpdateCheck.h
 )
 
@@ -45,6 +45,42 @@
 
 using namespace std;
 
+namespace
+{
+  /// sorts the indices in @p order by ascending score (ties by index): blocks are sorted in parallel and then merged pairwise
+  void sortByScore(const std::vector<double>& scores, std::vector<OpenMS::Size>& order)
+  {
+    auto less = [&scores](OpenMS::Size a, OpenMS::Size b)
+    {
+      return scores[a] < scores[b] || (!(scores[b] < scores[a]) && a < b);
+    };
+    const OpenMS::SignedSize n = order.size();
+    const OpenMS::SignedSize block_size = 1 << 16;
+    const OpenMS::SignedSize n_blocks = (n + block_size - 1) / block_size;
+#ifdef _OPENMP
+#pragma omp parallel for if(n_blocks > 1)
+#endif
+    for (OpenMS::SignedSize b = 0; b < n_blocks; ++b)
+    {
+      std::sort(order.begin() + b * block_size, order.begin() + std::min(n, (b + 1) * block_size), less);
+    }
+    for (OpenMS::SignedSize width = block_size; width < n; width *= 2)
+    {
+      const OpenMS::SignedSize n_merges = (n + 2 * width - 1) / (2 * width);
+#ifdef _OPENMP
+#pragma omp parallel for if(n_merges > 1)
+#endif
+      for (OpenMS::SignedSize m = 0; m < n_merges; ++m)
+      {
+        const OpenMS::SignedSize first = m * 2 * width;
+        const OpenMS::SignedSize middle = std::min(n, first + width);
+        const OpenMS::SignedSize last = std::min(n, first + 2 * width);
+        std::inplace_merge(order.begin() + first, order.begin() + middle, order.begin() + last, less);
+      }
+    }
+  }
+}
+
 namespace OpenMS
 {
   FalseDiscoveryRate::FalseDiscoveryRate() :
@@ -142,8 +178,10 @@ namespace OpenMS
 #ifdef FALSE_DISCOVERY_RATE_DEBUG
         cerr << "Id-run: " << *iit << endl;
 #endif
-        // get the scores of all peptide hits
-        vector<double> target_scores, decoy_scores;
+        // get the scores of all peptide hits (in the order they are annotated below)
+        vector<double> scores;
+        vector<TargetDecoyLabel> labels;
+        Size n_targets(0), n_decoys(0);
         for (auto it = ids.begin(); it != ids.end(); ++it)
         {
           // if runs should be treated separately, the identifiers must be the same
@@ -168,13 +206,15 @@ namespace OpenMS
             String target_decoy(it->getHits()[i].getMetaValue("target_decoy"));
             if (target_decoy == "target" || target_decoy == "target+decoy")
             {
-              target_scores.push_back(it->getHits()[i].getScore());
+              labels.push_back(TargetDecoyLabel::TARGET);
+              ++n_targets;
             }
             else
             {
               if (target_decoy == "decoy")
               {
-                decoy_scores.push_back(it->getHits()[i].getScore());
+                labels.push_back(TargetDecoyLabel::DECOY);
+                ++n_decoys;
               }
               else
               {
@@ -182,17 +222,19 @@ namespace OpenMS
                 {
                   throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown value of meta value 'target_decoy'", target_decoy);
                 }
+                labels.push_back(TargetDecoyLabel::NONE);
               }
             }
+            scores.push_back(it->getHits()[i].getScore());
           }
         }
 
 #ifdef FALSE_DISCOVERY_RATE_DEBUG
-        cerr << "#target-scores=" << target_scores.size() << ", #decoy-scores=" << decoy_scores.size() << endl;
+        cerr << "#target-scores=" << n_targets << ", #decoy-scores=" << n_decoys << endl;
 #endif
 
         // check decoy scores
-        if (decoy_scores.empty())
+        if (n_decoys == 0)
         {
           String error_string = "FalseDiscoveryRate: #decoy sequences is zero! Setting all target sequences to q-value/FDR 0! ";
           if (split_charge_variants || treat_runs_separately)
@@ -212,7 +254,7 @@ namespace OpenMS
         }
 
         // check target scores
-        if (target_scores.empty())
+        if (n_targets == 0)
         {
           String error_string = "FalseDiscoveryRate: #target sequences is zero! Ignoring. ";
           if (split_charge_variants || treat_runs_separately)
@@ -231,7 +273,7 @@ namespace OpenMS
           OPENMS_LOG_ERROR << error_string << std::endl;
         }
 
-        if (target_scores.empty() || decoy_scores.empty())
+        if (n_targets == 0 || n_decoys == 0)
         {
           // now remove the relevant entries, or put 'pseudo-scores' in
           for (auto it = ids.begin(); it != ids.end(); ++it)
@@ -280,10 +322,11 @@ namespace OpenMS
         }
 
         // calculate fdr for the forward scores
-        map<double, double> score_to_fdr;
-        calculateFDRs_(score_to_fdr, target_scores, decoy_scores, q_value, higher_score_better);
+        vector<double> fdrs;
+        calculateFDRsColumnar_(scores, labels, fdrs, q_value, higher_score_better);
 
         // annotate fdr
+        Size column = 0; // position of the next hit in 'fdrs'
         for (auto it = ids.begin(); it != ids.end(); ++it)
         {
           // if runs should be treated separately, the identifiers must be the same
@@ -303,6 +346,7 @@ namespace OpenMS
               hits.push_back(*pit);
               continue;
             }
+            const double fdr = fdrs[column++];
             if (hit.metaValueExists("target_decoy"))
             {
               String meta_value = (String)hit.getMetaValue("target_decoy");
@@ -312,7 +356,7 @@ namespace OpenMS
               }
             }
             hit.setMetaValue(score_type, pit->getScore());
-            hit.setScore(score_to_fdr[pit->getScore()]);
+            hit.setScore(fdr);
             hits.push_back(hit);
           }
           it->getHits().swap(hits);
@@ -567,16 +611,17 @@ namespace OpenMS
   {
     bool use_all_hits = param_.getValue("use_all_hits").toBool();
     bool include_decoys = param_.getValue("add_decoy_peptides").toBool();
-    vector<double> target_scores, decoy_scores;
+    vector<double> scores;
+    vector<TargetDecoyLabel> labels;
+    vector<IdentificationData::ObservationMatchRef> matches;
     map<IdentificationData::IdentifiedMolecule, bool> molecule_to_decoy;
-    map<IdentificationData::ObservationMatchRef, double> match_to_score;
     if (use_all_hits)
     {
       for (auto it = id_data.getObservationMatches().begin();
            it != id_data.getObservationMatches().end(); ++it)
       {
-        handleObservationMatch_(it, score_ref, target_scores, decoy_scores,
-                          molecule_to_decoy, match_to_score);
+        handleObservationMatch_(it, score_ref, scores, labels, matches,
+                                molecule_to_decoy);
       }
     }
     else
@@ -585,16 +630,15 @@ namespace OpenMS
           id_data.getBestMatchPerObservation(score_ref);
       for (auto match_ref : best_matches)
       {
-        handleObservationMatch_(match_ref, score_ref, target_scores, decoy_scores,
-                          molecule_to_decoy, match_to_score);
+        handleObservationMatch_(match_ref, score_ref, scores, labels, matches,
+                                molecule_to_decoy);
       }
     }
 
-    map<double, double> score_to_fdr;
+    vector<double> fdrs;
     bool higher_better = score_ref->higher_better;
     bool use_qvalue = !param_.getValue("no_qvalues").toBool();
-    calculateFDRs_(score_to_fdr, target_scores, decoy_scores, use_qvalue,
-                   higher_better);
+    calculateFDRsColumnar_(scores, labels, fdrs, use_qvalue, higher_better);
 
     IdentificationData::ScoreType fdr_score;
     fdr_score.higher_better = false;
@@ -608,19 +652,10 @@ namespace OpenMS
     }
     IdentificationData::ScoreTypeRef fdr_ref =
         id_data.registerScoreType(fdr_score);
-    for (IdentificationData::ObservationMatches::iterator it =
-           id_data.getObservationMatches().begin(); it !=
-           id_data.getObservationMatches().end(); ++it)
+    for (Size i = 0; i < matches.size(); ++i)
     {
-      if (!include_decoys)
-      {
-        auto pos = molecule_to_decoy.find(it->identified_molecule_var);
-        if ((pos != molecule_to_decoy.end()) && pos->second) continue;
-      }
-      auto pos = match_to_score.find(it);
-      if (pos == match_to_score.end()) continue;
-      double fdr = score_to_fdr.at(pos->second);
-      id_data.addScore(it, fdr_ref, fdr);
+      if (!include_decoys && (labels[i] == TargetDecoyLabel::DECOY)) continue;
+      id_data.addScore(matches[i], fdr_ref, fdrs[i]);
     }
     return fdr_ref;
   }
@@ -629,9 +664,9 @@ namespace OpenMS
   void FalseDiscoveryRate::handleObservationMatch_(
     IdentificationData::ObservationMatchRef match_ref,
     IdentificationData::ScoreTypeRef score_ref,
-    vector<double>& target_scores, vector<double>& decoy_scores,
-    map<IdentificationData::IdentifiedMolecule, bool>& molecule_to_decoy,
-    map<IdentificationData::ObservationMatchRef, double>& match_to_score) const
+    vector<double>& scores, vector<TargetDecoyLabel>& labels,
+    vector<IdentificationData::ObservationMatchRef>& matches,
+    map<IdentificationData::IdentifiedMolecule, bool>& molecule_to_decoy) const
   {
     const IdentificationData::IdentifiedMolecule& molecule_var =
       match_ref->identified_molecule_var;
@@ -643,7 +678,6 @@ namespace OpenMS
     }
     pair<double, bool> score = match_ref->getScore(score_ref);
     if (!score.second) return; // no score of this type
-    match_to_score[match_ref] = score.first;
     auto pos = molecule_to_decoy.find(molecule_var);
     bool is_decoy;
     if (pos == molecule_to_decoy.end()) // new molecule
@@ -662,14 +696,9 @@ namespace OpenMS
     {
       is_decoy = pos->second;
     }
-    if (is_decoy)
-    {
-      decoy_scores.push_back(score.first);
-    }
-    else
-    {
-      target_scores.push_back(score.first);
-    }
+    scores.push_back(score.first);
+    labels.push_back(is_decoy ? TargetDecoyLabel::DECOY : TargetDecoyLabel::TARGET);
+    matches.push_back(match_ref);
   }
 
 
@@ -824,6 +853,166 @@ namespace OpenMS
     }
   }
 
+  void FalseDiscoveryRate::calculateFDRsColumnar_(const vector<double>& scores, const vector<TargetDecoyLabel>& labels, vector<double>& fdrs, bool q_value, bool higher_score_better) const
+  {
+    const Size n = scores.size();
+    fdrs.assign(n, 0.0);
+    if (n == 0)
+    {
+      return;
+    }
+
+    // one sort of all entries (ascending score, ties by position)
+    vector<Size> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    sortByScore(scores, order);
+
+    // unique scores play the role of the keys of the map in calculateFDRs_
+    vector<Size> key_of(n);
+    Size n_keys = 0;
+    vector<double> target_scores, decoy_scores;
+    vector<Size> target_keys, decoy_keys;
+    for (Size r = 0; r < n; ++r)
+    {
+      const Size i = order[r];
+      if (r == 0 || scores[order[r - 1]] < scores[i])
+      {
+        ++n_keys;
+      }
+      key_of[i] = n_keys - 1;
+      if (labels[i] == TargetDecoyLabel::TARGET)
+      {
+        target_scores.push_back(scores[i]);
+        target_keys.push_back(n_keys - 1);
+      }
+      else if (labels[i] == TargetDecoyLabel::DECOY)
+      {
+        decoy_scores.push_back(scores[i]);
+        decoy_keys.push_back(n_keys - 1);
+      }
+    }
+
+    // same orientations as in calculateFDRs_
+    if (higher_score_better != q_value)
+    {
+      std::reverse(target_scores.begin(), target_scores.end());
+      std::reverse(target_keys.begin(), target_keys.end());
+    }
+    if (higher_score_better)
+    {
+      std::reverse(decoy_scores.begin(), decoy_scores.end());
+      std::reverse(decoy_keys.begin(), decoy_keys.end());
+    }
+
+    vector<double> key_fdr(n_keys, 0.0);
+    const Size number_of_target_scores = target_scores.size();
+    Size j = 0;
+
+    if (q_value)
+    {
+      double minimal_fdr = 1.;
+      for (Size i = 0; i != target_scores.size(); ++i)
+      {
+        if (decoy_scores.empty())
+        {
+          // set FDR to 0 (done below automatically)
+        }
+        else if (i == 0 && j == 0)
+        {
+          while (j != decoy_scores.size()
+                && ((target_scores[i] <= decoy_scores[j] && higher_score_better) ||
+                    (target_scores[i] >= decoy_scores[j] && !higher_score_better)))
+          {
+            ++j;
+          }
+        }
+        else
+        {
+          if (j == decoy_scores.size())
+          {
+            j--;
+          }
+          while (j != 0
+                && ((target_scores[i] > decoy_scores[j] && higher_score_better) ||
+                    (target_scores[i] < decoy_scores[j] && !higher_score_better)))
+          {
+            --j;
+          }
+          // Since j has to be equal to the number of fps above the threshold we add one
+          if ((target_scores[i] <= decoy_scores[j] && higher_score_better)
+             || (target_scores[i] >= decoy_scores[j] && !higher_score_better))
+          {
+            ++j;
+          }
+        }
+
+        if (minimal_fdr >= (double)j / (number_of_target_scores - i))
+        {
+          minimal_fdr = (double)j / (number_of_target_scores - i);
+        }
+        key_fdr[target_keys[i]] = minimal_fdr;
+      }
+    }
+    else
+    {
+      for (Size i = 0; i != target_scores.size(); ++i)
+      {
+        while (j != decoy_scores.size() &&
+               ((target_scores[i] <= decoy_scores[j] && higher_score_better) ||
+                (target_scores[i] >= decoy_scores[j] && !higher_score_better)))
+        {
+          ++j;
+        }
+        key_fdr[target_keys[i]] = (double)j / (double)(i + 1);
+      }
+    }
+
+    // assign q-value of decoy_score to closest target_score
+    for (Size i = 0; i != decoy_scores.size(); ++i)
+    {
+      const double ds = decoy_scores[i];
+      auto not_better = [ds, higher_score_better](double ts) { return higher_score_better ? ts <= ds : ts >= ds; };
+
+      // number of leading targets that are not better than the decoy (the linear scan of calculateFDRs_)
+      Size k = 0;
+      if (!target_scores.empty() && not_better(target_scores[0]))
+      {
+        if (q_value)
+        { // worst targets first: the leading targets form a partition
+          k = std::partition_point(target_scores.begin(), target_scores.end(), not_better) - target_scores.begin();
+        }
+        else
+        { // best targets first: if the best one is not better, none is
+          k = target_scores.size();
+        }
+      }
+
+      // corner cases
+      if (k == 0)
+      {
+        key_fdr[decoy_keys[i]] = target_scores.empty() ? 1.0 : key_fdr[target_keys[0]];
+      }
+      else if (k == target_scores.size())
+      {
+        key_fdr[decoy_keys[i]] = key_fdr[target_keys.back()];
+      }
+      else if (fabs(target_scores[k] - ds) < fabs(target_scores[k - 1] - ds))
+      {
+        key_fdr[decoy_keys[i]] = key_fdr[target_keys[k]];
+      }
+      else
+      {
+        key_fdr[decoy_keys[i]] = key_fdr[target_keys[k - 1]];
+      }
+    }
+
+    // scatter back to the entries
+    for (Size i = 0; i < n; ++i)
+    {
+      fdrs[i] = key_fdr[key_of[i]];
+    }
+  }
+
   //TODO does not support "by run" and/or "by charge"
   //TODO could be done for a percentage of FalsePos instead of a number
   //TODO can be templated for proteins
@@ -269,4 +269,33 @@ namespace OpenMS
     }
     outstr.close();
   }
+
+  void IonIdentityMolecularNetworking::writeSpectralNetworkTable(const std::vector<MSSpectrum>& spectra, const std::vector<PairwiseSpectralSimilarity::Edge>& edges, const String& output_file)
+  {
+    // initialize SVOutStream with comma separation
+    std::ofstream outstr(output_file.c_str());
+    SVOutStream out(outstr, ",", "_", String::NONE);
+
+    // write table header
+    out << "ID1" << "ID2" << "EdgeType" << "Score" << "Annotation" << std::endl;
+
+    // write one row per similar spectrum pair (row IDs are 1-based spectrum indices)
+    for (const auto& edge : edges)
+    {
+      double delta_mz = 0.0;
+      if (!spectra[edge.first].getPrecursors().empty() && !spectra[edge.second].getPrecursors().empty())
+      {
+        delta_mz = std::abs(spectra[edge.first].getPrecursors()[0].getMZ() - spectra[edge.second].getPrecursors()[0].getMZ());
+      }
+      out << edge.first + 1;
+      out << edge.second + 1;
+      out << "MS2 cosine";
+      out << edge.score;
+      std::stringstream annotation;
+      annotation << "matched_peaks=" << edge.matched_peaks << " dm/z=" << String(delta_mz);
+      out << annotation.str();
+      out << std::endl;
+    }
+    outstr.close();
+  }
 } // closing namespace OpenMS
\ No newline at end of file
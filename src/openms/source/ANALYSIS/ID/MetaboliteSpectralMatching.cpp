@@ -362,8 +362,10 @@ namespace OpenMS
 
     // for every DB (theoretical) peak in the valid m/z range, find the closest
     // matching experimental (observed) peak within the allowed tolerance;
-    // in principle, multiple DB peaks can match to the same exp. peak:
-    map<Size, vector<MSSpectrum::ConstIterator>> peak_matches;
+    // in principle, multiple DB peaks can match to the same exp. peak;
+    // as both spectra are sorted by m/z, the nearest exp. peak index never
+    // decreases, so all matches of one exp. peak are stored contiguously:
+    vector<pair<Size, MSSpectrum::ConstIterator>> peak_matches;
     for (auto db_it = db_spectrum.MZBegin(mz_lower_bound);
          db_it != db_spectrum.MZEnd(mz_upper_bound); ++db_it)
     {
@@ -375,18 +377,20 @@ namespace OpenMS
       }
 
       Int index = exp_spectrum.findNearest(db_mz, mz_offset);
-      if (index >= 0) peak_matches[index].push_back(db_it);
+      if (index >= 0) peak_matches.emplace_back(index, db_it);
     }
 
     double dot_product = 0.0;
-    for (const auto& match : peak_matches)
+    Size matched_ions_count = 0; // count obs. peaks only once
+    for (Size i = 0; i < peak_matches.size(); ++matched_ions_count)
     {
+      const Size exp_index = peak_matches[i].first;
       double db_intensity = 0.0;
-      for (const auto& db_it : match.second)
+      for (; i < peak_matches.size() && peak_matches[i].first == exp_index; ++i)
       {
-        db_intensity = max(db_intensity, double(db_it->getIntensity()));
+        db_intensity = max(db_intensity, double(peak_matches[i].second->getIntensity()));
       }
-      dot_product += db_intensity * exp_spectrum[match.first].getIntensity();
+      dot_product += db_intensity * exp_spectrum[exp_index].getIntensity();
     }
 
     // return annotations for matching peaks?
@@ -394,25 +398,21 @@ namespace OpenMS
         !db_spectrum.getStringDataArrays().empty() &&
         !db_spectrum.getIntegerDataArrays().empty())
     {
+      // potentially add several annotations for the same peak if there are
+      // multiple matches for that peak:
       for (const auto& match : peak_matches)
       {
         const auto& exp_peak = exp_spectrum[match.first];
-        // potentially add several annotations for the same peak if there are
-        // multiple matches for that peak:
-        for (const auto& db_it : match.second)
-        {
-          PeptideHit::PeakAnnotation ann;
-          Size index = db_it - db_spectrum.begin();
-          ann.annotation = db_spectrum.getStringDataArrays()[0].at(index);
-          ann.charge = db_spectrum.getIntegerDataArrays()[0].at(index);
-          ann.mz = exp_peak.getMZ();
-          ann.intensity = exp_peak.getIntensity();
-          annotations->push_back(ann);
-        }
+        PeptideHit::PeakAnnotation ann;
+        Size index = match.second - db_spectrum.begin();
+        ann.annotation = db_spectrum.getStringDataArrays()[0].at(index);
+        ann.charge = db_spectrum.getIntegerDataArrays()[0].at(index);
+        ann.mz = exp_peak.getMZ();
+        ann.intensity = exp_peak.getIntensity();
+        annotations->push_back(ann);
       }
     }
 
-    Size matched_ions_count = peak_matches.size(); // count obs. peaks only once
     double matched_ions_term = 0.0;
 
     // return score 0 if too few matched ions
@@ -472,8 +472,13 @@ namespace OpenMS
     bool fragment_error_unit_ppm(true);
     if (mz_error_unit_ == "Da") { fragment_error_unit_ppm = false; }
 
-    for (Size spec_idx = 0; spec_idx < msexp.size(); ++spec_idx)
+    // spectra are matched in parallel; results are concatenated in spectrum order afterwards
+    vector<vector<SpectralMatch>> spectrum_results(msexp.size());
+
+#pragma omp parallel for schedule(dynamic)
+    for (SignedSize spec_idx = 0; spec_idx < (SignedSize)msexp.size(); ++spec_idx)
     {
+      vector<SpectralMatch>& spectrum_matches = spectrum_results[spec_idx];
       // cout << "merged spectrum no. " << spec_idx << " with #fragment ions: " << msexp[spec_idx].size() << endl;
 
       // iterate over all precursor masses
@@ -565,7 +570,7 @@ namespace OpenMS
           for (Size result_idx = 0; result_idx < last_result_idx; ++result_idx)
           {
             // cout << "score: " << partial_results[result_idx].getMatchingScore() << " " << partial_results[result_idx].getMatchingSpectrumIndex() << endl;
-            matching_results.push_back(partial_results[result_idx]);
+            spectrum_matches.push_back(partial_results[result_idx]);
           }
         }
 
@@ -573,13 +578,18 @@ namespace OpenMS
         {
           if (!partial_results.empty())
           {
-            matching_results.push_back(partial_results[0]);
+            spectrum_matches.push_back(partial_results[0]);
           }
         }
 
       } // end precursor loop
     } // end spectra loop
 
+    for (auto& matches : spectrum_results)
+    {
+      matching_results.insert(matching_results.end(), matches.begin(), matches.end());
+    }
+
     // write final results to MzTab
     exportMzTab_(matching_results, mztab_out);
   }
@@ -35,15 +35,18 @@
 #include <OpenMS/ANALYSIS/ID/PeptideIndexing.h>
 
 #include <OpenMS/ANALYSIS/ID/AhoCorasickAmbiguous.h>
+#include <OpenMS/ANALYSIS/ID/ProteinSuffixArray.h>
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
 #include <OpenMS/CHEMISTRY/ProteaseDigestion.h>
 #include <OpenMS/CONCEPT/EnumHelpers.h>
+#include <OpenMS/SYSTEM/File.h>
 #include <OpenMS/SYSTEM/StopWatch.h>
 #include <OpenMS/SYSTEM/SysInfo.h>
 
 #include <atomic>
 #include <map>
 #include <array>
+#include <unordered_map>
 
 
 #ifdef _OPENMP 
@@ -249,6 +252,13 @@ using namespace std;
     defaults_.setValue("allow_nterm_protein_cleavage", "true", "Allow the protein N-terminus amino acid to clip.");
     defaults_.setValidStrings("allow_nterm_protein_cleavage", { "true", "false" });
 
+    defaults_.setValue("backend", "aho_corasick", "Search algorithm. 'aho_corasick' builds a trie over the peptides and streams the database through it (fast for moderate numbers of peptides). "
+                                                  "'suffix_array' indexes the database once and looks up all peptides in parallel (scales to millions of distinct peptides; the index can be stored, see 'suffix_array_file'). "
+                                                  "Both yield identical results.");
+    defaults_.setValidStrings("backend", { "aho_corasick", "suffix_array" });
+
+    defaults_.setValue("suffix_array_file", "", "Only for 'backend' = 'suffix_array': file to store the suffix array of the database in. If the file exists and was built from the same database (and 'IL_equivalent' setting), it is loaded instead of sorting the database anew; otherwise it is (re)written.");
+
     defaultsToParam_();
   }
 
@@ -271,6 +281,8 @@ using namespace std;
     aaa_max_ = static_cast<Int>(param_.getValue("aaa_max"));
     mm_max_ = static_cast<Int>(param_.getValue("mismatches_max"));
     allow_nterm_protein_cleavage_ = param_.getValue("allow_nterm_protein_cleavage").toBool();
+    use_suffix_array_ = (param_.getValue("backend") == "suffix_array");
+    suffix_array_file_ = param_.getValue("suffix_array_file").toString();
   }
 
 PeptideIndexing::ExitCodes PeptideIndexing::run(std::vector<FASTAFile::FASTAEntry>& proteins, std::vector<ProteinIdentification>& prot_ids, std::vector<PeptideIdentification>& pep_ids)
@@ -289,6 +301,11 @@ PeptideIndexing::ExitCodes PeptideIndexing::run(FASTAContainer<TFI_Vector>& prot
   return run_<TFI_Vector>(proteins, prot_ids, pep_ids);
 }
 
+PeptideIndexing::ExitCodes PeptideIndexing::run(FASTAContainer<TFI_MMap>& proteins, std::vector<ProteinIdentification>& prot_ids, std::vector<PeptideIdentification>& pep_ids)
+{
+  return run_<TFI_MMap>(proteins, prot_ids, pep_ids);
+}
+
 const String& PeptideIndexing::getDecoyString() const
 {
   return decoy_string_;
@@ -424,7 +441,9 @@ PeptideIndexing::ExitCodes PeptideIndexing::run_(FASTAContainer<T>& proteins, st
   std::vector<std::string> protein_accessions; // protein index -> accession
 
   bool invalid_protein_sequence = false; // check for proteins with modifications, i.e. '[' or '(', and throw an exception
+  uint16_t count_j_proteins(0);
 
+  if (!use_suffix_array_)
   { // new scope - forget data after search
     /*
         Aho Corasick (fast)
@@ -470,7 +489,6 @@ PeptideIndexing::ExitCodes PeptideIndexing::run_(FASTAContainer<T>& proteins, st
 
     OPENMS_LOG_INFO << "Searching with up to " << aaa_max_ << " ambiguous amino acid(s) and " << mm_max_ << " mismatch(es)!" << std::endl;
 
-    uint16_t count_j_proteins(0);
     bool has_active_data = true; // becomes false if end of FASTA file is reached
     const std::string jumpX(aaa_max_ + mm_max_ + 1, 'X'); // jump over stretches of 'X' which cost a lot of time; +1 because AXXA is a valid hit for aaa_max == 2 (cannot split it)
     // use very large target value for progress if DB size is unknown (did not fit into first chunk)
@@ -623,16 +641,190 @@ PeptideIndexing::ExitCodes PeptideIndexing::run_(FASTAContainer<T>& proteins, st
     OPENMS_LOG_INFO << "Peptide hits passing enzyme filter: " << func.filter_passed << "\n"
                     << "     ... rejected by enzyme filter: " << func.filter_rejected << std::endl;
 
-    if (count_j_proteins)
+  } // end local scope
+  else
+  { // new scope - forget data after search
+    /*
+        Suffix array over the database (scales with the number of peptides)
+    */
+    SysInfo::MemUsage mu;
+    StopWatch s;
+    s.start();
+    // identical peptide sequences are searched only once
+    std::vector<std::string> unique_peptides;
+    std::vector<Hit::T> peptide_to_unique; // peptide hit index --> index into unique_peptides
+    {
+      std::unordered_map<std::string, Hit::T> seq_to_unique;
+      for (const auto& pep : pep_ids)
+      {
+        for (const auto& hit : pep.getHits())
+        {
+          // same normalization as for Aho-Corasick; again, do not skip any peptides here
+          String seq = hit.getSequence().toUnmodifiedString().remove('*');
+          if (IL_equivalent_)
+          {
+            seq.substitute('L', 'I');
+          }
+          auto it = seq_to_unique.emplace(seq, Hit::T(unique_peptides.size())).first;
+          if (it->second == unique_peptides.size()) unique_peptides.push_back(seq);
+          peptide_to_unique.push_back(it->second);
+        }
+      }
+    }
+    if (peptide_to_unique.empty())
+    {
+      OPENMS_LOG_WARN << "Warning: Peptide identifications have no hits inside! Output will be empty as well." << std::endl;
+      return PEPTIDE_IDS_EMPTY;
+    }
+    // unique peptide --> all its peptide hit indices (in ascending order)
+    std::vector<Size> unique_to_peptide_offsets(unique_peptides.size() + 1, 0);
+    std::vector<Hit::T> unique_to_peptide(peptide_to_unique.size());
+    for (Hit::T u : peptide_to_unique) ++unique_to_peptide_offsets[u + 1];
+    for (Size u = 1; u < unique_to_peptide_offsets.size(); ++u) unique_to_peptide_offsets[u] += unique_to_peptide_offsets[u - 1];
+    {
+      std::vector<Size> fill(unique_to_peptide_offsets.begin(), unique_to_peptide_offsets.end() - 1);
+      for (Size i = 0; i < peptide_to_unique.size(); ++i) unique_to_peptide[fill[peptide_to_unique[i]]++] = Hit::T(i);
+    }
+
+    // read the full database (normalized like for Aho-Corasick)
+    ProteinSuffixArray suffix_array;
+    this->startProgress(0, 1, "Reading database");
+    while (proteins.activateCache())
     {
-      OPENMS_LOG_WARN << "PeptideIndexer found " << count_j_proteins << " protein sequences in your database containing the amino acid 'J'."
-        << "To match 'J' in a protein, an ambiguous amino acid placeholder for I/L will be used.\n"
-        << "This costs runtime and eats into the 'aaa_max' limit, leaving less opportunity for B/Z/X matches.\n"
-        << "If you want 'J' to be treated as unambiguous, enable '-IL_equivalent'!" << std::endl;
+      proteins.cacheChunk(PROTEIN_CACHE_SIZE);
+      for (Size i = 0; i < proteins.chunkSize(); ++i)
+      {
+        const FASTAFile::FASTAEntry& fe = proteins.chunkAt(i);
+        String prot = fe.sequence;
+        prot.remove('*');
+        if (prot.has('[') || prot.has('('))
+        {
+          invalid_protein_sequence = true;
+        }
+        if (IL_equivalent_)
+        {
+          prot.substitute('L', 'I');
+          prot.substitute('J', 'I');
+        }
+        else if (prot.has('J'))
+        {
+          ++count_j_proteins;
+        }
+        suffix_array.addProtein(prot);
+        protein_accessions.push_back(fe.identifier);
+        protein_is_decoy.push_back(prefix_ ? fe.identifier.hasPrefix(decoy_string_) : fe.identifier.hasSuffix(decoy_string_));
+      }
     }
+    this->endProgress();
 
+    if (!suffix_array_file_.empty() && File::exists(suffix_array_file_) && suffix_array.load(suffix_array_file_))
+    {
+      OPENMS_LOG_INFO << "Loaded suffix array from '" << suffix_array_file_ << "'";
+    }
+    else
+    {
+      OPENMS_LOG_INFO << "Building suffix array over " << suffix_array.textSize() << " residues ...";
+      suffix_array.build();
+      if (!suffix_array_file_.empty())
+      {
+        suffix_array.store(suffix_array_file_);
+      }
+    }
+    s.stop();
+    OPENMS_LOG_INFO << " done (" << int(s.getClockTime()) << "s)" << std::endl;
+    s.reset();
+
+    OPENMS_LOG_INFO << "Mapping " << peptide_to_unique.size() << " peptides (" << unique_peptides.size() << " distinct) to " << suffix_array.size() << " proteins." << std::endl;
+    OPENMS_LOG_INFO << "Searching with up to " << aaa_max_ << " ambiguous amino acid(s) and " << mm_max_ << " mismatch(es)!" << std::endl;
+
+    // find all occurrences: (text position, unique peptide index)
+    std::vector<std::pair<Hit::T, Hit::T>> occurrences;
+    this->startProgress(0, unique_peptides.size(), "Suffix array");
+    std::atomic<int> progress_peps(0);
+    #pragma omp parallel
+    {
+      std::vector<ProteinSuffixArray::T> positions;
+      std::vector<std::pair<Hit::T, Hit::T>> occurrences_thread;
+      #pragma omp for schedule(dynamic, 100) nowait
+      for (SignedSize u = 0; u < (SignedSize)unique_peptides.size(); ++u)
+      {
+        ++progress_peps; // atomic
+        #ifdef _OPENMP // without OMP, we always set progress
+        if (omp_get_thread_num() == 0)
+        #endif
+        {
+          this->setProgress(progress_peps);
+        }
+        positions.clear();
+        suffix_array.findAll(unique_peptides[u], aaa_max_, mm_max_, positions);
+        for (const auto pos : positions) occurrences_thread.emplace_back(pos, Hit::T(u));
+      }
+      #pragma omp critical(PeptideIndexer_joinSA)
+      occurrences.insert(occurrences.end(), occurrences_thread.begin(), occurrences_thread.end());
+    }
+    this->endProgress();
+    // group occurrences by protein (text positions are ordered like proteins)
+    std::sort(occurrences.begin(), occurrences.end());
+    std::vector<Size> protein_ranges; // start of each stretch of occurrences within one protein (and end of the last)
+    for (Size i = 0; i < occurrences.size(); ++i)
+    {
+      if (i == 0 || suffix_array.proteinIndex(occurrences[i].first) != suffix_array.proteinIndex(occurrences[i - 1].first))
+      {
+        protein_ranges.push_back(i);
+      }
+    }
+    protein_ranges.push_back(occurrences.size());
+
+    // validate enzyme termini per protein
+    #pragma omp parallel
+    {
+      FoundProteinFunctor func_threads(enzyme, xtandem_fix_parameters);
+      std::map<String, Size> acc_to_prot_thread; // map: accessions --> FASTA protein index
+      #pragma omp for schedule(dynamic, 100) nowait
+      for (SignedSize r = 0; r < (SignedSize)protein_ranges.size() - 1; ++r)
+      {
+        const Hit::T prot_idx = Hit::T(suffix_array.proteinIndex(occurrences[protein_ranges[r]].first));
+        const String prot = suffix_array.proteinSequence(prot_idx);
+        const Hit::T prot_start = suffix_array.proteinStart(prot_idx);
+        for (Size i = protein_ranges[r]; i < protein_ranges[r + 1]; ++i)
+        {
+          const Hit::T pos = occurrences[i].first - prot_start;
+          const Hit::T u = occurrences[i].second;
+          const Hit::T len = Hit::T(unique_peptides[u].size());
+          const bool valid = func_threads.validate(prot, pos, len, allow_nterm_protein_cleavage_);
+          for (Size k = unique_to_peptide_offsets[u]; k < unique_to_peptide_offsets[u + 1]; ++k)
+          {
+            func_threads.addHit(valid, unique_to_peptide[k], prot_idx, len, prot, pos);
+          }
+        }
+        acc_to_prot_thread[protein_accessions[prot_idx]] = prot_idx;
+      }
+
+      // join results
+      #pragma omp critical(PeptideIndexer_joinSA)
+      {
+        func.merge(func_threads);
+        acc_to_prot.insert(acc_to_prot_thread.begin(), acc_to_prot_thread.end());
+      }
+    }
+    // sort hits by peptide index
+    std::sort(func.pep_to_prot.begin(), func.pep_to_prot.end());
+    mu.after();
+    std::cout << mu.delta("Suffix array") << "\n\n";
+
+    OPENMS_LOG_INFO << "\nSuffix array search done:\n  found " << func.filter_passed << " hits for " << occurrences.size() << " occurrences of " << unique_peptides.size() << " distinct peptides.\n";
+    OPENMS_LOG_INFO << "Peptide hits passing enzyme filter: " << func.filter_passed << "\n"
+                    << "     ... rejected by enzyme filter: " << func.filter_rejected << std::endl;
   } // end local scope
 
+  if (count_j_proteins)
+  {
+    OPENMS_LOG_WARN << "PeptideIndexer found " << count_j_proteins << " protein sequences in your database containing the amino acid 'J'."
+      << "To match 'J' in a protein, an ambiguous amino acid placeholder for I/L will be used.\n"
+      << "This costs runtime and eats into the 'aaa_max' limit, leaving less opportunity for B/Z/X matches.\n"
+      << "If you want 'J' to be treated as unambiguous, enable '-IL_equivalent'!" << std::endl;
+  }
+
   //
   //   do mapping 
   //
@@ -807,7 +999,11 @@ PeptideIndexing::ExitCodes PeptideIndexing::run_(FASTAContainer<T>& proteins, st
       
       if (write_protein_sequence_ || write_protein_description_)
       {
-        proteins.readAt(fe, *it);
+        if (!proteins.readAt(fe, *it))
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, protein_accessions[*it],
+            "Could not re-read the protein entry from the database to annotate its sequence/description.");
+        }
         if (write_protein_sequence_)
         {
           hit.setSequence(fe.sequence);
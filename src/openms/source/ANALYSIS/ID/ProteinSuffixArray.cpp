@@ -0,0 +1,357 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/ID/ProteinSuffixArray.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <limits>
+#include <utility>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace OpenMS
+{
+  namespace
+  {
+    const uint32_t SUFFIX_ARRAY_FILE_IDENTIFIER = 0x58415350; // "PSAX"
+    const uint32_t SUFFIX_ARRAY_FILE_VERSION = 1;
+    const char PROTEIN_SEPARATOR = '\n';
+
+    /// matching codes: letters (case-insensitive) are 1..26, everything else is 0 (matches nothing)
+    constexpr std::array<uint8_t, 256> makeCodes()
+    {
+      std::array<uint8_t, 256> codes{};
+      for (int c = 'A'; c <= 'Z'; ++c)
+      {
+        codes[c] = uint8_t(c - 'A' + 1);
+        codes[c - 'A' + 'a'] = uint8_t(c - 'A' + 1);
+      }
+      return codes;
+    }
+    constexpr std::array<uint8_t, 256> CODES = makeCodes();
+
+    constexpr int code(const char c)
+    {
+      return CODES[(unsigned char)c];
+    }
+
+    /// can the ambiguous protein AA @p protein_aa stand for the peptide AA @p peptide_aa?
+    bool ambiguousMatch(const int protein_aa, const int peptide_aa)
+    {
+      switch (protein_aa)
+      {
+        case code('B'): return peptide_aa == code('D') || peptide_aa == code('N');
+        case code('J'): return peptide_aa == code('I') || peptide_aa == code('L');
+        case code('Z'): return peptide_aa == code('E') || peptide_aa == code('Q');
+        case code('X'): return peptide_aa != 0 && peptide_aa != code('B') && peptide_aa != code('J') && peptide_aa != code('Z') && peptide_aa != code('X');
+        default: return false;
+      }
+    }
+  }
+
+  void ProteinSuffixArray::addProtein(const std::string& sequence)
+  {
+    starts_.push_back(T(text_.size()));
+    text_ += sequence;
+    text_ += PROTEIN_SEPARATOR;
+    sa_.clear();
+  }
+
+  void ProteinSuffixArray::build()
+  {
+    const size_t n = text_.size();
+    if (n >= size_t(std::numeric_limits<T>::max()))
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, n);
+    }
+    sa_.assign(n, 0);
+    std::vector<T> rank(n); // rank of each suffix, i.e. start of its group in sa_
+    std::vector<T> keys(n); // sort key of sa_[j] in the current round
+
+    // initial sort by the first PACKED_CHARS characters (5 bits each; 0 is beyond the end of the text)
+    const size_t PACKED_CHARS = 6;
+    std::vector<std::pair<T, T>> groups; // unsorted ranges [a, b) of sa_
+    {
+      std::vector<std::pair<T, T>> packed(n); // (packed prefix, suffix)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)n; ++i)
+      {
+        T key = 0;
+        for (size_t d = 0; d < PACKED_CHARS; ++d)
+        {
+          key = (key << 5) | T(codeAt_(T(i), d) + 1);
+        }
+        packed[i] = {key, T(i)};
+      }
+      std::sort(packed.begin(), packed.end());
+      for (size_t run_start = 0; run_start < n;)
+      {
+        size_t run_end = run_start + 1;
+        while (run_end < n && packed[run_end].first == packed[run_start].first) ++run_end;
+        for (size_t j = run_start; j < run_end; ++j)
+        {
+          sa_[j] = packed[j].second;
+          rank[packed[j].second] = T(run_start);
+        }
+        if (run_end - run_start > 1) groups.emplace_back(T(run_start), T(run_end));
+        run_start = run_end;
+      }
+    }
+
+    // prefix doubling: suffixes within a group share the first h characters; sort them by the rank of the suffix h positions later
+    for (size_t h = PACKED_CHARS; !groups.empty(); h *= 2)
+    {
+      // sort all groups (reading ranks only)
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+      {
+        std::vector<std::pair<T, T>> tmp; // (key, suffix); key 0 is beyond the end of the text
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 256)
+#endif
+        for (SignedSize g = 0; g < (SignedSize)groups.size(); ++g)
+        {
+          const auto [a, b] = groups[g];
+          tmp.clear();
+          for (T j = a; j < b; ++j)
+          {
+            const size_t next = size_t(sa_[j]) + h;
+            tmp.emplace_back(next < n ? rank[next] + 1 : 0, sa_[j]);
+          }
+          std::sort(tmp.begin(), tmp.end());
+          for (T j = a; j < b; ++j)
+          {
+            keys[j] = tmp[j - a].first;
+            sa_[j] = tmp[j - a].second;
+          }
+        }
+      }
+
+      // split groups by key and update ranks
+      std::vector<std::pair<T, T>> next_groups;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+      {
+        std::vector<std::pair<T, T>> next_groups_thread;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 256) nowait
+#endif
+        for (SignedSize g = 0; g < (SignedSize)groups.size(); ++g)
+        {
+          const auto [a, b] = groups[g];
+          for (T run_start = a; run_start < b;)
+          {
+            T run_end = run_start + 1;
+            while (run_end < b && keys[run_end] == keys[run_start]) ++run_end;
+            for (T j = run_start; j < run_end; ++j) rank[sa_[j]] = run_start;
+            if (run_end - run_start > 1) next_groups_thread.emplace_back(run_start, run_end);
+            run_start = run_end;
+          }
+        }
+#ifdef _OPENMP
+#pragma omp critical(ProteinSuffixArray_groups)
+#endif
+        next_groups.insert(next_groups.end(), next_groups_thread.begin(), next_groups_thread.end());
+      }
+      groups.swap(next_groups);
+    }
+  }
+
+  bool ProteinSuffixArray::load(const String& filename)
+  {
+    std::ifstream ifs(filename.c_str(), std::ios::binary);
+    if (ifs.fail())
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    uint32_t file_identifier = 0, version = 0;
+    uint64_t text_size = 0, protein_count = 0, fingerprint = 0;
+    ifs.read((char*)&file_identifier, sizeof(file_identifier));
+    ifs.read((char*)&version, sizeof(version));
+    if (!ifs || file_identifier != SUFFIX_ARRAY_FILE_IDENTIFIER || version != SUFFIX_ARRAY_FILE_VERSION)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "File is not a stored protein suffix array (wrong file magic number or version). Aborting!", filename);
+    }
+    ifs.read((char*)&text_size, sizeof(text_size));
+    ifs.read((char*)&protein_count, sizeof(protein_count));
+    ifs.read((char*)&fingerprint, sizeof(fingerprint));
+    if (text_size != text_.size() || protein_count != starts_.size() || fingerprint != fingerprint_())
+    { // built from a different database
+      return false;
+    }
+    sa_.resize(text_size);
+    ifs.read((char*)sa_.data(), sa_.size() * sizeof(T));
+    if (!ifs)
+    {
+      sa_.clear();
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Stored protein suffix array is truncated. Aborting!", filename);
+    }
+    return true;
+  }
+
+  void ProteinSuffixArray::store(const String& filename) const
+  {
+    std::ofstream ofs(filename.c_str(), std::ios::binary);
+    if (!ofs)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    const uint64_t text_size = text_.size(), protein_count = starts_.size(), fingerprint = fingerprint_();
+    ofs.write((const char*)&SUFFIX_ARRAY_FILE_IDENTIFIER, sizeof(SUFFIX_ARRAY_FILE_IDENTIFIER));
+    ofs.write((const char*)&SUFFIX_ARRAY_FILE_VERSION, sizeof(SUFFIX_ARRAY_FILE_VERSION));
+    ofs.write((const char*)&text_size, sizeof(text_size));
+    ofs.write((const char*)&protein_count, sizeof(protein_count));
+    ofs.write((const char*)&fingerprint, sizeof(fingerprint));
+    ofs.write((const char*)sa_.data(), sa_.size() * sizeof(T));
+    ofs.close();
+    if (ofs.fail())
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+  }
+
+  bool ProteinSuffixArray::isBuilt() const
+  {
+    return sa_.size() == text_.size() && !text_.empty();
+  }
+
+  Size ProteinSuffixArray::size() const
+  {
+    return starts_.size();
+  }
+
+  Size ProteinSuffixArray::textSize() const
+  {
+    return text_.size();
+  }
+
+  void ProteinSuffixArray::findAll(const std::string& peptide, uint32_t max_aaa, uint32_t max_mm, std::vector<T>& positions) const
+  {
+    if (peptide.empty() || !isBuilt()) return;
+    search_(peptide, 0, 0, T(sa_.size()), max_aaa, max_mm, positions);
+  }
+
+  Size ProteinSuffixArray::proteinIndex(T pos) const
+  {
+    return std::upper_bound(starts_.begin(), starts_.end(), pos) - starts_.begin() - 1;
+  }
+
+  ProteinSuffixArray::T ProteinSuffixArray::proteinStart(Size index) const
+  {
+    return starts_[index];
+  }
+
+  String ProteinSuffixArray::proteinSequence(Size index) const
+  {
+    const T start = starts_[index];
+    const T end = (index + 1 < starts_.size() ? starts_[index + 1] : T(text_.size())) - 1; // exclude separator
+    return String(text_.begin() + start, text_.begin() + end);
+  }
+
+  uint64_t ProteinSuffixArray::fingerprint_() const
+  { // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : text_)
+    {
+      hash ^= c;
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
+  int ProteinSuffixArray::codeAt_(T suffix, size_t depth) const
+  {
+    const size_t pos = size_t(suffix) + depth;
+    return pos < text_.size() ? code(text_[pos]) : -1;
+  }
+
+  void ProteinSuffixArray::search_(const std::string& peptide, size_t depth, T l, T r, uint32_t aaa_left, uint32_t mm_left, std::vector<T>& positions) const
+  {
+    if (depth == peptide.size())
+    {
+      positions.insert(positions.end(), sa_.begin() + l, sa_.begin() + r);
+      return;
+    }
+    const int c = code(peptide[depth]);
+    // characters at 'depth' are sorted within [l, r): find the sub-interval of 'aa'
+    auto narrow = [&](T from, int aa) -> T
+    {
+      return T(std::partition_point(sa_.begin() + from, sa_.begin() + r, [&](T s) { return codeAt_(s, depth) <= aa; }) - sa_.begin());
+    };
+
+    if (aaa_left == 0 && mm_left == 0)
+    { // exact match only
+      if (c == 0) return;
+      const T lo = T(std::partition_point(sa_.begin() + l, sa_.begin() + r, [&](T s) { return codeAt_(s, depth) < c; }) - sa_.begin());
+      const T hi = narrow(lo, c);
+      if (lo < hi) search_(peptide, depth + 1, lo, hi, 0, 0, positions);
+      return;
+    }
+
+    // enumerate all characters present at 'depth'
+    for (T lo = l; lo < r;)
+    {
+      const int aa = codeAt_(sa_[lo], depth);
+      const T hi = narrow(lo, aa);
+      if (aa > 0) // separators and the end of the text match nothing
+      {
+        if (aa == c)
+        {
+          search_(peptide, depth + 1, lo, hi, aaa_left, mm_left, positions);
+        }
+        else if (aaa_left > 0 && ambiguousMatch(aa, c))
+        {
+          search_(peptide, depth + 1, lo, hi, aaa_left - 1, mm_left, positions);
+        }
+        else if (mm_left > 0 && c != 0)
+        {
+          search_(peptide, depth + 1, lo, hi, aaa_left, mm_left - 1, positions);
+        }
+      }
+      lo = hi;
+    }
+  }
+
+} // namespace OpenMS
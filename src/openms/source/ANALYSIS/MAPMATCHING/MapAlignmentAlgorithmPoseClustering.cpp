@@ -62,6 +62,9 @@ namespace OpenMS
     pairfinder_.setLogType(getLogType());
 
     max_num_peaks_considered_ = param_.getValue("max_num_peaks_considered");
+
+    // superimposer parameters may have changed
+    superimposer_.prepareMap(reference_, prepared_reference_);
   }
 
   MapAlignmentAlgorithmPoseClustering::~MapAlignmentAlgorithmPoseClustering()
@@ -92,7 +95,9 @@ namespace OpenMS
 
     // run superimposer to find the global transformation
     TransformationDescription si_trafo;
-    superimposer_.run(map_model, map_scene, si_trafo);
+    PoseClusteringAffineSuperimposer::PreparedMap prepared_scene;
+    superimposer_.prepareMap(map_scene, prepared_scene);
+    superimposer_.run(prepared_reference_, prepared_scene, si_trafo);
 
     // apply transformation to consensus features and contained feature
     // handles
@@ -37,6 +37,8 @@
 
 #include <OpenMS/CONCEPT/Factory.h>
 
+#include <Eigen/Sparse>
+
 #include <fstream>
 
 namespace OpenMS
@@ -44,7 +46,7 @@ namespace OpenMS
 
   MapAlignmentAlgorithmSpectrumAlignment::MapAlignmentAlgorithmSpectrumAlignment() :
     DefaultParamHandler("MapAlignmentAlgorithmSpectrumAlignment"),
-    ProgressLogger(), c1_(nullptr)
+    ProgressLogger(), c1_(nullptr), binned_(false), bin_size_(0), bin_offset_(0), rt_band_(0)
   {
     defaults_.setValue("gapcost", 1.0, "This Parameter stands for the cost of opening a gap in the Alignment. A gap means that one spectrum can not be aligned directly to another spectrum in the Map. This happens, when the similarity of both spectra a too low or even not present. Imagine it as a insert or delete of the spectrum in the map (similar to sequence alignment). The gap is necessary for aligning, if we open a gap there is a possibility that an another spectrum can be correct aligned with a higher score as before without gap. But to open a gap is a negative event and needs to carry a punishment, so a gap should only be opened if the benefits outweigh the downsides. The Parameter is to giving as a positive number, the implementation convert it to a negative number.");
     defaults_.setMinFloat("gapcost", 0.0);
@@ -63,7 +65,14 @@ namespace OpenMS
     defaults_.setValue("mismatchscore", -5.0, "Defines the score of two spectra if they have no similarity to each other. ", {"advanced"});
     defaults_.setMaxFloat("mismatchscore", 0.0);
     defaults_.setValue("scorefunction", "SteinScottImproveScore", "The score function is the core of an alignment. The success of an alignment depends mostly of the elected score function. The score function return the similarity of two spectra. The score influence defines later the way of possible traceback. There are multiple spectra similarity scores available..");
-    defaults_.setValidStrings("scorefunction", {"SteinScottImproveScore","ZhangSimilarityScore"}); //Factory<PeakSpectrumCompareFunctor>::registeredProducts());
+    defaults_.setValidStrings("scorefunction", {"SteinScottImproveScore","ZhangSimilarityScore","BinnedSpectralContrastAngle"}); //Factory<PeakSpectrumCompareFunctor>::registeredProducts());
+    defaults_.setValue("bin_size", BinnedSpectrum::DEFAULT_BIN_WIDTH_LOWRES, "Bin width (in Th) for the score function 'BinnedSpectralContrastAngle'.", {"advanced"});
+    defaults_.setMinFloat("bin_size", 1e-4);
+    defaults_.setValue("bin_offset", BinnedSpectrum::DEFAULT_BIN_OFFSET_LOWRES, "Bin offset (fraction of the bin width) for the score function 'BinnedSpectralContrastAngle'.", {"advanced"});
+    defaults_.setMinFloat("bin_offset", 0.0);
+    defaults_.setMaxFloat("bin_offset", 1.0);
+    defaults_.setValue("rt_band", 0.0, "Only spectra whose retention times differ by at most this value (in seconds) are compared, all other pairs count as mismatches. This saves most of the scoring for long runs, but requires the runs to be roughly aligned already. Set to 0 to compare all pairs.", {"advanced"});
+    defaults_.setMinFloat("rt_band", 0.0);
     defaultsToParam_();
     setLogType(CMD);
   }
@@ -83,6 +92,10 @@ namespace OpenMS
     {
       std::vector<MSSpectrum*> spectrum_pointers;
       msFilter_(peakmaps[0], spectrum_pointers);
+      if (binned_)
+      {
+        binSpectra_(spectrum_pointers, binned_pattern_, norms_pattern_);
+      }
       startProgress(0, (peakmaps.size() - 1), "Alignment");
       for (Size i = 1; i < peakmaps.size(); ++i)
       {
@@ -102,6 +115,10 @@ namespace OpenMS
     //tempalign -> container for holding only MSSpectrums with MS-Level 1
     std::vector<MSSpectrum*> tempalign;
     msFilter_(aligned, tempalign);
+    if (binned_)
+    {
+      binSpectra_(tempalign, binned_aligned_, norms_aligned_);
+    }
 
     //if it is possible, built 4 blocks. These can be aligned individually
     std::vector<Size> alignpoint;
@@ -117,7 +134,7 @@ namespace OpenMS
 
       for (Size k = 0; k < pattern.size(); ++k)
       {
-        float s =    scoring_(*pattern[k], *(tempalign[y]));
+        float s = scoring_(k, y, pattern, tempalign);
         if (s > maxi && s > cutoffScore_)
         {
           x = k;
@@ -134,7 +151,7 @@ namespace OpenMS
       Size yn = 0;
       for (Size k = 0; k < tempalign.size(); ++k)
       {
-        float s =    scoring_(*pattern[xn], *(tempalign[k]));
+        float s = scoring_(xn, k, pattern, tempalign);
         if (s > maxi && s > cutoffScore_)
         {
           yn = k;
@@ -218,6 +235,8 @@ namespace OpenMS
     bool finish = false;
     while (!finish)
     {
+      // the scores are independent of each other, so compute them in parallel before the DP
+      scoreBand_(n, m, k_, xbegin, ybegin, pattern, aligned, buffermatrix, column_row_orientation);
       traceback.clear();
       for (Size i = 0; i <= n; ++i)
       {
@@ -489,18 +508,7 @@ namespace OpenMS
     {
       if (buffer[i][j] == 0)
       {
-        float score = scoring_(*pattern[i + patternbegin - 1], *aligned[j + alignbegin - 1]);
-        if (score > 1)
-          score = 1;
-        if (debug_)
-        {
-          debugscoreDistributionCalculation_(score);
-        }
-        if (score < threshold_)
-          score = mismatchscore_;
-        else
-          score = 2 + score;
-        buffer[i][j] = score;
+        buffer[i][j] = matchScore_(scoring_(i + patternbegin - 1, j + alignbegin - 1, pattern, aligned));
       }
       return buffer[i][j];
     }
@@ -508,28 +516,103 @@ namespace OpenMS
     {
       if (buffer[j][i] == 0)
       {
-        float score = scoring_(*pattern[j + patternbegin - 1], *aligned[i + alignbegin - 1]);
-        if (score > 1)
-          score = 1;
-        if (debug_)
+        buffer[j][i] = matchScore_(scoring_(j + patternbegin - 1, i + alignbegin - 1, pattern, aligned));
+      }
+      return buffer[j][i];
+    }
+  }
+
+  void MapAlignmentAlgorithmSpectrumAlignment::scoreBand_(Size n, Size m, Int k_, Size patternbegin, Size alignbegin, const std::vector<MSSpectrum*>& pattern, const std::vector<MSSpectrum*>& aligned, std::map<Size, std::map<Size, float> >& buffer, bool column_row_orientation)
+  {
+    // collect the cells inside the band (see insideBand_) that have not been scored yet,
+    // as (pattern, aligned) coordinates of the buffer
+    std::vector<std::pair<Size, Size> > cells;
+    for (Int i = 1; i <= (Int)n; ++i)
+    {
+      const Int j_min = std::max(1, i - k_);
+      const Int j_max = std::min((Int)m, i + (Int)n - (Int)m + k_);
+      for (Int j = j_min; j <= j_max; ++j)
+      {
+        const Size x = column_row_orientation ? j : i;
+        const Size y = column_row_orientation ? i : j;
+        std::map<Size, std::map<Size, float> >::const_iterator row = buffer.find(x);
+        if (row != buffer.end())
         {
-          debugscoreDistributionCalculation_(score);
+          std::map<Size, float>::const_iterator cell = row->second.find(y);
+          if (cell != row->second.end() && cell->second != 0)
+          {
+            continue;
+          }
         }
-        if (score < threshold_)
-          score = mismatchscore_;
-        else
-          score = 2 + score;
-        buffer[j][i] = score;
+        cells.emplace_back(x, y);
       }
-      return buffer[j][i];
     }
+
+    std::vector<float> scores(cells.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for (SignedSize c = 0; c < (SignedSize)cells.size(); ++c)
+    {
+      scores[c] = scoring_(cells[c].first + patternbegin - 1, cells[c].second + alignbegin - 1, pattern, aligned);
+    }
+
+    for (Size c = 0; c < cells.size(); ++c)
+    {
+      buffer[cells[c].first][cells[c].second] = matchScore_(scores[c]);
+    }
+  }
+
+  float MapAlignmentAlgorithmSpectrumAlignment::matchScore_(float score)
+  {
+    if (score > 1)
+      score = 1;
+    if (debug_)
+    {
+      debugscoreDistributionCalculation_(score);
+    }
+    if (score < threshold_)
+      score = mismatchscore_;
+    else
+      score = 2 + score;
+    return score;
   }
 
-  inline float MapAlignmentAlgorithmSpectrumAlignment::scoring_(const MSSpectrum& a, MSSpectrum& b)
+  float MapAlignmentAlgorithmSpectrumAlignment::scoring_(Size pattern_index, Size aligned_index, const std::vector<MSSpectrum*>& pattern, const std::vector<MSSpectrum*>& aligned) const
   {
+    const MSSpectrum& a = *pattern[pattern_index];
+    const MSSpectrum& b = *aligned[aligned_index];
+    if (rt_band_ > 0 && std::fabs(a.getRT() - b.getRT()) > rt_band_)
+    {
+      return 0;
+    }
+    if (binned_)
+    {
+      const double norms = norms_pattern_[pattern_index] * norms_aligned_[aligned_index];
+      if (norms == 0)
+      {
+        return 0;
+      }
+      return binned_pattern_[pattern_index]->getBins()->dot(*binned_aligned_[aligned_index]->getBins()) / norms;
+    }
     return c1_->operator()(a, b);
   }
 
+  void MapAlignmentAlgorithmSpectrumAlignment::binSpectra_(const std::vector<MSSpectrum*>& spectra, std::vector<std::unique_ptr<BinnedSpectrum> >& binned, std::vector<double>& norms) const
+  {
+    binned.clear();
+    binned.resize(spectra.size());
+    norms.assign(spectra.size(), 0.0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)spectra.size(); ++i)
+    {
+      binned[i].reset(new BinnedSpectrum(*spectra[i], bin_size_, false, 0, bin_offset_));
+      norms[i] = std::sqrt(binned[i]->getBins()->dot(*binned[i]->getBins()));
+    }
+  }
+
   inline void MapAlignmentAlgorithmSpectrumAlignment::bucketFilter_(const std::vector<MSSpectrum*>& pattern, std::vector<MSSpectrum*>& aligned, std::vector<int>& xcoordinate, std::vector<float>& ycoordinate, std::vector<int>& xcoordinatepattern)
   {
     std::vector<std::pair<std::pair<Int, float>, float> > tempxy;
@@ -552,7 +635,7 @@ namespace OpenMS
       for (Size j = 0; j < bucketsize_; ++j)
       {
         //std::cout<< j << " j " << std::endl;
-        float score = scoring_(*pattern[xcoordinatepattern[(i * bucketsize_) + j]], *aligned[xcoordinate[(i * bucketsize_) + j]]);
+        float score = scoring_(xcoordinatepattern[(i * bucketsize_) + j], xcoordinate[(i * bucketsize_) + j], pattern, aligned);
         //modification only view as a possible data point if the score is higher than 0
         if (score >= threshold_)
         {
@@ -808,9 +891,21 @@ namespace OpenMS
     gap_    = (float)param_.getValue("gapcost");
     e_      = (float)param_.getValue("affinegapcost");
 
+    // the binned score is computed directly on the binned spectra
+    binned_ = param_.getValue("scorefunction") == "BinnedSpectralContrastAngle";
+    bin_size_ = (float)param_.getValue("bin_size");
+    bin_offset_ = (float)param_.getValue("bin_offset");
+    rt_band_ = param_.getValue("rt_band");
+
     // create spectrum compare functor if it does not yet exist
-    if (c1_ == nullptr || c1_->getName() != param_.getValue("scorefunction"))
+    if (binned_)
+    {
+      delete c1_;
+      c1_ = nullptr;
+    }
+    else if (c1_ == nullptr || c1_->getName() != param_.getValue("scorefunction"))
     {
+      delete c1_;
       c1_ = Factory<PeakSpectrumCompareFunctor>::create(param_.getValue("scorefunction").toString());
     }
 
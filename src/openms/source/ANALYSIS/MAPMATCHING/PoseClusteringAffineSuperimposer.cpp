@@ -39,6 +39,10 @@
 
 #include <boost/math/special_functions/fpclassify.hpp> // isnan
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 // #define Debug_PoseClusteringAffineSuperimposer
 
 namespace OpenMS
@@ -146,6 +150,11 @@ namespace OpenMS
     round, only consider quadruplets where the scaling factor matches the
     estimated bounds of (scale_low_1,scale_high_1), discard all other data.
 
+    The first point of the model map (i) is distributed over the OpenMP
+    threads.  Every thread hashes into a private copy of the hash tables; the
+    copies are added to the given hash tables in the order of the thread
+    numbers.  Dumping of pairs is done single-threaded.
+
   */
   void affineTransformationHashing(const bool do_dump_pairs,
                                    const std::vector<Peak2D> & model_map,
@@ -177,25 +186,62 @@ namespace OpenMS
       dump_pairs_file << "#" << ' ' << "i" << ' ' << "j" << ' ' << "k" << ' ' << "l" << ' ' << std::endl;
     }
 
+    // thread-local copies of the hash tables (same mapping, no votes yet)
+    typedef Math::LinearInterpolation<double, double> LinearInterpolationType_;
+    // inside an outer parallel region (e.g. MapAlignerPoseClustering aligns several maps in parallel) the loop below runs single-threaded
+    int num_threads = 1;
+#ifdef _OPENMP
+    if (!do_dump_pairs && !omp_in_parallel()) num_threads = omp_get_max_threads();
+#endif
+    std::vector<LinearInterpolationType_> local_scaling_hash(num_threads, hashing_round == 1 ? scaling_hash_1 : scaling_hash_2);
+    std::vector<LinearInterpolationType_> local_rt_low_hash, local_rt_high_hash;
+    if (hashing_round != 1)
+    {
+      local_rt_low_hash.assign(num_threads, rt_low_hash_);
+      local_rt_high_hash.assign(num_threads, rt_high_hash_);
+    }
+    for (int t = 0; t < num_threads; ++t)
+    {
+      std::fill(local_scaling_hash[t].getData().begin(), local_scaling_hash[t].getData().end(), 0.0);
+      if (hashing_round != 1)
+      {
+        std::fill(local_rt_low_hash[t].getData().begin(), local_rt_low_hash[t].getData().end(), 0.0);
+        std::fill(local_rt_high_hash[t].getData().begin(), local_rt_high_hash[t].getData().end(), 0.0);
+      }
+    }
+
+    // Both maps are sorted by m/z, so the m/z windows are found by binary search.
+    auto mz_less = [](const Peak2D& p, double mz) { return p.getMZ() < mz; };
+    auto mz_greater = [](double mz, const Peak2D& p) { return mz < p.getMZ(); };
+
     // first point in model map (i)
-    for (Size i = 0, i_low = 0, i_high = 0, k_low = 0, k_high = 0; i < model_map_size - 1; ++i)
+    // (work per i decreases with i, so distribute it round-robin)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(num_threads) if (num_threads > 1)
+#endif
+    for (SignedSize i_signed = 0; i_signed < SignedSize(model_map_size) - 1; ++i_signed)
     {
-      // Adjust window around i in model map (get all features in a m/z range of item i in the model map)
-      while (i_low < model_map_size && model_map[i_low].getMZ() < model_map[i].getMZ() - mz_pair_max_distance)
-        ++i_low;
-      while (i_high < model_map_size && model_map[i_high].getMZ() <= model_map[i].getMZ() + mz_pair_max_distance)
-        ++i_high;
+      const Size i = Size(i_signed);
+      Size thread_num = 0;
+#ifdef _OPENMP
+      thread_num = omp_get_thread_num();
+#endif
+      LinearInterpolationType_& thread_scaling_hash = local_scaling_hash[thread_num];
+
+      // window around i in model map (get all features in a m/z range of item i in the model map)
+      const double mz_min = model_map[i].getMZ() - mz_pair_max_distance;
+      const double mz_max = model_map[i].getMZ() + mz_pair_max_distance;
+      const Size i_low = std::lower_bound(model_map.begin(), model_map.end(), mz_min, mz_less) - model_map.begin();
+      const Size i_high = std::upper_bound(model_map.begin(), model_map.end(), mz_max, mz_greater) - model_map.begin();
       // stop if there are too many features are in our window
       double i_winlength_factor = 1. / (i_high - i_low);
       i_winlength_factor -= winlength_factor_baseline;
       if (i_winlength_factor <= 0)
         continue;
 
-      // Adjust window around k in scene map (get all features in a m/z range of item i in the scene map)
-      while (k_low < scene_map_size && scene_map[k_low].getMZ() < model_map[i].getMZ() - mz_pair_max_distance)
-        ++k_low;
-      while (k_high < scene_map_size && scene_map[k_high].getMZ() <= model_map[i].getMZ() + mz_pair_max_distance)
-        ++k_high;
+      // window around k in scene map (get all features in a m/z range of item i in the scene map)
+      const Size k_low = std::lower_bound(scene_map.begin(), scene_map.end(), mz_min, mz_less) - scene_map.begin();
+      const Size k_high = std::upper_bound(scene_map.begin(), scene_map.end(), mz_max, mz_greater) - scene_map.begin();
 
       // Iterate through all matching features in the scene map that are
       // within the m/z distance of item i from the model map.
@@ -283,17 +329,17 @@ namespace OpenMS
             if (hashing_round == 1)
             {
               // hashing round 1 (estimate the scaling only)
-              scaling_hash_1.addValue(log(scaling), similarity_ik_jl);
+              thread_scaling_hash.addValue(log(scaling), similarity_ik_jl);
             }
             else if (scaling >= scale_low_1 && scaling <= scale_high_1)
             {
               // hashing round 2 (estimate scaling and shift)
-              scaling_hash_2.addValue(log(scaling), similarity_ik_jl);
+              thread_scaling_hash.addValue(log(scaling), similarity_ik_jl);
 
               const double rt_low_image = shift + rt_low * scaling;
-              rt_low_hash_.addValue(rt_low_image, similarity_ik_jl);
+              local_rt_low_hash[thread_num].addValue(rt_low_image, similarity_ik_jl);
               const double rt_high_image = shift + rt_high * scaling;
-              rt_high_hash_.addValue(rt_high_image, similarity_ik_jl);
+              local_rt_high_hash[thread_num].addValue(rt_high_image, similarity_ik_jl);
 
               if (do_dump_pairs)
               {
@@ -306,6 +352,28 @@ namespace OpenMS
         }   // j
       }   // k
     }   // i
+
+    // reduce the thread-local hash tables
+    auto add_votes = [](const std::vector<LinearInterpolationType_>& local, LinearInterpolationType_& hash)
+    {
+      for (const LinearInterpolationType_& l : local)
+      {
+        for (Size index = 0; index < hash.getData().size(); ++index)
+        {
+          hash.getData()[index] += l.getData()[index];
+        }
+      }
+    };
+    if (hashing_round == 1)
+    {
+      add_votes(local_scaling_hash, scaling_hash_1);
+    }
+    else
+    {
+      add_votes(local_scaling_hash, scaling_hash_2);
+      add_votes(local_rt_low_hash, rt_low_hash_);
+      add_votes(local_rt_high_hash, rt_high_hash_);
+    }
   }
 
   /**
@@ -716,29 +784,71 @@ namespace OpenMS
     }
   }
 
-  double computeIntensityRatio(const std::vector<Peak2D> & model_map, const std::vector<Peak2D> & scene_map)
+  void PoseClusteringAffineSuperimposer::prepareMap(const std::vector<Peak2D> & map, PreparedMap & prepared) const
   {
-    double total_int_model_map = 0;
-    for (Size i = 0; i < model_map.size(); ++i)
+    prepared = PreparedMap();
+    if (map.empty())
     {
-      total_int_model_map += model_map[i].getIntensity();
+      return;
     }
 
-    double total_int_scene_map = 0;
-    for (Size i = 0; i < scene_map.size(); ++i)
+    // take estimates of the minimal / maximal element
+    // possible improvement: use the truncated map from below which should be
+    // more reliable (one outlier of low intensity could derail the estimate)
+    prepared.min_rt = std::min_element(map.begin(), map.end(), Peak2D::RTLess())->getRT();
+    prepared.max_rt = std::max_element(map.begin(), map.end(), Peak2D::RTLess())->getRT();
+
+    // Select the most abundant data points only (use copy to truncate).
+    prepared.points = map;
+    const Size num_used_points = (Int) param_.getValue("num_used_points");
+    // sort the last data points by ascending intensity (from the right, using reverse iterators)
+    //  -> linear in complexity, should be faster than sorting and then taking cutoff
+    if (prepared.points.size() > num_used_points)
     {
-      total_int_scene_map += scene_map[i].getIntensity();
+      std::nth_element(prepared.points.rbegin(), prepared.points.rbegin() + (prepared.points.size() - num_used_points),
+          prepared.points.rend(), Peak2D::IntensityLess());
+      prepared.points.resize(num_used_points);
     }
+    // sort by ascending m/z
+    std::sort(prepared.points.begin(), prepared.points.end(), Peak2D::MZLess());
+
+    // total intensity, used to normalize the intensities of both maps
+    for (const Peak2D& p : prepared.points)
+    {
+      prepared.total_intensity += p.getIntensity();
+    }
+  }
 
-    return total_int_model_map / total_int_scene_map;
+  void PoseClusteringAffineSuperimposer::prepareMap(const ConsensusMap & map, PreparedMap & prepared) const
+  {
+    std::vector<Peak2D> c_map;
+    c_map.reserve(map.size());
+    for (ConsensusMap::const_iterator it = map.begin(); it != map.end(); ++it)
+    {
+      Peak2D c;
+      c.setIntensity( it->getIntensity() );
+      c.setRT( it->getRT() );
+      c.setMZ( it->getMZ() );
+      c_map.push_back(c);
+    }
+    prepareMap(c_map, prepared);
   }
 
   void PoseClusteringAffineSuperimposer::run(const std::vector<Peak2D> & map_model,
                                              const std::vector<Peak2D> & map_scene, 
                                              TransformationDescription & transformation)
+  {
+    PreparedMap prepared_model, prepared_scene;
+    prepareMap(map_model, prepared_model);
+    prepareMap(map_scene, prepared_scene);
+    run(prepared_model, prepared_scene, transformation);
+  }
 
+  void PoseClusteringAffineSuperimposer::run(const PreparedMap & map_model,
+                                             const PreparedMap & map_scene,
+                                             TransformationDescription & transformation)
   {
-    if (map_model.empty() || map_scene.empty())
+    if (map_model.points.empty() || map_scene.points.empty())
     {
       throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
                                        "One of the input maps is empty! This is not allowed!");
@@ -802,48 +912,19 @@ namespace OpenMS
     setProgress(++actual_progress);
 
     //**************************************************************************
-    // Step 1: Select the most abundant data points only.
+    // Step 1: Select the most abundant data points only (done by prepareMap())
     //**************************************************************************
-    // use copy to truncate
-    std::vector<Peak2D> model_map(map_model);
-    std::vector<Peak2D> scene_map(map_scene);
-    {
-      // truncate the data as necessary
-      const Size num_used_points = (Int) param_.getValue("num_used_points");
-
-      // sort the last data points by ascending intensity (from the right, using reverse iterators)
-      //  -> linear in complexity, should be faster than sorting and then taking cutoff
-      if (model_map.size() > num_used_points)
-      {
-        std::nth_element(model_map.rbegin(), model_map.rbegin() + (model_map.size() - num_used_points),
-            model_map.rend(), Peak2D::IntensityLess());
-        model_map.resize(num_used_points);
-      }
-      setProgress(++actual_progress);
-      if (scene_map.size() > num_used_points)
-      {
-        std::nth_element(scene_map.rbegin(), scene_map.rbegin() + (scene_map.size() - num_used_points),
-            scene_map.rend(), Peak2D::IntensityLess());
-        scene_map.resize(num_used_points);
-      }
-      setProgress(++actual_progress);
-    }
-    // sort by ascending m/z
-    std::sort(model_map.begin(), model_map.end(), Peak2D::MZLess());
-    std::sort(scene_map.begin(), scene_map.end(), Peak2D::MZLess());
+    const std::vector<Peak2D>& model_map = map_model.points;
+    const std::vector<Peak2D>& scene_map = map_scene.points;
     setProgress((actual_progress = 10));
 
     //**************************************************************************
     // Preprocessing
     //**************************************************************************
-    // take estimates of the minimal / maximal element from both maps
-    // possible improvement: use the truncated map from above which should be
-    // more reliable (one outlier of low intensity could derail the estimate
-    // below)
-    const double model_minrt = std::min_element(map_model.begin(), map_model.end(), Peak2D::RTLess())->getRT();
-    const double scene_minrt = std::min_element(map_scene.begin(), map_scene.end(), Peak2D::RTLess())->getRT();
-    const double model_maxrt = std::max_element(map_model.begin(), map_model.end(), Peak2D::RTLess())->getRT();
-    const double scene_maxrt = std::max_element(map_scene.begin(), map_scene.end(), Peak2D::RTLess())->getRT();
+    const double model_minrt = map_model.min_rt;
+    const double scene_minrt = map_scene.min_rt;
+    const double model_maxrt = map_model.max_rt;
+    const double scene_maxrt = map_scene.max_rt;
     const double rt_low =  (model_minrt + scene_minrt) / 2.;
     const double rt_high = (model_maxrt + scene_maxrt) / 2.;
 
@@ -897,7 +978,7 @@ namespace OpenMS
     // Step 3: compute the ratio of the total intensities of both maps, for
     //         normalization
     //**************************************************************************
-    double total_intensity_ratio = computeIntensityRatio(model_map, scene_map);
+    double total_intensity_ratio = map_model.total_intensity / map_scene.total_intensity;
     setProgress((actual_progress = 20));
 
     // The serial number is incremented for each invocation of this, to avoid
@@ -1053,25 +1134,10 @@ namespace OpenMS
                                              const ConsensusMap& map_scene,
                                              TransformationDescription& transformation)
   {
-    std::vector<Peak2D> c_map_model, c_map_scene;
-    for (ConsensusMap::const_iterator it = map_model.begin(); it != map_model.end(); ++it)
-    {
-      Peak2D c;
-      c.setIntensity( it->getIntensity() );
-      c.setRT( it->getRT() );
-      c.setMZ( it->getMZ() );
-      c_map_model.push_back(c);
-    }
-    for (ConsensusMap::const_iterator it = map_scene.begin(); it != map_scene.end(); ++it)
-    {
-      Peak2D c;
-      c.setIntensity( it->getIntensity() );
-      c.setRT( it->getRT() );
-      c.setMZ( it->getMZ() );
-      c_map_scene.push_back(c);
-    }
-
-    run(c_map_model, c_map_scene, transformation);
+    PreparedMap prepared_model, prepared_scene;
+    prepareMap(map_model, prepared_model);
+    prepareMap(map_scene, prepared_scene);
+    run(prepared_model, prepared_scene, transformation);
   }
 
 } // namespace OpenMS
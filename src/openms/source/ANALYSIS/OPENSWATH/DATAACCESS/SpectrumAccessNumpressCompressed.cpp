@@ -0,0 +1,274 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessNumpressCompressed.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessSqMass.h>
+
+#include <OpenMS/FORMAT/MSNumpressCoder.h>
+
+#include <algorithm>    // std::lower_bound, std::any_of
+
+namespace OpenMS
+{
+
+  SpectrumAccessNumpressCompressed::SpectrumAccessNumpressCompressed(OpenSwath::ISpectrumAccess & origin, Size cache_size, double linear_fp_mass_acc) :
+    cache_size_(cache_size)
+  {
+    boost::shared_ptr<std::vector<CompressedArrays> > spectra(new std::vector<CompressedArrays>);
+    boost::shared_ptr<std::vector<OpenSwath::SpectrumMeta> > spectra_meta(new std::vector<OpenSwath::SpectrumMeta>);
+    boost::shared_ptr<std::vector<CompressedArrays> > chromatograms(new std::vector<CompressedArrays>);
+    boost::shared_ptr<std::vector<std::string> > chromatogram_ids(new std::vector<std::string>);
+
+    // special case: we can grab the data directly (and fast)
+    if (dynamic_cast<SpectrumAccessSqMass*> (&origin))
+    {
+      SpectrumAccessSqMass* tmp = dynamic_cast<SpectrumAccessSqMass*> (&origin);
+      std::vector<OpenSwath::SpectrumPtr> all_spectra;
+      tmp->getAllSpectra(all_spectra, *spectra_meta);
+      spectra->resize(all_spectra.size());
+      for (Size i = 0; i < all_spectra.size(); ++i)
+      {
+        compress_(all_spectra[i]->getDataArrays(), (*spectra)[i], linear_fp_mass_acc);
+        all_spectra[i].reset(); // free decoded data early
+      }
+    }
+    else
+    {
+      spectra->resize(origin.getNrSpectra());
+      for (Size i = 0; i < origin.getNrSpectra(); ++i)
+      {
+        compress_(origin.getSpectrumById(i)->getDataArrays(), (*spectra)[i], linear_fp_mass_acc);
+        spectra_meta->push_back( origin.getSpectrumMetaById(i) );
+      }
+      chromatograms->resize(origin.getNrChromatograms());
+      for (Size i = 0; i < origin.getNrChromatograms(); ++i)
+      {
+        compress_(origin.getChromatogramById(i)->getDataArrays(), (*chromatograms)[i], linear_fp_mass_acc);
+        chromatogram_ids->push_back( origin.getChromatogramNativeID(i) );
+      }
+    }
+
+    spectra_ = spectra;
+    spectra_meta_ = spectra_meta;
+    chromatograms_ = chromatograms;
+    chromatogram_ids_ = chromatogram_ids;
+
+    OPENMS_POSTCONDITION(spectra_->size() == spectra_meta_->size(), "Spectra and meta data needs to match")
+    OPENMS_POSTCONDITION(chromatogram_ids_->size() == chromatograms_->size(), "Chromatograms and meta data needs to match")
+  }
+
+  SpectrumAccessNumpressCompressed::~SpectrumAccessNumpressCompressed() {}
+
+  SpectrumAccessNumpressCompressed::SpectrumAccessNumpressCompressed(const SpectrumAccessNumpressCompressed & rhs) :
+    spectra_(rhs.spectra_),
+    spectra_meta_(rhs.spectra_meta_),
+    chromatograms_(rhs.chromatograms_),
+    chromatogram_ids_(rhs.chromatogram_ids_),
+    cache_size_(rhs.cache_size_)
+  {
+    // this only copies the pointers and not the actual data; every copy starts with an empty cache
+  }
+
+  boost::shared_ptr<OpenSwath::ISpectrumAccess> SpectrumAccessNumpressCompressed::lightClone() const
+  {
+    return boost::shared_ptr<SpectrumAccessNumpressCompressed>(new SpectrumAccessNumpressCompressed(*this));
+  }
+
+  bool SpectrumAccessNumpressCompressed::useSlof_(const OpenSwath::BinaryDataArray& array, Size index)
+  {
+    // slof stores the logarithm, i.e. it cannot encode negative values
+    if (std::any_of(array.data.begin(), array.data.end(), [](double d) { return d < 0; })) return false;
+
+    // the standard arrays have no description: m/z (or time) first, intensity second
+    if (array.description.empty()) return index == 1;
+
+    // additional arrays are named (e.g. 'Ion Mobility', 'signal to noise', 'raw intensity')
+    String description(array.description);
+    description.toLower();
+    return description.hasSubstring("intensity");
+  }
+
+  void SpectrumAccessNumpressCompressed::compress_(const std::vector<OpenSwath::BinaryDataArrayPtr>& arrays, CompressedArrays& result, double linear_fp_mass_acc)
+  {
+    MSNumpressCoder::NumpressConfig linear;
+    linear.np_compression = MSNumpressCoder::LINEAR;
+    linear.estimate_fixed_point = true;
+    linear.linear_fp_mass_acc = linear_fp_mass_acc;
+
+    MSNumpressCoder::NumpressConfig slof;
+    slof.np_compression = MSNumpressCoder::SLOF;
+    slof.estimate_fixed_point = true;
+
+    MSNumpressCoder coder;
+    result.resize(arrays.size());
+    for (Size k = 0; k < arrays.size(); ++k)
+    {
+      if (!arrays[k]) continue;
+
+      result[k].slof = useSlof_(*arrays[k], k);
+
+      String encoded;
+      coder.encodeNPRaw(arrays[k]->data, encoded, result[k].slof ? slof : linear);
+      result[k].data = encoded;
+      result[k].data.shrink_to_fit();
+      result[k].description = arrays[k]->description;
+    }
+  }
+
+  void SpectrumAccessNumpressCompressed::decompress_(const CompressedArrays& arrays, std::vector<OpenSwath::BinaryDataArrayPtr>& result)
+  {
+    MSNumpressCoder::NumpressConfig linear;
+    linear.np_compression = MSNumpressCoder::LINEAR;
+    MSNumpressCoder::NumpressConfig slof;
+    slof.np_compression = MSNumpressCoder::SLOF;
+
+    MSNumpressCoder coder;
+    result.resize(arrays.size());
+    for (Size k = 0; k < arrays.size(); ++k)
+    {
+      OpenSwath::BinaryDataArrayPtr array(new OpenSwath::BinaryDataArray);
+      coder.decodeNPRaw(arrays[k].data, array->data, arrays[k].slof ? slof : linear);
+      array->description = arrays[k].description;
+      result[k] = array;
+    }
+  }
+
+  OpenSwath::SpectrumPtr SpectrumAccessNumpressCompressed::getSpectrumById(int id)
+  {
+    OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
+    OPENMS_PRECONDITION(id < (int)getNrSpectra(), "Id cannot be larger than number of spectra");
+
+    auto cached = cache_index_.find(id);
+    if (cached != cache_index_.end())
+    {
+      // move to front (most recently used)
+      cache_.splice(cache_.begin(), cache_, cached->second);
+      return cached->second->second;
+    }
+
+    OpenSwath::SpectrumPtr sptr(new OpenSwath::Spectrum);
+    decompress_((*spectra_)[id], sptr->getDataArrays());
+
+    if (cache_size_ > 0)
+    {
+      cache_.push_front(std::make_pair(id, sptr));
+      cache_index_[id] = cache_.begin();
+      if (cache_.size() > cache_size_)
+      {
+        cache_index_.erase(cache_.back().first);
+        cache_.pop_back();
+      }
+    }
+    return sptr;
+  }
+
+  OpenSwath::SpectrumMeta SpectrumAccessNumpressCompressed::getSpectrumMetaById(int id) const
+  {
+    OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
+    OPENMS_PRECONDITION(id < (int)getNrSpectra(), "Id cannot be larger than number of spectra");
+    return (*spectra_meta_)[id];
+  }
+
+  std::vector<std::size_t> SpectrumAccessNumpressCompressed::getSpectraByRT(double RT, double deltaRT) const
+  {
+    OPENMS_PRECONDITION(deltaRT >= 0, "Delta RT needs to be a positive number");
+
+    // we first perform a search for the spectrum that is past the
+    // beginning of the RT domain. Then we add this spectrum and try to add
+    // further spectra as long as they are below RT + deltaRT.
+    std::vector<std::size_t> result;
+    OpenSwath::SpectrumMeta s;
+    s.RT = RT - deltaRT;
+    auto spectrum = std::lower_bound(spectra_meta_->begin(), spectra_meta_->end(), s, OpenSwath::SpectrumMeta::RTLess());
+    if (spectrum == spectra_meta_->end()) return result;
+
+    result.push_back(std::distance(spectra_meta_->begin(), spectrum));
+    ++spectrum;
+    while (spectrum != spectra_meta_->end() && spectrum->RT < RT + deltaRT)
+    {
+      result.push_back(std::distance(spectra_meta_->begin(), spectrum));
+      ++spectrum;
+    }
+    return result;
+  }
+
+  size_t SpectrumAccessNumpressCompressed::getNrSpectra() const
+  {
+    OPENMS_PRECONDITION(spectra_->size() == spectra_meta_->size(), "Spectra and meta data needs to match")
+    return spectra_->size();
+  }
+
+  OpenSwath::ChromatogramPtr SpectrumAccessNumpressCompressed::getChromatogramById(int id)
+  {
+    OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
+    OPENMS_PRECONDITION(id < (int)getNrChromatograms(), "Id cannot be larger than number of chromatograms");
+
+    OpenSwath::ChromatogramPtr cptr(new OpenSwath::Chromatogram);
+    decompress_((*chromatograms_)[id], cptr->getDataArrays());
+    return cptr;
+  }
+
+  size_t SpectrumAccessNumpressCompressed::getNrChromatograms() const
+  {
+    OPENMS_PRECONDITION(chromatogram_ids_->size() == chromatograms_->size(), "Chromatograms and meta data needs to match")
+    return chromatograms_->size();
+  }
+
+  std::string SpectrumAccessNumpressCompressed::getChromatogramNativeID(int id) const
+  {
+    OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
+    OPENMS_PRECONDITION(id < (int)getNrChromatograms(), "Id cannot be larger than number of chromatograms");
+    return (*chromatogram_ids_)[id];
+  }
+
+  Size SpectrumAccessNumpressCompressed::getNrCachedSpectra() const
+  {
+    return cache_.size();
+  }
+
+  Size SpectrumAccessNumpressCompressed::getCompressedSize() const
+  {
+    Size total(0);
+    for (const auto& container : {spectra_, chromatograms_})
+    {
+      for (const auto& arrays : *container)
+      {
+        for (const auto& a : arrays) total += a.data.size();
+      }
+    }
+    return total;
+  }
+
+} //end namespace OpenMS
@@ -34,6 +34,13 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathWorkflow.h>
 
+#include <OpenMS/SYSTEM/Tracer.h>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+
 // OpenSwathCalibrationWorkflow
 namespace OpenMS
 {
@@ -75,6 +82,7 @@ namespace OpenMS
     bool sonar,
     bool load_into_memory)
   {
+    OPENMS_TRACE_SCOPE("OpenSwathCalibrationWorkflow::performRTNormalization");
     OPENMS_LOG_DEBUG << "performRTNormalization method starting" << std::endl;
     std::vector< OpenMS::MSChromatogram > irt_chromatograms;
     TransformationDescription trafo; // dummy
@@ -454,6 +462,7 @@ namespace OpenMS
     int ms1_isotopes,
     bool load_into_memory)
   {
+    OPENMS_TRACE_SCOPE("OpenSwathWorkflow::performExtraction");
     tsv_writer.writeHeader();
     osw_writer.writeHeader();
 
@@ -463,7 +472,20 @@ namespace OpenMS
     TransformationDescription trafo_inverse = trafo;
     trafo_inverse.invert();
 
-    std::cout << "Will analyze " << transition_exp.transitions.size() << " transitions in total." << std::endl;
+    if (window_library_loader_ && (ms1_only || prm_ || pasef_))
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Loading the assay library per SWATH window is not supported for MS1-only, PRM or PASEF data." );
+    }
+
+    if (window_library_loader_)
+    {
+      std::cout << "Will load the transitions of each SWATH window on demand." << std::endl;
+    }
+    else
+    {
+      std::cout << "Will analyze " << transition_exp.transitions.size() << " transitions in total." << std::endl;
+    }
     int progress = 0;
     this->startProgress(0, swath_maps.size(), "Extracting and scoring transitions");
 
@@ -591,7 +613,7 @@ namespace OpenMS
     // better load balancing than static allocation.
 #ifdef _OPENMP
 #ifdef MT_ENABLE_NESTED_OPENMP
-    int total_nr_threads = omp_get_max_threads(); // store total number of threads we are allowed to use
+    total_nr_threads_ = omp_get_max_threads(); // store total number of threads we are allowed to use
     if (threads_outer_loop_ > -1)
     {
       std::cout << "Setting up nested loop with " << std::min(threads_outer_loop_, omp_get_max_threads()) << " threads out of "<< omp_get_max_threads() << std::endl;
@@ -601,7 +623,7 @@ namespace OpenMS
     }
     else
     {
-      std::cout << "Use non-nested loop with " << total_nr_threads << " threads." << std::endl;
+      std::cout << "Use non-nested loop with " << total_nr_threads_ << " threads." << std::endl;
     }
 #endif
 #pragma omp parallel for schedule(dynamic,1)
@@ -610,183 +632,457 @@ namespace OpenMS
     {
       if (!swath_maps[i].ms1) // skip MS1
       {
+        processSwathWindow_(swath_maps[i], i, transition_exp, tr_win_map, trafo, trafo_inverse, cp, ms1_cp,
+                            feature_finder_param, out_featureFile, store_features, tsv_writer, osw_writer,
+                            chromConsumer, batchSize, ms1_isotopes, load_into_memory, ms1_only);
+      }
 
-        // Step 1: select which transitions to extract (proceed in batches)
-        OpenSwath::LightTargetedExperiment transition_exp_used_all;
-        if (!(prm_ || pasef_))
-        {
-          // Step 1.1: select transitions matching the window
-          OpenSwathHelper::selectSwathTransitions(transition_exp, transition_exp_used_all,
-              cp.min_upper_edge_dist, swath_maps[i].lower, swath_maps[i].upper);
-        }
-        else
+      #pragma omp critical (progress)
+      this->setProgress(++progress);
+
+    }
+    this->endProgress();
+
+#ifdef _OPENMP
+#ifdef MT_ENABLE_NESTED_OPENMP
+    if (threads_outer_loop_ > -1)
+    {
+      omp_set_num_threads(total_nr_threads_); // set number of available threads back to initial value
+    }
+#endif
+#endif
+  }
+
+  void OpenSwathWorkflow::performExtractionPipelined(
+    Size nr_swath_maps,
+    const std::function<OpenSwath::SwathMap (Size)>& load_swath_map,
+    Size max_windows_in_flight,
+    const TransformationDescription trafo,
+    const ChromExtractParams & cp,
+    const ChromExtractParams & cp_ms1,
+    const Param & feature_finder_param,
+    const OpenSwath::LightTargetedExperiment& transition_exp,
+    FeatureMap& out_featureFile,
+    bool store_features,
+    OpenSwathTSVWriter & tsv_writer,
+    OpenSwathOSWWriter & osw_writer,
+    Interfaces::IMSDataConsumer * chromConsumer,
+    int batchSize,
+    int ms1_isotopes,
+    bool load_into_memory)
+  {
+    OPENMS_TRACE_SCOPE("OpenSwathWorkflow::performExtractionPipelined");
+    if (prm_ || pasef_)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Pipelined extraction is not supported for PRM or PASEF data, use performExtraction() instead." );
+    }
+    max_windows_in_flight = std::max(max_windows_in_flight, Size(1));
+
+    tsv_writer.writeHeader();
+    osw_writer.writeHeader();
+
+    // Compute inversion of the transformation
+    TransformationDescription trafo_inverse = trafo;
+    trafo_inverse.invert();
+
+    ChromExtractParams ms1_cp(cp_ms1);
+    if (!use_ms1_ion_mobility_)
+    {
+      ms1_cp.im_extraction_window = -1;
+    }
+
+    const std::vector<int> tr_win_map; // only needed for PRM / PASEF
+    ms1_map_ = nullptr;
+#ifdef _OPENMP
+    total_nr_threads_ = omp_get_max_threads();
+#endif
+
+    typedef std::pair<SignedSize, OpenSwath::SwathMap> WindowType;
+    std::mutex pipeline_mutex; // guards all pipeline state below
+    std::condition_variable pipeline_cv; // signalled whenever the pipeline state changes
+    std::deque<WindowType> ready_windows; // loaded windows waiting to be processed
+    std::vector<WindowType> windows_before_ms1; // loaded before the MS1 map was available (only used by the reader)
+    std::vector<Size> deferred_maps; // dropped before the MS1 map was available, read again later (only used by the reader)
+    Size windows_in_flight = 0; // loaded and not yet scored (including windows_before_ms1)
+    bool loading_done = false;
+    std::exception_ptr loading_error;
+
+    int progress = 0;
+    this->startProgress(0, nr_swath_maps, "Loading, extracting and scoring SWATH windows");
+
+    auto process_window = [&](const WindowType& w)
+    {
+      processSwathWindow_(w.second, w.first, transition_exp, tr_win_map, trafo, trafo_inverse, cp, ms1_cp,
+                          feature_finder_param, out_featureFile, store_features, tsv_writer, osw_writer,
+                          chromConsumer, batchSize, ms1_isotopes, load_into_memory, false);
+      {
+        std::lock_guard<std::mutex> lock(pipeline_mutex);
+        --windows_in_flight;
+      }
+      pipeline_cv.notify_all();
+#ifdef _OPENMP
+#pragma omp critical (progress)
+#endif
+      this->setProgress(++progress);
+    };
+
+    // Thread 0 reads the maps (and helps with scoring if too many windows are
+    // in flight), all other threads score windows as soon as they are ready.
+    // Once all maps are read, thread 0 joins the scoring.
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      bool is_reader = true;
+#ifdef _OPENMP
+      is_reader = (omp_get_thread_num() == 0);
+#endif
+      if (is_reader)
+      {
+        try
         {
-          // Step 1.2: select transitions based on matching PRM/PASEF window (best window)
-          std::set<std::string> matching_compounds;
-          for (Size k = 0; k < tr_win_map.size(); k++)
+          bool ms1_available = !use_ms1_traces_;
+          // read all maps in order, then the maps deferred while waiting for the MS1 map
+          for (Size k = 0; k < nr_swath_maps + deferred_maps.size(); ++k)
           {
-            if (tr_win_map[k] == i)
+            const Size i = (k < nr_swath_maps) ? k : deferred_maps[k - nr_swath_maps];
+            if (k == nr_swath_maps && !ms1_available)
             {
-               const OpenSwath::LightTransition& tr = transition_exp.transitions[k];
-               transition_exp_used_all.transitions.push_back(tr);
-               matching_compounds.insert(tr.getPeptideRef());
-               OPENMS_LOG_DEBUG << "Adding Precursor with m/z " << tr.getPrecursorMZ() << " and IM of " << tr.getPrecursorIM() <<  " to swath with mz upper of " << swath_maps[i].upper << " im lower of " << swath_maps[i].imLower << " and im upper of " << swath_maps[i].imUpper << std::endl;
+              // no MS1 map was found: score the held back and the deferred windows without MS1 traces
+              {
+                std::lock_guard<std::mutex> lock(pipeline_mutex);
+                ready_windows.insert(ready_windows.end(), windows_before_ms1.begin(), windows_before_ms1.end());
+              }
+              windows_before_ms1.clear();
+              ms1_available = true;
+              pipeline_cv.notify_all();
             }
-          }
 
-          std::set<std::string> matching_proteins;
-          for (Size i = 0; i < transition_exp.compounds.size(); i++)
-          {
-            if (matching_compounds.find(transition_exp.compounds[i].id) != matching_compounds.end())
+            // bound memory: wait (and score windows) while the limit of windows in flight is reached. Windows held
+            // back for the MS1 map cannot be scored yet, so if they alone fill the limit the reader keeps reading.
+            while (true)
             {
-              transition_exp_used_all.compounds.push_back( transition_exp.compounds[i] );
-              for (Size j = 0; j < transition_exp.compounds[i].protein_refs.size(); j++)
+              WindowType window;
+              bool got_window = false;
               {
-                matching_proteins.insert(transition_exp.compounds[i].protein_refs[j]);
+                std::unique_lock<std::mutex> lock(pipeline_mutex);
+                pipeline_cv.wait(lock, [&]
+                {
+                  return windows_in_flight < max_windows_in_flight || !ready_windows.empty() ||
+                         windows_in_flight == windows_before_ms1.size();
+                });
+                if (windows_in_flight < max_windows_in_flight || ready_windows.empty()) break;
+                window = ready_windows.front();
+                ready_windows.pop_front();
+                got_window = true;
               }
+              if (got_window) process_window(window);
             }
-          }
-          for (Size i = 0; i < transition_exp.proteins.size(); i++)
-          {
-            if (matching_proteins.find(transition_exp.proteins[i].id) != matching_proteins.end())
+
+            OpenSwath::SwathMap swath_map;
+            {
+              OPENMS_TRACE_SCOPE("loading SWATH map");
+              swath_map = load_swath_map(i);
+            }
+
+            if (!swath_map.sptr)
+            {
+#ifdef _OPENMP
+#pragma omp critical (progress)
+#endif
+              this->setProgress(++progress);
+              continue;
+            }
+
+            std::vector<WindowType> new_windows;
+            Size nr_new_in_flight = 0; // windows in new_windows which are not counted in windows_in_flight yet
+            if (swath_map.ms1)
+            {
+              if (use_ms1_traces_)
+              {
+                ms1_map_ = swath_map.sptr;
+                if (load_into_memory)
+                {
+                  ms1_map_ = boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*ms1_map_) );
+                }
+                ms1_available = true;
+                new_windows.swap(windows_before_ms1);
+              }
+#ifdef _OPENMP
+#pragma omp critical (progress)
+#endif
+              this->setProgress(++progress);
+            }
+            else if (ms1_available)
             {
-              transition_exp_used_all.proteins.push_back( transition_exp.proteins[i] );
+              new_windows.push_back(WindowType(i, swath_map));
+              nr_new_in_flight = 1;
+            }
+            else if (windows_before_ms1.size() < max_windows_in_flight)
+            {
+              windows_before_ms1.push_back(WindowType(i, swath_map));
+              std::lock_guard<std::mutex> lock(pipeline_mutex);
+              ++windows_in_flight;
+            }
+            else
+            {
+              // no room to hold back another window: drop it and read it again once the MS1 map is available
+              deferred_maps.push_back(i);
+            }
+
+            if (!new_windows.empty())
+            {
+              {
+                std::lock_guard<std::mutex> lock(pipeline_mutex);
+                ready_windows.insert(ready_windows.end(), new_windows.begin(), new_windows.end());
+                windows_in_flight += nr_new_in_flight;
+              }
+              pipeline_cv.notify_all();
             }
           }
         }
+        catch (...)
+        {
+          loading_error = std::current_exception();
+        }
 
-        if (!transition_exp_used_all.getTransitions().empty()) // skip if no transitions found
         {
+          std::lock_guard<std::mutex> lock(pipeline_mutex);
+          // no MS1 map was found (and nothing was deferred): score the remaining windows without MS1 traces
+          ready_windows.insert(ready_windows.end(), windows_before_ms1.begin(), windows_before_ms1.end());
+          windows_before_ms1.clear();
+          loading_done = true;
+        }
+        pipeline_cv.notify_all();
+      }
 
-          OpenSwath::SpectrumAccessPtr current_swath_map = swath_maps[i].sptr;
-          if (load_into_memory)
-          {
-            // This creates an InMemory object that keeps all data in memory
-            current_swath_map = boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*current_swath_map) );
-          }
+      // score windows until all have been read and processed
+      while (true)
+      {
+        WindowType window;
+        {
+          std::unique_lock<std::mutex> lock(pipeline_mutex);
+          pipeline_cv.wait(lock, [&] { return !ready_windows.empty() || loading_done; });
+          if (ready_windows.empty()) break; // loading is done and nothing is left
+          window = ready_windows.front();
+          ready_windows.pop_front();
+        }
+        process_window(window);
+      }
+    }
+    this->endProgress();
+    ms1_map_ = nullptr;
 
-          int batch_size;
-          if (batchSize <= 0 || batchSize >= (int)transition_exp_used_all.getCompounds().size())
-          {
-            batch_size = transition_exp_used_all.getCompounds().size();
-          }
-          else
+    if (loading_error)
+    {
+      std::rethrow_exception(loading_error);
+    }
+  }
+
+  void OpenSwathWorkflow::processSwathWindow_(
+    const OpenSwath::SwathMap& swath_map,
+    SignedSize swath_idx,
+    const OpenSwath::LightTargetedExperiment& transition_exp,
+    const std::vector<int>& tr_win_map,
+    const TransformationDescription& trafo,
+    const TransformationDescription& trafo_inverse,
+    const ChromExtractParams & cp,
+    const ChromExtractParams & ms1_cp,
+    const Param & feature_finder_param,
+    FeatureMap& out_featureFile,
+    bool store_features,
+    OpenSwathTSVWriter & tsv_writer,
+    OpenSwathOSWWriter & osw_writer,
+    Interfaces::IMSDataConsumer * chromConsumer,
+    int batchSize,
+    int ms1_isotopes,
+    bool load_into_memory,
+    bool ms1_only)
+  {
+    const std::vector< OpenSwath::SwathMap > current_swath_maps = {swath_map};
+
+    // Step 1: select which transitions to extract (proceed in batches)
+    OpenSwath::LightTargetedExperiment transition_exp_used_all;
+    if (!(prm_ || pasef_))
+    {
+      // Step 1.1: select transitions matching the window
+      if (window_library_loader_)
+      {
+        OpenSwath::LightTargetedExperiment window_library;
+        window_library_loader_(swath_map.lower, swath_map.upper, window_library);
+        OpenSwathHelper::selectSwathTransitions(window_library, transition_exp_used_all,
+            cp.min_upper_edge_dist, swath_map.lower, swath_map.upper);
+      }
+      else
+      {
+        OpenSwathHelper::selectSwathTransitions(transition_exp, transition_exp_used_all,
+            cp.min_upper_edge_dist, swath_map.lower, swath_map.upper);
+      }
+    }
+    else
+    {
+      // Step 1.2: select transitions based on matching PRM/PASEF window (best window)
+      std::set<std::string> matching_compounds;
+      for (Size k = 0; k < tr_win_map.size(); k++)
+      {
+        if (tr_win_map[k] == swath_idx)
+        {
+           const OpenSwath::LightTransition& tr = transition_exp.transitions[k];
+           transition_exp_used_all.transitions.push_back(tr);
+           matching_compounds.insert(tr.getPeptideRef());
+           OPENMS_LOG_DEBUG << "Adding Precursor with m/z " << tr.getPrecursorMZ() << " and IM of " << tr.getPrecursorIM() <<  " to swath with mz upper of " << swath_map.upper << " im lower of " << swath_map.imLower << " and im upper of " << swath_map.imUpper << std::endl;
+        }
+      }
+
+      std::set<std::string> matching_proteins;
+      for (Size i = 0; i < transition_exp.compounds.size(); i++)
+      {
+        if (matching_compounds.find(transition_exp.compounds[i].id) != matching_compounds.end())
+        {
+          transition_exp_used_all.compounds.push_back( transition_exp.compounds[i] );
+          for (Size j = 0; j < transition_exp.compounds[i].protein_refs.size(); j++)
           {
-            batch_size = batchSize;
+            matching_proteins.insert(transition_exp.compounds[i].protein_refs[j]);
           }
+        }
+      }
+      for (Size i = 0; i < transition_exp.proteins.size(); i++)
+      {
+        if (matching_proteins.find(transition_exp.proteins[i].id) != matching_proteins.end())
+        {
+          transition_exp_used_all.proteins.push_back( transition_exp.proteins[i] );
+        }
+      }
+    }
 
-          SignedSize nr_batches = (transition_exp_used_all.getCompounds().size() / batch_size);
+    if (!transition_exp_used_all.getTransitions().empty()) // skip if no transitions found
+    {
+
+      OpenSwath::SpectrumAccessPtr current_swath_map = swath_map.sptr;
+      if (load_into_memory)
+      {
+        // This creates an InMemory object that keeps all data in memory
+        current_swath_map = boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*current_swath_map) );
+      }
+
+      int batch_size;
+      if (batchSize <= 0 || batchSize >= (int)transition_exp_used_all.getCompounds().size())
+      {
+        batch_size = transition_exp_used_all.getCompounds().size();
+      }
+      else
+      {
+        batch_size = batchSize;
+      }
+
+      SignedSize nr_batches = (transition_exp_used_all.getCompounds().size() / batch_size);
 
 #ifdef _OPENMP
 #ifdef MT_ENABLE_NESTED_OPENMP
-          // If we have a multiple of threads_outer_loop_ here, then use nested
-          // parallelization here. E.g. if we use 8 threads for the outer loop,
-          // but we have a total of 24 cores available, each of the 8 threads
-          // will then create a team of 3 threads to work on the batches
-          // individually.
-          //
-          // We should avoid oversubscribing the CPUs, therefore we use integer division.
-          // -- see https://docs.oracle.com/cd/E19059-01/stud.10/819-0501/2_nested.html
-          int outer_thread_nr = omp_get_thread_num();
-          omp_set_num_threads(std::max(1, total_nr_threads / threads_outer_loop_) );
+      // If we have a multiple of threads_outer_loop_ here, then use nested
+      // parallelization here. E.g. if we use 8 threads for the outer loop,
+      // but we have a total of 24 cores available, each of the 8 threads
+      // will then create a team of 3 threads to work on the batches
+      // individually.
+      //
+      // We should avoid oversubscribing the CPUs, therefore we use integer division.
+      // -- see https://docs.oracle.com/cd/E19059-01/stud.10/819-0501/2_nested.html
+      int outer_thread_nr = omp_get_thread_num();
+      omp_set_num_threads(std::max(1, total_nr_threads_ / threads_outer_loop_) );
 #pragma omp parallel for schedule(dynamic, 1)
 #endif
 #endif
-          for (SignedSize pep_idx = 0; pep_idx <= nr_batches; pep_idx++)
-          {
-            OpenSwath::SpectrumAccessPtr current_swath_map_inner = current_swath_map;
+      for (SignedSize pep_idx = 0; pep_idx <= nr_batches; pep_idx++)
+      {
+        Tracer::Scope batch_trace("SWATH window batch");
+        OpenSwath::SpectrumAccessPtr current_swath_map_inner = current_swath_map;
 
 #ifdef _OPENMP
 #ifdef MT_ENABLE_NESTED_OPENMP
-            // To ensure multi-threading safe access to the individual spectra, we
-            // need to use a light clone of the spectrum access (if multiple threads
-            // share a single filestream and call seek on it, chaos will ensue).
-            if (total_nr_threads / threads_outer_loop_ > 1)
-            {
-              current_swath_map_inner = current_swath_map->lightClone();
-            }
+        // To ensure multi-threading safe access to the individual spectra, we
+        // need to use a light clone of the spectrum access (if multiple threads
+        // share a single filestream and call seek on it, chaos will ensue).
+        if (total_nr_threads_ / threads_outer_loop_ > 1)
+        {
+          current_swath_map_inner = current_swath_map->lightClone();
+        }
 #endif
 #pragma omp critical (osw_write_stdout)
 #endif
-            {
-              std::cout << "Thread " <<
+        {
+          std::cout << "Thread " <<
 #ifdef _OPENMP
 #ifdef MT_ENABLE_NESTED_OPENMP
-              outer_thread_nr << "_" << omp_get_thread_num() << " " <<
+          outer_thread_nr << "_" << omp_get_thread_num() << " " <<
 #else
-              omp_get_thread_num() << "_0 " <<
+          omp_get_thread_num() << "_0 " <<
 #endif
 #else
-              "0" <<
+          "0" <<
 #endif
-              "will analyze " << transition_exp_used_all.getCompounds().size() <<  " compounds and "
-              << transition_exp_used_all.getTransitions().size() <<  " transitions "
-              "from SWATH " << i << " (batch " << pep_idx << " out of " << nr_batches << ")" << std::endl;
-            }
-
-            // Create the new, batch-size transition experiment
-            OpenSwath::LightTargetedExperiment transition_exp_used;
-            selectCompoundsForBatch_(transition_exp_used_all, transition_exp_used, batch_size, pep_idx);
-
-            // Extract MS1 chromatograms for this batch
-            std::vector< MSChromatogram > ms1_chromatograms;
-            if (ms1_map_ != nullptr)
-            {
-              OpenSwath::SpectrumAccessPtr threadsafe_ms1 = ms1_map_->lightClone();
-              MS1Extraction_(threadsafe_ms1, swath_maps, ms1_chromatograms, chromConsumer, ms1_cp,
-                  transition_exp_used, trafo_inverse, ms1_only, ms1_isotopes);
-            }
-
-            // Step 2.1: extract these transitions
-            ChromatogramExtractor extractor;
-            std::vector< OpenSwath::ChromatogramPtr > chrom_list;
-            std::vector< ChromatogramExtractor::ExtractionCoordinates > coordinates;
-
-            // Step 2.2: prepare the extraction coordinates and extract chromatograms
-            // chrom_list contains one entry for each fragment ion (transition) in transition_exp_used
-            prepareExtractionCoordinates_(chrom_list, coordinates, transition_exp_used, trafo_inverse, cp);
-            extractor.extractChromatograms(current_swath_map_inner, chrom_list, coordinates, cp.mz_extraction_window,
-                cp.ppm, cp.im_extraction_window, cp.extraction_function);
-
-            // Step 2.3: convert chromatograms back to OpenMS::MSChromatogram and write to output
-            PeakMap chrom_exp;
-            extractor.return_chromatogram(chrom_list, coordinates, transition_exp_used,  SpectrumSettings(),
-                                          chrom_exp.getChromatograms(), false, cp.im_extraction_window);
+          "will analyze " << transition_exp_used_all.getCompounds().size() <<  " compounds and "
+          << transition_exp_used_all.getTransitions().size() <<  " transitions "
+          "from SWATH " << swath_idx << " (batch " << pep_idx << " out of " << nr_batches << ")" << std::endl;
+        }
 
+        // Create the new, batch-size transition experiment
+        OpenSwath::LightTargetedExperiment transition_exp_used;
+        selectCompoundsForBatch_(transition_exp_used_all, transition_exp_used, batch_size, pep_idx);
+        batch_trace.addItems(transition_exp_used.getTransitions().size());
 
-            // Step 3: score these extracted transitions
-            FeatureMap featureFile;
-            std::vector< OpenSwath::SwathMap > tmp = {swath_maps[i]};
-            tmp.back().sptr = current_swath_map_inner;
-            scoreAllChromatograms_(chrom_exp.getChromatograms(), ms1_chromatograms, tmp, transition_exp_used,
-                feature_finder_param, trafo, cp.rt_extraction_window, featureFile, tsv_writer, osw_writer, ms1_isotopes);
+        // Extract MS1 chromatograms for this batch
+        std::vector< MSChromatogram > ms1_chromatograms;
+        if (ms1_map_ != nullptr)
+        {
+          OPENMS_TRACE_SCOPE("MS1 extraction");
+          OpenSwath::SpectrumAccessPtr threadsafe_ms1 = ms1_map_->lightClone();
+          MS1Extraction_(threadsafe_ms1, current_swath_maps, ms1_chromatograms, chromConsumer, ms1_cp,
+              transition_exp_used, trafo_inverse, ms1_only, ms1_isotopes);
+        }
 
-            // Step 4: write all chromatograms and features out into an output object / file
-            // (this needs to be done in a critical section since we only have one
-            // output file and one output map).
-            #pragma omp critical (osw_write_out)
-            {
-              writeOutFeaturesAndChroms_(chrom_exp.getChromatograms(), featureFile, out_featureFile, store_features, chromConsumer);
-            }
-          }
+        // Step 2.1: extract these transitions
+        ChromatogramExtractor extractor;
+        std::vector< OpenSwath::ChromatogramPtr > chrom_list;
+        std::vector< ChromatogramExtractor::ExtractionCoordinates > coordinates;
+        PeakMap chrom_exp;
+        {
+          Tracer::Scope extraction_trace("MS2 extraction");
+
+          // Step 2.2: prepare the extraction coordinates and extract chromatograms
+          // chrom_list contains one entry for each fragment ion (transition) in transition_exp_used
+          prepareExtractionCoordinates_(chrom_list, coordinates, transition_exp_used, trafo_inverse, cp);
+          extractor.extractChromatograms(current_swath_map_inner, chrom_list, coordinates, cp.mz_extraction_window,
+              cp.ppm, cp.im_extraction_window, cp.extraction_function);
+
+          // Step 2.3: convert chromatograms back to OpenMS::MSChromatogram and write to output
+          extractor.return_chromatogram(chrom_list, coordinates, transition_exp_used,  SpectrumSettings(),
+                                        chrom_exp.getChromatograms(), false, cp.im_extraction_window);
+          extraction_trace.addItems(chrom_list.size());
+        }
 
-        } // continue 2 (no continue due to OpenMP)
-      } // continue 1 (no continue due to OpenMP)
 
-      #pragma omp critical (progress)
-      this->setProgress(++progress);
+        // Step 3: score these extracted transitions
+        FeatureMap featureFile;
+        {
+          Tracer::Scope scoring_trace("scoring");
+          std::vector< OpenSwath::SwathMap > tmp = current_swath_maps;
+          tmp.back().sptr = current_swath_map_inner;
+          scoreAllChromatograms_(chrom_exp.getChromatograms(), ms1_chromatograms, tmp, transition_exp_used,
+              feature_finder_param, trafo, cp.rt_extraction_window, featureFile, tsv_writer, osw_writer, ms1_isotopes);
+          scoring_trace.addItems(featureFile.size());
+        }
 
-    }
-    this->endProgress();
+        // Step 4: write all chromatograms and features out into an output object / file
+        // (this needs to be done in a critical section since we only have one
+        // output file and one output map).
+        #pragma omp critical (osw_write_out)
+        {
+          writeOutFeaturesAndChroms_(chrom_exp.getChromatograms(), featureFile, out_featureFile, store_features, chromConsumer);
+        }
+      }
 
-#ifdef _OPENMP
-#ifdef MT_ENABLE_NESTED_OPENMP
-    if (threads_outer_loop_ > -1)
-    {
-      omp_set_num_threads(total_nr_threads); // set number of available threads back to initial value
-    }
-#endif
-#endif
+    } // continue 2 (no continue due to OpenMP)
   }
 
   void OpenSwathWorkflow::writeOutFeaturesAndChroms_(
@@ -40,6 +40,7 @@
 #include <boost/range/algorithm.hpp>
 #include <boost/range/algorithm_ext/erase.hpp>
 
+#include <functional>
 #include <sstream>
 #include <unordered_map>
 #include <iostream>
@@ -59,6 +60,26 @@ namespace OpenMS
   }
 
   void TransitionPQPFile::readPQPInput_(const char* filename, std::vector<TSVTransition>& transition_list, bool legacy_traml_id)
+  {
+    streamPQPInput_(filename, [&transition_list](TSVTransition& tr) { transition_list.push_back(tr); }, legacy_traml_id);
+  }
+
+  void TransitionPQPFile::streamPQPInput_(const char* filename,
+                                          const std::function<void (TSVTransition&)>& consumer,
+                                          bool legacy_traml_id,
+                                          double lower_mz,
+                                          double upper_mz)
+  {
+    // Open database
+    SqliteConnector conn(filename, SqliteConnector::SqlOpenMode::READONLY);
+    streamPQPInput_(conn, consumer, legacy_traml_id, lower_mz, upper_mz);
+  }
+
+  void TransitionPQPFile::streamPQPInput_(SqliteConnector& conn,
+                                          const std::function<void (TSVTransition&)>& consumer,
+                                          bool legacy_traml_id,
+                                          double lower_mz,
+                                          double upper_mz)
   {
     sqlite3 *db;
     sqlite3_stmt * cntstmt;
@@ -74,12 +95,26 @@ namespace OpenMS
 
     startProgress(0, 1, "reading PQP file (SQL warmup)");
 
-    // Open database
-    SqliteConnector conn(filename);
     db = conn.getDB();
 
+    // Restrict to a precursor m/z window (e.g. a single SWATH) if requested
+    String where_window = "";
+    String where_window_peptides = "";
+    String where_window_transitions = "";
+    if (lower_mz >= 0 && upper_mz >= 0)
+    {
+      String window_condition = "PRECURSOR.PRECURSOR_MZ > " + String(lower_mz) +
+                                " AND PRECURSOR.PRECURSOR_MZ < " + String(upper_mz) + " ";
+      where_window = "WHERE " + window_condition;
+      // the protein and peptidoform aggregates are only built for the peptides / transitions of the window
+      where_window_peptides = "WHERE PEPTIDE_PROTEIN_MAPPING.PEPTIDE_ID IN "                               "(SELECT PRECURSOR_PEPTIDE_MAPPING.PEPTIDE_ID FROM PRECURSOR_PEPTIDE_MAPPING "                               "INNER JOIN PRECURSOR ON PRECURSOR_PEPTIDE_MAPPING.PRECURSOR_ID = PRECURSOR.ID "                               "WHERE " + window_condition + ") ";
+      where_window_transitions = "WHERE TRANSITION_PEPTIDE_MAPPING.TRANSITION_ID IN "                                  "(SELECT TRANSITION_PRECURSOR_MAPPING.TRANSITION_ID FROM TRANSITION_PRECURSOR_MAPPING "                                  "INNER JOIN PRECURSOR ON TRANSITION_PRECURSOR_MAPPING.PRECURSOR_ID = PRECURSOR.ID "                                  "WHERE " + window_condition + ") ";
+    }
+
     // Count transitions
-    SqliteConnector::prepareStatement(db, &cntstmt, "SELECT COUNT(*) FROM TRANSITION;");
+    SqliteConnector::prepareStatement(db, &cntstmt, "SELECT COUNT(*) FROM TRANSITION " \
+        "INNER JOIN TRANSITION_PRECURSOR_MAPPING ON TRANSITION.ID = TRANSITION_PRECURSOR_MAPPING.TRANSITION_ID " \
+        "INNER JOIN PRECURSOR ON TRANSITION_PRECURSOR_MAPPING.PRECURSOR_ID = PRECURSOR.ID " + where_window + ";");
     sqlite3_step( cntstmt );
     int num_transitions = sqlite3_column_int(cntstmt, 0);
     sqlite3_finalize(cntstmt);
@@ -153,15 +188,18 @@ namespace OpenMS
                   "INNER JOIN " \
                     "(SELECT PEPTIDE_ID, GROUP_CONCAT(PROTEIN_ACCESSION,';') AS PROTEIN_ACCESSION " \
                     "FROM PROTEIN " \
-                    "INNER JOIN PEPTIDE_PROTEIN_MAPPING ON PROTEIN.ID = PEPTIDE_PROTEIN_MAPPING.PROTEIN_ID "\
+                    "INNER JOIN PEPTIDE_PROTEIN_MAPPING ON PROTEIN.ID = PEPTIDE_PROTEIN_MAPPING.PROTEIN_ID " +
+                    where_window_peptides +
                     "GROUP BY PEPTIDE_ID) " \
                     "AS PROTEIN_AGGREGATED ON PEPTIDE.ID = PROTEIN_AGGREGATED.PEPTIDE_ID " \
                   "LEFT OUTER JOIN " \
                     "(SELECT TRANSITION_ID, GROUP_CONCAT(MODIFIED_SEQUENCE,'|') AS PEPTIDOFORMS " \
                     "FROM TRANSITION_PEPTIDE_MAPPING "\
-                    "INNER JOIN PEPTIDE ON TRANSITION_PEPTIDE_MAPPING.PEPTIDE_ID = PEPTIDE.ID "\
+                    "INNER JOIN PEPTIDE ON TRANSITION_PEPTIDE_MAPPING.PEPTIDE_ID = PEPTIDE.ID " +
+                    where_window_transitions +
                     "GROUP BY TRANSITION_ID) "\
-                    "AS PEPTIDE_AGGREGATED ON TRANSITION.ID = PEPTIDE_AGGREGATED.TRANSITION_ID ";
+                    "AS PEPTIDE_AGGREGATED ON TRANSITION.ID = PEPTIDE_AGGREGATED.TRANSITION_ID " +
+                  where_window;
 
     // Get compounds
     select_sql += "UNION SELECT " \
@@ -200,7 +238,8 @@ namespace OpenMS
                   "INNER JOIN TRANSITION_PRECURSOR_MAPPING ON PRECURSOR.ID = TRANSITION_PRECURSOR_MAPPING.PRECURSOR_ID " \
                   "INNER JOIN TRANSITION ON TRANSITION_PRECURSOR_MAPPING.TRANSITION_ID = TRANSITION.ID " \
                   "INNER JOIN PRECURSOR_COMPOUND_MAPPING ON PRECURSOR.ID = PRECURSOR_COMPOUND_MAPPING.PRECURSOR_ID " \
-                  "INNER JOIN COMPOUND ON PRECURSOR_COMPOUND_MAPPING.COMPOUND_ID = COMPOUND.ID; ";
+                  "INNER JOIN COMPOUND ON PRECURSOR_COMPOUND_MAPPING.COMPOUND_ID = COMPOUND.ID " +
+                  where_window + "; ";
 
 
     // Execute SQL select statement
@@ -252,7 +291,7 @@ namespace OpenMS
 
       if (mytransition.GeneName == "NA") mytransition.GeneName = "";
 
-      transition_list.push_back(mytransition);
+      consumer(mytransition);
       sqlite3_step( stmt );
     }
     endProgress();
@@ -716,9 +755,29 @@ namespace OpenMS
                                                          OpenSwath::LightTargetedExperiment& targeted_exp,
                                                          bool legacy_traml_id)
   {
-    std::vector<TSVTransition> transition_list;
-    readPQPInput_(filename, transition_list, legacy_traml_id);
-    TSVToTargetedExperiment_(transition_list, targeted_exp);
+    // convert row by row, the full list of TSVTransition is never held in memory
+    LightConversionState state;
+    streamPQPInput_(filename, [&](TSVTransition& tr) { addLightTransition_(tr, targeted_exp, state); }, legacy_traml_id);
+  }
+
+  void TransitionPQPFile::convertPQPToTargetedExperiment(const char* filename,
+                                                         double lower_mz,
+                                                         double upper_mz,
+                                                         OpenSwath::LightTargetedExperiment& targeted_exp,
+                                                         bool legacy_traml_id)
+  {
+    LightConversionState state;
+    streamPQPInput_(filename, [&](TSVTransition& tr) { addLightTransition_(tr, targeted_exp, state); }, legacy_traml_id, lower_mz, upper_mz);
+  }
+
+  void TransitionPQPFile::convertPQPToTargetedExperiment(SqliteConnector& conn,
+                                                         double lower_mz,
+                                                         double upper_mz,
+                                                         OpenSwath::LightTargetedExperiment& targeted_exp,
+                                                         bool legacy_traml_id)
+  {
+    LightConversionState state;
+    streamPQPInput_(conn, [&](TSVTransition& tr) { addLightTransition_(tr, targeted_exp, state); }, legacy_traml_id, lower_mz, upper_mz);
   }
 
 }
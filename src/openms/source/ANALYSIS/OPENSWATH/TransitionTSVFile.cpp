@@ -630,14 +630,14 @@ namespace OpenMS
         if (tr_it->isPeptide())
         {
           OpenMS::TargetedExperiment::Peptide peptide;
-          createPeptide_(tr_it, peptide);
+          createPeptide_(*tr_it, peptide);
           peptides.push_back(peptide);
           peptide_map[peptide.id] = 0;
         }
         else
         {
           OpenMS::TargetedExperiment::Compound compound;
-          createCompound_(tr_it, compound);
+          createCompound_(*tr_it, compound);
           compounds.push_back(compound);
           compound_map[compound.id] = 0;
         }
@@ -674,121 +674,119 @@ namespace OpenMS
 
   void TransitionTSVFile::TSVToTargetedExperiment_(std::vector<TSVTransition>& transition_list, OpenSwath::LightTargetedExperiment& exp)
   {
-    std::map<String, int> compound_map;
-    std::map<String, int> protein_map;
-
-    resolveMixedSequenceGroups_(transition_list);
+    LightConversionState state;
+    exp.transitions.reserve(exp.transitions.size() + transition_list.size());
 
     Size progress = 0;
     startProgress(0, transition_list.size(), "conversion to internal data representation");
-    for (auto tr_it = transition_list.cbegin(); tr_it != transition_list.cend(); ++tr_it)
-    {
-      OpenSwath::LightTransition transition;
-      transition.transition_name  = tr_it->transition_name;
-      transition.peptide_ref  = tr_it->group_id;
-      transition.library_intensity  = tr_it->library_intensity;
-      transition.precursor_mz  = tr_it->precursor;
-      transition.product_mz  = tr_it->product;
-      transition.precursor_im = tr_it->drift_time;
-      transition.fragment_charge = 0; // use zero for charge that is not set
-      if (!tr_it->fragment_charge.empty() && tr_it->fragment_charge != "NA")
-      {
-        transition.fragment_charge = tr_it->fragment_charge.toInt();
-      }
+    for (auto& tr : transition_list)
+    {
+      addLightTransition_(tr, exp, state);
+      setProgress(progress++);
+    }
+    endProgress();
+
+    OPENMS_POSTCONDITION(exp.transitions.size() == transition_list.size(), "Input and output list need to have equal size.")
+  }
+
+  void TransitionTSVFile::addLightTransition_(TSVTransition& tr, OpenSwath::LightTargetedExperiment& exp, LightConversionState& state)
+  {
+    resolveMixedSequenceGroup_(tr, state.label_sequences);
+
+    OpenSwath::LightTransition transition;
+    transition.transition_name  = tr.transition_name;
+    transition.peptide_ref  = tr.group_id;
+    transition.library_intensity  = tr.library_intensity;
+    transition.precursor_mz  = tr.precursor;
+    transition.product_mz  = tr.product;
+    transition.precursor_im = tr.drift_time;
+    transition.fragment_charge = 0; // use zero for charge that is not set
+    if (!tr.fragment_charge.empty() && tr.fragment_charge != "NA")
+    {
+      transition.fragment_charge = tr.fragment_charge.toInt();
+    }
 
-      transition.decoy = tr_it->decoy;
-      transition.detecting_transition = tr_it->detecting_transition;
-      transition.identifying_transition = tr_it->identifying_transition;
-      transition.quantifying_transition = tr_it->quantifying_transition;
+    transition.decoy = tr.decoy;
+    transition.detecting_transition = tr.detecting_transition;
+    transition.identifying_transition = tr.identifying_transition;
+    transition.quantifying_transition = tr.quantifying_transition;
 
-      exp.transitions.push_back(transition);
+    exp.transitions.push_back(transition);
 
-      // check whether we need a new compound
-      if (compound_map.find(tr_it->group_id) == compound_map.end())
+    // check whether we need a new compound
+    if (state.compounds.insert(tr.group_id).second)
+    {
+      OpenSwath::LightCompound compound;
+      if (tr.isPeptide())
       {
-        OpenSwath::LightCompound compound;
-        if (tr_it->isPeptide())
-        {
-          OpenMS::TargetedExperiment::Peptide tramlpeptide;
-          createPeptide_(tr_it, tramlpeptide);
-          OpenSwathDataAccessHelper::convertTargetedCompound(tramlpeptide, compound);
-        }
-        else
-        {
-          OpenMS::TargetedExperiment::Compound tramlcompound;
-          createCompound_(tr_it, tramlcompound);
-          OpenSwathDataAccessHelper::convertTargetedCompound(tramlcompound, compound);
-        }
-        exp.compounds.push_back(compound);
-        compound_map[compound.id] = 0;
+        OpenMS::TargetedExperiment::Peptide tramlpeptide;
+        createPeptide_(tr, tramlpeptide);
+        OpenSwathDataAccessHelper::convertTargetedCompound(tramlpeptide, compound);
+      }
+      else
+      {
+        OpenMS::TargetedExperiment::Compound tramlcompound;
+        createCompound_(tr, tramlcompound);
+        OpenSwathDataAccessHelper::convertTargetedCompound(tramlcompound, compound);
       }
+      exp.compounds.push_back(compound);
+    }
 
-      // check whether we need new proteins
-      for (Size i = 0; i < tr_it->ProteinName.size(); ++i)
+    // check whether we need new proteins
+    if (tr.isPeptide())
+    {
+      for (const auto& protein_name : tr.ProteinName)
       {
-        if (tr_it->isPeptide() && protein_map.find(tr_it->ProteinName[i]) == protein_map.end())
+        if (state.proteins.insert(protein_name).second)
         {
           OpenSwath::LightProtein protein;
-          protein.id = tr_it->ProteinName[i];
+          protein.id = protein_name;
           protein.sequence = "";
           exp.proteins.push_back(protein);
-          protein_map[tr_it->ProteinName[i]] = 0;
         }
       }
-
-      setProgress(progress++);
     }
-    endProgress();
-
-    OPENMS_POSTCONDITION(exp.transitions.size() == transition_list.size(), "Input and output list need to have equal size.")
   }
 
   void TransitionTSVFile::resolveMixedSequenceGroups_(std::vector<TransitionTSVFile::TSVTransition>& transition_list) const
   {
-    // Create temporary map by group label
-    std::map<String, std::vector<TSVTransition*> > label_transition_map;
-    for (auto & tr_it : transition_list)
+    std::unordered_map<std::string, std::string> label_sequences;
+    for (auto & tr : transition_list)
     {
-      if (!tr_it.peptide_group_label.empty())
-      {
-        label_transition_map[tr_it.peptide_group_label].push_back(&tr_it);
-      }
+      resolveMixedSequenceGroup_(tr, label_sequences);
+    }
+  }
+
+  void TransitionTSVFile::resolveMixedSequenceGroup_(TSVTransition& tr, std::unordered_map<std::string, std::string>& label_sequences) const
+  {
+    if (tr.peptide_group_label.empty())
+    {
+      return;
     }
 
-    // Iterate through all the group labels and perform sanity check whether
-    // the peptide sequence is the same for all of them
-    for (auto & pep_it : label_transition_map)
+    // the first transition seen for a group label defines its sequence
+    auto seq_it = label_sequences.emplace(tr.peptide_group_label, tr.PeptideSequence).first;
+    const String& curr_sequence = seq_it->second;
+
+    // Sanity check: different peptide sequence in the same peptide label
+    // group means that something is probably wrong ...
+    if (!curr_sequence.empty() && tr.PeptideSequence != curr_sequence)
     {
-      String curr_sequence;
-      if (!pep_it.second.empty())
-      { 
-        curr_sequence = (*pep_it.second.begin())->PeptideSequence;
+      if (override_group_label_check_)
+      {
+        // We wont fix it but give out a warning
+        OPENMS_LOG_WARN << "Warning: Found multiple peptide sequences for peptide label group " << tr.peptide_group_label <<
+          ". Since 'override_group_label_check' is on, nothing will be changed." << std::endl;
       }
-
-      for (auto & tr_it : pep_it.second)
+      else
       {
-        // Sanity check: different peptide sequence in the same peptide label
-        // group means that something is probably wrong ...
-        if (!curr_sequence.empty() && tr_it->PeptideSequence != curr_sequence)
-        {
-          if (override_group_label_check_)
-          {
-            // We wont fix it but give out a warning
-            OPENMS_LOG_WARN << "Warning: Found multiple peptide sequences for peptide label group " << pep_it.first << 
-              ". Since 'override_group_label_check' is on, nothing will be changed." << std::endl;
-          }
-          else
-          {
-            // Lets fix it and inform the user
-            OPENMS_LOG_WARN << "Warning: Found multiple peptide sequences for peptide label group " << pep_it.first << 
-              ". This is most likely an error and to fix this, a new peptide label group will be inferred - " << 
-              "to override this decision, please use the override_group_label_check parameter." << std::endl;
-            tr_it->peptide_group_label = tr_it->group_id;
-          }
-        }
+        // Lets fix it and inform the user
+        OPENMS_LOG_WARN << "Warning: Found multiple peptide sequences for peptide label group " << tr.peptide_group_label <<
+          ". This is most likely an error and to fix this, a new peptide label group will be inferred - " <<
+          "to override this decision, please use the override_group_label_check parameter." << std::endl;
+        tr.peptide_group_label = tr.group_id;
       }
     }
-
   }
 
   void TransitionTSVFile::createTransition_(std::vector<TSVTransition>::iterator& tr_it, OpenMS::ReactionMonitoringTransition& rm_trans)
@@ -1026,7 +1024,7 @@ namespace OpenMS
     retention_times.push_back(retention_time);
   }
 
-  void TransitionTSVFile::createPeptide_(std::vector<TSVTransition>::const_iterator tr_it, OpenMS::TargetedExperiment::Peptide& peptide)
+  void TransitionTSVFile::createPeptide_(const TSVTransition& tr, OpenMS::TargetedExperiment::Peptide& peptide)
   {
     // the following attributes will be stored as meta values (userParam):
     //  - full_peptide_name (full unimod peptide name)
@@ -1038,41 +1036,41 @@ namespace OpenMS
     // - id
     // - sequence
 
-    peptide.id = tr_it->group_id;
-    peptide.sequence = tr_it->PeptideSequence;
+    peptide.id = tr.group_id;
+    peptide.sequence = tr.PeptideSequence;
 
     // per peptide user params
-    peptide.setMetaValue("full_peptide_name", tr_it->FullPeptideName);
-    if (!tr_it->label_type.empty())
+    peptide.setMetaValue("full_peptide_name", tr.FullPeptideName);
+    if (!tr.label_type.empty())
     {
-      peptide.setMetaValue("LabelType", tr_it->label_type);
+      peptide.setMetaValue("LabelType", tr.label_type);
     }
-    if (!tr_it->GeneName.empty())
+    if (!tr.GeneName.empty())
     {
-      peptide.setMetaValue("GeneName", tr_it->GeneName);
+      peptide.setMetaValue("GeneName", tr.GeneName);
     }
-    if (!tr_it->SumFormula.empty())
+    if (!tr.SumFormula.empty())
     {
-      peptide.setMetaValue("SumFormula", tr_it->SumFormula);
+      peptide.setMetaValue("SumFormula", tr.SumFormula);
     }
 
     // per peptide CV terms
-    peptide.setPeptideGroupLabel(tr_it->peptide_group_label);
-    if (!tr_it->precursor_charge.empty() && tr_it->precursor_charge != "NA")
+    peptide.setPeptideGroupLabel(tr.peptide_group_label);
+    if (!tr.precursor_charge.empty() && tr.precursor_charge != "NA")
     {
-      peptide.setChargeState(tr_it->precursor_charge.toInt());
+      peptide.setChargeState(tr.precursor_charge.toInt());
     }
 
     // add retention time for the peptide
     std::vector<TargetedExperiment::RetentionTime> retention_times;
-    OpenMS::DataValue rt_value(tr_it->rt_calibrated);
+    OpenMS::DataValue rt_value(tr.rt_calibrated);
     interpretRetentionTime_(retention_times, rt_value);
     peptide.rts = retention_times;
 
     // add ion mobility drift time
-    if (tr_it->drift_time >= 0.0)
+    if (tr.drift_time >= 0.0)
     {
-      peptide.setDriftTime(tr_it->drift_time);
+      peptide.setDriftTime(tr.drift_time);
     }
 
     // Try to parse full UniMod string including modifications. If the string
@@ -1082,8 +1080,8 @@ namespace OpenMS
     // fall back to the "naked" sequence by default.
     std::vector<TargetedExperiment::Peptide::Modification> mods;
     AASequence aa_sequence;
-    String sequence = tr_it->FullPeptideName;
-    if (sequence.empty()) sequence = tr_it->PeptideSequence;
+    String sequence = tr.FullPeptideName;
+    if (sequence.empty()) sequence = tr.PeptideSequence;
     try
     {
       aa_sequence = AASequence::fromString(sequence);
@@ -1092,19 +1090,19 @@ namespace OpenMS
       if (force_invalid_mods_)
       {
         // fallback: parse the "naked" peptide sequence which should always work
-        OPENMS_LOG_DEBUG << "Invalid sequence when parsing '" << tr_it->FullPeptideName << "'" << std::endl;
-        aa_sequence = AASequence::fromString(tr_it->PeptideSequence);
+        OPENMS_LOG_DEBUG << "Invalid sequence when parsing '" << tr.FullPeptideName << "'" << std::endl;
+        aa_sequence = AASequence::fromString(tr.PeptideSequence);
       }
       else
       {
-        OPENMS_LOG_DEBUG << "Invalid sequence when parsing '" << tr_it->FullPeptideName << "'" << std::endl;
+        OPENMS_LOG_DEBUG << "Invalid sequence when parsing '" << tr.FullPeptideName << "'" << std::endl;
         std::cerr << "Error while reading file (use 'force_invalid_mods' parameter to override): " << e.what() << std::endl;
         throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-            "Invalid input, cannot parse: " + tr_it->FullPeptideName);
+            "Invalid input, cannot parse: " + tr.FullPeptideName);
       }
     }
 
-    peptide.protein_refs = tr_it->ProteinName;
+    peptide.protein_refs = tr.ProteinName;
 
     // check if the naked peptide sequence is equal to the unmodified AASequence
     if (peptide.sequence != aa_sequence.toUnmodifiedString())
@@ -1152,7 +1150,7 @@ namespace OpenMS
                           + aa_sequence.toUnmodifiedString() + " != " + peptide.sequence).c_str())
   }
 
-  void TransitionTSVFile::createCompound_(std::vector<TSVTransition>::const_iterator tr_it, OpenMS::TargetedExperiment::Compound& compound)
+  void TransitionTSVFile::createCompound_(const TSVTransition& tr, OpenMS::TargetedExperiment::Compound& compound)
   {
     // the following attributes will be stored as meta values (userParam):
     //  - CompoundName (name of the compound)
@@ -1165,33 +1163,33 @@ namespace OpenMS
     // - SMILES
     // - id
 
-    compound.id = tr_it->group_id;
+    compound.id = tr.group_id;
 
-    compound.molecular_formula = tr_it->SumFormula;
-    compound.smiles_string = tr_it->SMILES;
-    compound.setMetaValue("CompoundName", tr_it->CompoundName);
-    if (!tr_it->Adducts.empty()) compound.setMetaValue("Adducts", tr_it->Adducts);
+    compound.molecular_formula = tr.SumFormula;
+    compound.smiles_string = tr.SMILES;
+    compound.setMetaValue("CompoundName", tr.CompoundName);
+    if (!tr.Adducts.empty()) compound.setMetaValue("Adducts", tr.Adducts);
 
     // does this apply to compounds as well?
-    if (!tr_it->label_type.empty())
+    if (!tr.label_type.empty())
     {
-      compound.setMetaValue("LabelType", tr_it->label_type);
+      compound.setMetaValue("LabelType", tr.label_type);
     }
 
     // add ion mobility drift time
-    if (tr_it->drift_time >= 0.0)
+    if (tr.drift_time >= 0.0)
     {
-      compound.setDriftTime(tr_it->drift_time);
+      compound.setDriftTime(tr.drift_time);
     }
 
-    if (!tr_it->precursor_charge.empty() && tr_it->precursor_charge != "NA")
+    if (!tr.precursor_charge.empty() && tr.precursor_charge != "NA")
     {
-      compound.setChargeState(tr_it->precursor_charge.toInt());
+      compound.setChargeState(tr.precursor_charge.toInt());
     }
 
     // add retention time for the compound
     std::vector<TargetedExperiment::RetentionTime> retention_times;
-    OpenMS::DataValue rt_value(tr_it->rt_calibrated);
+    OpenMS::DataValue rt_value(tr.rt_calibrated);
     interpretRetentionTime_(retention_times, rt_value);
     compound.rts = retention_times;
   }
@@ -58,25 +58,6 @@ namespace OpenMS
     // initialize empty vector for the results
     vector<OPXLDataStructs::XLPrecursor> mass_to_candidates;
 
-    double max_precursor = spectrum_precursors[spectrum_precursors.size()-1];
-
-    Size peptides_size = peptides.size();
-
-    // compute a very conservative total upper bound, based on the heaviest possible linear peptide
-    // can be used instead of peptides.end() in all cases for this precursor mass
-    vector<OPXLDataStructs::AASeqWithMass>::const_iterator conservative_upper_bound = upper_bound(peptides.cbegin(), peptides.cend(), max_precursor, OPXLDataStructs::AASeqWithMassComparator());
-
-    // initialize additional iterators
-    // the upper bounds for a precursor mass can be used as the lower bounds
-    // for the next heavier precursor mass, narrowing down the search space for new bounds
-    vector<OPXLDataStructs::AASeqWithMass>::const_iterator first_loop = peptides.cbegin();
-    vector<OPXLDataStructs::AASeqWithMass>::const_iterator last_loop = peptides.cbegin();
-
-    vector<OPXLDataStructs::AASeqWithMass>::const_iterator first_mono = peptides.cbegin();
-    vector<OPXLDataStructs::AASeqWithMass>::const_iterator last_mono = peptides.cbegin();
-
-    vector<OPXLDataStructs::AASeqWithMass>::const_iterator last_alpha = peptides.cbegin();
-
     for (Size pm = 0; pm < spectrum_precursors.size(); ++pm)
     {
       double precursor_mass = spectrum_precursors[pm];
@@ -91,151 +72,165 @@ namespace OpenMS
         allowed_error = precursor_mass_tolerance;
       }
 
-      // ################################ Enumerate Loop-Links #################
-      // The largest peptides given a fixed precursor mass are possible with loop links
-      double min_peptide_mass = precursor_mass - cross_link_mass - allowed_error;
-      double max_peptide_mass = precursor_mass - cross_link_mass + allowed_error;
+      Size old_size = mass_to_candidates.size();
+      enumerateCrossLinksInWindow(peptides, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, precursor_mass, allowed_error, mass_to_candidates);
+      precursor_correction_positions.insert(precursor_correction_positions.end(), mass_to_candidates.size() - old_size, static_cast<int>(pm));
+    } // end of loop over precursor masses
+    return mass_to_candidates;
+  }
+
+  void OPXLHelper::enumerateCrossLinksInWindow(const vector<OPXLDataStructs::AASeqWithMass>& peptides, double cross_link_mass, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, double precursor_mass, double allowed_error, vector<OPXLDataStructs::XLPrecursor>& candidates)
+  {
+    if (peptides.empty())
+    {
+      return;
+    }
+
+    const Size peptides_size = peptides.size();
 
-      first_loop = lower_bound(first_loop, conservative_upper_bound, min_peptide_mass, OPXLDataStructs::AASeqWithMassComparator());
-      last_loop = upper_bound(last_loop, conservative_upper_bound, max_peptide_mass, OPXLDataStructs::AASeqWithMassComparator());
+    // ################################ Enumerate Loop-Links #################
+    // The largest peptides given a fixed precursor mass are possible with loop links
+    double min_peptide_mass = precursor_mass - cross_link_mass - allowed_error;
+    double max_peptide_mass = precursor_mass - cross_link_mass + allowed_error;
 
-      int first_index = first_loop - peptides.cbegin();
-      int last_index = last_loop - peptides.cbegin();
+    SignedSize first_index = lower_bound(peptides.cbegin(), peptides.cend(), min_peptide_mass, OPXLDataStructs::AASeqWithMassComparator()) - peptides.cbegin();
+    SignedSize last_index = upper_bound(peptides.cbegin() + first_index, peptides.cend(), max_peptide_mass, OPXLDataStructs::AASeqWithMassComparator()) - peptides.cbegin();
 
-#pragma omp parallel for
-      for (int p1 = first_index; p1 < last_index; ++p1)
+    for (SignedSize p1 = first_index; p1 < last_index; ++p1)
+    {
+      const String& seq_first = peptides[p1].unmodified_seq;
+      // test if this peptide could have loop-links: one cross-link with both sides attached to the same peptide
+      bool first_res = false; // is there a residue the first side of the linker can attach to?
+      bool second_res = false; // is there a residue the second side of the linker can attach to?
+      for (Size k = 0; k + 1 < seq_first.size(); ++k)
       {
-        const String& seq_first = peptides[p1].unmodified_seq;
-        // test if this peptide could have loop-links: one cross-link with both sides attached to the same peptide
-        bool first_res = false; // is there a residue the first side of the linker can attach to?
-        bool second_res = false; // is there a residue the second side of the linker can attach to?
-        for (Size k = 0; k < seq_first.size()-1; ++k)
+        for (Size i = 0; i < cross_link_residue1.size(); ++i)
         {
-         for (Size i = 0; i < cross_link_residue1.size(); ++i)
-         {
-           if (cross_link_residue1[i].size() == 1 && string(1, seq_first[k]) == cross_link_residue1[i])
-           {
-             first_res = true;
-           }
-         }
-         for (Size i = 0; i < cross_link_residue2.size(); ++i)
-         {
-           if (cross_link_residue2[i].size() == 1 && string(1, seq_first[k]) == cross_link_residue2[i])
-           {
-             second_res = true;
-           }
-         }
+          if (cross_link_residue1[i].size() == 1 && seq_first[k] == cross_link_residue1[i][0])
+          {
+            first_res = true;
+          }
         }
-
-        // If both sides of a cross-linker can link to this peptide, generate the loop-link
-        if (first_res && second_res)
+        for (Size i = 0; i < cross_link_residue2.size(); ++i)
         {
-         // Monoisotopic weight of the peptide + cross-linker
-         double cross_linked_peptide_mass = peptides[p1].peptide_mass + cross_link_mass;
-
-         // also only one peptide
-         OPXLDataStructs::XLPrecursor precursor;
-         precursor.precursor_mass = cross_linked_peptide_mass;
-         precursor.alpha_index = p1;
-         precursor.beta_index = peptides_size + 1; // an out-of-range index to represent an empty index
-         precursor.alpha_seq = seq_first;
-         precursor.beta_seq = "";
-
-#pragma omp critical (mass_to_candidates_access)
-         {
-           mass_to_candidates.push_back(precursor);
-           precursor_correction_positions.push_back(pm);
-         }
+          if (cross_link_residue2[i].size() == 1 && seq_first[k] == cross_link_residue2[i][0])
+          {
+            second_res = true;
+          }
         }
-      } // end of parallel loop over loop-link candidates
+      }
 
-      // ################################ Enumerate Mono-Links #################
-      for (Size i = 0; i < cross_link_mass_mono_link.size(); i++)
-      {
-        double mono_link_mass = cross_link_mass_mono_link[i];
+      // If both sides of a cross-linker can link to this peptide, generate the loop-link
+      if (first_res && second_res)
+      {
+        // also only one peptide
+        OPXLDataStructs::XLPrecursor precursor;
+        precursor.precursor_mass = peptides[p1].peptide_mass + cross_link_mass;
+        precursor.alpha_index = p1;
+        precursor.beta_index = peptides_size + 1; // an out-of-range index to represent an empty index
+        precursor.alpha_seq = seq_first;
+        precursor.beta_seq = "";
+        candidates.push_back(precursor);
+      }
+    }
 
-        min_peptide_mass = precursor_mass - mono_link_mass - allowed_error;
-        max_peptide_mass = precursor_mass - mono_link_mass + allowed_error;
+    // ################################ Enumerate Mono-Links #################
+    for (Size i = 0; i < cross_link_mass_mono_link.size(); i++)
+    {
+      double mono_link_mass = cross_link_mass_mono_link[i];
 
-        // mono-link masses are sorted in descending order
-        // so we can use the results from the last search as a new lower bounds for both searches again
-        first_mono = lower_bound(first_mono, conservative_upper_bound, min_peptide_mass, OPXLDataStructs::AASeqWithMassComparator());
-        last_mono = upper_bound(last_mono, conservative_upper_bound, max_peptide_mass, OPXLDataStructs::AASeqWithMassComparator());
+      min_peptide_mass = precursor_mass - mono_link_mass - allowed_error;
+      max_peptide_mass = precursor_mass - mono_link_mass + allowed_error;
 
-        first_index = first_mono - peptides.cbegin();
-        last_index = last_mono - peptides.cbegin();
+      first_index = lower_bound(peptides.cbegin(), peptides.cend(), min_peptide_mass, OPXLDataStructs::AASeqWithMassComparator()) - peptides.cbegin();
+      last_index = upper_bound(peptides.cbegin() + first_index, peptides.cend(), max_peptide_mass, OPXLDataStructs::AASeqWithMassComparator()) - peptides.cbegin();
 
-#pragma omp parallel for
-        for (int p1 = first_index; p1 < last_index; ++p1)
-        {
-          // Monoisotopic weight of the peptide + cross-linker
-          double cross_linked_peptide_mass = peptides[p1].peptide_mass + mono_link_mass;
+      for (SignedSize p1 = first_index; p1 < last_index; ++p1)
+      {
+        // Make sure it is clear only one peptide is considered here. Use an out-of-range value for the second peptide.
+        OPXLDataStructs::XLPrecursor precursor;
+        precursor.precursor_mass = peptides[p1].peptide_mass + mono_link_mass;
+        precursor.alpha_index = p1;
+        precursor.beta_index = peptides_size + 1; // an out-of-range index to represent an empty index
+        precursor.alpha_seq = peptides[p1].unmodified_seq;
+        precursor.beta_seq = "";
+        candidates.push_back(precursor);
+      }
+    }
 
-          // Make sure it is clear only one peptide is considered here. Use an out-of-range value for the second peptide.
-          OPXLDataStructs::XLPrecursor precursor;
-          precursor.precursor_mass = cross_linked_peptide_mass;
-          precursor.alpha_index = p1;
-          precursor.beta_index = peptides_size + 1; // an out-of-range index to represent an empty index
-          precursor.alpha_seq = peptides[p1].unmodified_seq;
-          precursor.beta_seq = "";
-
-#pragma omp critical (mass_to_candidates_access)
-         {
-           mass_to_candidates.push_back(precursor);
-           precursor_correction_positions.push_back(pm);
-         }
-        } // end of loop over candidates for a specific mono-link mass
-      } // end of loop over mono-link masses
-
-      // ################################ Enumerate Cross-Links #################
-      // constrain the conservative upper bound even more,
-      // because we have to fit in two peptides this time
-      // maximal mass: difference between precursor mass and the smallest peptide + cross-linker
-      max_peptide_mass = precursor_mass - cross_link_mass - peptides[0].peptide_mass + allowed_error;
-      last_alpha = upper_bound(last_alpha, conservative_upper_bound, max_peptide_mass, OPXLDataStructs::AASeqWithMassComparator());
-      int last_alpha_index = last_alpha - peptides.cbegin();
+    // ################################ Enumerate Cross-Links #################
+    // the mass both peptides have to add up to
+    const double pair_mass = precursor_mass - cross_link_mass;
 
-#pragma omp parallel for
-      for (int p1 = 0; p1 < last_alpha_index; ++p1)
-      {
-        // Constrain search for beta
-        double min_peptide_mass_beta = precursor_mass - cross_link_mass - peptides[p1].peptide_mass - allowed_error;
-        double max_peptide_mass_beta = precursor_mass - cross_link_mass - peptides[p1].peptide_mass + allowed_error;
+    // maximal mass of beta: difference between precursor mass and the smallest peptide + cross-linker
+    const SignedSize last_beta_bound = upper_bound(peptides.cbegin(), peptides.cend(), pair_mass - peptides[0].peptide_mass + allowed_error, OPXLDataStructs::AASeqWithMassComparator()) - peptides.cbegin();
+    // alpha is never heavier than beta, so it can be at most half of the pair mass
+    const SignedSize last_alpha_index = upper_bound(peptides.cbegin(), peptides.cbegin() + last_beta_bound, (pair_mass + allowed_error) / 2.0, OPXLDataStructs::AASeqWithMassComparator()) - peptides.cbegin();
 
-        // the last_alpha upper bound is also a conservative upper bound here
-        vector<OPXLDataStructs::AASeqWithMass>::const_iterator first_beta = lower_bound(peptides.cbegin()+p1, last_alpha, min_peptide_mass_beta, OPXLDataStructs::AASeqWithMassComparator());
-        vector<OPXLDataStructs::AASeqWithMass>::const_iterator last_beta = upper_bound(peptides.cbegin()+p1, last_alpha, max_peptide_mass_beta, OPXLDataStructs::AASeqWithMassComparator());
+    // The beta window [pair_mass - alpha - error, pair_mass - alpha + error] moves towards lighter peptides
+    // with every heavier alpha, so it can be tracked with two pointers instead of a binary search per alpha.
+    // Every thread scans a contiguous block of alphas and collects its pairs in a separate buffer.
+    // The buffers are concatenated in thread order, which gives the same ordering as a sequential scan.
+    std::vector< std::vector<OPXLDataStructs::XLPrecursor> > thread_candidates(1);
 
-        if (first_beta == last_beta)
-        {
-          continue;
-        }
+#ifdef _OPENMP
+#pragma omp parallel if(last_alpha_index > 1000)
+#endif
+    {
+      Size thread_num = 0;
+#ifdef _OPENMP
+#pragma omp single
+      thread_candidates.resize(omp_get_num_threads());
+      thread_num = omp_get_thread_num();
+#endif
+      std::vector<OPXLDataStructs::XLPrecursor>& local_candidates = thread_candidates[thread_num];
+      SignedSize first_beta = -1; // lazily initialized by the first alpha of this thread's block
+      SignedSize last_beta = -1;
 
-        Size first_beta_index = first_beta - peptides.begin();
-        Size last_beta_index = last_beta - peptides.begin();
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+      for (SignedSize p1 = 0; p1 < last_alpha_index; ++p1)
+      {
+        double min_peptide_mass_beta = pair_mass - peptides[p1].peptide_mass - allowed_error;
+        double max_peptide_mass_beta = pair_mass - peptides[p1].peptide_mass + allowed_error;
 
-        for (Size p2 = first_beta_index; p2 < last_beta_index; ++p2)
+        if (first_beta < 0)
         {
-          // Monoisotopic weight of the first peptide + the second peptide + cross-linker
-          double cross_linked_pair_mass = peptides[p1].peptide_mass + peptides[p2].peptide_mass + cross_link_mass;
+          first_beta = lower_bound(peptides.cbegin(), peptides.cbegin() + last_beta_bound, min_peptide_mass_beta, OPXLDataStructs::AASeqWithMassComparator()) - peptides.cbegin();
+          last_beta = upper_bound(peptides.cbegin() + first_beta, peptides.cbegin() + last_beta_bound, max_peptide_mass_beta, OPXLDataStructs::AASeqWithMassComparator()) - peptides.cbegin();
+        }
+        else
+        {
+          while (first_beta > 0 && peptides[first_beta - 1].peptide_mass >= min_peptide_mass_beta)
+          {
+            --first_beta;
+          }
+          while (last_beta > 0 && peptides[last_beta - 1].peptide_mass > max_peptide_mass_beta)
+          {
+            --last_beta;
+          }
+        }
 
+        // only consider pairs with alpha <= beta, to avoid enumerating every pair twice
+        for (SignedSize p2 = std::max(first_beta, p1); p2 < last_beta; ++p2)
+        {
           // this time both peptides have valid indices
           OPXLDataStructs::XLPrecursor precursor;
-          precursor.precursor_mass = cross_linked_pair_mass;
+          precursor.precursor_mass = peptides[p1].peptide_mass + peptides[p2].peptide_mass + cross_link_mass;
           precursor.alpha_index = p1;
           precursor.beta_index = p2;
           precursor.alpha_seq = peptides[p1].unmodified_seq;
           precursor.beta_seq = peptides[p2].unmodified_seq;
+          local_candidates.push_back(precursor);
+        }
+      }
+    }
 
-#pragma omp critical (mass_to_candidates_access)
-         {
-           mass_to_candidates.push_back(precursor);
-           precursor_correction_positions.push_back(pm);
-         }
-        } // end of loop over betas
-      } // end of parallel loop over alphas
-    } // end of loop over precursor masses
-    return mass_to_candidates;
+    for (std::vector<OPXLDataStructs::XLPrecursor>& local_candidates : thread_candidates)
+    {
+      candidates.insert(candidates.end(), std::make_move_iterator(local_candidates.begin()), std::make_move_iterator(local_candidates.end()));
+    }
   }
 
   std::vector<OPXLDataStructs::AASeqWithMass> OPXLHelper::digestDatabase(
@@ -59,6 +59,7 @@
 #include <OpenMS/SYSTEM/ExternalProcess.h>
 #include <OpenMS/SYSTEM/File.h>
 #include <OpenMS/SYSTEM/StopWatch.h>
+#include <OpenMS/SYSTEM/Tracer.h>
 #include <OpenMS/SYSTEM/SysInfo.h>
 #include <OpenMS/SYSTEM/UpdateCheck.h>
 
@@ -202,6 +203,7 @@ namespace OpenMS
     registerStringOption_("write_ini", "<file>", "", "Writes the default configuration file", false);
     registerStringOption_("write_ctd", "<out_dir>", "", "Writes the common tool description file(s) (Toolname(s).ctd) to <out_dir>", false, true);
     registerFlag_("no_progress", "Disables progress logging to command line", true);
+    registerStringOption_("profile", "<file>", "", "Writes a performance profile (time, CPU, memory and items per algorithm stage) to this file. Use '.json' for Chrome trace format (chrome://tracing, Perfetto), any other extension for folded stacks (flame graph tools)", false, true);
     registerFlag_("force", "Overrides tool-specific checks", true);
     registerFlag_("test", "Enables the test mode (needed for internal use only)", true);
     registerFlag_("-help", "Shows options");
@@ -447,10 +449,28 @@ namespace OpenMS
       //----------------------------------------------------------
       //main
       //----------------------------------------------------------
+      const String profile = getStringOption_("profile");
+      if (!profile.empty())
+      {
+        Tracer::getInstance().setEnabled(true);
+      }
       StopWatch sw;
       sw.start();
-      result = main_(argc, argv);
+      {
+        OPENMS_TRACE_SCOPE(tool_name_);
+        result = main_(argc, argv);
+      }
       sw.stop();
+      if (!profile.empty())
+      {
+        Tracer::getInstance().setEnabled(false);
+        Tracer::getInstance().store(profile);
+        if (Tracer::getInstance().getNrDroppedRecords() != 0 && profile.hasSuffix(".json"))
+        {
+          writeLog_("Warning: the profile trace only contains the first " + String(Tracer::getInstance().getMaxRecords()) + " regions.");
+        }
+        writeDebug_("Profile:\n" + Tracer::getInstance().toString(), 1);
+      }
       // useful for benchmarking and for execution on clusters with schedulers
       String mem_usage;
       {
@@ -0,0 +1,302 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopePatternCache.h>
+
+#include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <fstream>
+#include <iomanip>
+
+namespace OpenMS
+{
+  namespace
+  {
+    // first line of a stored table
+    const char* const table_header = "# OpenMS isotope pattern table";
+
+    // average compositions (C, H, N, O, S, P), same as in CoarseIsotopePatternGenerator::estimateFrom...Weight
+    const double averagine_peptide[6] = {4.9384, 7.7583, 1.3577, 1.4773, 0.0417, 0};
+    const double averagine_rna[6] = {9.75, 12.25, 3.75, 7, 0, 1};
+    const double averagine_dna[6] = {9.75, 12.25, 3.75, 6, 0, 1};
+
+    const double* averagineComposition(IsotopePatternCache::Averagine averagine)
+    {
+      switch (averagine)
+      {
+        case IsotopePatternCache::Averagine::RNA: return averagine_rna;
+        case IsotopePatternCache::Averagine::DNA: return averagine_dna;
+        default: return averagine_peptide;
+      }
+    }
+  }
+
+  IsotopePatternCache::IsotopePatternCache() :
+    mass_step_(1.0),
+    max_isotope_(0),
+    num_masses_(0)
+  {
+    std::copy(averagine_peptide, averagine_peptide + 6, composition_);
+  }
+
+  IsotopePatternCache::IsotopePatternCache(Averagine averagine, double max_mass, double mass_step, Size max_isotope) :
+    mass_step_(mass_step),
+    max_isotope_(max_isotope),
+    num_masses_(0)
+  {
+    const double* composition = averagineComposition(averagine);
+    std::copy(composition, composition + 6, composition_);
+    build_(max_mass);
+  }
+
+  IsotopePatternCache::IsotopePatternCache(double C, double H, double N, double O, double S, double P,
+                                           double max_mass, double mass_step, Size max_isotope) :
+    composition_{C, H, N, O, S, P},
+    mass_step_(mass_step),
+    max_isotope_(max_isotope),
+    num_masses_(0)
+  {
+    build_(max_mass);
+  }
+
+  void IsotopePatternCache::build_(double max_mass)
+  {
+    if (mass_step_ <= 0)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Mass step must be positive.", String(mass_step_));
+    }
+    if (max_isotope_ == 0)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Number of isotopes must be positive.", String(max_isotope_));
+    }
+
+    num_masses_ = Size(std::max(0.0, std::ceil(max_mass / mass_step_))) + 1;
+    table_.assign(num_masses_ * max_isotope_, 0.0);
+
+    // the masses are independent of each other
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for (SignedSize index = 0; index < SignedSize(num_masses_); ++index)
+    {
+      std::vector<double> intensities;
+      compute_(index * mass_step_, max_isotope_, intensities);
+      std::copy(intensities.begin(), intensities.end(), table_.begin() + index * max_isotope_);
+    }
+  }
+
+  void IsotopePatternCache::compute_(double mass, Size num_isotopes, std::vector<double>& intensities) const
+  {
+    intensities.assign(num_isotopes, 0.0);
+    CoarseIsotopePatternGenerator solver(num_isotopes);
+    const IsotopeDistribution dist = solver.estimateFromWeightAndComp(mass, composition_[0], composition_[1], composition_[2],
+                                                                      composition_[3], composition_[4], composition_[5]);
+    for (Size i = 0; i < std::min(num_isotopes, dist.size()); ++i)
+    {
+      intensities[i] = dist[i].getIntensity();
+    }
+  }
+
+  void IsotopePatternCache::getIntensities(double mass, Size num_isotopes, std::vector<double>& intensities) const
+  {
+    const double position = mass / mass_step_;
+    // outside of the table: compute the pattern
+    if (num_isotopes > max_isotope_ || !(position >= 0) || position + 1 >= double(num_masses_))
+    {
+      compute_(mass, num_isotopes, intensities);
+      return;
+    }
+
+    // interpolate linearly between the neighbouring masses
+    const Size index = Size(position);
+    const double fraction = position - index;
+    const double* low = &table_[index * max_isotope_];
+    const double* high = low + max_isotope_;
+    intensities.resize(num_isotopes);
+    double sum = 0;
+    for (Size i = 0; i < num_isotopes; ++i)
+    {
+      intensities[i] = low[i] + fraction * (high[i] - low[i]);
+      sum += intensities[i];
+    }
+    // renormalize like CoarseIsotopePatternGenerator does for the truncated distribution
+    if (sum > 0)
+    {
+      for (double& intensity : intensities)
+      {
+        intensity /= sum;
+      }
+    }
+  }
+
+  void IsotopePatternCache::getExactIntensities(double mass, Size num_isotopes, std::vector<double>& intensities) const
+  {
+    // same steps as CoarseIsotopePatternGenerator::estimateFromWeightAndComp, with the convolution memoized
+    EmpiricalFormula formula;
+    formula.estimateFromWeightAndComp(mass, composition_[0], composition_[1], composition_[2],
+                                      composition_[3], composition_[4], composition_[5]);
+    const std::pair<String, Size> key(formula.toString(), num_isotopes);
+    {
+      std::lock_guard<std::mutex> lock(exact_patterns_mutex_);
+      auto it = exact_patterns_.find(key);
+      if (it != exact_patterns_.end())
+      {
+        intensities = it->second;
+        return;
+      }
+    }
+
+    intensities.assign(num_isotopes, 0.0);
+    const IsotopeDistribution dist = formula.getIsotopeDistribution(CoarseIsotopePatternGenerator(num_isotopes));
+    for (Size i = 0; i < std::min(num_isotopes, dist.size()); ++i)
+    {
+      intensities[i] = dist[i].getIntensity();
+    }
+    std::lock_guard<std::mutex> lock(exact_patterns_mutex_);
+    exact_patterns_.emplace(key, intensities);
+  }
+
+  double IsotopePatternCache::getMaxMass() const
+  {
+    return num_masses_ == 0 ? 0.0 : (num_masses_ - 1) * mass_step_;
+  }
+
+  double IsotopePatternCache::getMassStep() const
+  {
+    return mass_step_;
+  }
+
+  Size IsotopePatternCache::getMaxIsotope() const
+  {
+    return max_isotope_;
+  }
+
+  void IsotopePatternCache::store(const String& filename) const
+  {
+    std::ofstream os(filename.c_str());
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    os << std::setprecision(17);
+    os << table_header << '\n';
+    for (Size i = 0; i < 6; ++i)
+    {
+      os << composition_[i] << '\t';
+    }
+    os << mass_step_ << '\t' << max_isotope_ << '\t' << num_masses_ << '\n';
+    for (Size index = 0; index < num_masses_; ++index)
+    {
+      for (Size i = 0; i < max_isotope_; ++i)
+      {
+        os << (i == 0 ? "" : "\t") << table_[index * max_isotope_ + i];
+      }
+      os << '\n';
+    }
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+  }
+
+  void IsotopePatternCache::load(const String& filename)
+  {
+    if (!File::exists(filename))
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    std::ifstream is(filename.c_str());
+    std::string header;
+    std::getline(is, header);
+    if (header != table_header)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, header, "Not an isotope pattern table: " + filename);
+    }
+
+    double composition[6];
+    double mass_step = 0;
+    Size max_isotope = 0, num_masses = 0;
+    for (Size i = 0; i < 6; ++i)
+    {
+      is >> composition[i];
+    }
+    is >> mass_step >> max_isotope >> num_masses;
+    if (!is || mass_step <= 0 || max_isotope == 0)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "Invalid isotope pattern table header");
+    }
+    std::vector<double> table(num_masses * max_isotope);
+    for (double& value : table)
+    {
+      is >> value;
+    }
+    if (!is)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "Isotope pattern table is truncated");
+    }
+
+    std::copy(composition, composition + 6, composition_);
+    mass_step_ = mass_step;
+    max_isotope_ = max_isotope;
+    num_masses_ = num_masses;
+    table_.swap(table);
+  }
+
+  const IsotopePatternCache& IsotopePatternCache::getDefault(Averagine averagine)
+  {
+    // function-local statics are initialized thread-safely
+    switch (averagine)
+    {
+      case Averagine::RNA:
+      {
+        static const IsotopePatternCache rna(Averagine::RNA, 10000.0);
+        return rna;
+      }
+      case Averagine::DNA:
+      {
+        static const IsotopePatternCache dna(Averagine::DNA, 10000.0);
+        return dna;
+      }
+      default:
+      {
+        static const IsotopePatternCache peptide(Averagine::PEPTIDE, 10000.0);
+        return peptide;
+      }
+    }
+  }
+
+} // namespace OpenMS
@@ -0,0 +1,265 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/COMPARISON/SPECTRA/PairwiseSpectralSimilarity.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+namespace OpenMS
+{
+
+  namespace
+  {
+    /// greedy one-to-one matching of two m/z-sorted peak lists; returns the sum of the products of matched intensities
+    template <typename IntensityType>
+    double matchPeaks(const double* mz_a, const IntensityType* int_a, Size size_a,
+                      const double* mz_b, const IntensityType* int_b, Size size_b,
+                      double tolerance, Size& matched_peaks)
+    {
+      double dot(0);
+      matched_peaks = 0;
+      Size i(0), j(0);
+      while (i < size_a && j < size_b)
+      {
+        const double diff = mz_b[j] - mz_a[i];
+        if (diff < -tolerance)
+        {
+          ++j;
+        }
+        else if (diff > tolerance)
+        {
+          ++i;
+        }
+        else
+        {
+          dot += double(int_a[i]) * int_b[j];
+          ++matched_peaks;
+          ++i;
+          ++j;
+        }
+      }
+      return dot;
+    }
+
+    /// appends the m/z-sorted peaks of @p spectrum with positive intensity to @p mz and @p intensity (intensities normalized to unit length)
+    void packSpectrum(const MSSpectrum& spectrum, vector<double>& mz, vector<float>& intensity, vector<pair<double, double> >& peaks)
+    {
+      peaks.clear();
+      double norm(0);
+      for (const auto& p : spectrum)
+      {
+        if (p.getIntensity() <= 0) continue;
+        peaks.emplace_back(p.getMZ(), p.getIntensity());
+        norm += double(p.getIntensity()) * p.getIntensity();
+      }
+      if (!is_sorted(peaks.begin(), peaks.end()))
+      {
+        sort(peaks.begin(), peaks.end());
+      }
+      const double scale = norm > 0 ? 1.0 / sqrt(norm) : 0.0;
+      for (const auto& p : peaks)
+      {
+        mz.push_back(p.first);
+        intensity.push_back(float(p.second * scale));
+      }
+    }
+  }
+
+  PairwiseSpectralSimilarity::PairwiseSpectralSimilarity() :
+    DefaultParamHandler("PairwiseSpectralSimilarity"),
+    ProgressLogger()
+  {
+    defaults_.setValue("fragment_mass_tolerance", 0.02, "Maximal m/z difference (in Th) of matching fragment peaks.");
+    defaults_.setMinFloat("fragment_mass_tolerance", 0.0);
+
+    defaults_.setValue("max_precursor_mz_difference", 500.0, "Only spectra whose precursor m/z differ by at most this value (in Th) are compared. Negative values disable the filter.");
+
+    defaults_.setValue("min_score", 0.7, "Minimal cosine similarity of a reported pair.");
+    defaults_.setMinFloat("min_score", 0.0);
+    defaults_.setMaxFloat("min_score", 1.0);
+
+    defaults_.setValue("min_matched_peaks", 6, "Minimal number of matched peaks of a reported pair.");
+    defaults_.setMinInt("min_matched_peaks", 0);
+
+    defaults_.setValue("block_size", 256, "Number of spectra per block of the similarity matrix (unit of work of a thread).", {"advanced"});
+    defaults_.setMinInt("block_size", 1);
+
+    defaultsToParam_();
+  }
+
+  void PairwiseSpectralSimilarity::updateMembers_()
+  {
+    fragment_mass_tolerance_ = param_.getValue("fragment_mass_tolerance");
+    max_precursor_mz_difference_ = param_.getValue("max_precursor_mz_difference");
+    min_score_ = param_.getValue("min_score");
+    min_matched_peaks_ = (int)param_.getValue("min_matched_peaks");
+    block_size_ = (int)param_.getValue("block_size");
+  }
+
+  double PairwiseSpectralSimilarity::cosine(const MSSpectrum& a, const MSSpectrum& b, double tolerance, Size& matched_peaks)
+  {
+    // same normalization as in compute()
+    vector<double> mz_a, mz_b;
+    vector<float> int_a, int_b;
+    vector<pair<double, double> > peaks;
+    packSpectrum(a, mz_a, int_a, peaks);
+    packSpectrum(b, mz_b, int_b, peaks);
+    return matchPeaks(mz_a.data(), int_a.data(), mz_a.size(), mz_b.data(), int_b.data(), mz_b.size(), tolerance, matched_peaks);
+  }
+
+  vector<PairwiseSpectralSimilarity::Edge> PairwiseSpectralSimilarity::compute(const vector<MSSpectrum>& spectra) const
+  {
+    const bool filter_precursor = max_precursor_mz_difference_ >= 0;
+    const Size n = spectra.size();
+
+    // rows of the matrix are sorted by precursor m/z
+    vector<double> precursor_mz(n, 0.0);
+    for (Size i = 0; i < n; ++i)
+    {
+      if (!spectra[i].getPrecursors().empty())
+      {
+        precursor_mz[i] = spectra[i].getPrecursors()[0].getMZ();
+      }
+      else if (filter_precursor)
+      {
+        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Spectrum " + String(i) + " has no precursor, which is required for the precursor m/z filter.");
+      }
+    }
+    vector<Size> order(n);
+    iota(order.begin(), order.end(), 0);
+    if (filter_precursor)
+    {
+      stable_sort(order.begin(), order.end(), [&precursor_mz](Size a, Size b) { return precursor_mz[a] < precursor_mz[b]; });
+    }
+
+    // pack all spectra: m/z-sorted peaks with normalized intensities, stored contiguously
+    vector<Size> offsets(1, 0);
+    vector<double> row_mz;
+    vector<float> row_intensity;
+    vector<double> row_precursor_mz(n);
+    vector<pair<double, double> > peaks;
+    for (Size r = 0; r < n; ++r)
+    {
+      const MSSpectrum& spectrum = spectra[order[r]];
+      row_precursor_mz[r] = precursor_mz[order[r]];
+      packSpectrum(spectrum, row_mz, row_intensity, peaks);
+      offsets.push_back(row_mz.size());
+    }
+
+    // blocks of the upper triangle which contain at least one pair within the precursor window
+    const Size block_size = block_size_;
+    const Size num_blocks = (n + block_size - 1) / block_size;
+    vector<pair<Size, Size> > blocks;
+    for (Size bi = 0; bi < num_blocks; ++bi)
+    {
+      const double max_mz_i = row_precursor_mz[min(n, (bi + 1) * block_size) - 1];
+      for (Size bj = bi; bj < num_blocks; ++bj)
+      {
+        // rows are sorted, so all further blocks are out of the window as well
+        if (filter_precursor && row_precursor_mz[bj * block_size] - max_mz_i > max_precursor_mz_difference_)
+        {
+          break;
+        }
+        blocks.emplace_back(bi, bj);
+      }
+    }
+
+    vector<vector<Edge> > block_edges(blocks.size());
+    startProgress(0, blocks.size(), "computing pairwise spectral similarities");
+    Size blocks_done(0);
+
+#pragma omp parallel for schedule(dynamic)
+    for (SignedSize b = 0; b < (SignedSize)blocks.size(); ++b)
+    {
+      const Size row_begin = blocks[b].first * block_size;
+      const Size row_end = min(n, row_begin + block_size);
+      const Size col_begin = blocks[b].second * block_size;
+      const Size col_end = min(n, col_begin + block_size);
+
+      vector<Edge>& edges = block_edges[b];
+      for (Size r = row_begin; r < row_end; ++r)
+      {
+        for (Size c = max(col_begin, r + 1); c < col_end; ++c)
+        {
+          if (filter_precursor && row_precursor_mz[c] - row_precursor_mz[r] > max_precursor_mz_difference_)
+          {
+            break;
+          }
+          Size matched_peaks(0);
+          const double score = matchPeaks(row_mz.data() + offsets[r], row_intensity.data() + offsets[r], offsets[r + 1] - offsets[r],
+                                          row_mz.data() + offsets[c], row_intensity.data() + offsets[c], offsets[c + 1] - offsets[c],
+                                          fragment_mass_tolerance_, matched_peaks);
+          if (score >= min_score_ && matched_peaks >= min_matched_peaks_)
+          {
+            Edge e;
+            e.first = min(order[r], order[c]);
+            e.second = max(order[r], order[c]);
+            e.score = score;
+            e.matched_peaks = matched_peaks;
+            edges.push_back(e);
+          }
+        }
+      }
+
+#pragma omp atomic
+      ++blocks_done;
+      IF_MASTERTHREAD setProgress(blocks_done);
+    }
+    endProgress();
+
+    vector<Edge> result;
+    for (const auto& edges : block_edges)
+    {
+      result.insert(result.end(), edges.begin(), edges.end());
+    }
+    sort(result.begin(), result.end(), [](const Edge& a, const Edge& b)
+      {
+        return a.first < b.first || (a.first == b.first && a.second < b.second);
+      });
+    return result;
+  }
+
+} // namespace OpenMS
@@ -0,0 +1,197 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/COMPARISON/SPECTRA/SpectralLibraryIndex.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace OpenMS
+{
+
+  SpectralLibraryIndex::SpectralLibraryIndex(double bin_size, double bin_offset) :
+    bin_size_(bin_size),
+    bin_offset_(bin_offset),
+    max_bin_(0),
+    offsets_(1, 0)
+  {
+    if (bin_size <= 0)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bin size must be positive.", String(bin_size));
+    }
+  }
+
+  Size SpectralLibraryIndex::getBinIndex(double mz) const
+  {
+    double idx = floor(mz / bin_size_ + bin_offset_);
+    return idx < 0 ? 0 : static_cast<Size>(idx);
+  }
+
+  void SpectralLibraryIndex::binSpectrum_(const MSSpectrum& spectrum, vector<pair<UInt, float> >& bins) const
+  {
+    bins.clear();
+    for (const auto& p : spectrum)
+    {
+      if (p.getIntensity() <= 0) continue;
+      bins.emplace_back(static_cast<UInt>(getBinIndex(p.getMZ())), p.getIntensity());
+    }
+    // spectra are usually sorted by m/z already
+    if (!is_sorted(bins.begin(), bins.end()))
+    {
+      sort(bins.begin(), bins.end());
+    }
+
+    // merge peaks in the same bin
+    Size n(0);
+    for (Size i = 0; i < bins.size(); ++i)
+    {
+      if (n > 0 && bins[n - 1].first == bins[i].first)
+      {
+        bins[n - 1].second += bins[i].second;
+      }
+      else
+      {
+        bins[n++] = bins[i];
+      }
+    }
+    bins.resize(n);
+
+    double norm(0);
+    for (const auto& b : bins) norm += double(b.second) * b.second;
+    if (norm > 0)
+    {
+      float scale = float(1.0 / sqrt(norm));
+      for (auto& b : bins) b.second *= scale;
+    }
+  }
+
+  void SpectralLibraryIndex::addPrecursor(double precursor_mz)
+  {
+    if (!precursor_mz_.empty() && precursor_mz < precursor_mz_.back())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Library spectra need to be added in order of increasing precursor m/z.");
+    }
+    precursor_mz_.push_back(precursor_mz);
+    offsets_.push_back(bins_.size());
+  }
+
+  void SpectralLibraryIndex::addSpectrum(double precursor_mz, const MSSpectrum& spectrum)
+  {
+    if (!precursor_mz_.empty() && precursor_mz < precursor_mz_.back())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Library spectra need to be added in order of increasing precursor m/z.");
+    }
+
+    vector<pair<UInt, float> > bins;
+    binSpectrum_(spectrum, bins);
+    for (const auto& b : bins)
+    {
+      bins_.push_back(b.first);
+      intensities_.push_back(b.second);
+    }
+    if (!bins.empty()) max_bin_ = max(max_bin_, bins.back().first);
+    precursor_mz_.push_back(precursor_mz);
+    offsets_.push_back(bins_.size());
+  }
+
+  Size SpectralLibraryIndex::size() const
+  {
+    return precursor_mz_.size();
+  }
+
+  void SpectralLibraryIndex::clear()
+  {
+    max_bin_ = 0;
+    precursor_mz_.clear();
+    offsets_.assign(1, 0);
+    bins_.clear();
+    intensities_.clear();
+  }
+
+  double SpectralLibraryIndex::getPrecursorMZ(Size index) const
+  {
+    return precursor_mz_[index];
+  }
+
+  pair<Size, Size> SpectralLibraryIndex::getPrecursorRange(double mz_low, double mz_high) const
+  {
+    auto first = lower_bound(precursor_mz_.begin(), precursor_mz_.end(), mz_low);
+    auto last = upper_bound(first, precursor_mz_.end(), mz_high);
+    return make_pair(Size(first - precursor_mz_.begin()), Size(last - precursor_mz_.begin()));
+  }
+
+  void SpectralLibraryIndex::prepareQuery(const MSSpectrum& query, vector<float>& dense_query) const
+  {
+    vector<pair<UInt, float> > bins;
+    binSpectrum_(query, bins);
+    dense_query.assign(Size(max_bin_) + 1, 0.0f);
+    for (const auto& b : bins)
+    {
+      if (b.first > max_bin_) break;
+      dense_query[b.first] = b.second;
+    }
+  }
+
+  void SpectralLibraryIndex::scoreCandidates(const vector<float>& dense_query, Size first, Size last, vector<float>& scores) const
+  {
+    if (dense_query.size() != Size(max_bin_) + 1)
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, dense_query.size());
+    }
+    last = min(last, size());
+    scores.assign(last > first ? last - first : 0, 0.0f);
+
+    const float* q = dense_query.data();
+    const UInt* bins = bins_.data();
+    const float* ints = intensities_.data();
+    for (Size c = first; c < last; ++c)
+    {
+      // gather: both vectors are normalized, so the dot product is the cosine
+      float dot(0);
+      for (Size k = offsets_[c]; k < offsets_[c + 1]; ++k)
+      {
+        dot += q[bins[k]] * ints[k];
+      }
+      scores[c - first] = dot;
+    }
+  }
+
+} // namespace OpenMS
@@ -8,8 +8,10 @@ BinnedSpectralContrastAngle.cpp
 BinnedSpectrum.cpp
 BinnedSpectrumCompareFunctor.cpp
 BinnedSumAgreeingIntensities.cpp
+PairwiseSpectralSimilarity.cpp
 PeakAlignment.cpp
 PeakSpectrumCompareFunctor.cpp
+SpectralLibraryIndex.cpp
 SpectraSTSimilarityScore.cpp
 SpectrumAlignment.cpp
 SpectrumAlignmentScore.cpp
@@ -37,6 +37,7 @@
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/SYSTEM/File.h>
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopePatternCache.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathHelper.h>
 
 #include <fstream>
@@ -287,6 +288,9 @@ namespace OpenMS
     defaults_.setValue("isotope_filtering_model", "metabolites (5% RMS)", "Remove/score candidate assemblies based on isotope intensities. SVM isotope models for metabolites were trained with either 2% or 5% RMS error. For peptides, an averagine cosine scoring is used. Select the appropriate noise model according to the quality of measurement or MS device.");
     defaults_.setValidStrings("isotope_filtering_model", {"metabolites (2% RMS)","metabolites (5% RMS)","peptides","none"});
 
+    defaults_.setValue("isotope_pattern_cache", "false", "For isotope_filtering_model 'peptides': reuse the averagine pattern of each estimated sum formula (see IsotopePatternCache) instead of convolving it for every candidate. The scores are identical.", {"advanced"});
+    defaults_.setValidStrings("isotope_pattern_cache", {"false","true"});
+
     defaults_.setValue("mz_scoring_13C", "false", "Use the 13C isotope peak position (~1.003355 Da) as the expected shift in m/z for isotope mass traces (highly recommended for lipidomics!). Disable for general metabolites (as described in Kenar et al. 2014, MCP.).");
     defaults_.setValidStrings("mz_scoring_13C", {"false","true"});
 
@@ -333,6 +337,7 @@ namespace OpenMS
     enable_RT_filtering_ = param_.getValue("enable_RT_filtering").toBool();
     
     isotope_filtering_model_ = param_.getValue("isotope_filtering_model").toString();
+    use_isotope_pattern_cache_ = param_.getValue("isotope_pattern_cache").toBool();
     use_smoothed_intensities_ = param_.getValue("use_smoothed_intensities").toBool();
 
     use_mz_scoring_C13_ = param_.getValue("mz_scoring_13C").toBool();
@@ -359,11 +364,24 @@ namespace OpenMS
 
   double FeatureFindingMetabo::computeAveragineSimScore_(const std::vector<double>& hypo_ints, const double& mol_weight) const
   {
-    CoarseIsotopePatternGenerator solver(hypo_ints.size());
-    auto isodist = solver.estimateFromPeptideWeight(mol_weight);
-    // isodist.renormalize();
+    std::vector<double> averagine_dist;
+    if (use_isotope_pattern_cache_)
+    {
+      // shared by all instances and threads; only the memoized exact patterns are used, no table
+      static const IsotopePatternCache averagine_patterns;
+      averagine_patterns.getExactIntensities(mol_weight, hypo_ints.size(), averagine_dist);
+    }
+    else
+    {
+      CoarseIsotopePatternGenerator solver(hypo_ints.size());
+      auto isodist = solver.estimateFromPeptideWeight(mol_weight);
+      // isodist.renormalize();
+      for (const Peak1D& peak : isodist)
+      {
+        averagine_dist.push_back(peak.getIntensity());
+      }
+    }
 
-    IsotopeDistribution::ContainerType averagine_dist = isodist.getContainer();
     double max_int(0.0), theo_max_int(0.0);
     for (Size i = 0; i < hypo_ints.size(); ++i)
     {
@@ -372,9 +390,9 @@ namespace OpenMS
         max_int = hypo_ints[i];
       }
 
-      if (averagine_dist[i].getIntensity() > theo_max_int)
+      if (averagine_dist[i] > theo_max_int)
       {
-        theo_max_int = averagine_dist[i].getIntensity();
+        theo_max_int = averagine_dist[i];
       }
     }
 
@@ -382,7 +400,7 @@ namespace OpenMS
     std::vector<double> averagine_ratios, hypo_isos;
     for (Size i = 0; i < hypo_ints.size(); ++i)
     {
-      averagine_ratios.push_back(averagine_dist[i].getIntensity() / theo_max_int);
+      averagine_ratios.push_back(averagine_dist[i] / theo_max_int);
       hypo_isos.push_back(hypo_ints[i] / max_int);
     }
 
@@ -34,6 +34,9 @@
 //
 #include <OpenMS/FILTERING/TRANSFORMERS/NLargest.h>
 
+#include <algorithm>
+#include <numeric>
+
 using namespace std;
 
 namespace OpenMS
@@ -80,6 +83,23 @@ namespace OpenMS
     return *this;
   }
 
+  void NLargest::filterSpectrum(SpectrumColumns & spectrum)
+  {
+    if (spectrum.size() <= peakcount_) return;
+
+    // only the n largest peaks need to be ordered; ties are broken by position (like the stable sort of the template)
+    const vector<float>& intensities = spectrum.getIntensityArray();
+    vector<Size> indices(spectrum.size());
+    iota(indices.begin(), indices.end(), 0);
+    partial_sort(indices.begin(), indices.begin() + peakcount_, indices.end(),
+      [&intensities](Size a, Size b)
+      {
+        return intensities[a] > intensities[b] || (intensities[a] == intensities[b] && a < b);
+      });
+    indices.resize(peakcount_);
+    spectrum.select(indices);
+  }
+
   void NLargest::filterPeakSpectrum(PeakSpectrum & spectrum)
   {
     filterSpectrum(spectrum);
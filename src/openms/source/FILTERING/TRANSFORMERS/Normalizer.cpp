@@ -64,6 +64,35 @@ namespace OpenMS
     return *this;
   }
 
+  void Normalizer::filterSpectrum(SpectrumColumns& spectrum) const
+  {
+    if (spectrum.empty()) return;
+
+    vector<float>& intensities = spectrum.getIntensityArray();
+    double divisor(0);
+    if (method_ == "to_one")
+    {
+      divisor = intensities[0]; // see template version: keeps a non-zero divisor for negative intensities
+      for (float intensity : intensities)
+      {
+        if (divisor < intensity) divisor = intensity;
+      }
+    }
+    else if (method_ == "to_TIC")
+    {
+      divisor = spectrum.calculateTIC();
+    }
+    else
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Method not known", method_);
+    }
+
+    for (float& intensity : intensities)
+    {
+      intensity = intensity / divisor;
+    }
+  }
+
   void Normalizer::filterPeakSpectrum(PeakSpectrum& spectrum) const
   {
     filterSpectrum(spectrum);
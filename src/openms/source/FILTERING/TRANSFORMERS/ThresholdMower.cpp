@@ -63,6 +63,21 @@ namespace OpenMS
     return *this;
   }
 
+  void ThresholdMower::filterSpectrum(SpectrumColumns & spectrum)
+  {
+    threshold_ = ((double)param_.getValue("threshold"));
+    const vector<float>& intensities = spectrum.getIntensityArray();
+    std::vector<Size> indices;
+    for (Size i = 0; i != intensities.size(); ++i)
+    {
+      if (intensities[i] >= threshold_)
+      {
+        indices.push_back(i);
+      }
+    }
+    spectrum.select(indices);
+  }
+
   void ThresholdMower::filterPeakSpectrum(PeakSpectrum & spectrum)
   {
     filterSpectrum(spectrum);
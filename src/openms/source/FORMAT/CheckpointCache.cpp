@@ -0,0 +1,195 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/FORMAT/CheckpointCache.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/CONCEPT/VersionInfo.h>
+#include <OpenMS/FORMAT/FileHandler.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+
+#include <fstream>
+
+using namespace std;
+
+namespace OpenMS
+{
+  const String CheckpointCache::FILE_HASHES = "file_hashes.tsv";
+
+  CheckpointCache::Key::Key(const String& stage) :
+    stage_(stage),
+    content_(stage + "\n" + VersionInfo::getVersion() + "\n") // results of different versions are not interchangeable
+  {
+  }
+
+  CheckpointCache::Key& CheckpointCache::Key::add(const String& name, const String& value)
+  {
+    content_ += name + "=" + value + "\n";
+    return *this;
+  }
+
+  CheckpointCache::Key& CheckpointCache::Key::add(const String& name, const Param& param)
+  {
+    for (Param::ParamIterator it = param.begin(); it != param.end(); ++it)
+    {
+      content_ += name + ":" + it.getName() + "=" + it->value.toString(true) + "\n";
+    }
+    return *this;
+  }
+
+  CheckpointCache::Key& CheckpointCache::Key::add(const Key& upstream)
+  {
+    content_ += "checkpoint=" + upstream.getStage() + "_" + upstream.getHash() + "\n";
+    return *this;
+  }
+
+  const String& CheckpointCache::Key::getStage() const
+  {
+    return stage_;
+  }
+
+  String CheckpointCache::Key::getHash() const
+  {
+    QByteArray hash = QCryptographicHash::hash(QByteArray(content_.c_str(), int(content_.size())), QCryptographicHash::Sha1);
+    return String(QString(hash.toHex()));
+  }
+
+  CheckpointCache::CheckpointCache() = default;
+
+  CheckpointCache::CheckpointCache(const String& directory, bool resume) :
+    directory_(directory),
+    resume_(resume)
+  {
+    if (directory_.empty()) return;
+
+    if (!QDir().mkpath(directory_.toQString()))
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, directory_, "Could not create checkpoint directory.");
+    }
+    directory_ = File::absolutePath(directory_);
+
+    // read the hashes of previously seen input files
+    ifstream is(directory_ + "/" + FILE_HASHES);
+    String line;
+    while (getline(is, line))
+    {
+      line.trim();
+      // format: hash<TAB>size<TAB>modification time<TAB>absolute path
+      Size tab = line.find('\t');
+      if (tab == String::npos) continue;
+      file_hashes_[line.substr(tab + 1)] = line.prefix(tab);
+    }
+  }
+
+  bool CheckpointCache::isEnabled() const
+  {
+    return !directory_.empty();
+  }
+
+  bool CheckpointCache::isResuming() const
+  {
+    return isEnabled() && resume_;
+  }
+
+  String CheckpointCache::hashFile(const String& filename)
+  {
+    QFileInfo info(filename.toQString());
+    if (!info.exists())
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    const String id = String(info.size()) + "\t" + String(info.lastModified().toMSecsSinceEpoch()) + "\t" + File::absolutePath(filename);
+
+    String hash;
+#ifdef _OPENMP
+#pragma omp critical (CheckpointCache_file_hashes)
+#endif
+    {
+      auto it = file_hashes_.find(id);
+      if (it != file_hashes_.end()) hash = it->second;
+    }
+    if (!hash.empty()) return hash;
+
+    hash = FileHandler::computeFileHash(filename); // outside of the critical section: may take a while for large files
+
+#ifdef _OPENMP
+#pragma omp critical (CheckpointCache_file_hashes)
+#endif
+    {
+      if (file_hashes_.insert(make_pair(id, hash)).second && isEnabled())
+      {
+        ofstream os(directory_ + "/" + FILE_HASHES, ios::app);
+        os << hash << "\t" << id << "\n";
+      }
+    }
+    return hash;
+  }
+
+  String CheckpointCache::getPath(const Key& key, const String& extension) const
+  {
+    return directory_ + "/" + key.getStage() + "_" + key.getHash() + "." + extension;
+  }
+
+  bool CheckpointCache::contains(const Key& key, const String& extension) const
+  {
+    return isResuming() && File::exists(getPath(key, extension));
+  }
+
+  void CheckpointCache::reportReuse_(const Key& key, const String& extension) const
+  {
+    OPENMS_LOG_INFO << "Reusing checkpoint '" << key.getStage() << "' from " << getPath(key, extension) << endl;
+  }
+
+  String CheckpointCache::getTemporaryPath_(const Key& key, const String& extension) const
+  {
+    // keep the extension last, file writers check it
+    return directory_ + "/" + key.getStage() + "_" + key.getHash() + ".part_" + File::getUniqueName(false) + "." + extension;
+  }
+
+  void CheckpointCache::commit_(const String& tmp_path, const String& path) const
+  {
+    if (!File::rename(tmp_path, path, true, false))
+    {
+      File::remove(tmp_path);
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, path, "Could not store checkpoint.");
+    }
+  }
+}
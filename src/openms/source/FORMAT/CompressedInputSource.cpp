@@ -34,8 +34,7 @@
 
 #include <OpenMS/FORMAT/CompressedInputSource.h>
 
-#include <OpenMS/FORMAT/GzipInputStream.h>
-#include <OpenMS/FORMAT/Bzip2InputStream.h>
+#include <OpenMS/FORMAT/ReadAheadInputStream.h>
 #include <OpenMS/FORMAT/HANDLERS/XMLHandler.h>
 
 #include <xercesc/util/XMLUniDefs.hpp>
@@ -143,27 +142,15 @@ namespace OpenMS
 
   BinInputStream * CompressedInputSource::makeStream() const
   {
-    if (head_[0] == 'B' && head_[1] == 'Z')
+    // decompression runs on a background thread, ahead of the parser
+    ReadAheadIfstream::CompressionType type = (head_[0] == 'B' && head_[1] == 'Z') ? ReadAheadIfstream::BZIP2 : ReadAheadIfstream::GZIP;
+    ReadAheadInputStream * retStrm = new ReadAheadInputStream(Internal::StringManager().convert(getSystemId()), type);
+    if (!retStrm->getIsOpen())
     {
-      Bzip2InputStream * retStrm = new Bzip2InputStream(Internal::StringManager().convert(getSystemId()));
-      if (!retStrm->getIsOpen())
-      {
-        delete retStrm;
-        return nullptr;
-      }
-      return retStrm;
+      delete retStrm;
+      return nullptr;
     }
-    else /*     (bz[0] == g1 && bz[1] == g2), where char g1 = 0x1f and char g2 = 0x8b */
-    {
-      GzipInputStream * retStrm = new GzipInputStream(Internal::StringManager().convert(getSystemId()));
-      if (!retStrm->getIsOpen())
-      {
-        delete retStrm;
-        return nullptr;
-      }
-      return retStrm;
-    }
-
+    return retStrm;
   }
 
 } // namespace OpenMS
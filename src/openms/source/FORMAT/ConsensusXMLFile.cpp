@@ -126,4 +126,20 @@ namespace OpenMS
 
   }
 
+  void ConsensusXMLFile::transform(const String& filename, ConsensusMap& meta_map, const std::function<void (ConsensusFeature&)>& consumer, bool load_peptide_ids)
+  {
+    meta_map.clear(true);
+
+    //set DocumentIdentifier
+    meta_map.setLoadedFileType(filename);
+    meta_map.setLoadedFilePath(filename);
+
+    Internal::ConsensusXMLHandler handler(meta_map, filename);
+    handler.setOptions(options_);
+    handler.setLogType(getLogType());
+    handler.setLoadPeptideIdentifications(load_peptide_ids);
+    handler.setConsensusFeatureConsumer(consumer);
+    parse_(filename, &handler);
+  }
+
 } // namespace OpenMS
@@ -0,0 +1,88 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/DATAACCESS/FeatureXMLWritingConsumer.h>
+
+#include <OpenMS/FORMAT/FileHandler.h>
+#include <OpenMS/KERNEL/FeatureMap.h>
+
+namespace OpenMS
+{
+
+  FeatureXMLWritingConsumer::FeatureXMLWritingConsumer(const String& filename, const FeatureMap& meta_map, Size expected_size) :
+    Internal::FeatureXMLHandler(meta_map, filename),
+    started_writing_(false),
+    features_written_(0),
+    features_expected_(expected_size)
+  {
+    if (!FileHandler::hasValidExtension(filename, FileTypes::FEATUREXML))
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "invalid file extension, expected '" + FileTypes::typeToName(FileTypes::FEATUREXML) + "'");
+    }
+    ofs_.open(filename.c_str(), std::ios::out | std::ios::binary);
+    if (!ofs_)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    ofs_.precision(writtenDigits(double()));
+  }
+
+  FeatureXMLWritingConsumer::~FeatureXMLWritingConsumer()
+  {
+    startWriting_();
+    writeFooter_(ofs_);
+    ofs_.close();
+  }
+
+  void FeatureXMLWritingConsumer::consumeFeature(const Feature& feature)
+  {
+    startWriting_();
+    writeFeature_(file_, ofs_, feature, "f_", feature.getUniqueId(), 0);
+    ++features_written_;
+  }
+
+  Size FeatureXMLWritingConsumer::getNrFeaturesWritten() const
+  {
+    return features_written_;
+  }
+
+  void FeatureXMLWritingConsumer::startWriting_()
+  {
+    if (started_writing_) return;
+    writeHeader_(ofs_, *cmap_, features_expected_);
+    started_writing_ = true;
+  }
+
+} // namespace OpenMS
+
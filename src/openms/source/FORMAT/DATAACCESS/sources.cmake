@@ -3,9 +3,12 @@ set(directory source/FORMAT/DATAACCESS)
 
 ### list all filenames of the directory here
 set(sources_list
+  ConsensusXMLWritingConsumer.cpp
   CsiFingerIdMzTabWriter.cpp
+  FeatureXMLWritingConsumer.cpp
   MSDataWritingConsumer.cpp
   MSDataTransformingConsumer.cpp
+  MSDataArenaConsumer.cpp
   MSDataAggregatingConsumer.cpp
   MSDataCachedConsumer.cpp
   MSDataChainingConsumer.cpp
@@ -35,6 +35,7 @@
 #include <OpenMS/FORMAT/FASTAFile.h>
 
 #include <OpenMS/FORMAT/FileHandler.h>
+#include <OpenMS/FORMAT/ReadAheadIfstream.h>
 #include <OpenMS/FORMAT/TextFile.h>
 #include <OpenMS/SYSTEM/File.h>
 
@@ -45,6 +46,38 @@ namespace OpenMS
 {
   using namespace std;
 
+  namespace
+  {
+    /// streambuf which reads from a ReadAheadIfstream (no seeking)
+    class ReadAheadStreambuf :
+      public std::streambuf
+    {
+    public:
+      explicit ReadAheadStreambuf(const String& filename) :
+        stream_(filename.c_str()),
+        buffer_(1 << 16)
+      {
+        setg(buffer_.data(), buffer_.data(), buffer_.data());
+      }
+
+    protected:
+      int_type underflow() override
+      {
+        if (gptr() < egptr())
+        {
+          return traits_type::to_int_type(*gptr());
+        }
+        size_t n = stream_.isOpen() ? stream_.read(buffer_.data(), buffer_.size()) : 0;
+        setg(buffer_.data(), buffer_.data(), buffer_.data() + n);
+        return n == 0 ? traits_type::eof() : traits_type::to_int_type(*gptr());
+      }
+
+    private:
+      ReadAheadIfstream stream_;
+      std::vector<char> buffer_;
+    };
+  }
+
   bool FASTAFile::readEntry_(std::string& id, std::string& description, std::string& seq)
   {
     std::streambuf* sb = infile_.rdbuf();
@@ -157,12 +190,25 @@ namespace OpenMS
       throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
     }
 
-    if (infile_.is_open()) infile_.close(); // precaution
+    // precaution
+    infile_.rdbuf(nullptr);
+    if (filebuf_.is_open()) filebuf_.close();
+    compressed_buf_.reset();
 
-    infile_.open(filename.c_str(), std::ios::binary | std::ios::in);
-    infile_.seekg(0, infile_.end);
-    fileSize_ = infile_.tellg();
-    infile_.seekg(0, infile_.beg);
+    if (ReadAheadIfstream::isCompressed(filename.c_str()))
+    {
+      compressed_buf_.reset(new ReadAheadStreambuf(filename));
+      infile_.rdbuf(compressed_buf_.get());
+      fileSize_ = 0; // unknown; seeking is not supported
+    }
+    else
+    {
+      filebuf_.open(filename.c_str(), std::ios::binary | std::ios::in);
+      infile_.rdbuf(&filebuf_);
+      infile_.seekg(0, infile_.end);
+      fileSize_ = infile_.tellg();
+      infile_.seekg(0, infile_.beg);
+    }
 
     std::streambuf *sb = infile_.rdbuf();
     while (sb->sgetc() == '#') // Skip the header of PEFF files (http://www.psidev.info/peff)
@@ -207,11 +253,24 @@ namespace OpenMS
 
   std::streampos FASTAFile::position()
   {
+    if (compressed_buf_)
+    {
+      throw Exception::NotImplemented(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+    }
     return infile_.tellg();
   }
 
+  bool FASTAFile::isSeekable() const
+  {
+    return !compressed_buf_;
+  }
+
   bool FASTAFile::setPosition(const std::streampos &pos)
   {
+    if (compressed_buf_)
+    {
+      throw Exception::NotImplemented(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+    }
     if (pos <= fileSize_)
     {
       infile_.clear(); // when end of file is reached, otherwise it gets -1
@@ -0,0 +1,288 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/FASTAIndexFile.h>
+
+#include <OpenMS/SYSTEM/File.h>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <cstring>
+#include <fstream>
+
+namespace OpenMS
+{
+  namespace
+  {
+    /// "FASX"; reads as "XSAF" on a machine with different byte order
+    const std::uint32_t COMPILED_FASTA_MAGIC = 0x46415358;
+    const std::uint32_t COMPILED_FASTA_VERSION = 1;
+    /// magic, version, entry count, offset table position
+    const std::uint64_t COMPILED_FASTA_HEADER_SIZE = 2 * sizeof(std::uint32_t) + 2 * sizeof(std::uint64_t);
+
+    /// Writes entries sequentially and appends the offset table when finished
+    class CompiledFASTAWriter
+    {
+    public:
+      explicit CompiledFASTAWriter(const String& filename) :
+        ofs_(filename.c_str(), std::ios::binary | std::ios::trunc),
+        filename_(filename)
+      {
+        if (!ofs_)
+        {
+          throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+        }
+        // placeholder header; count and table position are filled in by finish()
+        writeHeader_(0, 0);
+        pos_ = COMPILED_FASTA_HEADER_SIZE;
+      }
+
+      void add(const FASTAFile::FASTAEntry& entry)
+      {
+        writeField_(entry.identifier);
+        writeField_(entry.description);
+        writeField_(entry.sequence);
+      }
+
+      Size finish()
+      {
+        const std::uint64_t table_pos = pos_;
+        offsets_.push_back(pos_); // end of last entry
+        ofs_.write(reinterpret_cast<const char*>(offsets_.data()), offsets_.size() * sizeof(std::uint64_t));
+        const std::uint64_t count = (offsets_.size() - 1) / 3;
+        ofs_.seekp(0, std::ios::beg);
+        writeHeader_(count, table_pos);
+        ofs_.close();
+        if (ofs_.fail())
+        {
+          throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename_);
+        }
+        return count;
+      }
+
+    private:
+      void writeHeader_(std::uint64_t count, std::uint64_t table_pos)
+      {
+        ofs_.write(reinterpret_cast<const char*>(&COMPILED_FASTA_MAGIC), sizeof(COMPILED_FASTA_MAGIC));
+        ofs_.write(reinterpret_cast<const char*>(&COMPILED_FASTA_VERSION), sizeof(COMPILED_FASTA_VERSION));
+        ofs_.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        ofs_.write(reinterpret_cast<const char*>(&table_pos), sizeof(table_pos));
+      }
+
+      void writeField_(const String& s)
+      {
+        offsets_.push_back(pos_);
+        ofs_.write(s.data(), s.size());
+        pos_ += s.size();
+      }
+
+      std::ofstream ofs_;
+      String filename_;
+      std::vector<std::uint64_t> offsets_;
+      std::uint64_t pos_ = 0;
+    };
+  }
+
+  FASTAIndexFile::FASTAIndexFile() = default;
+
+  FASTAIndexFile::FASTAIndexFile(const String& filename)
+  {
+    open(filename);
+  }
+
+  FASTAIndexFile::~FASTAIndexFile() = default;
+
+  void FASTAIndexFile::open(const String& filename)
+  {
+    close();
+    if (!File::exists(filename))
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    filename_ = filename;
+    try
+    {
+      file_ = std::make_unique<boost::iostreams::mapped_file_source>(std::string(filename));
+    }
+    catch (const std::exception& e)
+    {
+      file_.reset();
+      throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename + " (" + e.what() + ")");
+    }
+
+    auto fail = [&](const String& msg)
+    {
+      close();
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, msg, filename);
+    };
+
+    const std::uint64_t file_size = file_->size();
+    if (file_size < COMPILED_FASTA_HEADER_SIZE)
+    {
+      fail("File is too small to be a compiled FASTA database.");
+    }
+    std::uint32_t magic, version;
+    std::uint64_t count, table_pos;
+    const char* p = file_->data();
+    std::memcpy(&magic, p, sizeof(magic)); p += sizeof(magic);
+    std::memcpy(&version, p, sizeof(version)); p += sizeof(version);
+    std::memcpy(&count, p, sizeof(count)); p += sizeof(count);
+    std::memcpy(&table_pos, p, sizeof(table_pos));
+    if (magic != COMPILED_FASTA_MAGIC)
+    {
+      fail("File is not a compiled FASTA database (wrong file magic number) or was written on a machine with different byte order.");
+    }
+    if (version != COMPILED_FASTA_VERSION)
+    {
+      fail("Unsupported compiled FASTA database version " + String(version) + " (expected " + String(COMPILED_FASTA_VERSION) + ").");
+    }
+    // the table must fit into the file; checked via division to avoid overflow of (3 * count + 1) * 8
+    if (table_pos < COMPILED_FASTA_HEADER_SIZE || table_pos > file_size
+      || (file_size - table_pos) / sizeof(std::uint64_t) < 1
+      || ((file_size - table_pos) / sizeof(std::uint64_t) - 1) / 3 < count)
+    {
+      fail("Compiled FASTA database is truncated (offset table incomplete).");
+    }
+    size_ = count;
+    offsets_ = file_->data() + table_pos;
+    if (offset_(3 * size_) != table_pos)
+    {
+      fail("Compiled FASTA database is corrupt (offset table does not match data section).");
+    }
+  }
+
+  void FASTAIndexFile::close()
+  {
+    file_.reset();
+    size_ = 0;
+    offsets_ = nullptr;
+  }
+
+  bool FASTAIndexFile::isOpen() const
+  {
+    return file_ != nullptr;
+  }
+
+  Size FASTAIndexFile::size() const
+  {
+    return size_;
+  }
+
+  void FASTAIndexFile::getEntry(Size index, FASTAFile::FASTAEntry& entry) const
+  {
+    if (index >= size_)
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, index, size_);
+    }
+    std::uint64_t o[4];
+    for (Size i = 0; i < 4; ++i) o[i] = offset_(3 * index + i);
+    if (!(COMPILED_FASTA_HEADER_SIZE <= o[0] && o[0] <= o[1] && o[1] <= o[2] && o[2] <= o[3] && o[3] <= offset_(3 * size_)))
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Compiled FASTA database is corrupt (invalid offsets for entry " + String(index) + ").", filename_);
+    }
+    entry.identifier.assign(at_(o[0]), o[1] - o[0]);
+    entry.description.assign(at_(o[1]), o[2] - o[1]);
+    entry.sequence.assign(at_(o[2]), o[3] - o[2]);
+  }
+
+  Size FASTAIndexFile::getSequenceLength(Size index) const
+  {
+    if (index >= size_)
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, index, size_);
+    }
+    return offset_(3 * index + 3) - offset_(3 * index + 2);
+  }
+
+  void FASTAIndexFile::store(const String& filename, const std::vector<FASTAFile::FASTAEntry>& data)
+  {
+    CompiledFASTAWriter writer(filename);
+    for (const auto& entry : data)
+    {
+      writer.add(entry);
+    }
+    writer.finish();
+  }
+
+  Size FASTAIndexFile::compile(const String& fasta_file, const String& filename)
+  {
+    FASTAFile f;
+    f.readStart(fasta_file);
+    CompiledFASTAWriter writer(filename);
+    FASTAFile::FASTAEntry entry;
+    while (f.readNext(entry))
+    {
+      writer.add(entry);
+    }
+    return writer.finish();
+  }
+
+  bool FASTAIndexFile::isCompiledFASTA(const String& filename)
+  {
+    std::ifstream ifs(filename.c_str(), std::ios::binary);
+    std::uint32_t magic = 0;
+    ifs.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    return ifs.good() && magic == COMPILED_FASTA_MAGIC;
+  }
+
+  void FASTAIndexFile::load(const String& filename, std::vector<FASTAFile::FASTAEntry>& data)
+  {
+    if (!isCompiledFASTA(filename))
+    {
+      FASTAFile().load(filename, data);
+      return;
+    }
+    FASTAIndexFile index(filename);
+    data.clear();
+    data.resize(index.size());
+    for (Size i = 0; i < data.size(); ++i)
+    {
+      index.getEntry(i, data[i]);
+    }
+  }
+
+  const char* FASTAIndexFile::at_(std::uint64_t offset) const
+  {
+    return file_->data() + offset;
+  }
+
+  std::uint64_t FASTAIndexFile::offset_(Size i) const
+  {
+    std::uint64_t o;
+    std::memcpy(&o, offsets_ + i * sizeof(std::uint64_t), sizeof(o));
+    return o;
+  }
+
+} // namespace OpenMS
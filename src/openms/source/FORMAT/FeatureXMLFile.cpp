@@ -96,6 +96,28 @@ namespace OpenMS
     feature_map.updateRanges();
   }
 
+  void FeatureXMLFile::transform(const String& filename, FeatureMap& feature_map, const std::function<void (Feature&)>& consumer)
+  {
+    feature_map.clear(true);
+    //set DocumentIdentifier
+    feature_map.setLoadedFileType(filename);
+    feature_map.setLoadedFilePath(filename);
+
+    Internal::FeatureXMLHandler handler(feature_map, filename);
+    handler.setOptions(options_);
+    handler.setLogType(getLogType());
+    handler.setFeatureConsumer([&consumer](Feature& feature)
+    {
+      // same FWHM hack as in load()
+      if (feature.metaValueExists("FWHM"))
+      {
+        feature.setWidth((double)feature.getMetaValue("FWHM"));
+      }
+      consumer(feature);
+    });
+    parse_(filename, &handler);
+  }
+
   void FeatureXMLFile::store(const String& filename, const FeatureMap& feature_map)
   {
 
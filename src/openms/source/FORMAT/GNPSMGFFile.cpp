@@ -258,7 +258,7 @@ namespace OpenMS
     // return will be reformatted vector<PeptideIdentification> pepts passed in by value
   }
 
-  void GNPSMGFFile::run(const String& consensus_file_path, const StringList& mzml_file_paths, const String& out) const
+  void GNPSMGFFile::run(const String& consensus_file_path, const StringList& mzml_file_paths, const String& out, std::vector<MSSpectrum>* exported_spectra) const
   {
     std::string output_type = getParameters().getValue("output_type");
 
@@ -278,6 +278,12 @@ namespace OpenMS
     ConsensusMap consensus_map;
     consensus_file.load(consensus_file_path, consensus_map);
 
+    if (exported_spectra != nullptr)
+    {
+      exported_spectra->clear();
+      exported_spectra->reserve(consensus_map.size());
+    }
+
     //-------------------------------------------------------------
     // open on-disc data (=spectra are only loaded on demand to safe memory)
     //-------------------------------------------------------------
@@ -393,6 +399,19 @@ namespace OpenMS
         output_file,
         peaks
       );
+
+      if (exported_spectra != nullptr)
+      {
+        MSSpectrum spectrum;
+        spectrum.setMSLevel(2);
+        spectrum.setRT(best_spec.getRT());
+        Precursor precursor;
+        precursor.setMZ(feature.getMZ());
+        precursor.setCharge(charge);
+        spectrum.getPrecursors().push_back(precursor);
+        spectrum.insert(spectrum.end(), peaks.begin(), peaks.end());
+        exported_spectra->push_back(std::move(spectrum));
+      }
     }
 
     output_file.close();
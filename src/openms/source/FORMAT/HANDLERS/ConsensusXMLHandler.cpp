@@ -54,6 +54,8 @@ namespace OpenMS::Internal
   {
     consensus_map_ = &map;
     file_ = filename;
+    load_peptide_ids_ = true;
+    disable_parsing_ = 0;
   }
 
   ConsensusXMLHandler::ConsensusXMLHandler(const ConsensusMap& map, const String& filename) :
@@ -64,6 +66,8 @@ namespace OpenMS::Internal
   {
     cconsensus_map_ = &map;
     file_ = filename;
+    load_peptide_ids_ = true;
+    disable_parsing_ = 0;
   }
 
   ConsensusXMLHandler::~ConsensusXMLHandler() = default;
@@ -83,17 +87,45 @@ namespace OpenMS::Internal
     return options_;
   }
 
+  void ConsensusXMLHandler::setConsensusFeatureConsumer(const std::function<void (ConsensusFeature&)>& consumer)
+  {
+    consensus_consumer_ = consumer;
+  }
+
+  void ConsensusXMLHandler::setLoadPeptideIdentifications(bool load)
+  {
+    load_peptide_ids_ = load;
+  }
+
   void ConsensusXMLHandler::endElement(const XMLCh* const /*uri*/, const XMLCh* const /*local_name*/, const XMLCh* const qname)
   {
     String tag = sm_.convert(qname);
     open_tags_.pop_back();
 
+    // handle skipping of whole sections
+    if (!load_peptide_ids_ && (tag == "PeptideIdentification" || tag == "UnassignedPeptideIdentification"))
+    {
+      --disable_parsing_;
+      return;
+    }
+    if (disable_parsing_)
+    {
+      return;
+    }
+
     if (tag == "consensusElement")
     {
       if ((!options_.hasRTRange() || options_.getRTRange().encloses(act_cons_element_.getRT())) && (!options_.hasMZRange() || options_.getMZRange().encloses(
                                                                                                       act_cons_element_.getMZ())) && (!options_.hasIntensityRange() || options_.getIntensityRange().encloses(act_cons_element_.getIntensity())))
       {
-        consensus_map_->push_back(act_cons_element_);
+        if (consensus_consumer_)
+        {
+          consensus_consumer_(act_cons_element_);
+        }
+        else
+        {
+          consensus_map_->push_back(act_cons_element_);
+        }
         act_cons_element_.getPeptideIdentifications().clear();
       }
       last_meta_ = nullptr;
@@ -160,6 +192,16 @@ namespace OpenMS::Internal
     open_tags_.push_back(sm_.convert(qname));
     const String& tag = open_tags_.back();
 
+    // handle skipping of whole sections
+    if (!load_peptide_ids_ && (tag == "PeptideIdentification" || tag == "UnassignedPeptideIdentification"))
+    {
+      ++disable_parsing_;
+    }
+    if (disable_parsing_)
+    {
+      return;
+    }
+
     String tmp_str;
     if (tag == "map")
     {
@@ -630,6 +672,21 @@ namespace OpenMS::Internal
     progress_ = 0;
     setProgress(++progress_);
 
+    writeHeader_(os, consensus_map);
+
+    // write all consensus elements
+    for (Size i = 0; i < consensus_map.size(); ++i)
+    {
+      setProgress(++progress_);
+      writeConsensusElement_(os, consensus_map[i]);
+    }
+
+    writeFooter_(os);
+    endProgress();
+  }
+
+  void ConsensusXMLHandler::writeHeader_(std::ostream& os, const ConsensusMap& consensus_map)
+  {
     setProgress(++progress_);
     os << "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>\n";
     os << "<?xml-stylesheet type=\"text/xsl\" href=\"https://www.openms.de/xml-stylesheet/ConsensusXML.xsl\" ?>\n";
@@ -797,49 +854,50 @@ namespace OpenMS::Internal
     }
     os << "\t</mapList>\n";
 
-    // write all consensus elements
     os << "\t<consensusElementList>\n";
-    for (Size i = 0; i < consensus_map.size(); ++i)
-    {
-      setProgress(++progress_);
-      // write a consensusElement
-      const ConsensusFeature& elem = consensus_map[i];
-      os << "\t\t<consensusElement id=\"e_" << elem.getUniqueId() << "\" quality=\"" << precisionWrapper(elem.getQuality()) << "\"";
-      if (elem.getCharge() != 0)
-      {
-        os << " charge=\"" << elem.getCharge() << "\"";
-      }
-      os << ">\n";
-      // write centroid
-      os << "\t\t\t<centroid rt=\"" << precisionWrapper(elem.getRT()) << "\" mz=\"" << precisionWrapper(elem.getMZ()) << "\" it=\"" << precisionWrapper(
-        elem.getIntensity()) << "\"/>\n";
-      // write groupedElementList
-      os << "\t\t\t<groupedElementList>\n";
-      for (ConsensusFeature::HandleSetType::const_iterator it = elem.begin(); it != elem.end(); ++it)
-      {
-        os << "\t\t\t\t<element"
-              " map=\"" << it->getMapIndex() << "\""
-                                                " id=\"" << it->getUniqueId() << "\""
-                                                                                 " rt=\"" << precisionWrapper(it->getRT()) << "\""
-                                                                                                                              " mz=\"" << precisionWrapper(it->getMZ()) << "\""
-                                                                                                                                                                           " it=\"" << precisionWrapper(it->getIntensity()) << "\"";
-        if (it->getCharge() != 0)
-        {
-          os << " charge=\"" << it->getCharge() << "\"";
-        }
-        os << "/>\n";
-      }
-      os << "\t\t\t</groupedElementList>\n";
+  }
 
-      // write PeptideIdentification
-      for (UInt j = 0; j < elem.getPeptideIdentifications().size(); ++j)
+  void ConsensusXMLHandler::writeConsensusElement_(std::ostream& os, const ConsensusFeature& elem)
+  {
+    os << "\t\t<consensusElement id=\"e_" << elem.getUniqueId() << "\" quality=\"" << precisionWrapper(elem.getQuality()) << "\"";
+    if (elem.getCharge() != 0)
+    {
+      os << " charge=\"" << elem.getCharge() << "\"";
+    }
+    os << ">\n";
+    // write centroid
+    os << "\t\t\t<centroid rt=\"" << precisionWrapper(elem.getRT()) << "\" mz=\"" << precisionWrapper(elem.getMZ()) << "\" it=\"" << precisionWrapper(
+      elem.getIntensity()) << "\"/>\n";
+    // write groupedElementList
+    os << "\t\t\t<groupedElementList>\n";
+    for (ConsensusFeature::HandleSetType::const_iterator it = elem.begin(); it != elem.end(); ++it)
+    {
+      os << "\t\t\t\t<element"
+            " map=\"" << it->getMapIndex() << "\""
+                                              " id=\"" << it->getUniqueId() << "\""
+                                                                               " rt=\"" << precisionWrapper(it->getRT()) << "\""
+                                                                                                                            " mz=\"" << precisionWrapper(it->getMZ()) << "\""
+                                                                                                                                                                         " it=\"" << precisionWrapper(it->getIntensity()) << "\"";
+      if (it->getCharge() != 0)
       {
-        writePeptideIdentification_(file_, os, elem.getPeptideIdentifications()[j], "PeptideIdentification", 3);
+        os << " charge=\"" << it->getCharge() << "\"";
       }
+      os << "/>\n";
+    }
+    os << "\t\t\t</groupedElementList>\n";
 
-      writeUserParam_("UserParam", os, elem, 3);
-      os << "\t\t</consensusElement>\n";
+    // write PeptideIdentification
+    for (UInt j = 0; j < elem.getPeptideIdentifications().size(); ++j)
+    {
+      writePeptideIdentification_(file_, os, elem.getPeptideIdentifications()[j], "PeptideIdentification", 3);
     }
+
+    writeUserParam_("UserParam", os, elem, 3);
+    os << "\t\t</consensusElement>\n";
+  }
+
+  void ConsensusXMLHandler::writeFooter_(std::ostream& os)
+  {
     os << "\t</consensusElementList>\n";
 
     os << "</consensusXML>\n";
@@ -847,7 +905,6 @@ namespace OpenMS::Internal
     //Clear members
     identifier_id_.clear();
     accession_to_id_.clear();
-    endProgress();
   }
 
   void ConsensusXMLHandler::writePeptideIdentification_(const String& filename, std::ostream& os, const PeptideIdentification& id, const String& tag_name,
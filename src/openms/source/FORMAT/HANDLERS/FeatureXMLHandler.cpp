@@ -74,6 +74,7 @@ namespace OpenMS::Internal
     //options_ = FeatureFileOptions(); do NOT reset this, since we need to preserve options!
     size_only_ = false;
     expected_size_ = 0;
+    consumed_features_ = 0;
     param_ = Param();
     current_chull_ = ConvexHull2D::PointArrayType();
     hull_position_ = DPosition<2>();
@@ -97,6 +98,23 @@ namespace OpenMS::Internal
   {
     const FeatureMap& feature_map = *(cmap_);
 
+    writeHeader_(os, feature_map, feature_map.size());
+
+    // write features with their corresponding attributes
+    startProgress(0, feature_map.size(), "Storing featureXML file");
+    for (Size s = 0; s < feature_map.size(); s++)
+    {
+      writeFeature_(file_, os, feature_map[s], "f_", feature_map[s].getUniqueId(), 0);
+      setProgress(s);
+      // writeFeature_(file_, os, feature_map[s], "f_", s, 0);
+    }
+    endProgress();
+
+    writeFooter_(os);
+  }
+
+  void FeatureXMLHandler::writeHeader_(std::ostream& os, const FeatureMap& feature_map, Size feature_count)
+  {
     os << "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>\n"
        << "<featureMap version=\"" << version_ << "\"";
     // file id
@@ -230,17 +248,11 @@ namespace OpenMS::Internal
       writePeptideIdentification_(file_, os, feature_map.getUnassignedPeptideIdentifications()[i], "UnassignedPeptideIdentification", 1);
     }
 
-    // write features with their corresponding attributes
-    os << "\t<featureList count=\"" << feature_map.size() << "\">\n";
-    startProgress(0, feature_map.size(), "Storing featureXML file");
-    for (Size s = 0; s < feature_map.size(); s++)
-    {
-      writeFeature_(file_, os, feature_map[s], "f_", feature_map[s].getUniqueId(), 0);
-      setProgress(s);
-      // writeFeature_(file_, os, feature_map[s], "f_", s, 0);
-    }
-    endProgress();
+    os << "\t<featureList count=\"" << feature_count << "\">\n";
+  }
 
+  void FeatureXMLHandler::writeFooter_(std::ostream& os)
+  {
     os << "\t</featureList>\n";
     os << "</featureMap>\n";
 
@@ -292,6 +304,10 @@ namespace OpenMS::Internal
     {
       ++disable_parsing_;
     }
+    else if ((!options_.getLoadPeptideIdentifications()) && (tag == "PeptideIdentification" || tag == "UnassignedPeptideIdentification"))
+    {
+      ++disable_parsing_;
+    }
     if (disable_parsing_)
     {
       return;
@@ -335,7 +351,7 @@ namespace OpenMS::Internal
         expected_size_ = count;
         throw EndParsingSoftly(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
       }
-      map_->reserve(std::min(Size(1e5), count)); // reserve vector for faster push_back, but with upper boundary of 1e5 (as >1e5 is most likely an invalid feature count)
+      if (!feature_consumer_) map_->reserve(std::min(Size(1e5), count)); // reserve vector for faster push_back, but with upper boundary of 1e5 (as >1e5 is most likely an invalid feature count)
       startProgress(0, count, "Loading featureXML file");
     }
     else if (tag == "quality" || tag == "hposition" || tag == "position")
@@ -733,7 +749,8 @@ namespace OpenMS::Internal
     // handle skipping of whole sections
     // IMPORTANT: check parent tags first (i.e. tags higher in the tree), since otherwise sections might be enabled/disabled too early/late
     if (((!options_.getLoadSubordinates()) && tag == "subordinate")
-       || ((!options_.getLoadConvexHull()) && tag == "convexhull"))
+       || ((!options_.getLoadConvexHull()) && tag == "convexhull")
+       || ((!options_.getLoadPeptideIdentifications()) && (tag == "PeptideIdentification" || tag == "UnassignedPeptideIdentification")))
     {
       --disable_parsing_;
       return; // even if disable_parsing is false now, we still exit (since this endelement() should be ignored)
@@ -761,6 +778,13 @@ namespace OpenMS::Internal
          &&  (!options_.hasMZRange() || options_.getMZRange().encloses(current_feature_->getMZ()))
          &&  (!options_.hasIntensityRange() || options_.getIntensityRange().encloses(current_feature_->getIntensity())))
       {
+        // when streaming, hand over completed top-level features right away
+        if (feature_consumer_ && subordinate_feature_level_ == 0)
+        {
+          feature_consumer_(map_->back());
+          map_->pop_back();
+          ++consumed_features_;
+        }
       }
       else
       {
@@ -1063,7 +1087,7 @@ namespace OpenMS::Internal
     {
       if (create)
       {
-        setProgress(map_->size());
+        setProgress(map_->size() + consumed_features_);
         map_->push_back(Feature());
         current_feature_ = &map_->back();
         last_meta_ =  &map_->back();
@@ -41,6 +41,8 @@
 #include <xercesc/dom/DOMElement.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
 
+#include <cstring>
+
 namespace OpenMS
 {
 
@@ -446,6 +448,404 @@ namespace OpenMS
     return sptr;
   }
 
+  namespace
+  {
+    /// A name or attribute value inside the input buffer (not null-terminated)
+    struct CharRange
+    {
+      const char* begin = nullptr;
+      Size length = 0;
+
+      bool operator==(const char* s) const
+      {
+        return strncmp(begin, s, length) == 0 && s[length] == '\0';
+      }
+    };
+
+    struct XMLAttribute
+    {
+      CharRange name;
+      CharRange value;
+    };
+
+    /**
+      @brief Minimal scanner for the tags of a single mzML spectrum/chromatogram
+
+      All functions return false if they encounter anything they do not
+      support, in which case the caller needs to use a full XML parser.
+    */
+    class MzMLElementScanner
+    {
+    public:
+      MzMLElementScanner(const char* begin, const char* end) :
+        pos_(begin),
+        end_(end)
+      {}
+
+      bool atEnd() const
+      {
+        return pos_ >= end_;
+      }
+
+      char peek(Size offset = 0) const
+      {
+        return (pos_ + offset < end_) ? pos_[offset] : '\0';
+      }
+
+      void skipWhitespace()
+      {
+        while (pos_ < end_ && isSpace_(*pos_)) ++pos_;
+      }
+
+      /// Skip character data up to the next '<'
+      void skipText()
+      {
+        const char* next = static_cast<const char*>(memchr(pos_, '<', end_ - pos_));
+        pos_ = (next == nullptr) ? end_ : next;
+      }
+
+      /// Read character data up to the next '<' (only plain ASCII without entities or carriage returns)
+      bool readText(CharRange& text)
+      {
+        text.begin = pos_;
+        skipText();
+        text.length = pos_ - text.begin;
+        for (Size i = 0; i < text.length; ++i)
+        {
+          const unsigned char c = text.begin[i];
+          if (c == '&' || c == '\r' || c >= 0x80) return false;
+        }
+        return !atEnd();
+      }
+
+      /// Read the start tag at the current '<', i.e. its name and attributes
+      bool readStartTag(CharRange& name, std::vector<XMLAttribute>& attributes, bool& self_closing)
+      {
+        attributes.clear();
+        self_closing = false;
+        ++pos_; // '<'
+        if (!readName_(name)) return false;
+        while (true)
+        {
+          const bool had_space = pos_ < end_ && isSpace_(*pos_);
+          skipWhitespace();
+          if (atEnd()) return false;
+          if (*pos_ == '>')
+          {
+            ++pos_;
+            return true;
+          }
+          if (*pos_ == '/')
+          {
+            if (peek(1) != '>') return false;
+            pos_ += 2;
+            self_closing = true;
+            return true;
+          }
+          if (!had_space) return false; // attributes need to be separated by whitespace
+
+          XMLAttribute attr;
+          if (!readName_(attr.name)) return false;
+          skipWhitespace();
+          if (peek() != '=') return false;
+          ++pos_;
+          skipWhitespace();
+          const char quote = peek();
+          if (quote != '"' && quote != '\'') return false;
+          ++pos_;
+          attr.value.begin = pos_;
+          while (pos_ < end_ && *pos_ != quote)
+          {
+            if (*pos_ == '<') return false;
+            ++pos_;
+          }
+          if (atEnd()) return false;
+          attr.value.length = pos_ - attr.value.begin;
+          ++pos_; // closing quote
+          attributes.push_back(attr);
+        }
+      }
+
+      /// Read the end tag at the current '</'
+      bool readEndTag(CharRange& name)
+      {
+        pos_ += 2; // '</'
+        if (!readName_(name)) return false;
+        skipWhitespace();
+        if (peek() != '>') return false;
+        ++pos_;
+        return true;
+      }
+
+      /**
+        @brief Decode an attribute value (predefined and numeric character entities, whitespace normalization)
+
+        Only ASCII content is supported.
+      */
+      static bool decodeValue(const CharRange& value, String& result)
+      {
+        result.clear();
+        const char* it = value.begin;
+        const char* end = value.begin + value.length;
+        while (it < end)
+        {
+          const unsigned char c = *it;
+          if (c >= 0x80)
+          {
+            return false;
+          }
+          else if (c == '&')
+          {
+            const char* semicolon = static_cast<const char*>(memchr(it, ';', end - it));
+            if (semicolon == nullptr) return false;
+            const CharRange entity{it + 1, Size(semicolon - it - 1)};
+            if (entity == "lt") result += '<';
+            else if (entity == "gt") result += '>';
+            else if (entity == "amp") result += '&';
+            else if (entity == "quot") result += '"';
+            else if (entity == "apos") result += '\'';
+            else if (entity.length > 1 && entity.begin[0] == '#')
+            {
+              const bool hex = entity.begin[1] == 'x';
+              const char* digits = entity.begin + (hex ? 2 : 1);
+              if (digits == semicolon) return false;
+              unsigned long code = 0;
+              for (const char* d = digits; d < semicolon; ++d)
+              {
+                int digit;
+                if (*d >= '0' && *d <= '9') digit = *d - '0';
+                else if (hex && *d >= 'a' && *d <= 'f') digit = *d - 'a' + 10;
+                else if (hex && *d >= 'A' && *d <= 'F') digit = *d - 'A' + 10;
+                else return false;
+                code = code * (hex ? 16 : 10) + digit;
+                if (code >= 0x80) return false;
+              }
+              if (code == 0) return false;
+              result += char(code);
+            }
+            else
+            {
+              return false;
+            }
+            it = semicolon + 1;
+            continue;
+          }
+          else if (c == '\r')
+          {
+            // line ends are normalized to a single whitespace
+            result += ' ';
+            if (it + 1 < end && it[1] == '\n') ++it;
+          }
+          else if (c == '\n' || c == '\t')
+          {
+            result += ' ';
+          }
+          else
+          {
+            result += char(c);
+          }
+          ++it;
+        }
+        return true;
+      }
+
+    private:
+      static bool isSpace_(char c)
+      {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+      }
+
+      bool readName_(CharRange& name)
+      {
+        name.begin = pos_;
+        while (pos_ < end_)
+        {
+          const char c = *pos_;
+          if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':' ||
+              (pos_ != name.begin && ((c >= '0' && c <= '9') || c == '-' || c == '.')))
+          {
+            ++pos_;
+          }
+          else
+          {
+            break;
+          }
+        }
+        name.length = pos_ - name.begin;
+        return name.length > 0;
+      }
+
+      const char* pos_;
+      const char* end_;
+    };
+
+    const XMLAttribute* findAttribute(const std::vector<XMLAttribute>& attributes, const char* name)
+    {
+      for (const XMLAttribute& attr : attributes)
+      {
+        if (attr.name == name) return &attr;
+      }
+      return nullptr;
+    }
+  }
+
+  bool MzMLSpectrumDecoder::fastParseString_(const std::string& in, std::vector<BinaryData>& data, std::string& id) const
+  {
+    MzMLElementScanner scanner(in.data(), in.data() + in.size());
+    std::vector<XMLAttribute> attributes;
+    std::vector<CharRange> open_elements;
+    CharRange name, text;
+    bool self_closing;
+
+    //-------------------------------------------------------------
+    // root element: <spectrum> or <chromatogram>
+    //-------------------------------------------------------------
+    scanner.skipWhitespace();
+    if (scanner.peek() != '<' || !scanner.readStartTag(name, attributes, self_closing))
+    {
+      return false;
+    }
+    if (!(name == "spectrum") && !(name == "chromatogram"))
+    {
+      return false; // DOM parser checks the precondition
+    }
+    const XMLAttribute* length_attr = findAttribute(attributes, "defaultArrayLength");
+    if (length_attr == nullptr || length_attr->value.length == 0 || length_attr->value.length > 9)
+    {
+      return false; // DOM parser reports the error
+    }
+    int default_array_length = 0;
+    for (Size i = 0; i < length_attr->value.length; ++i)
+    {
+      const char c = length_attr->value.begin[i];
+      if (c < '0' || c > '9') return false;
+      default_array_length = default_array_length * 10 + (c - '0');
+    }
+    const XMLAttribute* id_attr = findAttribute(attributes, "id");
+    if (id_attr != nullptr)
+    {
+      String tmp;
+      if (!MzMLElementScanner::decodeValue(id_attr->value, tmp)) return false;
+      id = tmp;
+    }
+    if (self_closing)
+    {
+      return true;
+    }
+    open_elements.push_back(name);
+
+    //-------------------------------------------------------------
+    // content: only direct children of <binaryDataArray> are interpreted
+    //-------------------------------------------------------------
+    Size bda_depth = 0; // number of open elements including the current <binaryDataArray> (0 if outside)
+    bool has_binary_tag = false;
+    String accession, value, cv_name, unit_accession;
+    while (true)
+    {
+      scanner.skipText();
+      if (scanner.atEnd())
+      {
+        return false; // unclosed root element
+      }
+      const char next = scanner.peek(1);
+      if (next == '!' || next == '?')
+      {
+        return false; // comments, CDATA, DTD and processing instructions
+      }
+
+      if (next == '/')
+      {
+        if (!scanner.readEndTag(name)) return false;
+        const CharRange& open = open_elements.back();
+        if (open.length != name.length || strncmp(open.begin, name.begin, name.length) != 0)
+        {
+          return false; // mismatched tags
+        }
+        if (open_elements.size() == bda_depth)
+        {
+          if (!has_binary_tag) return false; // DOM parser reports the error
+          data.back().size = default_array_length;
+          bda_depth = 0;
+        }
+        open_elements.pop_back();
+        if (open_elements.empty())
+        {
+          return true; // ignore anything after the root element
+        }
+        continue;
+      }
+
+      if (!scanner.readStartTag(name, attributes, self_closing)) return false;
+
+      if (name == "binaryDataArray")
+      {
+        if (bda_depth != 0) return false; // nested arrays are not valid mzML
+        data.emplace_back();
+        has_binary_tag = false;
+        if (self_closing) return false; // DOM parser reports the missing <binary>
+        bda_depth = open_elements.size() + 1;
+      }
+      else if (bda_depth != 0 && open_elements.size() == bda_depth)
+      {
+        if (name == "binary")
+        {
+          has_binary_tag = true;
+          if (self_closing) continue;
+          if (!scanner.readText(text)) return false;
+          // the <binary> element may only contain text
+          if (scanner.peek(1) != '/' || !scanner.readEndTag(name) || !(name == "binary")) return false;
+          if (text.length > 0)
+          {
+            data.back().base64.append(text.begin, text.length);
+          }
+          continue;
+        }
+        else if (name == "cvParam")
+        {
+          const XMLAttribute* attr;
+          accession.clear();
+          value.clear();
+          cv_name.clear();
+          unit_accession.clear();
+          if ((attr = findAttribute(attributes, "accession")) && !MzMLElementScanner::decodeValue(attr->value, accession)) return false;
+          if ((attr = findAttribute(attributes, "value")) && !MzMLElementScanner::decodeValue(attr->value, value)) return false;
+          if ((attr = findAttribute(attributes, "name")) && !MzMLElementScanner::decodeValue(attr->value, cv_name)) return false;
+          if ((attr = findAttribute(attributes, "unitAccession")) && !MzMLElementScanner::decodeValue(attr->value, unit_accession)) return false;
+
+          // set precision, data_type
+          Internal::MzMLHandlerHelper::handleBinaryDataArrayCVParam(data, accession, value, cv_name, unit_accession);
+        }
+        else if (name == "userParam")
+        {
+          std::cout << " unhandled userParam" << std::endl;
+        }
+        else if (name == "referenceableParamGroupRef")
+        {
+          std::cout << " unhandled referenceableParamGroupRef" << std::endl;
+        }
+      }
+
+      if (!self_closing)
+      {
+        open_elements.push_back(name);
+      }
+    }
+  }
+
+  std::string MzMLSpectrumDecoder::parseString_(const std::string& in, std::vector<BinaryData>& data)
+  {
+    if (!use_dom_parser_)
+    {
+      std::string id;
+      if (fastParseString_(in, data, id))
+      {
+        return id;
+      }
+      data.clear();
+    }
+    return domParseString_(in, data);
+  }
+
   void MzMLSpectrumDecoder::handleBinaryDataArray_(xercesc::DOMNode* indexListNode, std::vector<BinaryData>& data)
   {
     // access result through data.back()
@@ -619,14 +1019,14 @@ namespace OpenMS
   void MzMLSpectrumDecoder::domParseSpectrum(const std::string& in, OpenMS::Interfaces::SpectrumPtr& sptr)
   {
     std::vector<BinaryData> data;
-    domParseString_(in, data);
+    parseString_(in, data);
     sptr = decodeBinaryDataSpectrum_(data);
   }
 
   void MzMLSpectrumDecoder::domParseSpectrum(const std::string& in, MSSpectrum& s)
   {
     std::vector<BinaryData> data;
-    std::string id = domParseString_(in, data);
+    std::string id = parseString_(in, data);
     decodeBinaryDataMSSpectrum_(data, s);
     s.setNativeID(id);
   }
@@ -634,7 +1034,7 @@ namespace OpenMS
   void MzMLSpectrumDecoder::domParseChromatogram(const std::string& in, MSChromatogram& c)
   {
     std::vector<BinaryData> data;
-    std::string id = domParseString_(in, data);
+    std::string id = parseString_(in, data);
     decodeBinaryDataMSChrom_(data, c);
     c.setNativeID(id);
   }
@@ -642,7 +1042,7 @@ namespace OpenMS
   void MzMLSpectrumDecoder::domParseChromatogram(const std::string& in, OpenMS::Interfaces::ChromatogramPtr& sptr)
   {
     std::vector<BinaryData> data;
-    domParseString_(in, data);
+    parseString_(in, data);
     sptr = decodeBinaryDataChrom_(data);
   }
 
@@ -651,5 +1051,10 @@ namespace OpenMS
     skip_xml_checks_ = skip;
   }
 
+  void MzMLSpectrumDecoder::setUseDOMParser(bool use_dom)
+  {
+    use_dom_parser_ = use_dom;
+  }
+
 }
 
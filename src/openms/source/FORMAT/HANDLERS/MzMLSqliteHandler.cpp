@@ -78,6 +78,21 @@ namespace OpenMS::Internal
       return tmp;
     }
 
+    /// set intensities of @p container from @p data (resizes the container if still empty)
+    template<class ContainerT, typename ValueT>
+    void setIntensities_(ContainerT& container, const std::vector<ValueT>& data)
+    {
+      if (container.empty())
+      {
+        container.resize(data.size());
+      }
+      auto data_it = data.begin();
+      for (auto it = container.begin(); it != container.end(); ++it, ++data_it)
+      {
+        it->setIntensity(*data_it);
+      }
+    }
+
     /*
      *
      * This function populates a set of empty data containers (MSSpectrum or
@@ -105,6 +120,7 @@ namespace OpenMS::Internal
       cont_data.resize(containers.size());
       std::map<Size,Size> sql_container_map;
       std::vector<double> data;
+      std::vector<float> float_data; // slof-coded intensities are decoded directly to float
       String stemp;
       while (sqlite3_column_type( stmt, 0 ) != SQLITE_NULL)
       {
@@ -141,6 +157,7 @@ namespace OpenMS::Internal
         // data_type is one of 0 = mz, 1 = int, 2 = rt
         // compression is one of 0 = no, 1 = zlib, 2 = np-linear, 3 = np-slof, 4 = np-pic, 5 = np-linear + zlib, 6 = np-slof + zlib, 7 = np-pic + zlib
         data.clear();
+        float_data.clear();
         stemp.clear();
         if (compression == 1)
         {
@@ -169,7 +186,14 @@ namespace OpenMS::Internal
           OpenMS::ZlibCompression::uncompressString(raw_text, blob_bytes, stemp);
           MSNumpressCoder::NumpressConfig config;
           config.setCompression("slof");
-          MSNumpressCoder().decodeNPRaw(stemp, data, config);
+          if (data_type == 1)
+          {
+            MSNumpressCoder().decodeNPRaw(stemp, float_data, config);
+          }
+          else
+          {
+            MSNumpressCoder().decodeNPRaw(stemp, data, config);
+          }
         }
         else
         {
@@ -180,14 +204,13 @@ namespace OpenMS::Internal
         if (data_type == 1)
         {
           // intensity
-          if (containers[curr_id].empty())
+          if (compression == 6)
           {
-            containers[curr_id].resize(data.size());
+            setIntensities_(containers[curr_id], float_data);
           }
-          std::vector< double >::iterator data_it = data.begin();
-          for (auto it = containers[curr_id].begin(); it != containers[curr_id].end(); ++it, ++data_it)
+          else
           {
-            it->setIntensity(*data_it);
+            setIntensities_(containers[curr_id], data);
           }
           cont_data[curr_id] += 1;
         }
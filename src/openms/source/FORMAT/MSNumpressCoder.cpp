@@ -87,6 +87,14 @@ namespace OpenMS
     // decodeNP_internal_(reinterpret_cast<const unsigned char*>(base64_uncompressed.constData()), base64_uncompressed.size(), out, config);
   }
 
+  void MSNumpressCoder::decodeNP(const String & in, std::vector<float> & out,
+      bool zlib_compression, const NumpressConfig & config)
+  {
+    QByteArray base64_uncompressed;
+    Base64::decodeSingleString(in, base64_uncompressed, zlib_compression);
+    decodeNPInternal_(reinterpret_cast<const unsigned char*>(base64_uncompressed.constData()), base64_uncompressed.size(), out, config);
+  }
+
   void MSNumpressCoder::encodeNPRaw(const std::vector<double>& in, String& result, const NumpressConfig & config)
   {
     if (in.empty())
@@ -299,87 +307,107 @@ namespace OpenMS
     decodeNPInternal_(reinterpret_cast<const unsigned char*>(in.c_str()), in.size(), out, config);
   }
 
-  void MSNumpressCoder::decodeNPInternal_(const unsigned char* in, size_t in_size, std::vector<double>& out, const NumpressConfig & config)
+  void MSNumpressCoder::decodeNPRaw(const std::string & in, std::vector<float>& out, const NumpressConfig & config)
   {
-    out.clear();
-    if (in_size == 0) return;
-
-    size_t byteCount = in_size;
+    decodeNPInternal_(reinterpret_cast<const unsigned char*>(in.c_str()), in.size(), out, config);
+  }
 
-#ifdef NUMPRESS_DEBUG
-    std::cout << "decodeNPInternal_: array input with length " << in_size << std::endl;
-    for (int i = 0; i < in_size; i++)
+  namespace
+  {
+    /// numpress decoding into double or float output (the MSNumpress decoders are overloaded for both)
+    template <typename T>
+    void decodeNumpress(const unsigned char* in, size_t in_size, std::vector<T>& out, const MSNumpressCoder::NumpressConfig & config)
     {
-      std::cout << "array[" << i << "] : " << (int)in[i] << std::endl;
-    }
-#endif
+      out.clear();
+      if (in_size == 0) return;
 
-    try
-    {
-      size_t initialSize;
+      size_t byteCount = in_size;
 
-      switch (config.np_compression)
-      {
-      case LINEAR:
+#ifdef NUMPRESS_DEBUG
+      std::cout << "decodeNPInternal_: array input with length " << in_size << std::endl;
+      for (int i = 0; i < in_size; i++)
       {
-        initialSize = byteCount * 2;
-        if (out.size() < initialSize)
-        { 
-          out.resize(initialSize);
-        }
-        size_t count = numpress::MSNumpress::decodeLinear(in, byteCount, &out[0]);
-        out.resize(count);
-        break;
+        std::cout << "array[" << i << "] : " << (int)in[i] << std::endl;
       }
+#endif
 
-      case PIC:
+      try
       {
-        initialSize = byteCount * 2;
-        if (out.size() < initialSize)
-        { 
-          out.resize(initialSize);
+        size_t initialSize;
+
+        switch (config.np_compression)
+        {
+        case MSNumpressCoder::LINEAR:
+        {
+          initialSize = byteCount * 2;
+          if (out.size() < initialSize)
+          { 
+            out.resize(initialSize);
+          }
+          size_t count = numpress::MSNumpress::decodeLinear(in, byteCount, &out[0]);
+          out.resize(count);
+          break;
         }
-        size_t count = numpress::MSNumpress::decodePic(in, byteCount, &out[0]);
-        out.resize(count);
-        break;
-      }
 
-      case SLOF:
-      {
-        initialSize = byteCount / 2;
-        if (out.size() < initialSize)
-        { 
-          out.resize(initialSize);
+        case MSNumpressCoder::PIC:
+        {
+          initialSize = byteCount * 2;
+          if (out.size() < initialSize)
+          { 
+            out.resize(initialSize);
+          }
+          size_t count = numpress::MSNumpress::decodePic(in, byteCount, &out[0]);
+          out.resize(count);
+          break;
         }
-        size_t count = numpress::MSNumpress::decodeSlof(in, byteCount, &out[0]);
-        out.resize(count);
-        break;
-      }
 
-      case NONE:
+        case MSNumpressCoder::SLOF:
+        {
+          initialSize = byteCount / 2;
+          if (out.size() < initialSize)
+          { 
+            out.resize(initialSize);
+          }
+          size_t count = numpress::MSNumpress::decodeSlof(in, byteCount, &out[0]);
+          out.resize(count);
+          break;
+        }
+
+        case MSNumpressCoder::NONE:
+        {
+          return;
+        }
+
+        default:
+          break;
+        }
+
+      }
+      catch (...)
       {
-        return;
+        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Error in Numpress decompression");
       }
 
-      default:
-        break;
+#ifdef NUMPRESS_DEBUG
+      std::cout << "decodeNPInternal_: output size " << out.size() << std::endl;
+      for (int i = 0; i < out.size(); i++)
+      {
+        std::cout << "array[" << i << "] : " << out[i] << std::endl;
       }
+#endif
 
-    }
-    catch (...)
-    {
-      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Error in Numpress decompression");
-    }
 
-#ifdef NUMPRESS_DEBUG
-    std::cout << "decodeNPInternal_: output size " << out.size() << std::endl;
-    for (int i = 0; i < out.size(); i++)
-    {
-      std::cout << "array[" << i << "] : " << out[i] << std::endl;
     }
-#endif
+  }
 
+  void MSNumpressCoder::decodeNPInternal_(const unsigned char* in, size_t in_size, std::vector<double>& out, const NumpressConfig & config)
+  {
+    decodeNumpress(in, in_size, out, config);
+  }
 
+  void MSNumpressCoder::decodeNPInternal_(const unsigned char* in, size_t in_size, std::vector<float>& out, const NumpressConfig & config)
+  {
+    decodeNumpress(in, in_size, out, config);
   }
 
 } //namespace OpenMS
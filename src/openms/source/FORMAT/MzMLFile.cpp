@@ -34,17 +34,28 @@
 
 #include <OpenMS/FORMAT/MzMLFile.h>
 
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/FORMAT/HANDLERS/IndexedMzMLDecoder.h>
 #include <OpenMS/FORMAT/HANDLERS/MzMLHandler.h>
 #include <OpenMS/FORMAT/HANDLERS/XMLHandler.h>
 #include <OpenMS/FORMAT/CVMappingFile.h>
 #include <OpenMS/FORMAT/VALIDATORS/XMLValidator.h>
 #include <OpenMS/FORMAT/VALIDATORS/MzMLValidator.h>
 #include <OpenMS/FORMAT/TextFile.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataArenaConsumer.h>
 #include <OpenMS/FORMAT/DATAACCESS/MSDataTransformingConsumer.h>
 #include <OpenMS/SYSTEM/File.h>
+#include <OpenMS/SYSTEM/Tracer.h>
 
+#include <cctype>
+#include <exception>
+#include <fstream>
 #include <sstream>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
@@ -157,17 +168,311 @@ namespace OpenMS
     parseBuffer_(buffer, &handler);
   }
 
+  void MzMLFile::load(const String& filename, ArenaMSExperiment& map)
+  {
+    Tracer::Scope trace("MzMLFile::load");
+    trace.samplePeakMemory();
+    map.clear();
+
+    MSDataArenaConsumer consumer(map);
+    transform(filename, &consumer);
+
+    //set DocumentIdentifier (after transform(), which replaces the experimental settings)
+    map.setLoadedFileType(filename);
+    map.setLoadedFilePath(filename);
+  }
+
   void MzMLFile::load(const String& filename, PeakMap& map)
   {
+    Tracer::Scope trace("MzMLFile::load");
+    trace.samplePeakMemory();
     map.reset();
 
     //set DocumentIdentifier
     map.setLoadedFileType(filename);
     map.setLoadedFilePath(filename);
 
-    Internal::MzMLHandler handler(map, filename, getVersion(), *this);
-    handler.setOptions(options_);
-    safeParse_(filename, &handler);
+    bool loaded = false;
+    if (options_.getParallelIndexedLoad() && !options_.getMetadataOnly())
+    {
+      if (!File::exists(filename))
+      {
+        throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+      }
+      try
+      {
+        loaded = loadIndexedParallel_(filename, map);
+      }
+      catch (Exception::BaseException& e)
+      {
+        String expr;
+        expr += e.getFile();
+        expr += "@";
+        expr += e.getLine();
+        expr += "-";
+        expr += e.getFunction();
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, expr, String("- due to that error of type ") + e.getName());
+      }
+    }
+    if (!loaded)
+    {
+      Internal::MzMLHandler handler(map, filename, getVersion(), *this);
+      handler.setOptions(options_);
+      safeParse_(filename, &handler);
+    }
+    trace.addItems(map.size() + map.getChromatograms().size());
+  }
+
+  namespace
+  {
+    /// Read the bytes [begin, end) of a file
+    std::string readFileRange(std::ifstream& ifs, std::streampos begin, std::streampos end)
+    {
+      std::string buffer(Size(end - begin), '\0');
+      ifs.seekg(begin);
+      ifs.read(&buffer[0], buffer.size());
+      if (ifs.gcount() != std::streamsize(buffer.size()))
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "",
+            "Could not read " + String(buffer.size()) + " bytes at offset " + String(Size(begin)));
+      }
+      return buffer;
+    }
+
+    /// Set the 'count' attribute of the last <tag ...> start tag in @p text (the number only serves to reserve memory)
+    void setListCount(std::string& text, const String& tag, Size count)
+    {
+      const Size start = text.rfind("<" + tag);
+      if (start == std::string::npos) return;
+      const Size tag_end = text.find('>', start);
+      Size attr = start;
+      while ((attr = text.find("count=", attr + 1)) < tag_end)
+      {
+        const char quote = text[attr + 6];
+        if (std::isspace(static_cast<unsigned char>(text[attr - 1])) && (quote == '"' || quote == '\''))
+        {
+          const Size value_end = text.find(quote, attr + 7);
+          if (value_end < tag_end)
+          {
+            text.replace(attr + 7, value_end - attr - 7, String(count));
+          }
+          return;
+        }
+      }
+    }
+  }
+
+  bool MzMLFile::loadIndexedParallel_(const String& filename, PeakMap& map)
+  {
+    IndexedMzMLDecoder decoder;
+    const std::streampos index_offset = decoder.findIndexListOffset(filename);
+    if (index_offset == std::streampos(-1))
+    {
+      return false;
+    }
+    IndexedMzMLDecoder::OffsetVector spectra_offsets, chromatograms_offsets;
+    if (decoder.parseOffsets(filename, index_offset, spectra_offsets, chromatograms_offsets) != 0)
+    {
+      return false;
+    }
+
+    // <spectrumList> and <chromatogramList> in file order
+    struct ListInfo
+    {
+      String tag;
+      std::vector<std::streampos> offsets;
+      std::streampos end; ///< position of the closing tag of the list
+      std::string prefix; ///< everything from the start of the file up to the first entry of this list
+    };
+    std::vector<ListInfo> lists;
+    for (const auto& list : {std::make_pair("spectrumList", &spectra_offsets), std::make_pair("chromatogramList", &chromatograms_offsets)})
+    {
+      if (list.second->empty()) continue;
+      lists.emplace_back();
+      lists.back().tag = list.first;
+      for (const auto& offset : *list.second)
+      {
+        // entries need to be ordered as in the file
+        if (offset.second >= index_offset || (!lists.back().offsets.empty() && offset.second <= lists.back().offsets.back()))
+        {
+          return false;
+        }
+        lists.back().offsets.push_back(offset.second);
+      }
+    }
+    if (lists.empty() || spectra_offsets.size() + chromatograms_offsets.size() < 2)
+    {
+      return false;
+    }
+    if (lists.size() == 2)
+    {
+      if (lists[1].offsets[0] < lists[0].offsets[0])
+      {
+        std::swap(lists[0], lists[1]);
+      }
+      if (lists[0].offsets.back() > lists[1].offsets[0])
+      {
+        return false; // interleaved lists are not valid mzML
+      }
+    }
+
+    //-------------------------------------------------------------
+    // locate the list boundaries
+    //-------------------------------------------------------------
+    std::ifstream ifs(filename.c_str(), std::ios::binary);
+    lists[0].prefix = readFileRange(ifs, 0, lists[0].offsets[0]);
+    if (lists[0].prefix.rfind("<" + lists[0].tag) == std::string::npos)
+    {
+      return false;
+    }
+    const String closing = String("</run></mzML>") + (lists[0].prefix.find("<indexedmzML") != std::string::npos ? "</indexedmzML>" : "");
+    for (Size l = 0; l < lists.size(); ++l)
+    {
+      ListInfo& list = lists[l];
+      const std::streampos next = (l + 1 < lists.size()) ? lists[l + 1].offsets[0] : index_offset;
+      const std::string tail = readFileRange(ifs, list.offsets.back(), next);
+      const Size pos = tail.rfind("</" + list.tag);
+      if (pos == std::string::npos)
+      {
+        return false;
+      }
+      list.end = list.offsets.back() + std::streamoff(pos);
+      if (l + 1 < lists.size())
+      {
+        // the next list follows the closing tag of this (now empty) list
+        lists[l + 1].prefix = list.prefix;
+        setListCount(lists[l + 1].prefix, list.tag, 0);
+        lists[l + 1].prefix.append(tail, pos, std::string::npos);
+      }
+    }
+
+    //-------------------------------------------------------------
+    // parse blocks of consecutive entries in parallel
+    //-------------------------------------------------------------
+    struct Block
+    {
+      Size list;
+      Size first;
+      Size last; ///< past-the-end
+    };
+    std::vector<Block> blocks;
+#ifdef _OPENMP
+    const Size nr_threads = omp_get_max_threads();
+#else
+    const Size nr_threads = 1;
+#endif
+    for (Size l = 0; l < lists.size(); ++l)
+    {
+      // several blocks per thread for load balancing, since entries differ in size
+      const Size nr_entries = lists[l].offsets.size();
+      const Size block_size = std::max(Size(1), (nr_entries + 4 * nr_threads - 1) / (4 * nr_threads));
+      for (Size first = 0; first < nr_entries; first += block_size)
+      {
+        blocks.push_back({l, first, std::min(first + block_size, nr_entries)});
+      }
+    }
+
+    ProgressLogger silent_logger;
+    std::vector<PeakMap> parts(blocks.size());
+    std::exception_ptr parse_error;
+    bool invalid_offsets = false;
+    Size progress = 0;
+    startProgress(0, blocks.size(), "loading indexed mzML");
+#pragma omp parallel for schedule(dynamic, 1)
+    for (SignedSize b = 0; b < (SignedSize)blocks.size(); ++b)
+    {
+      try
+      {
+        const Block& block = blocks[b];
+        const ListInfo& list = lists[block.list];
+        const std::streampos end = (block.last < list.offsets.size()) ? list.offsets[block.last] : list.end;
+
+        std::ifstream block_ifs(filename.c_str(), std::ios::binary);
+        const std::string entries = readFileRange(block_ifs, list.offsets[block.first], end);
+        // all offsets need to point to a <spectrum> or <chromatogram> tag (the list tag without 'List')
+        const Size element_length = list.tag.size() - 4;
+        bool valid = true;
+        for (Size i = block.first; i < block.last && valid; ++i)
+        {
+          const Size pos = list.offsets[i] - list.offsets[block.first];
+          valid = pos + element_length + 1 < entries.size() && entries[pos] == '<' &&
+                  entries.compare(pos + 1, element_length, list.tag, 0, element_length) == 0 &&
+                  std::isspace(static_cast<unsigned char>(entries[pos + element_length + 1]));
+        }
+        if (!valid)
+        {
+#pragma omp critical (MzMLFile_loadIndexedParallel_error)
+          invalid_offsets = true;
+          continue;
+        }
+
+        std::string document = list.prefix;
+        setListCount(document, list.tag, block.last - block.first);
+        document += entries;
+        document += "</" + list.tag + ">" + closing;
+
+        Internal::MzMLHandler handler(parts[b], filename, getVersion(), silent_logger);
+        handler.setOptions(options_);
+        parseBuffer_(document, &handler);
+      }
+      catch (...)
+      {
+#pragma omp critical (MzMLFile_loadIndexedParallel_error)
+        if (!parse_error)
+        {
+          parse_error = std::current_exception();
+        }
+      }
+#pragma omp critical (MzMLFile_loadIndexedParallel_progress)
+      setProgress(++progress);
+    }
+    endProgress();
+    if (invalid_offsets)
+    {
+      OPENMS_LOG_WARN << "The index of '" << filename << "' does not match its content. Loading it sequentially." << std::endl;
+      return false;
+    }
+    if (parse_error)
+    {
+      std::rethrow_exception(parse_error);
+    }
+
+    //-------------------------------------------------------------
+    // parse the header once to obtain the experimental settings
+    //-------------------------------------------------------------
+    {
+      std::string header = lists[0].prefix;
+      setListCount(header, lists[0].tag, 0);
+      header += "</" + lists[0].tag + ">" + closing;
+      Internal::MzMLHandler handler(map, filename, getVersion(), silent_logger);
+      handler.setOptions(options_);
+      parseBuffer_(header, &handler);
+    }
+
+    //-------------------------------------------------------------
+    // concatenate in file order
+    //-------------------------------------------------------------
+    Size nr_spectra = 0, nr_chromatograms = 0;
+    for (const PeakMap& part : parts)
+    {
+      nr_spectra += part.size();
+      nr_chromatograms += part.getChromatograms().size();
+    }
+    map.reserveSpaceSpectra(nr_spectra);
+    map.reserveSpaceChromatograms(nr_chromatograms);
+    for (PeakMap& part : parts)
+    {
+      for (MSSpectrum& spectrum : part.getSpectra())
+      {
+        map.addSpectrum(std::move(spectrum));
+      }
+      for (MSChromatogram& chromatogram : part.getChromatograms())
+      {
+        map.addChromatogram(std::move(chromatogram));
+      }
+      part.clear(true);
+    }
+    return true;
   }
 
   void MzMLFile::store(const String& filename, const PeakMap& map) const
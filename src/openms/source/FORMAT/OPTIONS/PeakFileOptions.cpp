@@ -63,7 +63,8 @@ namespace OpenMS
     np_config_int_(),
     np_config_fda_(),
     maximal_data_pool_size_(100),
-    precursor_mz_selected_ion_(true)
+    precursor_mz_selected_ion_(true),
+    parallel_indexed_load_(false)
   {
   }
 
@@ -92,7 +93,8 @@ namespace OpenMS
     np_config_int_(options.np_config_int_),
     np_config_fda_(options.np_config_fda_),
     maximal_data_pool_size_(options.maximal_data_pool_size_),
-    precursor_mz_selected_ion_(options.precursor_mz_selected_ion_)
+    precursor_mz_selected_ion_(options.precursor_mz_selected_ion_),
+    parallel_indexed_load_(options.parallel_indexed_load_)
   {
   }
 
@@ -362,6 +364,16 @@ namespace OpenMS
     precursor_mz_selected_ion_ = choice;
   }
 
+  bool PeakFileOptions::getParallelIndexedLoad() const
+  {
+    return parallel_indexed_load_;
+  }
+
+  void PeakFileOptions::setParallelIndexedLoad(bool parallel)
+  {
+    parallel_indexed_load_ = parallel;
+  }
+
   bool PeakFileOptions::hasFilters() const
   {
     return (has_rt_range_ || hasMSLevels());
@@ -0,0 +1,242 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/FORMAT/ReadAheadIfstream.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/FORMAT/Bzip2Ifstream.h>
+#include <OpenMS/FORMAT/GzipIfstream.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+
+namespace OpenMS
+{
+  ReadAheadIfstream::ReadAheadIfstream() :
+    producer_done_(true),
+    stop_(false),
+    current_pos_(0),
+    chunk_size_(1 << 20),
+    max_chunks_(4),
+    is_open_(false),
+    stream_at_end_(true)
+  {
+  }
+
+  ReadAheadIfstream::ReadAheadIfstream(const char * filename, CompressionType type) :
+    ReadAheadIfstream()
+  {
+    open(filename, type);
+  }
+
+  ReadAheadIfstream::~ReadAheadIfstream()
+  {
+    close();
+  }
+
+  bool ReadAheadIfstream::isCompressed(const char * filename)
+  {
+    ifstream in(filename, ios::binary);
+    unsigned char magic[2] = {0, 0};
+    in.read(reinterpret_cast<char*>(magic), 2);
+    if (in.gcount() != 2) return false;
+    return (magic[0] == 'B' && magic[1] == 'Z') || // bzip2
+           (magic[0] == 0x1f && magic[1] == 0x8b); // gzip
+  }
+
+  void ReadAheadIfstream::setBufferSize(Size chunk_size, Size max_chunks)
+  {
+    chunk_size_ = std::max(chunk_size, Size(1));
+    max_chunks_ = std::max(max_chunks, Size(1));
+  }
+
+  void ReadAheadIfstream::open(const char * filename, CompressionType type)
+  {
+    close();
+
+    if (type == AUTO)
+    {
+      ifstream in(filename, ios::binary);
+      if (!in)
+      {
+        throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+      }
+      char magic[2] = {0, 0};
+      in.read(magic, 2);
+      type = (magic[0] == 'B' && magic[1] == 'Z') ? BZIP2 : GZIP;
+    }
+
+    // open in the calling thread, so a missing file is reported right away
+    if (type == BZIP2)
+    {
+      bzip2_.reset(new Bzip2Ifstream(filename));
+    }
+    else
+    {
+      gzip_.reset(new GzipIfstream(filename));
+    }
+
+    chunks_.clear();
+    current_.clear();
+    current_pos_ = 0;
+    producer_done_ = false;
+    stop_ = false;
+    error_ = nullptr;
+    is_open_ = true;
+    stream_at_end_ = false;
+
+    worker_ = std::thread(&ReadAheadIfstream::run_, this);
+  }
+
+  void ReadAheadIfstream::run_()
+  {
+    try
+    {
+      bool at_end = false;
+      while (!at_end)
+      {
+        std::vector<char> chunk;
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          if (!free_chunks_.empty())
+          {
+            chunk.swap(free_chunks_.back());
+            free_chunks_.pop_back();
+          }
+        }
+
+        // decompress without holding the lock
+        chunk.resize(chunk_size_);
+        size_t n = bzip2_ ? bzip2_->read(chunk.data(), chunk.size()) : gzip_->read(chunk.data(), chunk.size());
+        chunk.resize(n);
+        at_end = bzip2_ ? bzip2_->streamEnd() : gzip_->streamEnd();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        chunk_consumed_.wait(lock, [this]() { return stop_ || chunks_.size() < max_chunks_; });
+        if (stop_) break;
+        if (n > 0) chunks_.push_back(std::move(chunk));
+        if (at_end) producer_done_ = true;
+        lock.unlock();
+        chunk_ready_.notify_one();
+      }
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      error_ = std::current_exception();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      producer_done_ = true;
+    }
+    chunk_ready_.notify_one();
+  }
+
+  size_t ReadAheadIfstream::read(char * s, size_t n)
+  {
+    if (!is_open_)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "no file for decompression initialized");
+    }
+
+    size_t total = 0;
+    while (total < n)
+    {
+      if (current_pos_ == current_.size())
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (current_.capacity() > 0) free_chunks_.push_back(std::move(current_));
+        current_.clear();
+        current_pos_ = 0;
+        chunk_ready_.wait(lock, [this]() { return !chunks_.empty() || producer_done_; });
+        if (chunks_.empty())
+        {
+          // background thread is done: end of file or error
+          std::exception_ptr error = error_;
+          lock.unlock();
+          close();
+          if (error) std::rethrow_exception(error);
+          break;
+        }
+        current_.swap(chunks_.front());
+        chunks_.pop_front();
+        lock.unlock();
+        chunk_consumed_.notify_one();
+      }
+
+      size_t k = std::min(n - total, current_.size() - current_pos_);
+      std::memcpy(s + total, current_.data() + current_pos_, k);
+      current_pos_ += k;
+      total += k;
+    }
+
+    // detect the end of file eagerly (as GzipIfstream does)
+    if (is_open_ && current_pos_ == current_.size())
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (chunks_.empty() && producer_done_ && !error_)
+      {
+        lock.unlock();
+        close();
+      }
+    }
+    return total;
+  }
+
+  void ReadAheadIfstream::close()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    chunk_consumed_.notify_one();
+    if (worker_.joinable())
+    {
+      worker_.join();
+    }
+    gzip_.reset();
+    bzip2_.reset();
+    chunks_.clear();
+    current_.clear();
+    current_pos_ = 0;
+    is_open_ = false;
+    stream_at_end_ = true;
+  }
+
+} //namespace OpenMS
@@ -68,66 +68,19 @@ namespace OpenMS
 #endif
     for (SignedSize i = 0; i < boost::numeric_cast<SignedSize>(file_list.size()); ++i)
     {
-
-#ifdef _OPENMP
-#pragma omp critical (OPENMS_SwathFile_loadSplit)
-#endif
-      {
-        std::cout << "Loading file " << i << " with name " << file_list[i] << " using readoptions " << readoptions << std::endl;
-      }
-
-      String tmp_fname = "openswath_tmpfile_" + String(i) + ".mzML";
-
-      boost::shared_ptr<PeakMap > exp(new PeakMap);
-      OpenSwath::SpectrumAccessPtr spectra_ptr;
-
       // Populate meta-data
       if (i == 0)
       {
         exp_meta = populateMetaData_(file_list[i]);
       }
 
-      if (readoptions == "normal")
-      {
-        MzMLFile().load(file_list[i], *exp.get());
-        spectra_ptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
-      }
-      else if (readoptions == "cache")
-      {
-        // Cache and load the exp (metadata only) file again
-        spectra_ptr = doCacheFile_(file_list[i], tmp, tmp_fname, exp);
-      }
-      else
-      {
-        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-          "Unknown option " + readoptions);
-      }
-
-      OpenSwath::SwathMap swath_map;
-
-      bool ms1 = false;
-      double upper = -1, lower = -1, center = -1;
-      if (exp->empty())
+      String tmp_fname = "openswath_tmpfile_" + String(i) + ".mzML";
+      OpenSwath::SwathMap swath_map = loadSplitFile(file_list[i], tmp, tmp_fname, readoptions);
+      if (!swath_map.sptr)
       {
-        std::cerr << "WARNING: File " << file_list[i] << "\n does not have any scans - I will skip it" << std::endl;
         continue;
       }
-      if (exp->getSpectra()[0].getPrecursors().empty())
-      {
-        std::cout << "NOTE: File " << file_list[i] << "\n does not have any precursors - I will assume it is the MS1 scan." << std::endl;
-        ms1 = true;
-      }
-      else
-      {
-        // Checks that this is really a SWATH map and extracts upper/lower window
-        OpenSwathHelper::checkSwathMap(*exp.get(), lower, upper, center);
-      }
 
-      swath_map.sptr = spectra_ptr;
-      swath_map.lower = lower;
-      swath_map.upper = upper;
-      swath_map.center = center;
-      swath_map.ms1 = ms1;
 #ifdef _OPENMP
 #pragma omp critical (OPENMS_SwathFile_loadSplit)
 #endif
@@ -141,6 +94,70 @@ namespace OpenMS
     return swath_maps;
   }
 
+  OpenSwath::SwathMap SwathFile::loadSplitFile(const String& file,
+                                              const String& tmp,
+                                              const String& tmp_fname,
+                                              const String& readoptions)
+  {
+#ifdef _OPENMP
+#pragma omp critical (OPENMS_SwathFile_loadSplit)
+#endif
+    {
+      std::cout << "Loading file " << file << " using readoptions " << readoptions << std::endl;
+    }
+
+    boost::shared_ptr<PeakMap > exp(new PeakMap);
+    OpenSwath::SpectrumAccessPtr spectra_ptr;
+
+    if (readoptions == "normal")
+    {
+      MzMLFile().load(file, *exp.get());
+      spectra_ptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+    }
+    else if (readoptions == "cache")
+    {
+      // Cache and load the exp (metadata only) file again
+      spectra_ptr = doCacheFile_(file, tmp, tmp_fname, exp);
+    }
+    else
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Unknown option " + readoptions);
+    }
+
+    OpenSwath::SwathMap swath_map;
+
+    bool ms1 = false;
+    double upper = -1, lower = -1, center = -1;
+    if (exp->empty())
+    {
+      std::cerr << "WARNING: File " << file << "\n does not have any scans - I will skip it" << std::endl;
+      return swath_map;
+    }
+    if (exp->getSpectra()[0].getPrecursors().empty())
+    {
+      std::cout << "NOTE: File " << file << "\n does not have any precursors - I will assume it is the MS1 scan." << std::endl;
+      ms1 = true;
+    }
+    else
+    {
+      // Checks that this is really a SWATH map and extracts upper/lower window
+      OpenSwathHelper::checkSwathMap(*exp.get(), lower, upper, center);
+    }
+
+    swath_map.sptr = spectra_ptr;
+    swath_map.lower = lower;
+    swath_map.upper = upper;
+    swath_map.center = center;
+    swath_map.ms1 = ms1;
+    return swath_map;
+  }
+
+  boost::shared_ptr<ExperimentalSettings> SwathFile::loadMetaData(const String& file)
+  {
+    return populateMetaData_(file);
+  }
+
   /// Loads a Swath run from a single mzML file
   std::vector<OpenSwath::SwathMap> SwathFile::loadMzML(const String& file,
                                                        const String& tmp,
@@ -9,6 +9,7 @@ Base64.cpp
 Bzip2Ifstream.cpp
 Bzip2InputStream.cpp
 CachedMzML.cpp
+CheckpointCache.cpp
 ChromeleonFile.cpp
 CompressedInputSource.cpp
 CVMappingFile.cpp
@@ -20,6 +21,7 @@ DTAFile.cpp
 EDTAFile.cpp
 ExperimentalDesignFile.cpp
 FASTAFile.cpp
+FASTAIndexFile.cpp
 FeatureXMLFile.cpp
 FileHandler.cpp
 FileTypes.cpp
@@ -75,6 +77,8 @@ PercolatorInfile.cpp
 PercolatorOutfile.cpp
 ProtXMLFile.cpp
 QcMLFile.cpp
+ReadAheadIfstream.cpp
+ReadAheadInputStream.cpp
 SequestInfile.cpp
 SequestOutfile.cpp
 SpecArrayFile.cpp
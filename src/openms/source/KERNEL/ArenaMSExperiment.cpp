@@ -0,0 +1,304 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/KERNEL/ArenaMSExperiment.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/CONCEPT/Helpers.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <algorithm>
+
+namespace OpenMS
+{
+  namespace
+  {
+    /// number of most recently added pool entries which are compared when interning (usually, all spectra share one or two records)
+    const Size INTERN_LOOKBACK = 8;
+
+    /// compares two data processing lists; usually, they contain the very same objects
+    bool dataProcessingEqual(const std::vector<ConstDataProcessingPtr>& a, const std::vector<ConstDataProcessingPtr>& b)
+    {
+      return a.size() == b.size() &&
+             std::equal(a.begin(), a.end(), b.begin(),
+               [](const ConstDataProcessingPtr& x, const ConstDataProcessingPtr& y) { return x == y || OpenMS::Helpers::cmpPtrSafe(x, y); });
+    }
+
+    /// compares only the parts of SpectrumSettings which ArenaMSExperiment shares between spectra (except data processing)
+    bool sharedSettingsEqual(const SpectrumSettings& a, const SpectrumSettings& b)
+    {
+      return a.getType() == b.getType() &&
+             a.getComment() == b.getComment() &&
+             a.getInstrumentSettings() == b.getInstrumentSettings() &&
+             a.getSourceFile() == b.getSourceFile() &&
+             a.getPeptideIdentifications() == b.getPeptideIdentifications();
+    }
+  }
+
+  ArenaMSExperiment::ArenaMSExperiment(Size block_size) :
+    ExperimentalSettings(),
+    block_size_(std::max(block_size, Size(1)))
+  {
+  }
+
+  ArenaMSExperiment::~ArenaMSExperiment() = default;
+
+  ArenaMSExperiment& ArenaMSExperiment::operator=(const ExperimentalSettings& source)
+  {
+    ExperimentalSettings::operator=(source);
+    return *this;
+  }
+
+  void ArenaMSExperiment::reserveSpaceSpectra(Size n)
+  {
+    spectra_.reserve(n);
+  }
+
+  void ArenaMSExperiment::reserveSpaceChromatograms(Size n)
+  {
+    chromatograms_.reserve(n);
+  }
+
+  Size ArenaMSExperiment::internSettings_(const SpectrumSettings& spectrum)
+  {
+    // converted once per spectrum, not once per comparison
+    std::vector<ConstDataProcessingPtr> data_processing = spectrum.getDataProcessing();
+    const Size n = settings_pool_.size();
+    for (Size i = n; i > 0 && i + INTERN_LOOKBACK > n; --i)
+    {
+      const SharedSettings_& pooled = settings_pool_[i - 1];
+      if (dataProcessingEqual(pooled.data_processing, data_processing) && sharedSettingsEqual(pooled.settings, spectrum))
+      {
+        return i - 1;
+      }
+    }
+    // copy (shares the DataProcessing objects) and reset all per-spectrum parts
+    SharedSettings_ shared{spectrum, std::move(data_processing)};
+    shared.settings.setNativeID(String());
+    shared.settings.setPrecursors(std::vector<Precursor>());
+    shared.settings.setProducts(std::vector<Product>());
+    shared.settings.setAcquisitionInfo(AcquisitionInfo());
+    shared.settings.clearMetaInfo();
+    settings_pool_.push_back(std::move(shared));
+    return n;
+  }
+
+  ArenaMSExperiment::SpectrumEntry_ ArenaMSExperiment::appendPeaks_(const MSSpectrum& spectrum)
+  {
+    const Size n = spectrum.size();
+    // start a new block if the spectrum does not fit into the current one (never reallocate a block: this would invalidate PeakRanges)
+    if (blocks_.empty() || blocks_.back().capacity() - blocks_.back().size() < n)
+    {
+      blocks_.emplace_back();
+      blocks_.back().reserve(std::max(block_size_, n));
+    }
+    std::vector<Peak1D>& block = blocks_.back();
+
+    SpectrumEntry_ entry;
+    entry.block = blocks_.size() - 1;
+    entry.offset = block.size();
+    entry.count = n;
+    block.insert(block.end(), spectrum.begin(), spectrum.end());
+    nr_peaks_ += n;
+
+    entry.settings = internSettings_(spectrum);
+    entry.rt = spectrum.getRT();
+    entry.drift_time = spectrum.getDriftTime();
+    entry.drift_time_unit = spectrum.getDriftTimeUnit();
+    entry.ms_level = spectrum.getMSLevel();
+    entry.name = spectrum.getName();
+    entry.native_id = spectrum.getNativeID();
+    return entry;
+  }
+
+  void ArenaMSExperiment::addSpectrum(const MSSpectrum& spectrum)
+  {
+    SpectrumEntry_ entry = appendPeaks_(spectrum);
+    entry.precursors = spectrum.getPrecursors();
+    entry.products = spectrum.getProducts();
+    entry.acquisition_info = spectrum.getAcquisitionInfo();
+    entry.meta = static_cast<const MetaInfoInterface&>(spectrum);
+    entry.float_data_arrays = spectrum.getFloatDataArrays();
+    entry.string_data_arrays = spectrum.getStringDataArrays();
+    entry.integer_data_arrays = spectrum.getIntegerDataArrays();
+    spectra_.push_back(std::move(entry));
+  }
+
+  void ArenaMSExperiment::addSpectrum(MSSpectrum&& spectrum)
+  {
+    SpectrumEntry_ entry = appendPeaks_(spectrum);
+    entry.precursors = std::move(spectrum.getPrecursors());
+    entry.products = std::move(spectrum.getProducts());
+    entry.acquisition_info = std::move(spectrum.getAcquisitionInfo());
+    entry.meta = std::move(static_cast<MetaInfoInterface&>(spectrum));
+    entry.float_data_arrays = std::move(spectrum.getFloatDataArrays());
+    entry.string_data_arrays = std::move(spectrum.getStringDataArrays());
+    entry.integer_data_arrays = std::move(spectrum.getIntegerDataArrays());
+    spectra_.push_back(std::move(entry));
+    spectrum.clear(true); // releases the peak storage
+  }
+
+  void ArenaMSExperiment::addChromatogram(const MSChromatogram& chromatogram)
+  {
+    chromatograms_.push_back(chromatogram);
+  }
+
+  void ArenaMSExperiment::clear()
+  {
+    // swap with empty containers to actually release the memory
+    std::vector<std::vector<Peak1D>>().swap(blocks_);
+    std::vector<SpectrumEntry_>().swap(spectra_);
+    std::vector<SharedSettings_>().swap(settings_pool_);
+    std::vector<MSChromatogram>().swap(chromatograms_);
+    nr_peaks_ = 0;
+  }
+
+  Size ArenaMSExperiment::size() const
+  {
+    return spectra_.size();
+  }
+
+  bool ArenaMSExperiment::empty() const
+  {
+    return spectra_.empty();
+  }
+
+  Size ArenaMSExperiment::getNrPeaks() const
+  {
+    return nr_peaks_;
+  }
+
+  Size ArenaMSExperiment::getNrBlocks() const
+  {
+    return blocks_.size();
+  }
+
+  Size ArenaMSExperiment::getNrSharedSettings() const
+  {
+    return settings_pool_.size();
+  }
+
+  const ArenaMSExperiment::SpectrumEntry_& ArenaMSExperiment::entry_(Size index) const
+  {
+    if (index >= spectra_.size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, index, spectra_.size());
+    }
+    return spectra_[index];
+  }
+
+  ArenaMSExperiment::PeakRange ArenaMSExperiment::getPeaks(Size index) const
+  {
+    const SpectrumEntry_& entry = entry_(index);
+    if (entry.count == 0)
+    {
+      return PeakRange{nullptr, nullptr};
+    }
+    const Peak1D* first = blocks_[entry.block].data() + entry.offset;
+    return PeakRange{first, first + entry.count};
+  }
+
+  double ArenaMSExperiment::getRT(Size index) const
+  {
+    return entry_(index).rt;
+  }
+
+  UInt ArenaMSExperiment::getMSLevel(Size index) const
+  {
+    return entry_(index).ms_level;
+  }
+
+  const String& ArenaMSExperiment::getNativeID(Size index) const
+  {
+    return entry_(index).native_id;
+  }
+
+  const std::vector<Precursor>& ArenaMSExperiment::getPrecursors(Size index) const
+  {
+    return entry_(index).precursors;
+  }
+
+  void ArenaMSExperiment::getSpectrum(Size index, MSSpectrum& spectrum) const
+  {
+    const SpectrumEntry_& entry = entry_(index);
+    spectrum.clear(false); // keeps the capacity of the peak vector
+
+    spectrum = settings_pool_[entry.settings].settings;
+    spectrum.setNativeID(entry.native_id);
+    spectrum.setPrecursors(entry.precursors);
+    spectrum.setProducts(entry.products);
+    spectrum.setAcquisitionInfo(entry.acquisition_info);
+    static_cast<MetaInfoInterface&>(spectrum) = entry.meta;
+
+    spectrum.setRT(entry.rt);
+    spectrum.setDriftTime(entry.drift_time);
+    spectrum.setDriftTimeUnit(entry.drift_time_unit);
+    spectrum.setMSLevel(entry.ms_level);
+    spectrum.setName(entry.name);
+    spectrum.setFloatDataArrays(entry.float_data_arrays);
+    spectrum.setStringDataArrays(entry.string_data_arrays);
+    spectrum.setIntegerDataArrays(entry.integer_data_arrays);
+
+    const PeakRange peaks = getPeaks(index);
+    spectrum.insert(spectrum.end(), peaks.begin(), peaks.end());
+  }
+
+  MSSpectrum ArenaMSExperiment::getSpectrum(Size index) const
+  {
+    MSSpectrum spectrum;
+    getSpectrum(index, spectrum);
+    return spectrum;
+  }
+
+  const std::vector<MSChromatogram>& ArenaMSExperiment::getChromatograms() const
+  {
+    return chromatograms_;
+  }
+
+  void ArenaMSExperiment::exportTo(MSExperiment& exp) const
+  {
+    exp.clear(true);
+    exp = static_cast<const ExperimentalSettings&>(*this);
+    exp.reserveSpaceSpectra(spectra_.size());
+    for (Size i = 0; i < spectra_.size(); ++i)
+    {
+      MSSpectrum spectrum;
+      getSpectrum(i, spectrum);
+      exp.addSpectrum(std::move(spectrum));
+    }
+    exp.setChromatograms(chromatograms_);
+  }
+
+} // namespace OpenMS
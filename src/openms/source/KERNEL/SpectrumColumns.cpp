@@ -0,0 +1,370 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/KERNEL/SpectrumColumns.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace OpenMS
+{
+  namespace
+  {
+    /// reorders @p column according to @p indices (as MSSpectrum::select() does for data arrays)
+    template <typename ColumnType>
+    void selectColumn(ColumnType& column, const std::vector<Size>& indices)
+    {
+      ColumnType tmp(column); // keep the meta data of data arrays
+      tmp.clear();
+      tmp.reserve(indices.size());
+      for (Size i : indices)
+      {
+        tmp.push_back(std::move(column[i]));
+      }
+      std::swap(column, tmp);
+    }
+
+    /// throws if a non-empty data array does not have one entry per peak
+    template <typename DataArraysType>
+    void checkDataArrays(const DataArraysType& arrays, Size peaks_old, const String& name)
+    {
+      for (Size i = 0; i < arrays.size(); ++i)
+      {
+        if (!arrays[i].empty() && arrays[i].size() != peaks_old)
+        {
+          throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, name + "[" + String(i) + "] size (" +
+                                        String(arrays[i].size()) + ") does not match spectrum size (" + String(peaks_old) + ")");
+        }
+      }
+    }
+
+    template <typename DataArraysType>
+    void selectDataArrays(DataArraysType& arrays, const std::vector<Size>& indices)
+    {
+      for (auto& array : arrays)
+      {
+        if (!array.empty())
+        {
+          selectColumn(array, indices);
+        }
+      }
+    }
+  }
+
+  SpectrumColumns::SpectrumColumns(const MSSpectrum& spectrum)
+  {
+    assign(spectrum);
+  }
+
+  bool SpectrumColumns::operator==(const SpectrumColumns& rhs) const
+  {
+    return mz_ == rhs.mz_ &&
+           intensity_ == rhs.intensity_ &&
+           float_data_arrays_ == rhs.float_data_arrays_ &&
+           string_data_arrays_ == rhs.string_data_arrays_ &&
+           integer_data_arrays_ == rhs.integer_data_arrays_;
+  }
+
+  bool SpectrumColumns::operator!=(const SpectrumColumns& rhs) const
+  {
+    return !(*this == rhs);
+  }
+
+  void SpectrumColumns::assign(const MSSpectrum& spectrum)
+  {
+    const Size n = spectrum.size();
+    mz_.resize(n);
+    intensity_.resize(n);
+    for (Size i = 0; i < n; ++i)
+    {
+      mz_[i] = spectrum[i].getMZ();
+      intensity_[i] = spectrum[i].getIntensity();
+    }
+    float_data_arrays_ = spectrum.getFloatDataArrays();
+    string_data_arrays_ = spectrum.getStringDataArrays();
+    integer_data_arrays_ = spectrum.getIntegerDataArrays();
+  }
+
+  void SpectrumColumns::exportTo(MSSpectrum& spectrum) const
+  {
+    const Size n = mz_.size();
+    spectrum.resize(n);
+    for (Size i = 0; i < n; ++i)
+    {
+      spectrum[i].setMZ(mz_[i]);
+      spectrum[i].setIntensity(intensity_[i]);
+    }
+    spectrum.setFloatDataArrays(float_data_arrays_);
+    spectrum.setStringDataArrays(string_data_arrays_);
+    spectrum.setIntegerDataArrays(integer_data_arrays_);
+  }
+
+  Size SpectrumColumns::size() const
+  {
+    return mz_.size();
+  }
+
+  bool SpectrumColumns::empty() const
+  {
+    return mz_.empty();
+  }
+
+  void SpectrumColumns::clear()
+  {
+    mz_.clear();
+    intensity_.clear();
+    float_data_arrays_.clear();
+    string_data_arrays_.clear();
+    integer_data_arrays_.clear();
+  }
+
+  void SpectrumColumns::reserve(Size n)
+  {
+    mz_.reserve(n);
+    intensity_.reserve(n);
+  }
+
+  void SpectrumColumns::push_back(double mz, float intensity)
+  {
+    mz_.push_back(mz);
+    intensity_.push_back(intensity);
+  }
+
+  const std::vector<double>& SpectrumColumns::getMZArray() const
+  {
+    return mz_;
+  }
+
+  std::vector<double>& SpectrumColumns::getMZArray()
+  {
+    return mz_;
+  }
+
+  const std::vector<float>& SpectrumColumns::getIntensityArray() const
+  {
+    return intensity_;
+  }
+
+  std::vector<float>& SpectrumColumns::getIntensityArray()
+  {
+    return intensity_;
+  }
+
+  const SpectrumColumns::FloatDataArrays& SpectrumColumns::getFloatDataArrays() const
+  {
+    return float_data_arrays_;
+  }
+
+  SpectrumColumns::FloatDataArrays& SpectrumColumns::getFloatDataArrays()
+  {
+    return float_data_arrays_;
+  }
+
+  const SpectrumColumns::StringDataArrays& SpectrumColumns::getStringDataArrays() const
+  {
+    return string_data_arrays_;
+  }
+
+  SpectrumColumns::StringDataArrays& SpectrumColumns::getStringDataArrays()
+  {
+    return string_data_arrays_;
+  }
+
+  const SpectrumColumns::IntegerDataArrays& SpectrumColumns::getIntegerDataArrays() const
+  {
+    return integer_data_arrays_;
+  }
+
+  SpectrumColumns::IntegerDataArrays& SpectrumColumns::getIntegerDataArrays()
+  {
+    return integer_data_arrays_;
+  }
+
+  bool SpectrumColumns::isSorted() const
+  {
+    return std::is_sorted(mz_.begin(), mz_.end());
+  }
+
+  void SpectrumColumns::sortByPosition()
+  {
+    if (isSorted())
+    {
+      return;
+    }
+    std::vector<Size> indices(mz_.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::stable_sort(indices.begin(), indices.end(), [this](Size a, Size b) { return mz_[a] < mz_[b]; });
+    select(indices);
+  }
+
+  void SpectrumColumns::sortByIntensity(bool reverse)
+  {
+    std::vector<Size> indices(intensity_.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    if (reverse)
+    {
+      if (std::is_sorted(intensity_.begin(), intensity_.end(), std::greater<float>()))
+      {
+        return;
+      }
+      std::stable_sort(indices.begin(), indices.end(), [this](Size a, Size b) { return intensity_[b] < intensity_[a]; });
+    }
+    else
+    {
+      if (std::is_sorted(intensity_.begin(), intensity_.end()))
+      {
+        return;
+      }
+      std::stable_sort(indices.begin(), indices.end(), [this](Size a, Size b) { return intensity_[a] < intensity_[b]; });
+    }
+    select(indices);
+  }
+
+  void SpectrumColumns::select(const std::vector<Size>& indices)
+  {
+    const Size peaks_old = size();
+    // check all data arrays first, so nothing is changed on error
+    checkDataArrays(float_data_arrays_, peaks_old, "FloatDataArray");
+    checkDataArrays(string_data_arrays_, peaks_old, "StringDataArray");
+    checkDataArrays(integer_data_arrays_, peaks_old, "IntegerDataArray");
+    selectDataArrays(float_data_arrays_, indices);
+    selectDataArrays(string_data_arrays_, indices);
+    selectDataArrays(integer_data_arrays_, indices);
+    selectColumn(mz_, indices);
+    selectColumn(intensity_, indices);
+  }
+
+  Size SpectrumColumns::MZBegin(double mz) const
+  {
+    return std::lower_bound(mz_.begin(), mz_.end(), mz) - mz_.begin();
+  }
+
+  Size SpectrumColumns::MZEnd(double mz) const
+  {
+    return std::upper_bound(mz_.begin(), mz_.end(), mz) - mz_.begin();
+  }
+
+  Size SpectrumColumns::findNearest(double mz) const
+  {
+    if (mz_.empty())
+    {
+      throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "There must be at least one peak to determine the nearest peak!");
+    }
+    const Size i = MZBegin(mz);
+    // border cases
+    if (i == 0)
+    {
+      return 0;
+    }
+    if (i == mz_.size())
+    {
+      return i - 1;
+    }
+    // the peak before or the current peak are closest
+    return (std::fabs(mz_[i] - mz) < std::fabs(mz_[i - 1] - mz)) ? i : i - 1;
+  }
+
+  Int SpectrumColumns::findNearest(double mz, double tolerance) const
+  {
+    if (mz_.empty())
+    {
+      return -1;
+    }
+    const Size i = findNearest(mz);
+    if (mz_[i] >= mz - tolerance && mz_[i] <= mz + tolerance)
+    {
+      return static_cast<Int>(i);
+    }
+    return -1;
+  }
+
+  Int SpectrumColumns::findNearest(double mz, double tolerance_left, double tolerance_right) const
+  {
+    if (mz_.empty())
+    {
+      return -1;
+    }
+    Size i = findNearest(mz);
+    const double nearest_mz = mz_[i];
+    if (nearest_mz < mz)
+    {
+      if (nearest_mz >= mz - tolerance_left)
+      {
+        return static_cast<Int>(i); // nearest peak is in left tolerance window
+      }
+      // nearest peak is too far left, but the next one might be in the right window
+      if (i + 1 < mz_.size() && mz_[i + 1] <= mz + tolerance_right)
+      {
+        return static_cast<Int>(i + 1);
+      }
+    }
+    else
+    {
+      if (nearest_mz <= mz + tolerance_right)
+      {
+        return static_cast<Int>(i); // nearest peak is in right tolerance window
+      }
+      // nearest peak is too far right, but the previous one might be in the left window
+      if (i > 0 && mz_[i - 1] >= mz - tolerance_left)
+      {
+        return static_cast<Int>(i - 1);
+      }
+    }
+    return -1;
+  }
+
+  double SpectrumColumns::calculateTIC() const
+  {
+    double tic = 0.0;
+    for (float intensity : intensity_)
+    {
+      tic += intensity;
+    }
+    return tic;
+  }
+
+  float SpectrumColumns::getMaxIntensity() const
+  {
+    if (intensity_.empty())
+    {
+      return 0.0f;
+    }
+    return *std::max_element(intensity_.begin(), intensity_.end());
+  }
+
+} // namespace OpenMS
@@ -28,6 +28,8 @@ ChromatogramPeak.cpp
 MSChromatogram.cpp
 ChromatogramTools.cpp
 SpectrumHelper.cpp
+SpectrumColumns.cpp
+ArenaMSExperiment.cpp
 )
 
 ### add path to the filenames
@@ -402,10 +402,16 @@ size_t encodeLinear(
 
 
 
-size_t decodeLinear(
+/**
+ * Decodes linear prediction data into any floating point type. Prediction is
+ * always done on the exact integer representation, so only the final
+ * division by the fixed point depends on T.
+ */
+template <typename T>
+static size_t decodeLinearImpl(
 		const unsigned char *data,
 		const size_t dataSize,
-		double *result
+		T *result
 ) {
 	size_t i;
 	size_t ri = 0;
@@ -441,7 +447,7 @@ size_t decodeLinear(
 	{
 		ints[1] = ints[1] | ((0xff & (init = data[8+i])) << (i*8));
 	}
-	result[0] = ints[1] / fixedPoint;
+	result[0] = static_cast<T>(ints[1] / fixedPoint);
 
 	if (dataSize == 12)
 	{
@@ -456,7 +462,7 @@ size_t decodeLinear(
 	{
 		ints[2] = ints[2] | ((0xff & (init = data[12+i])) << (i*8));
 	}
-	result[1] = ints[2] / fixedPoint;
+	result[1] = static_cast<T>(ints[2] / fixedPoint);
 		
 	half = 0;
 	ri = 2;
@@ -483,7 +489,7 @@ size_t decodeLinear(
 		extrapol = ints[1] + (ints[1] - ints[0]);
 		y = extrapol + diff;
 		//printf(" %d \n", diff);
-		result[ri++] 	= y / fixedPoint;
+		result[ri++] 	= static_cast<T>(y / fixedPoint);
 		ints[2] 		= y;
 	}
 
@@ -492,6 +498,26 @@ size_t decodeLinear(
 
 
 
+size_t decodeLinear(
+		const unsigned char *data,
+		const size_t dataSize,
+		double *result
+) {
+	return decodeLinearImpl(data, dataSize, result);
+}
+
+
+
+size_t decodeLinear(
+		const unsigned char *data,
+		const size_t dataSize,
+		float *result
+) {
+	return decodeLinearImpl(data, dataSize, result);
+}
+
+
+
 void encodeLinear(
 		const std::vector<double> &data, 
 		std::vector<unsigned char> &result,
@@ -685,10 +711,11 @@ size_t encodePic(
 
 
 
-size_t decodePic(
+template <typename T>
+static size_t decodePicImpl(
 		const unsigned char *data,
 		const size_t dataSize,
-		double *result
+		T *result
 ) {
 	size_t ri;
 	unsigned int x;
@@ -716,7 +743,7 @@ size_t decodePic(
 		//printf("%7d %7d %7d %7d %7d\n", ri, di, half, dataSize, count);
 		
 		//printf("count: %d \n", count);
-		result[ri++] = static_cast<double>(x);
+		result[ri++] = static_cast<T>(x);
 	}
 
 	return ri;
@@ -724,6 +751,26 @@ size_t decodePic(
 
 
 
+size_t decodePic(
+		const unsigned char *data,
+		const size_t dataSize,
+		double *result
+) {
+	return decodePicImpl(data, dataSize, result);
+}
+
+
+
+size_t decodePic(
+		const unsigned char *data,
+		const size_t dataSize,
+		float *result
+) {
+	return decodePicImpl(data, dataSize, result);
+}
+
+
+
 void encodePic(
 		const std::vector<double> &data,  
 		std::vector<unsigned char> &result
@@ -834,6 +881,49 @@ size_t decodeSlof(
 
 
 
+size_t decodeSlof(
+		const unsigned char *data, 
+		const size_t dataSize, 
+		float *result
+) {
+	size_t i, ri;
+	double fixedPoint;
+
+	if (dataSize < 8) 
+	{
+		throw "[MSNumpress::decodeSlof] Corrupt input data: not enough bytes to read fixed point! ";
+	}
+	fixedPoint = decodeFixedPoint(data);
+	const size_t count = (dataSize - 8) / 2;
+
+	// Few values: exp() per value is cheaper than building the tables.
+	if (count < 1024)
+	{
+		ri = 0;
+		for (i=8; i+1<dataSize; i+=2) {
+			unsigned short x = static_cast<unsigned short>(data[i] | (data[i+1] << 8));
+			result[ri++] = static_cast<float>(exp(x / fixedPoint) - 1);
+		}
+		return ri;
+	}
+
+	// exp(x / fp) = exp(high_byte * 256 / fp) * exp(low_byte / fp): 512 calls to exp() instead of one per value,
+	// and the remaining loop (two lookups, one multiplication) can be vectorized.
+	// The product differs from exp(x / fp) by at most a few ulp of a double, far below float precision.
+	double exp_high[256], exp_low[256];
+	for (i=0; i<256; i++) {
+		exp_high[i] = exp((i * 256.0) / fixedPoint);
+		exp_low[i] = exp(i / fixedPoint);
+	}
+	const unsigned char *values = data + 8;
+	for (ri=0; ri<count; ri++) {
+		result[ri] = static_cast<float>(exp_high[values[2*ri+1]] * exp_low[values[2*ri]] - 1);
+	}
+	return ri;
+}
+
+
+
 void encodeSlof(
 		const std::vector<double> &data,  
 		std::vector<unsigned char> &result,
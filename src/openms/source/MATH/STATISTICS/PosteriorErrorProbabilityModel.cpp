@@ -49,10 +49,65 @@
 
 #include <algorithm>
 
-
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace std;
 
+namespace
+{
+  /// Number of scores per block of the parallel kernels.
+  /// Sums are formed per block and then added in block order, so the results do not depend on the number of threads.
+  const OpenMS::SignedSize KERNEL_BLOCK_SIZE = 8192;
+
+  /// Calls @p block_sum(begin, end) for consecutive blocks of [0, n) in parallel and returns the sum of the results in block order
+  template <typename BlockSum>
+  std::pair<double, double> sumBlocks(OpenMS::Size n, const BlockSum& block_sum)
+  {
+    const OpenMS::SignedSize n_blocks = (static_cast<OpenMS::SignedSize>(n) + KERNEL_BLOCK_SIZE - 1) / KERNEL_BLOCK_SIZE;
+    std::vector<std::pair<double, double>> partial(n_blocks, {0.0, 0.0});
+#ifdef _OPENMP
+#pragma omp parallel for if(n_blocks > 1)
+#endif
+    for (OpenMS::SignedSize b = 0; b < n_blocks; ++b)
+    {
+      const OpenMS::Size begin = b * KERNEL_BLOCK_SIZE;
+      const OpenMS::Size end = std::min(n, begin + KERNEL_BLOCK_SIZE);
+      partial[b] = block_sum(begin, end);
+    }
+    std::pair<double, double> total(0.0, 0.0);
+    for (const std::pair<double, double>& p : partial)
+    {
+      total.first += p.first;
+      total.second += p.second;
+    }
+    return total;
+  }
+
+  /// Picks @p n scores at evenly spaced quantiles of the sorted @p scores (including the smallest and largest one)
+  std::vector<double> subsampleSortedScores(const std::vector<double>& scores, OpenMS::Size n)
+  {
+    if (n == 0 || n >= scores.size())
+    {
+      return scores;
+    }
+    std::vector<double> sample;
+    sample.reserve(n);
+    if (n == 1)
+    {
+      sample.push_back(scores[scores.size() / 2]);
+      return sample;
+    }
+    const double step = static_cast<double>(scores.size() - 1) / static_cast<double>(n - 1);
+    for (OpenMS::Size i = 0; i < n; ++i)
+    {
+      sample.push_back(scores[static_cast<OpenMS::Size>(std::round(i * step))]);
+    }
+    return sample;
+  }
+}
+
 namespace OpenMS::Math
 {
 
@@ -69,6 +124,8 @@ namespace OpenMS::Math
       defaults_.setValue("max_nr_iterations", 1000, "Bounds the number of iterations for the EM algorithm when convergence is slow.", {"advanced"});
       defaults_.setValidStrings("incorrectly_assigned", {"Gumbel","Gauss"});
       defaults_.setValue("neg_log_delta",6, "The negative logarithm of the convergence threshold for the likelihood increase.");
+      defaults_.setValue("max_fit_scores", 0, "If larger than 0 and more scores are given, the model is fitted on this many scores taken at evenly spaced quantiles of the score distribution. Probabilities are still computed for all scores. 0 = fit on all scores.", {"advanced"});
+      defaults_.setMinInt("max_fit_scores", 0);
       defaults_.setValue("outlier_handling","ignore_iqr_outliers", "What to do with outliers:\n"
                                                                    "- ignore_iqr_outliers: ignore outliers outside of 3*IQR from Q1/Q3 for fitting\n"
                                                                    "- set_iqr_to_closest_valid: set IQR-based outliers to the last valid value for fitting\n"
@@ -94,7 +151,7 @@ namespace OpenMS::Math
 
       smallest_score_ = search_engine_scores[0];
 
-      vector<double> x_scores{search_engine_scores};
+      vector<double> x_scores = subsampleSortedScores(search_engine_scores, (int)param_.getValue("max_fit_scores"));
 
       //transform to a positive range
       for (double & d : x_scores) { d += fabs(smallest_score_) + 0.001; }
@@ -159,22 +216,8 @@ namespace OpenMS::Math
       {
         //-------------------------------------------------------------
         // E-STEP (gauss)
-        double newGaussMean = 0.0;
-        auto the_x = x_scores.cbegin();
-
-        for (auto incorrect = incorrect_posteriors.cbegin(); incorrect != incorrect_posteriors.cend(); ++incorrect, ++the_x)
-        {
-          newGaussMean += (1.-*incorrect) * *the_x;
-        }
-        newGaussMean /= sumCorrectPosteriors;
-
-        double newGaussSigma = 0.0;
-        the_x = x_scores.cbegin();
-
-        for (auto incorrect = incorrect_posteriors.cbegin(); incorrect != incorrect_posteriors.cend(); ++incorrect, ++the_x)
-        {
-          newGaussSigma += (1. - *incorrect) * pow((*the_x) - newGaussMean, 2);
-        }
+        double newGaussMean = pos_neg_mean_weighted_posteriors(x_scores, incorrect_posteriors).first / sumCorrectPosteriors;
+        double newGaussSigma = pos_neg_sigma_weighted_posteriors(x_scores, incorrect_posteriors, {newGaussMean, 0.0}).first;
         newGaussSigma = sqrt(newGaussSigma/sumCorrectPosteriors);
 
         GumbelMaxLikelihoodFitter::GumbelDistributionFitResult newGumbelParams = gmlf.fitWeighted(x_scores, incorrect_posteriors);
@@ -270,7 +313,7 @@ namespace OpenMS::Math
 
       smallest_score_ = search_engine_scores[0];
 
-      vector<double> x_scores{search_engine_scores};
+      vector<double> x_scores = subsampleSortedScores(search_engine_scores, (int)param_.getValue("max_fit_scores"));
 
       //transform to a positive range
       for (double & d : x_scores)
@@ -468,15 +511,23 @@ namespace OpenMS::Math
         incorrect_density.resize(x_scores.size());
         correct_density.resize(x_scores.size());
       }
-      auto incorrect(incorrect_density.begin());
-      auto correct(correct_density.begin());
-      for (double const & score : x_scores)
+      // GaussFitResult::eval(x) == A * exp(-0.5 * ((x - x0) / sigma)^2); the constants are hoisted out of the loop
+      // TODO: incorrect is currently filled with gauss as fitting gumble is not supported
+      const double inc_A = incorrectly_assigned_fit_param_.A, inc_x0 = incorrectly_assigned_fit_param_.x0, inc_sigma = incorrectly_assigned_fit_param_.sigma;
+      const double cor_A = correctly_assigned_fit_param_.A, cor_x0 = correctly_assigned_fit_param_.x0, cor_sigma = correctly_assigned_fit_param_.sigma;
+      const double* x = x_scores.data();
+      double* incorrect = incorrect_density.data();
+      double* correct = correct_density.data();
+      const SignedSize n = x_scores.size();
+#ifdef _OPENMP
+#pragma omp parallel for if(n > KERNEL_BLOCK_SIZE)
+#endif
+      for (SignedSize i = 0; i < n; ++i)
       {
-        // TODO: incorrect is currently filled with gauss as fitting gumble is not supported
-        *incorrect = incorrectly_assigned_fit_param_.eval(score);
-        *correct = correctly_assigned_fit_param_.eval(score);
-        ++incorrect;
-        ++correct;
+        const double z_inc = (x[i] - inc_x0) / inc_sigma;
+        const double z_cor = (x[i] - cor_x0) / cor_sigma;
+        incorrect[i] = inc_A * exp(-0.5 * z_inc * z_inc);
+        correct[i] = cor_A * exp(-0.5 * z_cor * z_cor);
       }
     }
 
@@ -487,14 +538,24 @@ namespace OpenMS::Math
         incorrect_density.resize(x_scores.size());
         correct_density.resize(x_scores.size());
       }
-      auto incorrect(incorrect_density.begin());
-      auto correct(correct_density.begin());
-      for (double const & score : x_scores)
+      // same as GumbelDistributionFitResult::log_eval_no_normalize and GaussFitResult::log_eval_no_normalize, with the constants hoisted out of the loop
+      const double inc_a = incorrectly_assigned_fit_gumbel_param_.a, inc_b = incorrectly_assigned_fit_gumbel_param_.b;
+      const double inc_log_norm = -log(inc_b);
+      const double cor_x0 = correctly_assigned_fit_param_.x0, cor_sigma = correctly_assigned_fit_param_.sigma;
+      const double cor_log_norm = -log(cor_sigma) - 0.5 * log(2.0 * Constants::PI);
+      const double* x = x_scores.data();
+      double* incorrect = incorrect_density.data();
+      double* correct = correct_density.data();
+      const SignedSize n = x_scores.size();
+#ifdef _OPENMP
+#pragma omp parallel for if(n > KERNEL_BLOCK_SIZE)
+#endif
+      for (SignedSize i = 0; i < n; ++i)
       {
-        *incorrect = incorrectly_assigned_fit_gumbel_param_.log_eval_no_normalize(score);
-        *correct = correctly_assigned_fit_param_.log_eval_no_normalize(score);
-        ++incorrect;
-        ++correct;
+        const double diff = (x[i] - inc_a) / inc_b;
+        const double z_cor = (x[i] - cor_x0) / cor_sigma;
+        incorrect[i] = inc_log_norm - diff - exp(-diff);
+        correct[i] = cor_log_norm - 0.5 * z_cor * z_cor;
       }
     }
 
@@ -505,91 +566,118 @@ namespace OpenMS::Math
         incorrect_density.resize(x_scores.size());
         correct_density.resize(x_scores.size());
       }
-      auto incorrect(incorrect_density.begin());
-      auto correct(correct_density.begin());
-      for (double const & score : x_scores)
+      // same as GaussFitResult::log_eval_no_normalize, with the constants hoisted out of the loop
+      // TODO: incorrect is currently filled with gauss as fitting gumble is not supported
+      const double half_log_two_pi = 0.5 * log(2.0 * Constants::PI);
+      const double inc_x0 = incorrectly_assigned_fit_param_.x0, inc_sigma = incorrectly_assigned_fit_param_.sigma;
+      const double inc_log_norm = -log(inc_sigma) - half_log_two_pi;
+      const double cor_x0 = correctly_assigned_fit_param_.x0, cor_sigma = correctly_assigned_fit_param_.sigma;
+      const double cor_log_norm = -log(cor_sigma) - half_log_two_pi;
+      const double* x = x_scores.data();
+      double* incorrect = incorrect_density.data();
+      double* correct = correct_density.data();
+      const SignedSize n = x_scores.size();
+#ifdef _OPENMP
+#pragma omp parallel for if(n > KERNEL_BLOCK_SIZE)
+#endif
+      for (SignedSize i = 0; i < n; ++i)
       {
-        // TODO: incorrect is currently filled with gauss as fitting gumble is not supported
-        *incorrect = incorrectly_assigned_fit_param_.log_eval_no_normalize(score);
-        *correct = correctly_assigned_fit_param_.log_eval_no_normalize(score);
-        ++incorrect;
-        ++correct;
+        const double z_inc = (x[i] - inc_x0) / inc_sigma;
+        const double z_cor = (x[i] - cor_x0) / cor_sigma;
+        incorrect[i] = inc_log_norm - 0.5 * z_inc * z_inc;
+        correct[i] = cor_log_norm - 0.5 * z_cor * z_cor;
       }
     }
 
     double PosteriorErrorProbabilityModel::computeLogLikelihood(const vector<double>& incorrect_density, const vector<double>& correct_density) const
     {
-      double maxlike(0);
-      auto incorrect = incorrect_density.cbegin();
-      for (auto correct = correct_density.cbegin(); correct < correct_density.cend(); ++correct, ++incorrect)
+      const double prior_neg = negative_prior_;
+      const double prior_pos = 1 - negative_prior_;
+      const double* incorrect = incorrect_density.data();
+      const double* correct = correct_density.data();
+      return sumBlocks(correct_density.size(), [&](Size begin, Size end)
       {
-        maxlike += log10(negative_prior_ * (*incorrect) + (1 - negative_prior_) * (*correct));
-      }
-      return maxlike;
+        double maxlike(0);
+        for (Size i = begin; i < end; ++i)
+        {
+          maxlike += log10(prior_neg * incorrect[i] + prior_pos * correct[i]);
+        }
+        return std::make_pair(maxlike, 0.0);
+      }).first;
     }
 
     double PosteriorErrorProbabilityModel::computeLLAndIncorrectPosteriorsFromLogDensities(
         const vector<double>& incorrect_log_density, const vector<double>& correct_log_density,
         vector<double>& incorrect_posterior) const
     {
-      double loglikelihood = 0.0;
-      double log_prior_pos = log(1. - negative_prior_);
-      double log_prior_neg = log(negative_prior_);
-      auto incorrect = incorrect_log_density.cbegin();
+      const double log_prior_pos = log(1. - negative_prior_);
+      const double log_prior_neg = log(negative_prior_);
       if (incorrect_posterior.size() != incorrect_log_density.size())
       {
         incorrect_posterior.resize(incorrect_log_density.size());
       }
-      auto incorrect_posterior_it = incorrect_posterior.begin();
+      const double* incorrect = incorrect_log_density.data();
+      const double* correct = correct_log_density.data();
+      double* posterior = incorrect_posterior.data();
 
-      for (auto correct = correct_log_density.cbegin(); correct < correct_log_density.cend(); ++correct, ++incorrect, ++incorrect_posterior_it)
+      return sumBlocks(correct_log_density.size(), [&](Size begin, Size end)
       {
-        double log_resp_correct = log_prior_pos + *correct;
-        double log_resp_incorrect = log_prior_neg + *incorrect;
-        double max_log_resp = std::max(log_resp_correct,log_resp_incorrect);
-        log_resp_correct -= max_log_resp;
-        log_resp_incorrect -= max_log_resp;
-        double resp_correct = exp(log_resp_correct);
-        double resp_incorrect = exp(log_resp_incorrect);
-        double sum = resp_correct + resp_incorrect;
-        // normalize
-        *incorrect_posterior_it = resp_incorrect / sum; //TODO can we somehow stay in log space (i.e. fill as log posteriors?)
-        loglikelihood += max_log_resp + log(sum);
-      }
-      return loglikelihood;
+        double loglikelihood = 0.0;
+        for (Size i = begin; i < end; ++i)
+        {
+          double log_resp_correct = log_prior_pos + correct[i];
+          double log_resp_incorrect = log_prior_neg + incorrect[i];
+          double max_log_resp = std::max(log_resp_correct, log_resp_incorrect);
+          double resp_correct = exp(log_resp_correct - max_log_resp);
+          double resp_incorrect = exp(log_resp_incorrect - max_log_resp);
+          double sum = resp_correct + resp_incorrect;
+          // normalize
+          posterior[i] = resp_incorrect / sum; //TODO can we somehow stay in log space (i.e. fill as log posteriors?)
+          loglikelihood += max_log_resp + log(sum);
+        }
+        return std::make_pair(loglikelihood, 0.0);
+      }).first;
     }
 
     std::pair<double,double> PosteriorErrorProbabilityModel::pos_neg_mean_weighted_posteriors(const vector<double>& x_scores, const vector<double>& incorrect_posteriors)
     {
-      double pos_x0(0);
-      double neg_x0(0);
-      auto the_x = x_scores.cbegin();
-
-      for (auto incorrect = incorrect_posteriors.cbegin(); incorrect < incorrect_posteriors.end(); ++incorrect, ++the_x)
+      const double* x = x_scores.data();
+      const double* incorrect = incorrect_posteriors.data();
+      return sumBlocks(incorrect_posteriors.size(), [&](Size begin, Size end)
       {
-        pos_x0 += (1. - *incorrect) * (*the_x);
-        neg_x0 += (*incorrect) * (*the_x);
-      }
-      return {pos_x0,neg_x0};
+        double pos_x0(0);
+        double neg_x0(0);
+        for (Size i = begin; i < end; ++i)
+        {
+          pos_x0 += (1. - incorrect[i]) * x[i];
+          neg_x0 += incorrect[i] * x[i];
+        }
+        return std::make_pair(pos_x0, neg_x0);
+      });
     }
 
-
-
     std::pair<double,double> PosteriorErrorProbabilityModel::pos_neg_sigma_weighted_posteriors(
         const vector<double>& x_scores,
         const vector<double>& incorrect_posteriors,
         const std::pair<double,double>& pos_neg_mean)
     {
-      double pos_sigma(0);
-      double neg_sigma(0);
-      auto the_x = x_scores.cbegin();
-
-      for (auto incorrect = incorrect_posteriors.cbegin(); incorrect < incorrect_posteriors.end(); ++incorrect, ++the_x)
+      const double* x = x_scores.data();
+      const double* incorrect = incorrect_posteriors.data();
+      const double pos_mean = pos_neg_mean.first;
+      const double neg_mean = pos_neg_mean.second;
+      return sumBlocks(incorrect_posteriors.size(), [&](Size begin, Size end)
       {
-        pos_sigma += (1. - *incorrect) * pow((*the_x) - pos_neg_mean.first, 2);
-        neg_sigma += (*incorrect) * pow((*the_x) - pos_neg_mean.second, 2);
-      }
-      return {pos_sigma, neg_sigma};
+        double pos_sigma(0);
+        double neg_sigma(0);
+        for (Size i = begin; i < end; ++i)
+        {
+          const double pos_diff = x[i] - pos_mean;
+          const double neg_diff = x[i] - neg_mean;
+          pos_sigma += (1. - incorrect[i]) * pos_diff * pos_diff;
+          neg_sigma += incorrect[i] * neg_diff * neg_diff;
+        }
+        return std::make_pair(pos_sigma, neg_sigma);
+      });
     }
 
     double PosteriorErrorProbabilityModel::computeProbability(double score) const
@@ -1124,8 +1212,13 @@ namespace OpenMS::Math
 
         if (engine == se)
         {
-          for (PeptideIdentification & pep : peptide_ids)
+          bool invalid_probability = false;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(||: invalid_probability)
+#endif
+          for (SignedSize pep_index = 0; pep_index < static_cast<SignedSize>(peptide_ids.size()); ++pep_index)
           {
+            PeptideIdentification& pep = peptide_ids[pep_index];
             if (prot.getIdentifier() == pep.getIdentifier())
             {
               String score_type = pep.getScoreType() + "_score";
@@ -1151,7 +1244,7 @@ namespace OpenMS::Math
                     // invalid score? invalid fit!
                     if ((score < 0.0) || (score > 1.0)) 
                     {
-                      unable_to_fit_data = true;
+                      invalid_probability = true;
                     }
                     //TODO implement something to check the quality of fit and set data_might_not_be_well_fit
                   }
@@ -1169,6 +1262,7 @@ namespace OpenMS::Math
               pep.setHits(hits);
             }
           }
+          unable_to_fit_data = unable_to_fit_data || invalid_probability;
         }
       }
     }
@@ -0,0 +1,335 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/SYSTEM/Tracer.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/SYSTEM/SysInfo.h>
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#ifdef OPENMS_WINDOWSPLATFORM
+#include <windows.h>
+#else
+#include <ctime>
+#endif
+
+namespace OpenMS
+{
+  std::atomic<bool> Tracer::enabled_{false};
+
+  namespace
+  {
+    /// per-thread state of the Tracer
+    struct ThreadState_
+    {
+      Size thread = 0;
+      Size depth = 0;
+      std::string path; ///< ';'-separated names of the open regions
+    };
+
+    std::atomic<Size> thread_counter_{0};
+
+    ThreadState_& threadState_()
+    {
+      static thread_local ThreadState_ state{thread_counter_++, 0, std::string()};
+      return state;
+    }
+
+    /// CPU time of the calling thread in seconds
+    double threadCPUTime_()
+    {
+#ifdef OPENMS_WINDOWSPLATFORM
+      FILETIME creation, exit, kernel, user;
+      if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) return 0.0;
+      auto to_100ns = [](const FILETIME& ft) { return (ULONGLONG(ft.dwHighDateTime) << 32) | ft.dwLowDateTime; };
+      return double(to_100ns(kernel) + to_100ns(user)) * 1e-7;
+#else
+      timespec ts;
+      if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0.0;
+      return double(ts.tv_sec) + double(ts.tv_nsec) * 1e-9;
+#endif
+    }
+
+    /// orders paths such that children directly follow their parent
+    struct PathLess_
+    {
+      bool operator()(const String& a, const String& b) const
+      {
+        return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(), [](char x, char y)
+        {
+          return (x == ';' ? '\0' : x) < (y == ';' ? '\0' : y);
+        });
+      }
+    };
+
+    /// escape a string for use in JSON
+    String jsonEscape_(const String& in)
+    {
+      String out;
+      out.reserve(in.size());
+      for (char c : in)
+      {
+        switch (c)
+        {
+          case '"': out += "\\\""; break;
+          case '\\': out += "\\\\"; break;
+          case '\n': out += "\\n"; break;
+          case '\t': out += "\\t"; break;
+          default:
+            if (static_cast<unsigned char>(c) < 0x20) out += ' ';
+            else out += c;
+        }
+      }
+      return out;
+    }
+  }
+
+  void Tracer::Scope::begin_(const char* name)
+  {
+    Tracer& t = Tracer::getInstance();
+    ThreadState_& state = threadState_();
+    path_length_ = state.path.size();
+    if (!state.path.empty()) state.path += ';';
+    // ';' separates stack frames in the folded format
+    for (const char* c = name; *c != '\0'; ++c) state.path += (*c == ';' ? ',' : *c);
+    ++state.depth;
+    // top-level regions always sample the peak memory
+    if (t.open_regions_.fetch_add(1, std::memory_order_relaxed) == 0) sample_memory_ = true;
+    active_ = true;
+    cpu_start_ = threadCPUTime_();
+    start_ = t.now_();
+  }
+
+  void Tracer::Scope::end_()
+  {
+    Tracer& t = Tracer::getInstance();
+    double end = t.now_();
+    ThreadState_& state = threadState_();
+
+    Record r;
+    r.wall_time = end - start_;
+    r.cpu_time = threadCPUTime_() - cpu_start_;
+    r.start = start_;
+    r.thread = state.thread;
+    r.depth = state.depth - 1;
+    r.items = items_;
+    r.path = state.path;
+    r.name = state.path.substr(path_length_ == 0 ? 0 : path_length_ + 1);
+    if (sample_memory_)
+    {
+      size_t peak(0);
+      SysInfo::getProcessPeakMemoryConsumption(peak);
+      r.peak_memory = peak;
+    }
+
+    state.path.resize(path_length_);
+    --state.depth;
+    t.open_regions_.fetch_sub(1, std::memory_order_relaxed);
+    active_ = false;
+
+    t.add_(std::move(r));
+  }
+
+  Tracer& Tracer::getInstance()
+  {
+    static Tracer instance;
+    return instance;
+  }
+
+  void Tracer::setEnabled(bool enabled)
+  {
+    if (enabled && !isEnabled())
+    {
+      origin_.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    }
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+
+  void Tracer::clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    records_.clear();
+    summary_.clear();
+    dropped_records_ = 0;
+  }
+
+  void Tracer::setMaxRecords(Size max_records)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_records_ = max_records;
+  }
+
+  Size Tracer::getMaxRecords() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return max_records_;
+  }
+
+  Size Tracer::getNrDroppedRecords() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_records_;
+  }
+
+  std::vector<Tracer::Record> Tracer::getRecords() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_;
+  }
+
+  std::vector<Tracer::Record> Tracer::getSummary() const
+  {
+    std::vector<Record> result;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      result.reserve(summary_.size());
+      for (const auto& p : summary_) result.push_back(p.second);
+    }
+    std::sort(result.begin(), result.end(), [](const Record& a, const Record& b) { return PathLess_()(a.path, b.path); });
+    return result;
+  }
+
+  void Tracer::storeChromeTrace(const String& filename) const
+  {
+    std::ofstream os(filename.c_str());
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    os.precision(3);
+    os << std::fixed;
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const Record& r : getRecords())
+    {
+      if (!first) os << ",";
+      first = false;
+      os << "\n{\"name\":\"" << jsonEscape_(r.name) << "\",\"cat\":\"OpenMS\",\"ph\":\"X\""
+         << ",\"ts\":" << r.start * 1e6 << ",\"dur\":" << r.wall_time * 1e6
+         << ",\"pid\":1,\"tid\":" << r.thread
+         << ",\"args\":{\"cpu_s\":" << r.cpu_time << ",\"peak_memory_kb\":" << r.peak_memory << ",\"items\":" << r.items << "}}";
+    }
+    os << "\n]}\n";
+  }
+
+  void Tracer::storeFoldedStacks(const String& filename) const
+  {
+    std::ofstream os(filename.c_str());
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    // self time = total time of a path minus the total time of its direct children
+    std::vector<Record> summary = getSummary();
+    std::map<String, double> self_time;
+    for (const Record& r : summary) self_time[r.path] += r.wall_time;
+    for (const Record& r : summary)
+    {
+      Size sep = r.path.rfind(';');
+      if (sep == std::string::npos) continue;
+      auto parent = self_time.find(r.path.prefix(sep));
+      if (parent != self_time.end()) parent->second -= r.wall_time;
+    }
+    for (const auto& p : self_time)
+    {
+      // parallel children can exceed their parent's wall time
+      os << p.first << " " << (Size)std::max(0.0, p.second * 1e6) << "\n";
+    }
+  }
+
+  void Tracer::store(const String& filename) const
+  {
+    if (filename.hasSuffix(".json"))
+    {
+      storeChromeTrace(filename);
+    }
+    else
+    {
+      storeFoldedStacks(filename);
+    }
+  }
+
+  String Tracer::toString() const
+  {
+    std::stringstream ss;
+    ss.precision(2);
+    ss << std::fixed;
+    for (const Record& r : getSummary())
+    {
+      ss << String(2 * r.depth, ' ') << r.name << ": " << r.wall_time << " s (wall), " << r.cpu_time << " s (CPU)";
+      if (r.items != 0) ss << ", " << r.items << " items";
+      if (r.peak_memory != 0) ss << ", peak memory " << (r.peak_memory / 1024) << " MB";
+      ss << "\n";
+    }
+    return ss.str();
+  }
+
+  double Tracer::now_() const
+  {
+    const std::chrono::steady_clock::duration origin(origin_.load(std::memory_order_relaxed));
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch() - origin).count();
+  }
+
+  void Tracer::add_(Record&& r)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = summary_.find(r.path);
+    if (it == summary_.end())
+    {
+      summary_.emplace(r.path, r);
+    }
+    else
+    {
+      Record& s = it->second;
+      s.start = std::min(s.start, r.start);
+      s.wall_time += r.wall_time;
+      s.cpu_time += r.cpu_time;
+      s.peak_memory = std::max(s.peak_memory, r.peak_memory);
+      s.items += r.items;
+    }
+    if (records_.size() < max_records_)
+    {
+      records_.push_back(std::move(r));
+    }
+    else
+    {
+      ++dropped_records_;
+    }
+  }
+
+} // namespace OpenMS
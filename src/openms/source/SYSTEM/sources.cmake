@@ -12,6 +12,7 @@ PythonInfo.cpp
 RWrapper.cpp
 StopWatch.cpp
 SysInfo.cpp
+Tracer.cpp
 UpdateCheck.cpp
 )
 
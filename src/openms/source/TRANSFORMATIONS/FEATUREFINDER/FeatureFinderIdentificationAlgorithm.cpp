@@ -48,6 +48,7 @@
 #include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/CHEMISTRY/ModificationsDB.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
+#include <OpenMS/SYSTEM/Tracer.h>
 
 #include <vector>
 #include <numeric>
@@ -254,6 +255,7 @@ namespace OpenMS
     const String spectra_file
     )
   {
+    OPENMS_TRACE_SCOPE("FeatureFinderIdentificationAlgorithm::run");
     if ((svm_n_samples_ > 0) && (svm_n_samples_ < 2 * svm_n_parts_))
     {
       String msg = "Sample size of " + String(svm_n_samples_) +
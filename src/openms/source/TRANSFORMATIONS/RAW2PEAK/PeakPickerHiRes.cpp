@@ -41,6 +41,7 @@
 #include <OpenMS/MATH/MISC/SplineBisection.h>
 #include <OpenMS/MATH/MISC/CubicSpline2d.h>
 #include <OpenMS/KERNEL/SpectrumHelper.h>
+#include <OpenMS/SYSTEM/Tracer.h>
 
 
 using namespace std;
@@ -466,6 +467,9 @@ namespace OpenMS
                                        std::vector<std::vector<PeakBoundary> >& boundaries_chrom,
                                        const bool check_spectrum_type) const
   {
+    Tracer::Scope trace("PeakPickerHiRes::pickExperiment");
+    trace.addItems(input.size() + input.getChromatograms().size());
+
     // make sure that output is clear
     output.clear(true);
 
@@ -62,7 +62,7 @@ namespace OpenMS
 public:
 
     /// Constructor
-    TOPPASOutputFilesDialog(const QString& dir_name, int num_jobs);
+    TOPPASOutputFilesDialog(const QString& dir_name, int num_jobs, int memory_mb = 0);
     ~TOPPASOutputFilesDialog() override;
 
     /// Returns the name of the directory
@@ -71,6 +71,9 @@ public:
     /// Returns the maximum number of jobs in the spinbox
     int getNumJobs() const;
 
+    /// Returns the maximum memory (in MB) of jobs run in parallel (0 = unlimited)
+    int getMemory() const;
+
 public slots:
 
     /// Lets the user select the directory via a file dialog
@@ -0,0 +1,222 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#pragma once
+
+// OpenMS_GUI config
+#include <OpenMS/VISUAL/OpenMS_GUIConfig.h>
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/KERNEL/StandardTypes.h>
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Level-of-detail representation of the MS1 peaks of a peak map for fast 2D drawing.
+
+    Drawing a zoomed-out view of a large map needs the maximum intensity per pixel, which requires touching every
+    peak in the visible area. This class pre-aggregates maximum intensities on a sequence of increasingly coarse
+    RT x m/z grids (a pyramid), so that the cost of drawing depends on the number of pixels, not the number of peaks.
+
+    Level 0 has one row per MS1 spectrum and divides the m/z range of the map into @p finest_mz_bins bins.
+    Each further level merges pairs of adjacent rows and pairs of adjacent m/z bins, until less than
+    @p coarsest_mz_bins m/z bins remain. Only non-empty bins are stored, i.e. memory is bounded by the number of
+    peaks, but usually far smaller for dense (profile) data.
+
+    The pyramid is a snapshot: it is not updated if the map changes.
+
+    @ingroup Visual
+  */
+  class OPENMS_GUI_DLLAPI IntensityPyramid
+  {
+public:
+    /// A single resolution level: one sparse row of m/z bins per group of MS1 spectra, sorted by RT
+    struct Level
+    {
+      double mz_bin_width = 1.0; ///< width of an m/z bin
+      std::vector<double> row_rt; ///< RT of each row (average RT of the spectra it represents)
+      std::vector<Size> row_begin; ///< offset of the first bin of each row in @p bins (one more entry than rows)
+      std::vector<UInt32> bins; ///< m/z bin index of each non-empty bin (sorted within a row)
+      std::vector<float> intensities; ///< maximum intensity of each non-empty bin
+
+      /// number of rows
+      Size rowCount() const
+      {
+        return row_rt.size();
+      }
+    };
+
+    /// Builds a pyramid in small steps (see below)
+    class Builder;
+
+    /// Default constructor (empty pyramid)
+    IntensityPyramid() = default;
+
+    /**
+      @brief Builds the pyramid for all MS1 spectra of @p map
+
+      @param map The peak map (need not be sorted)
+      @param finest_mz_bins Number of m/z bins of level 0 (spanning the m/z range of all MS1 peaks)
+      @param coarsest_mz_bins No further levels are added once a level has less m/z bins than this
+
+      @exception Exception::InvalidValue if @p finest_mz_bins is 0
+    */
+    explicit IntensityPyramid(const PeakMap& map, Size finest_mz_bins = 16384, Size coarsest_mz_bins = 128);
+
+    /// true if the map did not contain any MS1 peaks
+    bool empty() const;
+
+    /// number of levels (level 0 is the finest)
+    Size getLevelCount() const;
+
+    /**
+      @brief Returns the level with index @p level
+
+      @exception Exception::IndexOverflow if @p level is not smaller than getLevelCount()
+    */
+    const Level& getLevel(Size level) const;
+
+    /// lowest m/z of all MS1 peaks (i.e. the lower boundary of the first m/z bin)
+    double getMinMZ() const;
+
+    /**
+      @brief Selects the coarsest level which still has at least one bin per pixel in the given area
+
+      Returns -1 if level 0 is too coarse, i.e. the area has to be drawn from the raw peaks.
+      In RT, level 0 is always sufficient, since its rows are the spectra themselves.
+
+      @param rt_min Lower RT of the area
+      @param rt_max Upper RT of the area
+      @param mz_min Lower m/z of the area
+      @param mz_max Upper m/z of the area
+      @param rt_pixel_count Number of pixels in RT dimension
+      @param mz_pixel_count Number of pixels in m/z dimension
+    */
+    SignedSize selectLevel(double rt_min, double rt_max, double mz_min, double mz_max, Size rt_pixel_count, Size mz_pixel_count) const;
+
+    /**
+      @brief Calls @p f(rt, mz, intensity) for every non-empty bin of @p level in the given area
+
+      The m/z passed to @p f is the center of the bin, the RT that of its row.
+    */
+    template <typename Function>
+    void forEachBin(Size level, double rt_min, double rt_max, double mz_min, double mz_max, Function f) const
+    {
+      const Level& l = getLevel(level);
+      const double bin_min = std::max(0.0, (mz_min - min_mz_) / l.mz_bin_width);
+      const double bin_max = (mz_max - min_mz_) / l.mz_bin_width;
+      if (bin_max < 0.0) return;
+      const UInt32 first_bin = (UInt32)bin_min;
+      const UInt32 last_bin = (UInt32)std::min(bin_max, 4294967295.0);
+
+      Size row = std::lower_bound(l.row_rt.begin(), l.row_rt.end(), rt_min) - l.row_rt.begin();
+      for (; row < l.rowCount() && l.row_rt[row] <= rt_max; ++row)
+      {
+        const auto row_end = l.bins.begin() + l.row_begin[row + 1];
+        for (auto it = std::lower_bound(l.bins.begin() + l.row_begin[row], row_end, first_bin); it != row_end && *it <= last_bin; ++it)
+        {
+          f(l.row_rt[row], min_mz_ + (*it + 0.5) * l.mz_bin_width, l.intensities[it - l.bins.begin()]);
+        }
+      }
+    }
+
+protected:
+    /// Builds the next coarser level from the last one
+    void addCoarserLevel_();
+
+    /// lowest m/z of all MS1 peaks
+    double min_mz_ = 0.0;
+    /// levels, from finest to coarsest
+    std::vector<Level> levels_;
+  };
+
+  /**
+    @brief Builds a pyramid in small steps, e.g. between GUI events.
+
+    Level 0 is built from the map by repeated calls to step(), which each process a bounded number of peaks. The map
+    is only accessed during these calls, so it can be read on the thread that owns (and modifies) it. finish() then
+    adds the coarser levels from level 0 alone and may thus run in any thread.
+  */
+  class OPENMS_GUI_DLLAPI IntensityPyramid::Builder
+  {
+public:
+    /**
+      @brief Constructor
+
+      @param finest_mz_bins Number of m/z bins of level 0 (spanning the m/z range of all MS1 peaks)
+      @param coarsest_mz_bins No further levels are added once a level has less m/z bins than this
+
+      @exception Exception::InvalidValue if @p finest_mz_bins is 0
+    */
+    explicit Builder(Size finest_mz_bins = 16384, Size coarsest_mz_bins = 128);
+
+    /**
+      @brief Processes up to (about) @p max_peaks peaks of @p map and returns true once level 0 is complete
+
+      All calls must be made with the same, unmodified map.
+    */
+    bool step(const PeakMap& map, Size max_peaks);
+
+    /// Adds the coarser levels and returns the pyramid (step() must have returned true). Can be called from another thread.
+    IntensityPyramid finish();
+
+    /// Makes a running finish() return early (with an incomplete pyramid). Can be called from another thread.
+    void cancel();
+
+protected:
+    /// The pyramid being built
+    IntensityPyramid pyramid_;
+    Size finest_mz_bins_;
+    Size coarsest_mz_bins_;
+    /// 0: collecting MS1 spectra and their m/z range, 1: binning the spectra (level 0), 2: level 0 complete
+    int phase_ = 0;
+    /// next spectrum of the map (phase 0) or next entry of ms1_ (phase 1)
+    Size next_ = 0;
+    /// (RT, index) of the non-empty MS1 spectra, sorted by RT in phase 1
+    std::vector<std::pair<double, Size>> ms1_;
+    double min_mz_;
+    double max_mz_;
+    /// dense scratch row of level 0 (only touched bins are reset after each spectrum)
+    std::vector<float> row_;
+    std::vector<UInt32> touched_;
+    std::atomic<bool> cancelled_;
+  };
+
+} // namespace OpenMS
@@ -40,13 +40,24 @@
 // OpenMS
 #include <OpenMS/VISUAL/PlotCanvas.h>
 #include <OpenMS/VISUAL/Plot1DCanvas.h>
+#include <OpenMS/VISUAL/IntensityPyramid.h>
 #include <OpenMS/KERNEL/PeakIndex.h>
 
+// STL
+#include <future>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <boost/weak_ptr.hpp>
+
 // QT
 class QPainter;
 class QMouseEvent;
 class QAction;
 class QMenu;
+class QTimer;
 
 namespace OpenMS
 {
@@ -140,6 +151,9 @@ protected slots:
     /// Reacts on changed layer parameters
     void currentLayerParametersChanged_();
 
+    /// Continues building pending intensity pyramids and repaints once they are ready (restarts the timer while builds are pending)
+    void checkPendingPyramids_();
+
 protected:
     // Docu in base class
     bool finishAdding_() override;
@@ -192,6 +206,26 @@ protected:
     */
     void paintMaximumIntensities_(Size layer_index, Size rt_pixel_count, Size mz_pixel_count, QPainter& p);
 
+    /**
+      @brief Paints maximum intensities from level @p level of an intensity pyramid instead of the raw peaks.
+
+      Same output as paintMaximumIntensities_(), but the cost depends on the number of pixels instead of the number of peaks.
+    */
+    void paintPyramidIntensities_(Size layer_index, const IntensityPyramid& pyramid, Size level, Size rt_pixel_count, Size mz_pixel_count);
+
+    /**
+      @brief Returns the intensity pyramid of the peak layer @p layer_index, or nullptr if none is available (yet).
+
+      Pyramids are only built for maps with at least PYRAMID_MIN_PEAKS MS1 peaks. The first request for a map starts building the pyramid
+      and returns nullptr: level 0 is built from the map in steps of PYRAMID_STEP_PEAKS peaks on the GUI thread (see checkPendingPyramids_()),
+      so the map is never read while it might be modified, and the coarser levels are added in a background thread. The canvas is repainted
+      once the pyramid is ready. Pyramids are rebuilt if the number of spectra or peaks of the map changed.
+    */
+    const IntensityPyramid* getIntensityPyramid_(Size layer_index);
+
+    /// Removes the pyramid of @p data from the cache (cancelling and joining its background build)
+    void erasePyramid_(const ExperimentType* data);
+
     /**
       @brief Paints the precursor peaks.
 
@@ -390,6 +424,29 @@ protected:
     double pen_size_max_; ///< maximum number of pixels for one data point
     double canvas_coverage_min_; ///< minimum coverage of the canvas required; if lower, points are upscaled in size
 
+    /// minimum number of MS1 peaks of a map to build an intensity pyramid for it (smaller maps are drawn fast enough from the raw peaks)
+    static constexpr Size PYRAMID_MIN_PEAKS = 20000000;
+    /// number of peaks processed per step when building level 0 of an intensity pyramid on the GUI thread
+    static constexpr Size PYRAMID_STEP_PEAKS = 2000000;
+
+    /// An intensity pyramid of a peak map (possibly still being built)
+    struct PyramidCacheEntry
+    {
+      boost::weak_ptr<const ExperimentType> data; ///< the map the pyramid belongs to (not owned, so the map can be unloaded)
+      Size spectra_count = 0; ///< number of spectra of the map when the pyramid was built
+      Size peak_count = 0; ///< number of MS1 peaks of the map when the pyramid was built
+      std::shared_ptr<IntensityPyramid::Builder> builder; ///< builds the pyramid (level 0 on the GUI thread, then the rest in @p thread)
+      bool level0_done = false; ///< is level 0 complete (i.e. has the background build been started)?
+      std::thread thread; ///< adds the coarser levels (joined when the entry is erased)
+      std::shared_future<std::shared_ptr<const IntensityPyramid>> future; ///< result of the background build
+      std::shared_ptr<const IntensityPyramid> pyramid; ///< the pyramid, once the build is done (nullptr if it failed)
+      bool done = false; ///< has the build finished?
+    };
+    /// intensity pyramids of the peak layers, by peak map
+    std::map<const ExperimentType*, PyramidCacheEntry> pyramids_;
+    /// continues pending pyramid builds and triggers a repaint once they are ready
+    QTimer* pyramid_timer_;
+
   private:
     /// Default C'tor hidden
     Plot2DCanvas();
@@ -44,6 +44,8 @@
 #include <QtWidgets/QGraphicsScene>
 #include <QtCore/QProcess>
 
+#include <map>
+
 namespace OpenMS
 {
   class TOPPASVertex;
@@ -93,11 +95,13 @@ public:
     struct TOPPProcess
     {
       /// Constructor
-      TOPPProcess(QProcess * p, const QString & cmd, const QStringList & arg, TOPPASToolVertex * const tool) :
+      TOPPProcess(QProcess * p, const QString & cmd, const QStringList & arg, TOPPASToolVertex * const tool, int thread_count = 0, UInt memory_mb = 0) :
         proc(p),
         command(cmd),
         args(arg),
-        tv(tool)
+        tv(tool),
+        threads(thread_count),
+        memory(memory_mb)
       {
       }
 
@@ -109,6 +113,12 @@ public:
       QStringList args;
       /// The tool which is started (used to call its slots)
       TOPPASToolVertex * tv;
+      /// Number of threads the tool wants to use (0 if it has no '-threads' parameter; it then counts as one thread)
+      int threads;
+      /// Peak memory of the tool in MB (0 if unknown)
+      UInt memory;
+      /// Scheduling priority: number of tools on the longest path from this tool to the end of the pipeline (set by enqueueProcess())
+      int priority = 0;
     };
 
     /// The current action mode (creation of a new edge, or panning of the widget)
@@ -204,9 +214,18 @@ public:
     bool isPipelineRunning() const;
     /// Shows a dialog that allows to specify the output directory. If @p always_ask == false, the dialog won't be shown if a directory has been set, already.
     bool askForOutputDir(bool always_ask = true);
-    /// Enqueues the process, it will be run when the currently pending processes have finished
+    /// Enqueues the process, it will be run when enough threads and memory are available (see runNextProcess())
     void enqueueProcess(const TOPPProcess & process);
-    /// Runs the next process in the queue, if any
+    /**
+      @brief Runs as many queued processes as the thread and memory budget allows
+
+      Processes are started by priority, i.e. tools with the longest chain of downstream tools (the critical path) first,
+      and in order of enqueueing among equals. Each process uses as many threads as its tool's '-threads' parameter requests
+      (limited to the thread budget, see setAllowedThreads()) and the memory set via TOPPASToolVertex::setMemoryRequirement()
+      (see setAllowedMemory()). The number of threads granted is passed to the tool on the command line.
+      If the next process does not fit into the remaining budget, its resources are reserved, such that processes of lower
+      priority cannot starve it. A process which exceeds the total budget is run once nothing else is running.
+    */
     void runNextProcess();
     /// Resets the processes queue
     void resetProcessesQueue();
@@ -240,8 +259,10 @@ public:
     QString getDescription() const;
     /// when description is updated by user, use this to update the description for later storage in file
     void setDescription(const QString & desc);
-    /// sets the maximum number of jobs
+    /// sets the maximum number of threads used by all running tools (a tool with '-threads N' uses N)
     void setAllowedThreads(int num_threads);
+    /// sets the total memory (in MB) available to all running tools (0 = unlimited)
+    void setAllowedMemory(UInt memory_mb);
     /// returns the hovering edge
     TOPPASEdge* getHoveringEdge();
     /// Checks whether all output vertices are finished, and if yes, emits entirePipelineFinished() (called by finished output vertices)
@@ -275,8 +296,8 @@ public slots:
     void changedParameter(const bool invalidates_running_pipeline);
     /// Invoked by OutfilelistVertex of user changed the folder name
     void changedOutputFolder();
-    /// Called by a finished QProcess to indicate that we are free to start a new one
-    void processFinished();
+    /// Called by a finished QProcess to release its threads and memory, so new ones can be started
+    void processFinished(QProcess * process);
     /// dirty solution: when using ExecutePipeline this slot is called when the pipeline crashes. This will quit the app
     void quitWithError();
 
@@ -355,12 +376,18 @@ protected:
     TOPPASScene * clipboard_;
     /// dry run mode (no tools are actually called)
     bool dry_run_;
-    /// currently running processes...
+    /// threads used by currently running processes
     int threads_active_;
+    /// memory (in MB) used by currently running processes
+    UInt memory_active_;
+    /// threads and memory (in MB) used by each running process
+    std::map<const QProcess *, std::pair<int, UInt> > running_processes_;
     /// description text
     QString description_text_;
     /// maximum number of allowed threads
     int allowed_threads_;
+    /// maximum memory (in MB) used by all running processes (0 = unlimited)
+    UInt allowed_memory_;
     /// last node where 'resume' was started
     TOPPASToolVertex* resume_source_;
 
@@ -370,6 +397,8 @@ protected:
     bool isEdgeAllowed_(TOPPASVertex * u, TOPPASVertex * v);
     /// DFS helper method. Returns true, if a back edge has been discovered
     bool dfsVisit_(TOPPASVertex * vertex);
+    /// Returns the number of tools on the longest path from @p vertex to the end of the pipeline (including @p vertex); @p cache memorizes results
+    int criticalPathLength_(const TOPPASVertex * vertex, std::map<const TOPPASVertex *, int> & cache) const;
     /// Performs a sanity check of the pipeline and notifies user when it finds something strange. Returns if pipeline OK.
     /// if 'allowUserOverride' is true, some dialogs are shown which allow the user to ignore some warnings (e.g. disconnected nodes)
     bool sanityCheck_(bool allowUserOverride);
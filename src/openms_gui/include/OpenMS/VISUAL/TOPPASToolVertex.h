@@ -165,6 +165,12 @@ public:
     void setParam(const Param& param);
     /// Returns the Param object of this tool
     const Param& getParam();
+    /// Returns the number of threads a run of this tool uses (its 'threads' parameter), or 0 if the tool has no such parameter
+    int getThreadRequirement() const;
+    /// Sets the peak memory (in MB) of a single run of this tool (0 = unknown), used for scheduling runs in parallel (see TOPPASScene::runNextProcess())
+    void setMemoryRequirement(UInt memory_mb);
+    /// Returns the peak memory (in MB) of a single run of this tool (0 = unknown)
+    UInt getMemoryRequirement() const;
     /// Checks if all parent nodes have finished the tool execution and, if so, runs the tool
     void run() override;
     /// Updates the vector containing the lists of current output files for all output parameters
@@ -273,6 +279,8 @@ protected:
     bool tool_ready_{true};
     /// Breakpoint set?
     bool breakpoint_set_{false};
+    /// peak memory (in MB) of a single run (0 = unknown)
+    UInt memory_requirement_{0};
   };
 }
 
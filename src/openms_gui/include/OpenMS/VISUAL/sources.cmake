@@ -17,6 +17,7 @@ GUIProgressLoggerImpl.h
 HistogramWidget.h
 InputFile.h
 InputFileList.h
+IntensityPyramid.h
 LayerListView.h
 LayerDataBase.h
 LayerDataChrom.h
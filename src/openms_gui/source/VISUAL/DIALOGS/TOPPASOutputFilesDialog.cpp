@@ -48,7 +48,7 @@
 
 namespace OpenMS
 {
-  TOPPASOutputFilesDialog::TOPPASOutputFilesDialog(const QString& dir_name, int num_jobs)
+  TOPPASOutputFilesDialog::TOPPASOutputFilesDialog(const QString& dir_name, int num_jobs, int memory_mb)
     : ui_(new Ui::TOPPASOutputFilesDialogTemplate)
   {
     ui_->setupUi(this);
@@ -64,6 +64,7 @@ namespace OpenMS
     {
       ui_->num_jobs_box->setValue(num_jobs);
     }
+    ui_->memory_box->setValue(memory_mb);
     
     connect(ui_->ok_button, SIGNAL(clicked()), this, SLOT(checkValidity_()));
     connect(ui_->cancel_button, SIGNAL(clicked()), this, SLOT(reject()));
@@ -92,6 +93,11 @@ namespace OpenMS
     return ui_->num_jobs_box->value();
   }
 
+  int TOPPASOutputFilesDialog::getMemory() const
+  {
+    return ui_->memory_box->value();
+  }
+
   void TOPPASOutputFilesDialog::checkValidity_()
   {
     if (!ui_->out_dir->dirNameValid())
@@ -259,6 +259,7 @@ namespace OpenMS
     vis_param_ = arg_param_.copy(getTool() + ":1:", true);
     vis_param_.remove("log");
     vis_param_.remove("no_progress");
+    vis_param_.remove("profile");
     vis_param_.remove("debug");
 
     editor_->load(vis_param_);
@@ -362,6 +363,7 @@ namespace OpenMS
     vis_param_ = arg_param_.copy(getTool() + ":1:", true);
     vis_param_.remove("log");
     vis_param_.remove("no_progress");
+    vis_param_.remove("profile");
     vis_param_.remove("debug");
     //load data into editor
     editor_->load(vis_param_);
@@ -0,0 +1,258 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/VISUAL/IntensityPyramid.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <limits>
+#include <utility>
+
+using namespace std;
+
+namespace OpenMS
+{
+
+  IntensityPyramid::Builder::Builder(Size finest_mz_bins, Size coarsest_mz_bins) :
+    finest_mz_bins_(finest_mz_bins),
+    coarsest_mz_bins_(coarsest_mz_bins),
+    min_mz_(numeric_limits<double>::max()),
+    max_mz_(numeric_limits<double>::lowest()),
+    cancelled_(false)
+  {
+    if (finest_mz_bins == 0 || finest_mz_bins > numeric_limits<UInt32>::max())
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Number of m/z bins must be in [1, 2^32).", String(finest_mz_bins));
+    }
+  }
+
+  bool IntensityPyramid::Builder::step(const PeakMap& map, Size max_peaks)
+  {
+    Size peaks = 0;
+    if (phase_ == 0)
+    {
+      // MS1 spectra and the m/z range of their peaks
+      for (; next_ < map.size() && peaks < max_peaks; ++next_)
+      {
+        const MSSpectrum& spec = map[next_];
+        if (spec.getMSLevel() != 1 || spec.empty()) continue;
+        ms1_.emplace_back(spec.getRT(), next_);
+        for (const Peak1D& p : spec)
+        {
+          min_mz_ = std::min(min_mz_, p.getMZ());
+          max_mz_ = std::max(max_mz_, p.getMZ());
+        }
+        peaks += spec.size();
+      }
+      if (next_ < map.size()) return false;
+
+      if (ms1_.empty())
+      {
+        phase_ = 2;
+        return true;
+      }
+      stable_sort(ms1_.begin(), ms1_.end(), [](const pair<double, Size>& a, const pair<double, Size>& b) { return a.first < b.first; });
+
+      // level 0: one row per spectrum
+      pyramid_.min_mz_ = min_mz_;
+      Level level;
+      level.mz_bin_width = (max_mz_ > min_mz_) ? (max_mz_ - min_mz_) / finest_mz_bins_ : 1.0;
+      level.row_rt.reserve(ms1_.size());
+      level.row_begin.reserve(ms1_.size() + 1);
+      level.row_begin.push_back(0);
+      pyramid_.levels_.push_back(std::move(level));
+      row_.assign(finest_mz_bins_, numeric_limits<float>::lowest());
+      next_ = 0;
+      phase_ = 1;
+    }
+
+    if (phase_ == 1)
+    {
+      const float unset = numeric_limits<float>::lowest();
+      Level& level = pyramid_.levels_.front();
+      for (; next_ < ms1_.size() && peaks < max_peaks; ++next_)
+      {
+        const MSSpectrum& spec = map[ms1_[next_].second];
+        for (const Peak1D& p : spec)
+        {
+          UInt32 bin = (UInt32)std::min(Size((p.getMZ() - min_mz_) / level.mz_bin_width), finest_mz_bins_ - 1);
+          if (row_[bin] == unset)
+          {
+            touched_.push_back(bin);
+          }
+          row_[bin] = std::max(row_[bin], p.getIntensity());
+        }
+        sort(touched_.begin(), touched_.end());
+        for (UInt32 bin : touched_)
+        {
+          level.bins.push_back(bin);
+          level.intensities.push_back(row_[bin]);
+          row_[bin] = unset;
+        }
+        touched_.clear();
+        level.row_rt.push_back(ms1_[next_].first);
+        level.row_begin.push_back(level.bins.size());
+        peaks += spec.size();
+      }
+      if (next_ < ms1_.size()) return false;
+
+      // free the scratch data
+      vector<float>().swap(row_);
+      vector<pair<double, Size>>().swap(ms1_);
+      phase_ = 2;
+    }
+    return true;
+  }
+
+  IntensityPyramid IntensityPyramid::Builder::finish()
+  {
+    if (phase_ != 2)
+    {
+      throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Level 0 of the intensity pyramid is not complete.");
+    }
+    Size mz_bins = finest_mz_bins_;
+    while (!pyramid_.levels_.empty() && mz_bins >= 2 * coarsest_mz_bins_ && pyramid_.levels_.back().rowCount() > 1 && !cancelled_)
+    {
+      pyramid_.addCoarserLevel_();
+      mz_bins = (mz_bins + 1) / 2;
+    }
+    return std::move(pyramid_);
+  }
+
+  void IntensityPyramid::Builder::cancel()
+  {
+    cancelled_ = true;
+  }
+
+  IntensityPyramid::IntensityPyramid(const PeakMap& map, Size finest_mz_bins, Size coarsest_mz_bins)
+  {
+    Builder builder(finest_mz_bins, coarsest_mz_bins);
+    builder.step(map, numeric_limits<Size>::max());
+    *this = builder.finish();
+  }
+
+  void IntensityPyramid::addCoarserLevel_()
+  {
+    const Level& fine = levels_.back();
+    Level coarse;
+    coarse.mz_bin_width = fine.mz_bin_width * 2;
+    coarse.row_begin.push_back(0);
+    for (Size row = 0; row < fine.rowCount(); row += 2)
+    {
+      const Size rows = std::min(Size(2), fine.rowCount() - row);
+      double rt_sum = 0;
+      // merge the (sorted) bins of both rows, halving their resolution
+      Size a = fine.row_begin[row], a_end = fine.row_begin[row + 1];
+      Size b = a_end, b_end = fine.row_begin[row + rows]; // empty range for a single row
+      for (Size r = row; r < row + rows; ++r) rt_sum += fine.row_rt[r];
+
+      while (a < a_end || b < b_end)
+      {
+        Size next;
+        if (b == b_end || (a < a_end && fine.bins[a] <= fine.bins[b]))
+        {
+          next = a++;
+        }
+        else
+        {
+          next = b++;
+        }
+        const UInt32 bin = fine.bins[next] / 2;
+        const float intensity = fine.intensities[next];
+        if (coarse.bins.size() > coarse.row_begin.back() && coarse.bins.back() == bin)
+        {
+          coarse.intensities.back() = std::max(coarse.intensities.back(), intensity);
+        }
+        else
+        {
+          coarse.bins.push_back(bin);
+          coarse.intensities.push_back(intensity);
+        }
+      }
+      coarse.row_rt.push_back(rt_sum / rows);
+      coarse.row_begin.push_back(coarse.bins.size());
+    }
+    levels_.push_back(std::move(coarse));
+  }
+
+  bool IntensityPyramid::empty() const
+  {
+    return levels_.empty();
+  }
+
+  Size IntensityPyramid::getLevelCount() const
+  {
+    return levels_.size();
+  }
+
+  const IntensityPyramid::Level& IntensityPyramid::getLevel(Size level) const
+  {
+    if (level >= levels_.size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, level, levels_.size());
+    }
+    return levels_[level];
+  }
+
+  double IntensityPyramid::getMinMZ() const
+  {
+    return min_mz_;
+  }
+
+  SignedSize IntensityPyramid::selectLevel(double rt_min, double rt_max, double mz_min, double mz_max, Size rt_pixel_count, Size mz_pixel_count) const
+  {
+    for (SignedSize level = levels_.size() - 1; level >= 0; --level)
+    {
+      const Level& l = levels_[level];
+      if ((mz_max - mz_min) / l.mz_bin_width < mz_pixel_count)
+      {
+        continue; // too coarse in m/z
+      }
+      if (level > 0)
+      {
+        Size rows = std::upper_bound(l.row_rt.begin(), l.row_rt.end(), rt_max) - std::lower_bound(l.row_rt.begin(), l.row_rt.end(), rt_min);
+        if (rows < rt_pixel_count)
+        {
+          continue; // too coarse in RT
+        }
+      }
+      return level;
+    }
+    return -1;
+  }
+
+} // namespace OpenMS
@@ -33,6 +33,7 @@
 // --------------------------------------------------------------------------
 
 // OpenMS
+#include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/FORMAT/ConsensusXMLFile.h>
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
 #include <OpenMS/FORMAT/FileHandler.h>
@@ -51,6 +52,11 @@
 #include <OpenMS/VISUAL/PlotWidget.h>
 //STL
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <thread>
 
 //QT
 #include <QBitmap>
@@ -58,6 +64,7 @@
 #include <QPainter>
 #include <QPolygon>
 #include <QElapsedTimer>
+#include <QtCore/QTimer>
 #include <QtWidgets/QComboBox>
 #include <QtWidgets/QMenu>
 #include <QtWidgets/QMessageBox>
@@ -86,7 +93,9 @@ namespace OpenMS
     measurement_start_(),
     pen_size_min_(1),
     pen_size_max_(20),
-    canvas_coverage_min_(0.2)
+    canvas_coverage_min_(0.2),
+    pyramids_(),
+    pyramid_timer_(nullptr)
   {
     //Parameter handling
     defaults_.setValue("background_color", "#ffffff", "Background color.");
@@ -117,10 +126,28 @@ namespace OpenMS
     }
     //connect preferences change to the right slot
     connect(this, SIGNAL(preferencesChange()), this, SLOT(currentLayerParametersChanged_()));
+
+    //poll for intensity pyramids being built in the background
+    pyramid_timer_ = new QTimer(this);
+    pyramid_timer_->setSingleShot(true);
+    pyramid_timer_->setInterval(250);
+    connect(pyramid_timer_, SIGNAL(timeout()), this, SLOT(checkPendingPyramids_()));
   }
 
   Plot2DCanvas::~Plot2DCanvas()
   {
+    // background pyramid builds only use their own data, but must not outlive the canvas
+    for (auto& p : pyramids_)
+    {
+      p.second.builder->cancel();
+    }
+    for (auto& p : pyramids_)
+    {
+      if (p.second.thread.joinable())
+      {
+        p.second.thread.join();
+      }
+    }
   }
 
   void Plot2DCanvas::highlightPeak_(QPainter & painter, const PeakIndex & peak)
@@ -628,6 +655,21 @@ namespace OpenMS
 
     double snap_factor = snap_factors_[layer_index];
 
+    // large maps: use the intensity pyramid (if ready), unless peaks need to be filtered individually
+    if (layer.filters.size() == 0)
+    {
+      const IntensityPyramid* pyramid = getIntensityPyramid_(layer_index);
+      if (pyramid != nullptr)
+      {
+        SignedSize level = pyramid->selectLevel(rt_min, rt_max, mz_min, mz_max, rt_pixel_count, mz_pixel_count);
+        if (level >= 0) // otherwise zoomed in too far for the finest level
+        {
+          paintPyramidIntensities_(layer_index, *pyramid, level, rt_pixel_count, mz_pixel_count);
+          return;
+        }
+      }
+    }
+
     //calculate pixel size in data coordinates
     double rt_step_size = (rt_max - rt_min) / rt_pixel_count;
     double mz_step_size = (mz_max - mz_min) / mz_pixel_count;
@@ -708,6 +750,222 @@ namespace OpenMS
     }
   }
 
+  void Plot2DCanvas::paintPyramidIntensities_(Size layer_index, const IntensityPyramid& pyramid, Size level, Size rt_pixel_count, Size mz_pixel_count)
+  {
+    Int image_width = buffer_.width();
+    Int image_height = buffer_.height();
+
+    const LayerDataBase& layer = getLayer(layer_index);
+    const double rt_min = visible_area_.minPosition()[1];
+    const double rt_max = visible_area_.maxPosition()[1];
+    const double mz_min = visible_area_.minPosition()[0];
+    const double mz_max = visible_area_.maxPosition()[0];
+
+    double snap_factor = snap_factors_[layer_index];
+
+    //calculate pixel size in data coordinates
+    double rt_step_size = (rt_max - rt_min) / rt_pixel_count;
+    double mz_step_size = (mz_max - mz_min) / mz_pixel_count;
+
+    // maximum intensity per pixel (bins are at most as large as pixels, so each bin is assigned to the pixel of its center)
+    const float unset = std::numeric_limits<float>::lowest();
+    vector<float> pixel_max(rt_pixel_count * mz_pixel_count, unset);
+    pyramid.forEachBin(level, rt_min, rt_max, mz_min, mz_max, [&](double rt, double mz, float intensity)
+    {
+      double rt_pixel = std::floor((rt - rt_min) / rt_step_size);
+      double mz_pixel = std::floor((mz - mz_min) / mz_step_size);
+      if (rt_pixel < 0 || rt_pixel >= rt_pixel_count || mz_pixel < 0 || mz_pixel >= mz_pixel_count)
+      {
+        return;
+      }
+      float& max = pixel_max[Size(rt_pixel) * mz_pixel_count + Size(mz_pixel)];
+      max = std::max(max, intensity);
+    });
+
+    //draw to buffer
+    for (Size rt = 0; rt < rt_pixel_count; ++rt)
+    {
+      for (Size mz = 0; mz < mz_pixel_count; ++mz)
+      {
+        float max = pixel_max[rt * mz_pixel_count + mz];
+        if (max >= 0.0)
+        {
+          QPoint pos;
+          dataToWidget_(mz_min + (mz + 0.5) * mz_step_size, rt_min + (rt + 0.5) * rt_step_size, pos);
+          if (pos.y() < image_height && pos.x() < image_width)
+          {
+            buffer_.setPixel(pos.x(), pos.y(), heightColor_(max, layer.gradient, snap_factor).rgb());
+          }
+        }
+      }
+    }
+  }
+
+  const IntensityPyramid* Plot2DCanvas::getIntensityPyramid_(Size layer_index)
+  {
+    // forget pyramids of unloaded maps
+    std::vector<const ExperimentType*> unloaded;
+    for (const auto& p : pyramids_)
+    {
+      if (p.second.data.expired())
+      {
+        unloaded.push_back(p.first);
+      }
+    }
+    for (const ExperimentType* map : unloaded)
+    {
+      erasePyramid_(map);
+    }
+
+    LayerDataBase::ConstExperimentSharedPtrType data = getLayer(layer_index).getPeakData();
+    Size peak_count = 0;
+    for (const SpectrumType& spec : *data)
+    {
+      if (spec.getMSLevel() == 1)
+      {
+        peak_count += spec.size();
+      }
+    }
+    if (peak_count < PYRAMID_MIN_PEAKS)
+    {
+      return nullptr;
+    }
+
+    auto it = pyramids_.find(data.get());
+    if (it != pyramids_.end() && (it->second.spectra_count != data->size() || it->second.peak_count != peak_count))
+    {
+      erasePyramid_(data.get()); // map was modified
+      it = pyramids_.end();
+    }
+    if (it == pyramids_.end())
+    {
+      PyramidCacheEntry& entry = pyramids_[data.get()];
+      entry.data = data;
+      entry.spectra_count = data->size();
+      entry.peak_count = peak_count;
+      entry.builder = std::make_shared<IntensityPyramid::Builder>();
+      // level 0 is built in steps whenever the event loop is idle (see checkPendingPyramids_())
+      pyramid_timer_->start(0);
+      return nullptr;
+    }
+
+    PyramidCacheEntry& entry = it->second;
+    if (!entry.level0_done)
+    {
+      return nullptr; // level 0 still building
+    }
+    if (!entry.done)
+    {
+      if (entry.future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+      {
+        return nullptr; // still building
+      }
+      entry.done = true;
+      try
+      {
+        entry.pyramid = entry.future.get();
+      }
+      catch (std::exception& e)
+      {
+        OPENMS_LOG_WARN << "Could not build intensity pyramid (drawing from raw peaks instead): " << e.what() << std::endl;
+      }
+    }
+    return entry.pyramid.get();
+  }
+
+  void Plot2DCanvas::erasePyramid_(const ExperimentType* data)
+  {
+    auto it = pyramids_.find(data);
+    if (it == pyramids_.end())
+    {
+      return;
+    }
+    it->second.builder->cancel();
+    if (it->second.thread.joinable())
+    {
+      it->second.thread.join();
+    }
+    pyramids_.erase(it);
+  }
+
+  void Plot2DCanvas::checkPendingPyramids_()
+  {
+    bool ready = false;
+    bool pending = false;
+    bool level0_pending = false;
+    for (auto& p : pyramids_)
+    {
+      PyramidCacheEntry& entry = p.second;
+      if (entry.done)
+      {
+        continue;
+      }
+      if (!entry.level0_done)
+      {
+        // level 0 reads the map, so it is built here on the GUI thread, where the map is modified
+        LayerDataBase::ConstExperimentSharedPtrType data = entry.data.lock();
+        if (!data || data->size() != entry.spectra_count)
+        {
+          continue; // unloaded or modified: erased (or rebuilt) on the next repaint
+        }
+        try
+        {
+          if (!entry.builder->step(*data, PYRAMID_STEP_PEAKS))
+          {
+            level0_pending = true;
+            continue;
+          }
+        }
+        catch (std::exception& e)
+        {
+          OPENMS_LOG_WARN << "Could not build intensity pyramid (drawing from raw peaks instead): " << e.what() << std::endl;
+          entry.level0_done = true;
+          entry.done = true;
+          continue;
+        }
+        // the coarser levels only need level 0, so they are added in the background
+        entry.level0_done = true;
+        auto promise = std::make_shared<std::promise<std::shared_ptr<const IntensityPyramid>>>();
+        entry.future = promise->get_future().share();
+        std::shared_ptr<IntensityPyramid::Builder> builder = entry.builder;
+        entry.thread = std::thread([promise, builder]()
+        {
+          try
+          {
+            promise->set_value(std::make_shared<const IntensityPyramid>(builder->finish()));
+          }
+          catch (...)
+          {
+            promise->set_exception(std::current_exception());
+          }
+        });
+        pending = true;
+        continue;
+      }
+      if (entry.future.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+      {
+        ready = true;
+      }
+      else
+      {
+        pending = true;
+      }
+    }
+    if (level0_pending)
+    {
+      pyramid_timer_->start(0);
+    }
+    else if (pending)
+    {
+      pyramid_timer_->start(250);
+    }
+    if (ready)
+    {
+      update_buffer_ = true;
+      update_(OPENMS_PRETTY_FUNCTION);
+    }
+  }
+
   void Plot2DCanvas::paintFeatureData_(Size layer_index, QPainter& painter)
   {
     const LayerDataBase& layer = getLayer(layer_index);
@@ -56,8 +56,11 @@
 #include <QtCore/QDir>
 #include <QtCore/QSet>
 #include <QtCore/QTextStream>
+#include <QtWidgets/QInputDialog>
 #include <QtWidgets/QMessageBox>
 
+#include <algorithm>
+#include <limits>
 #include <map>
 
 namespace OpenMS
@@ -89,7 +92,10 @@ namespace OpenMS
     clipboard_(nullptr),
     dry_run_(true),
     threads_active_(0),
+    memory_active_(0),
+    running_processes_(),
     allowed_threads_(1),
+    allowed_memory_(0),
     resume_source_(nullptr)
   {
     /*	ATTENTION!
@@ -619,6 +625,23 @@ namespace OpenMS
     return false;
   }
 
+  int TOPPASScene::criticalPathLength_(const TOPPASVertex* vertex, std::map<const TOPPASVertex*, int>& cache) const
+  {
+    auto cached = cache.find(vertex);
+    if (cached != cache.end())
+    {
+      return cached->second;
+    }
+    int downstream = 0;
+    for (TOPPASVertex::ConstEdgeIterator it = vertex->outEdgesBegin(); it != vertex->outEdgesEnd(); ++it)
+    {
+      downstream = std::max(downstream, criticalPathLength_((*it)->getTargetVertex(), cache));
+    }
+    int length = downstream + (qobject_cast<const TOPPASToolVertex*>(vertex) ? 1 : 0);
+    cache[vertex] = length;
+    return length;
+  }
+
   void TOPPASScene::resetDownstream(TOPPASVertex* vertex)
   {
     // reset all nodes
@@ -751,6 +774,10 @@ namespace OpenMS
         save_param.setValue("vertices:" + id + ":tool_name", ttv->getName());
         save_param.setValue("vertices:" + id + ":tool_type", ttv->getType());
         save_param.insert("vertices:" + id + ":parameters:", ttv->getParam());
+        if (ttv->getMemoryRequirement() > 0)
+        {
+          save_param.setValue("vertices:" + id + ":memory", (int)ttv->getMemoryRequirement());
+        }
         save_param.setValue("vertices:" + id + ":x_pos", tv->x());
         save_param.setValue("vertices:" + id + ":y_pos", tv->y());
         continue;
@@ -976,6 +1003,10 @@ namespace OpenMS
           Param param_param = vertices_param.copy(current_id + ":parameters:", true);
           TOPPASToolVertex* tv = new TOPPASToolVertex(tool_name, tool_type);
           tv->setParam(param_param);
+          if (vertices_param.exists(current_id + ":memory")) // optional
+          {
+            tv->setMemoryRequirement((int)vertices_param.getValue(current_id + ":memory"));
+          }
 
           connectToolVertexSignals(tv);
 
@@ -1689,9 +1720,15 @@ namespace OpenMS
     }
   }
 
-  void TOPPASScene::processFinished()
+  void TOPPASScene::processFinished(QProcess* process)
   {
-    --threads_active_;
+    auto it = running_processes_.find(process);
+    if (it != running_processes_.end())
+    {
+      threads_active_ -= it->second.first;
+      memory_active_ -= it->second.second;
+      running_processes_.erase(it);
+    }
     // try to run next in line
     runNextProcess();
   }
@@ -1702,11 +1739,12 @@ namespace OpenMS
     {
       if (always_ask || !user_specified_out_dir_)
       {
-        TOPPASOutputFilesDialog tofd(out_dir_, allowed_threads_);
+        TOPPASOutputFilesDialog tofd(out_dir_, allowed_threads_, (int)allowed_memory_);
         if (tofd.exec())
         {
           setOutDir(tofd.getDirectory());
           setAllowedThreads(tofd.getNumJobs());
+          setAllowedMemory(tofd.getMemory());
         }
         else
         {
@@ -1813,6 +1851,7 @@ namespace OpenMS
       if (found_tool)
       {
         action.insert("Edit parameters");
+        action.insert("Set memory requirement");
         action.insert("Resume");
         action.insert("Open files in TOPPView");
         action.insert("Open containing folder");
@@ -1901,6 +1940,32 @@ namespace OpenMS
         return;
       }
 
+      if (text == "Set memory requirement")
+      {
+        QList<TOPPASToolVertex*> tools;
+        foreach(QGraphicsItem* gi, selectedItems())
+        {
+          TOPPASToolVertex* ttv = dynamic_cast<TOPPASToolVertex*>(gi);
+          if (ttv)
+          {
+            tools << ttv;
+          }
+        }
+        bool ok = false;
+        int memory = QInputDialog::getInt(nullptr, "Set memory requirement", "Peak memory of a single run of the tool in MB (0 = unknown).\nRuns are only started in parallel if they fit into the memory budget.",
+                                          tools.empty() ? 0 : (int)tools.first()->getMemoryRequirement(), 0, std::numeric_limits<int>::max(), 100, &ok);
+        if (ok)
+        {
+          foreach(TOPPASToolVertex* ttv, tools)
+          {
+            ttv->setMemoryRequirement(memory);
+          }
+          setChanged(true);
+        }
+        event->accept();
+        return;
+      }
+
       foreach(QGraphicsItem* gi, selectedItems())
       {
 
@@ -2019,7 +2084,13 @@ namespace OpenMS
 
   void TOPPASScene::enqueueProcess(const TOPPProcess& process)
   {
-    topp_processes_queue_ << process;
+    TOPPProcess p(process);
+    std::map<const TOPPASVertex*, int> cache;
+    p.priority = criticalPathLength_(p.tv, cache);
+    // keep the queue sorted by priority (critical path first), and by order of enqueueing among equals
+    QList<TOPPProcess>::iterator pos = std::upper_bound(topp_processes_queue_.begin(), topp_processes_queue_.end(), p,
+                                                        [](const TOPPProcess& a, const TOPPProcess& b) { return a.priority > b.priority; });
+    topp_processes_queue_.insert(pos, p);
   }
 
   void TOPPASScene::runNextProcess()
@@ -2030,20 +2101,48 @@ namespace OpenMS
 
     used = true;
 
-    while (!topp_processes_queue_.empty() && threads_active_ < allowed_threads_)
+    // start one process at a time and re-evaluate, since processes might finish (and enqueue others) synchronously (FakeProcess)
+    bool started = true;
+    while (started)
     {
-      ++threads_active_; // will be decreased, once the tool finishes
-      TOPPProcess tp = topp_processes_queue_.first();
-      topp_processes_queue_.pop_front();
-      FakeProcess* p = qobject_cast<FakeProcess*>(tp.proc);
-      if (p)
+      started = false;
+      // remaining budget (may become negative by reservations of processes which do not fit)
+      SignedSize free_threads = allowed_threads_ - threads_active_;
+      SignedSize free_memory = (allowed_memory_ == 0) ? std::numeric_limits<SignedSize>::max() : SignedSize(allowed_memory_) - SignedSize(memory_active_);
+      for (int i = 0; i < topp_processes_queue_.size() && free_threads > 0; ++i)
       {
-        p->start(tp.command, tp.args);
-      }
-      else
-      {
-        tp.tv->emitToolStarted();
-        tp.proc->start(tp.command, tp.args);
+        const TOPPProcess& next = topp_processes_queue_[i];
+        const int threads = std::min(std::max(next.threads, 1), allowed_threads_);
+        const UInt memory = (allowed_memory_ == 0) ? 0 : next.memory;
+        if ((threads > free_threads || SignedSize(memory) > free_memory) && !running_processes_.empty())
+        {
+          // reserve the resources of this process; it is run once enough processes have finished
+          free_threads -= threads;
+          free_memory -= memory;
+          continue;
+        }
+
+        TOPPProcess tp = topp_processes_queue_.takeAt(i);
+        // will be released, once the tool finishes
+        threads_active_ += threads;
+        memory_active_ += memory;
+        running_processes_[tp.proc] = std::make_pair(threads, memory);
+        if (tp.threads > 0)
+        {
+          tp.args << "-threads" << QString::number(threads);
+        }
+        FakeProcess* p = qobject_cast<FakeProcess*>(tp.proc);
+        if (p)
+        {
+          p->start(tp.command, tp.args);
+        }
+        else
+        {
+          tp.tv->emitToolStarted();
+          tp.proc->start(tp.command, tp.args);
+        }
+        started = true;
+        break;
       }
     }
     used = false;
@@ -2385,6 +2484,11 @@ namespace OpenMS
     allowed_threads_ = num_jobs;
   }
 
+  void TOPPASScene::setAllowedMemory(UInt memory_mb)
+  {
+    allowed_memory_ = memory_mb;
+  }
+
   bool TOPPASScene::isGUIMode() const
   {
     return gui_;
@@ -53,6 +53,7 @@
 #include <QtCore/QRegExp>
 
 #include <QSvgRenderer>
+#include <algorithm>
 #include <map>
 
 namespace OpenMS
@@ -98,7 +99,8 @@ namespace OpenMS
     param_(rhs.param_),
     status_(rhs.status_),
     tool_ready_(rhs.tool_ready_),
-    breakpoint_set_(false)
+    breakpoint_set_(false),
+    memory_requirement_(rhs.memory_requirement_)
   {
   }
 
@@ -112,6 +114,7 @@ namespace OpenMS
     finished_ = rhs.finished_;
     status_ = rhs.status_;
     breakpoint_set_ = false;
+    memory_requirement_ = rhs.memory_requirement_;
 
     return *this;
   }
@@ -682,7 +685,7 @@ namespace OpenMS
         }
       }
       toolScheduledSlot();
-      ts->enqueueProcess(TOPPASScene::TOPPProcess(p, File::findSiblingTOPPExecutable(name_).toQString(), args, this));
+      ts->enqueueProcess(TOPPASScene::TOPPProcess(p, File::findSiblingTOPPExecutable(name_).toQString(), args, this, getThreadRequirement(), memory_requirement_));
     }
 
     // run pending processes
@@ -704,13 +707,12 @@ namespace OpenMS
     QProcess* p = qobject_cast<QProcess*>(QObject::sender());
 
     RAIICleanup clean([&]() {
-      // clean up at end
+      // clean up at end (release the resources of the process before it is deleted)
+      ts->processFinished(p);
       if (p)
       {
         delete p;
       }
-
-      ts->processFinished();
     });
 
     //** ERROR handling
@@ -843,6 +845,25 @@ namespace OpenMS
     param_ = param;
   }
 
+  int TOPPASToolVertex::getThreadRequirement() const
+  {
+    if (!param_.exists("threads"))
+    {
+      return 0;
+    }
+    return std::max((int)param_.getValue("threads"), 1);
+  }
+
+  void TOPPASToolVertex::setMemoryRequirement(UInt memory_mb)
+  {
+    memory_requirement_ = memory_mb;
+  }
+
+  UInt TOPPASToolVertex::getMemoryRequirement() const
+  {
+    return memory_requirement_;
+  }
+
   TOPPASToolVertex::TOOLSTATUS TOPPASToolVertex::getStatus() const
   {
     return status_;
@@ -20,6 +20,7 @@ InputFile.cpp
 InputFile.ui
 InputFileList.cpp
 InputFileList.ui
+IntensityPyramid.cpp
 LayerListView.cpp
 LayerDataBase.cpp
 LayerDataChrom.cpp
@@ -136,6 +136,7 @@ set(system_executables_list
   PythonInfo_test
   StopWatch_test
   SysInfo_test
+  Tracer_test
 )
 
 set(kernel_executables_list
@@ -164,6 +165,8 @@ set(kernel_executables_list
   RichPeak2D_test
   StandardTypes_test
   SpectrumHelper_test
+  SpectrumColumns_test
+  ArenaMSExperiment_test
 )
 
 set(format_executables_list
@@ -172,10 +175,12 @@ set(format_executables_list
   MSNumpressCoder_test
   Bzip2Ifstream_test
   Bzip2InputStream_test
+  CheckpointCache_test
   ChromeleonFile_test
   CVMappingFile_test
   CompressedInputSource_test
   ConsensusXMLFile_test
+  ConsensusXMLWritingConsumer_test
   ControlledVocabulary_test
   CsvFile_test
   DTA2DFile_test
@@ -183,8 +188,10 @@ set(format_executables_list
   EDTAFile_test
   ExperimentalDesignFile_test
   FASTAFile_test
+  FASTAIndexFile_test
   FeatureFileOptions_test
   FeatureXMLFile_test
+  FeatureXMLWritingConsumer_test
   FileHandler_test
   FileTypes_test
   GzipIfstream_test
@@ -243,6 +250,8 @@ set(format_executables_list
   PepXMLFile_test
   PercolatorOutfile_test
   ProtXMLFile_test
+  ReadAheadIfstream_test
+  ReadAheadInputStream_test
   SVOutStream_test
   SemanticValidator_test
   SequestInfile_test
@@ -270,8 +279,10 @@ set(format_executables_list
   MSDataTransformingConsumer_test
   MSDataChainingConsumer_test
   MSDataStoringConsumer_test
+  MSDataArenaConsumer_test
   MSDataAggregatingConsumer_test
   SpectrumAccessQuadMZTransforming_test
+  SpectrumAccessNumpressCompressed_test
   SpectrumAccessSqMass_test
   SiriusFragmentAnnotation_test
 )
@@ -377,10 +388,12 @@ set(comparison_executables_list
   ClusterHierarchical_test
   CompleteLinkage_test
   EuclideanSimilarity_test
+  PairwiseSpectralSimilarity_test
   PeakAlignment_test
   PeakSpectrumCompareFunctor_test
   SingleLinkage_test
   SpectraSTSimilarityScore_test
+  SpectralLibraryIndex_test
   SpectrumAlignmentScore_test
   SpectrumAlignment_test
   SpectrumCheapDPCorr_test
@@ -410,6 +423,7 @@ set(chemistry_executables_list
   IntegerMassDecomposer_test
   IsoSpec_test
   IsotopeDistribution_test
+  IsotopePatternCache_test
   MassDecomposer_test
   ModificationDefinition_test
   ModificationDefinitionsSet_test
@@ -551,6 +565,7 @@ set(analysis_executables_list
   PrecursorPurity_test
   ProtonDistributionModel_test
   ProteinResolver_test
+  ProteinSuffixArray_test
   PSLPFormulation_test
   PSProteinInference_test
   QTClusterFinder_test
@@ -0,0 +1,316 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/KERNEL/ArenaMSExperiment.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(ArenaMSExperiment, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// shared meta data for all test spectra
+DataProcessingPtr dp(new DataProcessing);
+dp->getProcessingActions().insert(DataProcessing::PEAK_PICKING);
+
+auto makeSpectrum = [&dp](double rt, UInt ms_level, Size n_peaks)
+{
+  MSSpectrum s;
+  s.setRT(rt);
+  s.setMSLevel(ms_level);
+  s.setNativeID("scan=" + String(rt));
+  s.setComment("shared comment");
+  s.getInstrumentSettings().setPolarity(IonSource::Polarity::POSITIVE);
+  s.getDataProcessing().push_back(dp);
+  s.setMetaValue("filter string", "FTMS + p ESI Full ms" + String(ms_level));
+  if (ms_level > 1)
+  {
+    Precursor p;
+    p.setMZ(400.0 + rt);
+    s.getPrecursors().push_back(p);
+  }
+  for (Size i = 0; i < n_peaks; ++i)
+  {
+    s.push_back(Peak1D(100.0 + i, float(rt + i)));
+  }
+  return s;
+};
+
+ArenaMSExperiment* ptr = nullptr;
+ArenaMSExperiment* null_ptr = nullptr;
+START_SECTION(explicit ArenaMSExperiment(Size block_size = DEFAULT_BLOCK_SIZE))
+{
+  ptr = new ArenaMSExperiment();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_EQUAL(ptr->getNrBlocks(), 0)
+}
+END_SECTION
+
+START_SECTION(~ArenaMSExperiment())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(void addSpectrum(const MSSpectrum& spectrum))
+{
+  ArenaMSExperiment arena(10); // small blocks
+  arena.addSpectrum(makeSpectrum(1.0, 1, 6));
+  arena.addSpectrum(makeSpectrum(2.0, 2, 3));
+  TEST_EQUAL(arena.getNrBlocks(), 1) // 6 + 3 peaks fit into one block
+  arena.addSpectrum(makeSpectrum(3.0, 2, 3)); // does not fit anymore
+  TEST_EQUAL(arena.getNrBlocks(), 2)
+  arena.addSpectrum(makeSpectrum(4.0, 1, 25)); // larger than a block
+  TEST_EQUAL(arena.getNrBlocks(), 3)
+  arena.addSpectrum(makeSpectrum(5.0, 1, 0));
+  TEST_EQUAL(arena.size(), 5)
+  TEST_EQUAL(arena.getNrPeaks(), 37)
+  // all spectra share the same comment, instrument settings and data processing
+  TEST_EQUAL(arena.getNrSharedSettings(), 1)
+
+  MSSpectrum other = makeSpectrum(6.0, 1, 1);
+  other.setComment("different");
+  arena.addSpectrum(other);
+  TEST_EQUAL(arena.getNrSharedSettings(), 2)
+}
+END_SECTION
+
+START_SECTION(void addSpectrum(MSSpectrum&& spectrum))
+{
+  ArenaMSExperiment arena(10);
+  MSSpectrum s = makeSpectrum(2.0, 2, 3);
+  s.getFloatDataArrays().resize(1);
+  s.getFloatDataArrays()[0].assign({1.0f, 2.0f, 3.0f});
+  s.setMetaValue("moved", 1);
+  const MSSpectrum expected = s;
+  arena.addSpectrum(std::move(s));
+  TEST_EQUAL(arena.size(), 1)
+  TEST_EQUAL(arena.getNrPeaks(), 3)
+  TEST_EQUAL(arena.getSpectrum(0) == expected, true)
+  // the moved-from spectrum is left empty
+  TEST_EQUAL(s.empty(), true)
+  TEST_EQUAL(s.getFloatDataArrays().empty(), true)
+  TEST_EQUAL(s.getPrecursors().empty(), true)
+  // interned with the copied spectrum
+  arena.addSpectrum(expected);
+  TEST_EQUAL(arena.getNrSharedSettings(), 1)
+}
+END_SECTION
+
+START_SECTION(PeakRange getPeaks(Size index) const)
+{
+  ArenaMSExperiment arena(10);
+  arena.addSpectrum(makeSpectrum(1.0, 1, 6));
+  arena.addSpectrum(makeSpectrum(2.0, 2, 3));
+  arena.addSpectrum(makeSpectrum(3.0, 2, 0));
+  ArenaMSExperiment::PeakRange peaks = arena.getPeaks(1);
+  TEST_EQUAL(peaks.size(), 3)
+  TEST_REAL_SIMILAR(peaks[2].getMZ(), 102.0)
+  TEST_REAL_SIMILAR(peaks.begin()->getIntensity(), 2.0)
+  TEST_EQUAL(arena.getPeaks(2).empty(), true)
+  TEST_EXCEPTION(Exception::IndexOverflow, arena.getPeaks(3))
+}
+END_SECTION
+
+START_SECTION(double getRT(Size index) const)
+{
+  ArenaMSExperiment arena;
+  arena.addSpectrum(makeSpectrum(12.5, 2, 1));
+  TEST_REAL_SIMILAR(arena.getRT(0), 12.5)
+  TEST_EQUAL(arena.getMSLevel(0), 2)
+  TEST_EQUAL(arena.getNativeID(0), "scan=12.5")
+  TEST_EQUAL(arena.getPrecursors(0).size(), 1)
+  TEST_EXCEPTION(Exception::IndexOverflow, arena.getRT(1))
+}
+END_SECTION
+
+START_SECTION(UInt getMSLevel(Size index) const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(const String& getNativeID(Size index) const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(const std::vector<Precursor>& getPrecursors(Size index) const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(void getSpectrum(Size index, MSSpectrum& spectrum) const)
+{
+  ArenaMSExperiment arena(10);
+  vector<MSSpectrum> input = {makeSpectrum(1.0, 1, 6), makeSpectrum(2.0, 2, 3), makeSpectrum(3.0, 2, 12)};
+  input[1].setDriftTime(3.5);
+  input[1].getFloatDataArrays().resize(1);
+  input[1].getFloatDataArrays()[0].setName("ion mobility");
+  input[1].getFloatDataArrays()[0].assign({1.0f, 2.0f, 3.0f});
+  for (const MSSpectrum& s : input)
+  {
+    arena.addSpectrum(s);
+  }
+  MSSpectrum out;
+  out.setName("previous content");
+  out.setMetaValue("previous", 1);
+  for (Size i = 0; i < input.size(); ++i)
+  {
+    arena.getSpectrum(i, out);
+    TEST_EQUAL(out == input[i], true)
+    TEST_EQUAL(out.getName(), "")
+    TEST_EQUAL(out.metaValueExists("previous"), false)
+  }
+  // DataProcessing objects are shared, not copied
+  TEST_EQUAL(out.getDataProcessing()[0].get() == dp.get(), true)
+}
+END_SECTION
+
+START_SECTION(MSSpectrum getSpectrum(Size index) const)
+{
+  ArenaMSExperiment arena;
+  MSSpectrum s = makeSpectrum(2.0, 2, 3);
+  arena.addSpectrum(s);
+  TEST_EQUAL(arena.getSpectrum(0) == s, true)
+  TEST_EXCEPTION(Exception::IndexOverflow, arena.getSpectrum(1))
+}
+END_SECTION
+
+START_SECTION(void addChromatogram(const MSChromatogram& chromatogram))
+{
+  ArenaMSExperiment arena;
+  MSChromatogram c;
+  c.setNativeID("TIC");
+  arena.addChromatogram(c);
+  TEST_EQUAL(arena.getChromatograms().size(), 1)
+  TEST_EQUAL(arena.getChromatograms()[0].getNativeID(), "TIC")
+}
+END_SECTION
+
+START_SECTION(const std::vector<MSChromatogram>& getChromatograms() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(void clear())
+{
+  ArenaMSExperiment arena;
+  arena.setComment("settings are kept");
+  arena.addSpectrum(makeSpectrum(1.0, 1, 6));
+  arena.addChromatogram(MSChromatogram());
+  arena.clear();
+  TEST_EQUAL(arena.size(), 0)
+  TEST_EQUAL(arena.getNrPeaks(), 0)
+  TEST_EQUAL(arena.getNrBlocks(), 0)
+  TEST_EQUAL(arena.getNrSharedSettings(), 0)
+  TEST_EQUAL(arena.getChromatograms().size(), 0)
+  TEST_EQUAL(arena.getComment(), "settings are kept")
+}
+END_SECTION
+
+START_SECTION(ArenaMSExperiment& operator=(const ExperimentalSettings& source))
+{
+  ArenaMSExperiment arena;
+  arena.addSpectrum(makeSpectrum(1.0, 1, 6));
+  ExperimentalSettings es;
+  es.setComment("new settings");
+  arena = es;
+  TEST_EQUAL(arena.getComment(), "new settings")
+  TEST_EQUAL(arena.size(), 1)
+}
+END_SECTION
+
+START_SECTION(ArenaMSExperiment(const ArenaMSExperiment&))
+{
+  ArenaMSExperiment arena(10);
+  arena.addSpectrum(makeSpectrum(1.0, 1, 6));
+  ArenaMSExperiment copy(arena);
+  copy.addSpectrum(makeSpectrum(2.0, 1, 2)); // the copied block has no spare capacity: a new block is started
+  TEST_EQUAL(copy.getNrBlocks(), 2)
+  TEST_REAL_SIMILAR(copy.getPeaks(0)[5].getMZ(), 105.0)
+  TEST_EQUAL(arena.size(), 1)
+}
+END_SECTION
+
+START_SECTION(void exportTo(MSExperiment& exp) const)
+{
+  MzMLFile f;
+  PeakMap exp;
+  f.load(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML"), exp);
+
+  ArenaMSExperiment arena;
+  arena = static_cast<const ExperimentalSettings&>(exp);
+  for (const MSSpectrum& s : exp)
+  {
+    arena.addSpectrum(s);
+  }
+  for (const MSChromatogram& c : exp.getChromatograms())
+  {
+    arena.addChromatogram(c);
+  }
+  TEST_EQUAL(arena.size(), exp.size())
+
+  PeakMap exported;
+  arena.exportTo(exported);
+  TEST_EQUAL(exported.size(), exp.size())
+  ABORT_IF(exported.size() != exp.size())
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    TEST_EQUAL(exported[i] == exp[i], true)
+  }
+  TEST_EQUAL(exported.getChromatograms().size(), exp.getChromatograms().size())
+  TEST_EQUAL(static_cast<const ExperimentalSettings&>(exported) == static_cast<const ExperimentalSettings&>(exp), true)
+}
+END_SECTION
+
+START_SECTION(void reserveSpaceSpectra(Size n))
+  NOT_TESTABLE
+END_SECTION
+
+START_SECTION(void reserveSpaceChromatograms(Size n))
+  NOT_TESTABLE
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,206 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/CheckpointCache.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/FeatureXMLFile.h>
+#include <OpenMS/FORMAT/FileHandler.h>
+#include <OpenMS/KERNEL/FeatureMap.h>
+#include <OpenMS/SYSTEM/File.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(CheckpointCache, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+CheckpointCache* ptr = nullptr;
+CheckpointCache* null_ptr = nullptr;
+START_SECTION(CheckpointCache())
+{
+  ptr = new CheckpointCache();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->isEnabled(), false)
+  TEST_EQUAL(ptr->isResuming(), false)
+}
+END_SECTION
+
+START_SECTION(~CheckpointCache())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(Key::getHash() const)
+{
+  Param p;
+  p.setValue("a", 1.0);
+  p.setValue("b", "test");
+
+  CheckpointCache::Key k1("stage");
+  k1.add("in", "abc").add("param", p);
+  CheckpointCache::Key k2("stage");
+  k2.add("in", "abc").add("param", p);
+  TEST_EQUAL(k1.getStage(), "stage")
+  TEST_EQUAL(k1.getHash().size(), 40)
+  TEST_EQUAL(k1.getHash(), k2.getHash())
+
+  // any difference in stage, values or parameters leads to a different key
+  CheckpointCache::Key k3("other_stage");
+  k3.add("in", "abc").add("param", p);
+  TEST_NOT_EQUAL(k1.getHash(), k3.getHash())
+  CheckpointCache::Key k4("stage");
+  k4.add("in", "abd").add("param", p);
+  TEST_NOT_EQUAL(k1.getHash(), k4.getHash())
+  p.setValue("a", 1.5);
+  CheckpointCache::Key k5("stage");
+  k5.add("in", "abc").add("param", p);
+  TEST_NOT_EQUAL(k1.getHash(), k5.getHash())
+
+  // keys of upstream checkpoints
+  CheckpointCache::Key k6("downstream");
+  k6.add(k1);
+  CheckpointCache::Key k7("downstream");
+  k7.add(k5);
+  TEST_NOT_EQUAL(k6.getHash(), k7.getHash())
+}
+END_SECTION
+
+String tmp_dir;
+NEW_TMP_FILE(tmp_dir);
+tmp_dir += "_checkpoints";
+
+START_SECTION((CheckpointCache(const String& directory, bool resume)))
+{
+  CheckpointCache cache(tmp_dir, false);
+  TEST_EQUAL(cache.isEnabled(), true)
+  TEST_EQUAL(cache.isResuming(), false)
+  TEST_EQUAL(File::exists(tmp_dir), true)
+
+  CheckpointCache resuming(tmp_dir, true);
+  TEST_EQUAL(resuming.isResuming(), true)
+}
+END_SECTION
+
+START_SECTION((String hashFile(const String& filename)))
+{
+  const String filename = OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML");
+  CheckpointCache cache(tmp_dir, false);
+  TEST_EQUAL(cache.hashFile(filename), FileHandler::computeFileHash(filename))
+  // remembered in the cache directory
+  TEST_EQUAL(File::exists(tmp_dir + "/file_hashes.tsv"), true)
+  CheckpointCache cache2(tmp_dir, true);
+  TEST_EQUAL(cache2.hashFile(filename), FileHandler::computeFileHash(filename))
+
+  // also works without cache directory
+  CheckpointCache disabled;
+  TEST_EQUAL(disabled.hashFile(filename), FileHandler::computeFileHash(filename))
+
+  TEST_EXCEPTION(Exception::FileNotFound, cache.hashFile("this_file_does_not_exist.featureXML"))
+}
+END_SECTION
+
+START_SECTION((String getPath(const Key& key, const String& extension) const))
+{
+  CheckpointCache cache(tmp_dir, false);
+  CheckpointCache::Key key("features");
+  String path = cache.getPath(key, "featureXML");
+  TEST_EQUAL(path.hasPrefix(File::absolutePath(tmp_dir) + "/features_"), true)
+  TEST_EQUAL(path.hasSuffix(key.getHash() + ".featureXML"), true)
+}
+END_SECTION
+
+START_SECTION((template <typename FileType, typename... Data> void store(const Key& key, const String& extension, const Data&... data) const))
+{
+  FeatureMap features;
+  FeatureXMLFile().load(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"), features);
+
+  CheckpointCache::Key key("features");
+  key.add("in", "FeatureXMLFile_1");
+
+  // nothing is written without cache directory
+  CheckpointCache disabled;
+  disabled.store<FeatureXMLFile>(key, "featureXML", features);
+
+  CheckpointCache cache(tmp_dir, false);
+  TEST_EQUAL(cache.contains(key, "featureXML"), false)
+  cache.store<FeatureXMLFile>(key, "featureXML", features);
+  TEST_EQUAL(File::exists(cache.getPath(key, "featureXML")), true)
+  // only reused when resuming
+  TEST_EQUAL(cache.contains(key, "featureXML"), false)
+}
+END_SECTION
+
+START_SECTION((template <typename FileType, typename... Data> bool load(const Key& key, const String& extension, Data&... data) const))
+{
+  FeatureMap features;
+  FeatureXMLFile().load(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"), features);
+
+  CheckpointCache::Key key("features");
+  key.add("in", "FeatureXMLFile_1");
+
+  CheckpointCache cache(tmp_dir, false);
+  FeatureMap loaded;
+  TEST_EQUAL(cache.load<FeatureXMLFile>(key, "featureXML", loaded), false)
+  TEST_EQUAL(loaded.size(), 0)
+
+  CheckpointCache resuming(tmp_dir, true);
+  TEST_EQUAL(resuming.contains(key, "featureXML"), true)
+  TEST_EQUAL(resuming.load<FeatureXMLFile>(key, "featureXML", loaded), true)
+  TEST_EQUAL(loaded.size(), features.size())
+  ABORT_IF(loaded.size() != features.size())
+  for (Size i = 0; i < loaded.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(loaded[i].getRT(), features[i].getRT())
+    TEST_REAL_SIMILAR(loaded[i].getMZ(), features[i].getMZ())
+  }
+
+  // a different key misses the checkpoint
+  CheckpointCache::Key other("features");
+  other.add("in", "FeatureXMLFile_2");
+  TEST_EQUAL(resuming.load<FeatureXMLFile>(other, "featureXML", loaded), false)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -208,6 +208,55 @@ TEST_REAL_SIMILAR(map[0].getIntensity(), 23000.238)
 
 END_SECTION
 
+START_SECTION((void transform(const String& filename, ConsensusMap& meta_map, const std::function<void (ConsensusFeature&)>& consumer, bool load_peptide_ids = true)))
+  ConsensusXMLFile f;
+  ConsensusMap loaded;
+  f.load(OPENMS_GET_TEST_DATA_PATH("ConsensusXMLFile_1.consensusXML"), loaded);
+
+  ConsensusMap meta;
+  std::vector<ConsensusFeature> streamed;
+  Size headers_at_first_feature = 0;
+  f.transform(OPENMS_GET_TEST_DATA_PATH("ConsensusXMLFile_1.consensusXML"), meta, [&](ConsensusFeature& feature)
+  {
+    if (streamed.empty()) headers_at_first_feature = meta.getColumnHeaders().size();
+    streamed.push_back(feature);
+  });
+
+  TEST_EQUAL(meta.size(), 0)
+  TEST_EQUAL(streamed.size(), loaded.size())
+  ABORT_IF(streamed.size() != loaded.size())
+  for (Size i = 0; i < streamed.size(); ++i)
+  {
+    TEST_EQUAL(streamed[i].getUniqueId(), loaded[i].getUniqueId())
+    TEST_REAL_SIMILAR(streamed[i].getRT(), loaded[i].getRT())
+    TEST_REAL_SIMILAR(streamed[i].getMZ(), loaded[i].getMZ())
+    TEST_EQUAL(streamed[i].size(), loaded[i].size())
+    TEST_EQUAL(streamed[i].getPeptideIdentifications().size(), loaded[i].getPeptideIdentifications().size())
+  }
+  TEST_EQUAL(headers_at_first_feature, loaded.getColumnHeaders().size())
+  TEST_EQUAL(meta.getProteinIdentifications().size(), loaded.getProteinIdentifications().size())
+  TEST_EQUAL(meta.getUnassignedPeptideIdentifications().size(), loaded.getUnassignedPeptideIdentifications().size())
+
+  // without peptide identifications
+  Size with_ids = 0;
+  Size count = 0;
+  f.transform(OPENMS_GET_TEST_DATA_PATH("ConsensusXMLFile_1.consensusXML"), meta, [&](ConsensusFeature& feature)
+  {
+    if (!feature.getPeptideIdentifications().empty()) ++with_ids;
+    ++count;
+  }, false);
+  TEST_EQUAL(count, loaded.size())
+  TEST_EQUAL(with_ids, 0)
+  TEST_EQUAL(meta.getUnassignedPeptideIdentifications().size(), 0)
+  TEST_EQUAL(meta.getProteinIdentifications().size(), loaded.getProteinIdentifications().size())
+
+  // range restrictions apply
+  f.getOptions().setRTRange(makeRange(815, 818));
+  count = 0;
+  f.transform(OPENMS_GET_TEST_DATA_PATH("ConsensusXMLFile_2_options.consensusXML"), meta, [&count](ConsensusFeature&) { ++count; });
+  TEST_EQUAL(count, 1)
+END_SECTION
+
 START_SECTION((void store(const String &filename, const ConsensusMap &consensus_map)))
   std::string tmp_filename;
   NEW_TMP_FILE(tmp_filename);
@@ -220,6 +220,84 @@ START_SECTION(size_t size() const)
 
 END_SECTION
 
+START_SECTION([EXTRA] compressed FASTA file)
+  // compressed input cannot be repositioned, entries are kept in memory instead
+  vector<FASTAFile::FASTAEntry> data;
+  FASTAFile().load(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"), data);
+  FCFile f(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta.gz"));
+  TEST_EQUAL(f.cacheChunk(2), true)
+  TEST_EQUAL(f.activateCache(), true)
+  TEST_EQUAL(f.cacheChunk(10), true)
+  TEST_EQUAL(f.activateCache(), true)
+  TEST_EQUAL(f.size(), data.size())
+  FASTAFile::FASTAEntry pe;
+  for (Size i = 0; i < data.size(); ++i)
+  {
+    TEST_EQUAL(f.readAt(pe, i), true)
+    TEST_EQUAL(pe == data[i], true)
+  }
+  f.reset();
+  TEST_EQUAL(f.size(), 0)
+  TEST_EQUAL(f.cacheChunk(1), true)
+  TEST_EQUAL(f.activateCache(), true)
+  TEST_EQUAL(f.readAt(pe, 0), true)
+  TEST_EQUAL(pe == data[0], true)
+END_SECTION
+
+START_SECTION([EXTRA] FASTAContainer<TFI_MMap>)
+{
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  FASTAIndexFile::compile(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"), tmp_filename);
+  std::vector<FASTAFile::FASTAEntry> data;
+  FASTAFile().load(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"), data);
+
+  FASTAContainer<TFI_MMap> f(tmp_filename);
+  TEST_EQUAL(f.empty(), false)
+  TEST_EQUAL(f.size(), 5) // known upfront
+  TEST_EQUAL(f.cacheChunk(2), true)
+  TEST_EQUAL(f.chunkSize(), 0)
+  TEST_EQUAL(f.activateCache(), true)
+  TEST_EQUAL(f.chunkSize(), 2)
+  TEST_EQUAL(f.getChunkOffset(), 0)
+  TEST_EQUAL(f.chunkAt(1) == data[1], true)
+  // random access beyond the active chunk
+  FASTAFile::FASTAEntry pe;
+  TEST_EQUAL(f.readAt(pe, 4), true)
+  TEST_EQUAL(pe == data[4], true)
+
+  TEST_EQUAL(f.cacheChunk(2), true)
+  TEST_EQUAL(f.activateCache(), true)
+  TEST_EQUAL(f.getChunkOffset(), 2)
+  TEST_EQUAL(f.chunkAt(0) == data[2], true)
+  TEST_EQUAL(f.cacheChunk(3), true) // only 1 left
+  TEST_EQUAL(f.activateCache(), true)
+  TEST_EQUAL(f.chunkSize(), 1)
+  TEST_EQUAL(f.chunkAt(0) == data[4], true)
+  TEST_EQUAL(f.cacheChunk(3), false)
+  TEST_EQUAL(f.activateCache(), false)
+  TEST_EQUAL(f.readAt(pe, 0), true)
+  TEST_EQUAL(pe == data[0], true)
+  TEST_EXCEPTION(Exception::IndexOverflow, f.readAt(pe, 5))
+
+  f.reset();
+  TEST_EQUAL(f.cacheChunk(10), true)
+  TEST_EQUAL(f.activateCache(), true)
+  TEST_EQUAL(f.chunkSize(), 5)
+  TEST_EQUAL(f.chunkAt(3) == data[3], true)
+
+  // same decoy detection as for the file-based container
+  FASTAContainer<TFI_File> ff(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"));
+  TEST_EQUAL(DecoyHelper::countDecoys(f) == DecoyHelper::countDecoys(ff), true)
+
+  NEW_TMP_FILE(tmp_filename);
+  FASTAIndexFile::store(tmp_filename, {});
+  FASTAContainer<TFI_MMap> f2(tmp_filename);
+  TEST_EQUAL(f2.empty(), true)
+  TEST_EQUAL(f2.cacheChunk(10), false)
+}
+END_SECTION
+
 START_SECTION(Result findDecoyString(FASTAContainer<T>& proteins))
 // test without decoys in input
   FASTAContainer<TFI_File> f1{OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta")};
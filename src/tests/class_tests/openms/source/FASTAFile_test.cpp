@@ -296,6 +296,39 @@ START_SECTION([EXTRA] test_position)
 END_SECTION
 
 
+START_SECTION([EXTRA] compressed input)
+  vector<FASTAFile::FASTAEntry> data, data_gz, data_bz2;
+  FASTAFile file;
+  file.load(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"), data);
+  file.load(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta.gz"), data_gz);
+  file.load(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta.bz2"), data_bz2);
+  TEST_EQUAL(data_gz.size(), data.size())
+  TEST_EQUAL(data_bz2.size(), data.size())
+  TEST_EQUAL(data_gz == data, true)
+  TEST_EQUAL(data_bz2 == data, true)
+
+  // streamed reading works, seeking does not
+  FASTAFile::FASTAEntry entry;
+  file.readStart(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta.gz"));
+  TEST_EQUAL(file.readNext(entry), true)
+  TEST_EQUAL(entry == data[0], true)
+  TEST_EQUAL(file.isSeekable(), false)
+  TEST_EXCEPTION(Exception::NotImplemented, file.setPosition(0))
+  TEST_EXCEPTION(Exception::NotImplemented, file.position())
+  Size count = 1;
+  while (file.readNext(entry)) ++count;
+  TEST_EQUAL(count, data.size())
+  TEST_EQUAL(file.atEnd(), true)
+
+  // switching back to an uncompressed file
+  file.readStart(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"));
+  TEST_EQUAL(file.readNext(entry), true)
+  TEST_EQUAL(entry == data[0], true)
+  TEST_EQUAL(file.isSeekable(), true)
+  TEST_EQUAL(file.setPosition(0), true)
+END_SECTION
+
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -0,0 +1,237 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/FASTAIndexFile.h>
+///////////////////////////
+
+#include <fstream>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(FASTAIndexFile, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+FASTAIndexFile* ptr = nullptr;
+FASTAIndexFile* nullPointer = nullptr;
+START_SECTION(FASTAIndexFile())
+{
+  ptr = new FASTAIndexFile();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->isOpen(), false)
+  TEST_EQUAL(ptr->size(), 0)
+}
+END_SECTION
+
+START_SECTION(~FASTAIndexFile())
+{
+  delete ptr;
+}
+END_SECTION
+
+std::vector<FASTAFile::FASTAEntry> fev = { {"id0", "desc0", "AAAA"}, {"id1", "", "BBBBBB"}, {"", "desc2", ""}, {"id3", "desc3 with spaces", "DDDD*"} };
+
+START_SECTION(static void store(const String& filename, const std::vector<FASTAFile::FASTAEntry>& data))
+{
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  FASTAIndexFile::store(tmp_filename, fev);
+  FASTAIndexFile f(tmp_filename);
+  TEST_EQUAL(f.size(), fev.size())
+  FASTAFile::FASTAEntry pe;
+  for (Size i = 0; i < fev.size(); ++i)
+  {
+    f.getEntry(i, pe);
+    TEST_EQUAL(pe == fev[i], true)
+  }
+
+  // empty database
+  NEW_TMP_FILE(tmp_filename);
+  FASTAIndexFile::store(tmp_filename, {});
+  FASTAIndexFile f2(tmp_filename);
+  TEST_EQUAL(f2.isOpen(), true)
+  TEST_EQUAL(f2.size(), 0)
+
+  TEST_EXCEPTION(Exception::UnableToCreateFile, FASTAIndexFile::store("/does/not/exist/db.bin", fev))
+}
+END_SECTION
+
+START_SECTION(static Size compile(const String& fasta_file, const String& filename))
+{
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  TEST_EQUAL(FASTAIndexFile::compile(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"), tmp_filename), 5)
+
+  std::vector<FASTAFile::FASTAEntry> data;
+  FASTAFile().load(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"), data);
+  FASTAIndexFile f(tmp_filename);
+  TEST_EQUAL(f.size(), data.size())
+  FASTAFile::FASTAEntry pe;
+  for (Size i = 0; i < data.size(); ++i)
+  {
+    f.getEntry(i, pe);
+    TEST_EQUAL(pe == data[i], true)
+  }
+
+  TEST_EXCEPTION(Exception::FileNotFound, FASTAIndexFile::compile("doesnotexist.fasta", tmp_filename))
+}
+END_SECTION
+
+START_SECTION(void open(const String& filename))
+{
+  FASTAIndexFile f;
+  TEST_EXCEPTION(Exception::FileNotFound, f.open("doesnotexist.bin"))
+  TEST_EQUAL(f.isOpen(), false)
+  // plain FASTA is rejected
+  TEST_EXCEPTION(Exception::ParseError, f.open(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta")))
+  TEST_EQUAL(f.isOpen(), false)
+
+  // truncated file
+  String tmp_filename, tmp_truncated;
+  NEW_TMP_FILE(tmp_filename);
+  NEW_TMP_FILE(tmp_truncated);
+  FASTAIndexFile::store(tmp_filename, fev);
+  {
+    std::ifstream ifs(tmp_filename.c_str(), std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    std::ofstream ofs(tmp_truncated.c_str(), std::ios::binary);
+    ofs.write(content.data(), content.size() - 8);
+  }
+  TEST_EXCEPTION(Exception::ParseError, f.open(tmp_truncated))
+  TEST_EQUAL(f.isOpen(), false)
+
+  f.open(tmp_filename);
+  TEST_EQUAL(f.isOpen(), true)
+  TEST_EQUAL(f.size(), 4)
+}
+END_SECTION
+
+START_SECTION(void close())
+{
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  FASTAIndexFile::store(tmp_filename, fev);
+  FASTAIndexFile f(tmp_filename);
+  TEST_EQUAL(f.isOpen(), true)
+  f.close();
+  TEST_EQUAL(f.isOpen(), false)
+  TEST_EQUAL(f.size(), 0)
+}
+END_SECTION
+
+START_SECTION(bool isOpen() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(Size size() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(void getEntry(Size index, FASTAFile::FASTAEntry& entry) const)
+{
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  FASTAIndexFile::store(tmp_filename, fev);
+  FASTAIndexFile f(tmp_filename);
+  FASTAFile::FASTAEntry pe;
+  // random access, in any order
+  f.getEntry(3, pe);
+  TEST_EQUAL(pe.identifier, "id3")
+  TEST_EQUAL(pe.description, "desc3 with spaces")
+  TEST_EQUAL(pe.sequence, "DDDD*")
+  f.getEntry(0, pe);
+  TEST_EQUAL(pe.sequence, "AAAA")
+  f.getEntry(2, pe);
+  TEST_EQUAL(pe.identifier, "")
+  TEST_EQUAL(pe.sequence, "")
+  TEST_EXCEPTION(Exception::IndexOverflow, f.getEntry(4, pe))
+}
+END_SECTION
+
+START_SECTION(Size getSequenceLength(Size index) const)
+{
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  FASTAIndexFile::store(tmp_filename, fev);
+  FASTAIndexFile f(tmp_filename);
+  TEST_EQUAL(f.getSequenceLength(0), 4)
+  TEST_EQUAL(f.getSequenceLength(1), 6)
+  TEST_EQUAL(f.getSequenceLength(2), 0)
+  TEST_EQUAL(f.getSequenceLength(3), 5)
+  TEST_EXCEPTION(Exception::IndexOverflow, f.getSequenceLength(4))
+}
+END_SECTION
+
+START_SECTION(static bool isCompiledFASTA(const String& filename))
+{
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  FASTAIndexFile::store(tmp_filename, fev);
+  TEST_EQUAL(FASTAIndexFile::isCompiledFASTA(tmp_filename), true)
+  TEST_EQUAL(FASTAIndexFile::isCompiledFASTA(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta")), false)
+  TEST_EQUAL(FASTAIndexFile::isCompiledFASTA("doesnotexist.bin"), false)
+}
+END_SECTION
+
+START_SECTION(static void load(const String& filename, std::vector<FASTAFile::FASTAEntry>& data))
+{
+  std::vector<FASTAFile::FASTAEntry> parsed;
+  FASTAFile().load(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"), parsed);
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  FASTAIndexFile::compile(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"), tmp_filename);
+
+  std::vector<FASTAFile::FASTAEntry> data(1); // previous content is removed
+  FASTAIndexFile::load(tmp_filename, data);
+  TEST_EQUAL(data == parsed, true)
+  data.resize(1);
+  FASTAIndexFile::load(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"), data);
+  TEST_EQUAL(data == parsed, true)
+  TEST_EXCEPTION(Exception::FileNotFound, FASTAIndexFile::load("doesnotexist.fasta", data))
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -177,6 +177,59 @@ START_SECTION((void apply(std::vector<PeptideIdentification> &id)))
 }
 END_SECTION
 
+START_SECTION([EXTRA] apply(std::vector<PeptideIdentification> &id) gives the same values as separate target/decoy lists)
+{
+  vector<ProteinIdentification> prot_ids;
+  vector<PeptideIdentification> pep_ids;
+  IdXMLFile().load(OPENMS_GET_TEST_DATA_PATH("FalseDiscoveryRate_OMSSA.idXML"), prot_ids, pep_ids);
+  // only top hits are used by apply(ids)
+  for (PeptideIdentification& pep_id : pep_ids)
+  {
+    pep_id.sort();
+    if (pep_id.getHits().size() > 1) pep_id.getHits().resize(1);
+  }
+
+  for (const char* no_qvalues : {"false", "true"})
+  {
+    // reference: targets and decoys in separate lists
+    vector<PeptideIdentification> fwd_ids, rev_ids;
+    for (const PeptideIdentification& pep_id : pep_ids)
+    {
+      if (pep_id.getHits().empty()) continue;
+      if (String(pep_id.getHits()[0].getMetaValue("target_decoy")) == "decoy")
+      {
+        rev_ids.push_back(pep_id);
+      }
+      else
+      {
+        fwd_ids.push_back(pep_id);
+      }
+    }
+    FalseDiscoveryRate fdr;
+    Param p = fdr.getParameters();
+    p.setValue("no_qvalues", no_qvalues);
+    p.setValue("add_decoy_peptides", "true");
+    fdr.setParameters(p);
+    fdr.apply(fwd_ids, rev_ids);
+
+    vector<PeptideIdentification> all_ids = pep_ids;
+    fdr.apply(all_ids);
+
+    Size fwd_index(0), rev_index(0);
+    for (const PeptideIdentification& pep_id : all_ids)
+    {
+      if (pep_id.getHits().empty()) continue;
+      double expected = (String(pep_id.getHits()[0].getMetaValue("target_decoy")) == "decoy") ?
+        rev_ids[rev_index++].getHits()[0].getScore() : fwd_ids[fwd_index++].getHits()[0].getScore();
+      // bit-identical
+      TEST_EQUAL(pep_id.getHits()[0].getScore() == expected, true)
+    }
+    TEST_EQUAL(fwd_index, fwd_ids.size())
+    TEST_EQUAL(rev_index, rev_ids.size())
+  }
+}
+END_SECTION
+
 START_SECTION((void apply(std::vector<ProteinIdentification>& ids)))
 {
   vector<ProteinIdentification> fwd_prot_ids, rev_prot_ids, prot_ids;
@@ -103,6 +103,21 @@ START_SECTION((bool getLoadSubordinates() const ))
 }
 END_SECTION
 
+START_SECTION((void setLoadPeptideIdentifications(bool load)))
+{
+  FeatureFileOptions tmp;
+  tmp.setLoadPeptideIdentifications(false);
+  TEST_EQUAL(tmp.getLoadPeptideIdentifications(), false)
+}
+END_SECTION
+
+START_SECTION((bool getLoadPeptideIdentifications() const))
+{
+  FeatureFileOptions tmp;
+  TEST_EQUAL(tmp.getLoadPeptideIdentifications(), true)
+}
+END_SECTION
+
 START_SECTION((void setMetadataOnly(bool only)))
 {
   // TODO
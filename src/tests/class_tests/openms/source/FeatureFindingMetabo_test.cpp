@@ -126,6 +126,25 @@ START_SECTION((void run(std::vector< MassTrace > &, FeatureMap &, chromatograms
   test_ffm.run(splitted_mt, test_fm, chromatograms);
   TEST_EQUAL(test_fm.size(), 80);
   // --> this gives less features, i.e. more isotope clusters (but the input data is simulated and highly weird -- should be replaced at some point)
+
+  // averagine scoring with memoized isotope patterns gives identical results
+  p = FeatureFindingMetabo().getParameters();
+  p.setValue("isotope_filtering_model", "peptides");
+  test_ffm.setParameters(p);
+  FeatureMap fm_direct, fm_cached;
+  test_ffm.run(splitted_mt, fm_direct, chromatograms);
+  p.setValue("isotope_pattern_cache", "true");
+  test_ffm.setParameters(p);
+  test_ffm.run(splitted_mt, fm_cached, chromatograms);
+  TEST_EQUAL(fm_cached.size(), fm_direct.size())
+  ABORT_IF(fm_cached.size() != fm_direct.size())
+  for (Size i = 0; i < fm_direct.size(); ++i)
+  {
+    TEST_EQUAL(fm_cached[i].getOverallQuality(), fm_direct[i].getOverallQuality())
+    TEST_EQUAL(fm_cached[i].getIntensity(), fm_direct[i].getIntensity())
+    TEST_EQUAL(fm_cached[i].getCharge(), fm_direct[i].getCharge())
+    TEST_EQUAL(fm_cached[i].getMZ(), fm_direct[i].getMZ())
+  }
 }
 END_SECTION
 
@@ -230,6 +230,66 @@ START_SECTION((void load(const String &filename, FeatureMap&feature_map)))
 }
 END_SECTION
 
+START_SECTION((void transform(const String& filename, FeatureMap& feature_map, const std::function<void (Feature&)>& consumer)))
+{
+  FeatureXMLFile f;
+  FeatureMap loaded;
+  f.load(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"), loaded);
+
+  FeatureMap meta;
+  std::vector<Feature> streamed;
+  Size proteins_at_first_feature = 0;
+  f.transform(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"), meta, [&](Feature& feature)
+  {
+    if (streamed.empty()) proteins_at_first_feature = meta.getProteinIdentifications().size();
+    streamed.push_back(feature);
+  });
+
+  // features are streamed, not stored
+  TEST_EQUAL(meta.size(), 0)
+  TEST_EQUAL(streamed.size(), loaded.size())
+  ABORT_IF(streamed.size() != loaded.size())
+  for (Size i = 0; i < streamed.size(); ++i)
+  {
+    TEST_EQUAL(streamed[i].getUniqueId(), loaded[i].getUniqueId())
+    TEST_REAL_SIMILAR(streamed[i].getRT(), loaded[i].getRT())
+    TEST_REAL_SIMILAR(streamed[i].getMZ(), loaded[i].getMZ())
+    TEST_REAL_SIMILAR(streamed[i].getIntensity(), loaded[i].getIntensity())
+    TEST_EQUAL(streamed[i].getConvexHulls().size(), loaded[i].getConvexHulls().size())
+    TEST_EQUAL(streamed[i].getSubordinates().size(), loaded[i].getSubordinates().size())
+    TEST_EQUAL(streamed[i].getPeptideIdentifications().size(), loaded[i].getPeptideIdentifications().size())
+  }
+
+  // map-level data is complete before the first feature
+  TEST_EQUAL(proteins_at_first_feature, loaded.getProteinIdentifications().size())
+  TEST_EQUAL(meta.getIdentifier(), loaded.getIdentifier())
+  TEST_EQUAL(meta.getDataProcessing().size(), loaded.getDataProcessing().size())
+  TEST_EQUAL(meta.getUnassignedPeptideIdentifications().size(), loaded.getUnassignedPeptideIdentifications().size())
+
+  // skip convex hulls, subordinates and peptide identifications
+  f.getOptions().setLoadConvexHull(false);
+  f.getOptions().setLoadSubordinates(false);
+  f.getOptions().setLoadPeptideIdentifications(false);
+  Size with_extras = 0;
+  streamed.clear();
+  f.transform(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"), meta, [&](Feature& feature)
+  {
+    if (!feature.getConvexHulls().empty() || !feature.getSubordinates().empty() || !feature.getPeptideIdentifications().empty()) ++with_extras;
+    streamed.push_back(feature);
+  });
+  TEST_EQUAL(streamed.size(), loaded.size())
+  TEST_EQUAL(with_extras, 0)
+  TEST_EQUAL(meta.getUnassignedPeptideIdentifications().size(), 0)
+
+  // range restrictions apply
+  FeatureXMLFile f2;
+  f2.getOptions().setRTRange(makeRange(1.5, 4.5));
+  Size count = 0;
+  f2.transform(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_2_options.featureXML"), meta, [&count](Feature&) { ++count; });
+  TEST_EQUAL(count, 5)
+}
+END_SECTION
+
 START_SECTION((void store(const String &filename, const FeatureMap&feature_map)))
 {
   FeatureMap map;
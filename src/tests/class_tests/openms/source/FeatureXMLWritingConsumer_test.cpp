@@ -0,0 +1,112 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/DATAACCESS/FeatureXMLWritingConsumer.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/FeatureXMLFile.h>
+#include <OpenMS/KERNEL/FeatureMap.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(FeatureXMLWritingConsumer, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+FeatureXMLWritingConsumer* ptr = nullptr;
+FeatureXMLWritingConsumer* null_ptr = nullptr;
+FeatureMap empty_map;
+START_SECTION((FeatureXMLWritingConsumer(const String& filename, const FeatureMap& meta_map, Size expected_size)))
+{
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  ptr = new FeatureXMLWritingConsumer(tmp_filename, empty_map, 0);
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EXCEPTION(Exception::UnableToCreateFile, FeatureXMLWritingConsumer("test.mzML", empty_map, 0))
+}
+END_SECTION
+
+START_SECTION((~FeatureXMLWritingConsumer()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((void consumeFeature(const Feature& feature)))
+{
+  // stream a file through the consumer: the result must equal a regular store()
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  FeatureXMLFile f;
+  {
+    FeatureMap meta;
+    FeatureXMLWritingConsumer writer(tmp_filename, meta, f.loadSize(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML")));
+    f.transform(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"), meta, [&writer](Feature& feature)
+    {
+      writer.consumeFeature(feature);
+    });
+    TEST_EQUAL(writer.getNrFeaturesWritten(), 2)
+  }
+  WHITELIST("?xml-stylesheet")
+  TEST_FILE_SIMILAR(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"), tmp_filename)
+
+  FeatureMap reloaded;
+  f.load(tmp_filename, reloaded);
+  TEST_EQUAL(reloaded.size(), 2)
+
+  // an empty map still gives a valid file
+  NEW_TMP_FILE(tmp_filename);
+  {
+    FeatureXMLWritingConsumer writer(tmp_filename, empty_map, 0);
+  }
+  TEST_EQUAL(f.isValid(tmp_filename, std::cerr), true)
+}
+END_SECTION
+
+START_SECTION((Size getNrFeaturesWritten() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
+
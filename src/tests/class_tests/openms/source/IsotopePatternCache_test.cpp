@@ -0,0 +1,222 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopePatternCache.h>
+///////////////////////////
+
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(IsotopePatternCache, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+IsotopePatternCache* ptr = nullptr;
+IsotopePatternCache* null_ptr = nullptr;
+START_SECTION(IsotopePatternCache())
+{
+  ptr = new IsotopePatternCache();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->getMaxIsotope(), 0)
+  TEST_REAL_SIMILAR(ptr->getMaxMass(), 0.0)
+}
+END_SECTION
+
+START_SECTION(~IsotopePatternCache())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((IsotopePatternCache(Averagine averagine, double max_mass, double mass_step = 1.0, Size max_isotope = 20)))
+{
+  IsotopePatternCache cache(IsotopePatternCache::Averagine::PEPTIDE, 1000.0, 10.0, 5);
+  TEST_REAL_SIMILAR(cache.getMaxMass(), 1000.0)
+  TEST_REAL_SIMILAR(cache.getMassStep(), 10.0)
+  TEST_EQUAL(cache.getMaxIsotope(), 5)
+
+  TEST_EXCEPTION(Exception::InvalidValue, IsotopePatternCache(IsotopePatternCache::Averagine::PEPTIDE, 1000.0, 0.0, 5))
+  TEST_EXCEPTION(Exception::InvalidValue, IsotopePatternCache(IsotopePatternCache::Averagine::PEPTIDE, 1000.0, 1.0, 0))
+}
+END_SECTION
+
+START_SECTION((IsotopePatternCache(double C, double H, double N, double O, double S, double P, double max_mass, double mass_step = 1.0, Size max_isotope = 20)))
+{
+  // same composition as the RNA averagine
+  IsotopePatternCache custom(9.75, 12.25, 3.75, 7, 0, 1, 2000.0, 5.0, 4);
+  IsotopePatternCache rna(IsotopePatternCache::Averagine::RNA, 2000.0, 5.0, 4);
+  vector<double> a, b;
+  custom.getIntensities(1234.5, 4, a);
+  rna.getIntensities(1234.5, 4, b);
+  TEST_EQUAL(a.size(), 4)
+  for (Size i = 0; i < a.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(a[i], b[i])
+  }
+}
+END_SECTION
+
+START_SECTION((void getIntensities(double mass, Size num_isotopes, std::vector<double>& intensities) const))
+{
+  IsotopePatternCache cache(IsotopePatternCache::Averagine::PEPTIDE, 3000.0, 1.0, 10);
+  vector<double> intensities;
+
+  // on a grid point, the pattern is exactly the one of the generator
+  CoarseIsotopePatternGenerator solver(4);
+  IsotopeDistribution dist = solver.estimateFromPeptideWeight(1500.0);
+  cache.getIntensities(1500.0, 4, intensities);
+  TEST_EQUAL(intensities.size(), 4)
+  for (Size i = 0; i < 4; ++i)
+  {
+    TEST_REAL_SIMILAR(intensities[i], dist[i].getIntensity())
+  }
+
+  // in between, it is interpolated
+  vector<double> low, high;
+  cache.getIntensities(1500.0, 10, low);
+  cache.getIntensities(1501.0, 10, high);
+  cache.getIntensities(1500.25, 10, intensities);
+  for (Size i = 0; i < 10; ++i)
+  {
+    TEST_REAL_SIMILAR(intensities[i], 0.75 * low[i] + 0.25 * high[i])
+  }
+
+  // beyond the table, the pattern is computed
+  dist = CoarseIsotopePatternGenerator(12).estimateFromPeptideWeight(5000.0);
+  cache.getIntensities(5000.0, 12, intensities);
+  TEST_EQUAL(intensities.size(), 12)
+  for (Size i = 0; i < 12; ++i)
+  {
+    TEST_REAL_SIMILAR(intensities[i], dist[i].getIntensity())
+  }
+}
+END_SECTION
+
+START_SECTION((void getExactIntensities(double mass, Size num_isotopes, std::vector<double>& intensities) const))
+{
+  IsotopePatternCache cache; // no table needed
+  vector<double> intensities;
+  for (double mass : {1500.0, 1500.25, 1500.4, 1500.25, 4321.7, 12000.0})
+  {
+    // exactly (bit-identical) the pattern of the generator, also when memoized
+    IsotopeDistribution dist = CoarseIsotopePatternGenerator(5).estimateFromPeptideWeight(mass);
+    cache.getExactIntensities(mass, 5, intensities);
+    TEST_EQUAL(intensities.size(), 5)
+    for (Size i = 0; i < 5; ++i)
+    {
+      TEST_EQUAL(intensities[i], dist[i].getIntensity())
+    }
+  }
+  // same formula, different number of isotopes (renormalized differently)
+  IsotopeDistribution dist = CoarseIsotopePatternGenerator(3).estimateFromPeptideWeight(1500.25);
+  cache.getExactIntensities(1500.25, 3, intensities);
+  TEST_EQUAL(intensities.size(), 3)
+  for (Size i = 0; i < 3; ++i)
+  {
+    TEST_EQUAL(intensities[i], dist[i].getIntensity())
+  }
+}
+END_SECTION
+
+START_SECTION((double getMaxMass() const))
+{
+  TEST_REAL_SIMILAR(IsotopePatternCache(IsotopePatternCache::Averagine::DNA, 95.0, 10.0, 3).getMaxMass(), 100.0)
+}
+END_SECTION
+
+START_SECTION((double getMassStep() const))
+{
+  TEST_REAL_SIMILAR(IsotopePatternCache(IsotopePatternCache::Averagine::DNA, 100.0, 2.5, 3).getMassStep(), 2.5)
+}
+END_SECTION
+
+START_SECTION((Size getMaxIsotope() const))
+{
+  TEST_EQUAL(IsotopePatternCache(IsotopePatternCache::Averagine::DNA, 100.0, 2.5, 3).getMaxIsotope(), 3)
+}
+END_SECTION
+
+START_SECTION((void store(const String& filename) const))
+{
+  // tested below
+  NOT_TESTABLE
+}
+END_SECTION
+
+START_SECTION((void load(const String& filename)))
+{
+  IsotopePatternCache cache(IsotopePatternCache::Averagine::PEPTIDE, 500.0, 2.0, 6);
+  String filename;
+  NEW_TMP_FILE(filename)
+  cache.store(filename);
+
+  IsotopePatternCache loaded;
+  loaded.load(filename);
+  TEST_REAL_SIMILAR(loaded.getMaxMass(), 500.0)
+  TEST_REAL_SIMILAR(loaded.getMassStep(), 2.0)
+  TEST_EQUAL(loaded.getMaxIsotope(), 6)
+  vector<double> a, b;
+  cache.getIntensities(321.1, 6, a);
+  loaded.getIntensities(321.1, 6, b);
+  TEST_EQUAL(b.size(), 6)
+  for (Size i = 0; i < a.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(a[i], b[i])
+  }
+
+  TEST_EXCEPTION(Exception::FileNotFound, loaded.load("this_file_does_not_exist.tsv"))
+  TEST_EXCEPTION(Exception::ParseError, loaded.load(OPENMS_GET_TEST_DATA_PATH("ExperimentalDesign_input_1.tsv")))
+}
+END_SECTION
+
+START_SECTION((static const IsotopePatternCache& getDefault(Averagine averagine)))
+{
+  const IsotopePatternCache& peptide = IsotopePatternCache::getDefault(IsotopePatternCache::Averagine::PEPTIDE);
+  TEST_EQUAL(&peptide == &IsotopePatternCache::getDefault(IsotopePatternCache::Averagine::PEPTIDE), true)
+  TEST_EQUAL(&peptide != &IsotopePatternCache::getDefault(IsotopePatternCache::Averagine::RNA), true)
+  TEST_REAL_SIMILAR(peptide.getMaxMass(), 10000.0)
+  TEST_EQUAL(peptide.getMaxIsotope(), 20)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,130 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataArenaConsumer.h>
+
+///////////////////////////
+
+START_TEST(MSDataArenaConsumer, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+using namespace OpenMS;
+
+MSDataArenaConsumer* arena_consumer_ptr = nullptr;
+MSDataArenaConsumer* arena_consumer_nullPointer = nullptr;
+ArenaMSExperiment target;
+
+START_SECTION((explicit MSDataArenaConsumer(ArenaMSExperiment& exp)))
+  arena_consumer_ptr = new MSDataArenaConsumer(target);
+  TEST_NOT_EQUAL(arena_consumer_ptr, arena_consumer_nullPointer)
+END_SECTION
+
+START_SECTION((~MSDataArenaConsumer()))
+    delete arena_consumer_ptr;
+END_SECTION
+
+START_SECTION((void consumeSpectrum(SpectrumType & s)))
+{
+  ArenaMSExperiment exp;
+  MSDataArenaConsumer consumer(exp);
+
+  MSSpectrum s;
+  s.push_back(Peak1D(100.0, 1.0f));
+  s.setName("spec1");
+  s.setRT(5);
+  consumer.consumeSpectrum(s);
+  TEST_EQUAL(s.empty(), true) // moved into the arena
+  TEST_EQUAL(s.getName(), "")
+  s.push_back(Peak1D(100.0, 1.0f));
+  s.setName("spec2");
+  s.setRT(15);
+  consumer.consumeSpectrum(s);
+
+  TEST_EQUAL(exp.size(), 2)
+  TEST_EQUAL(exp.getNrPeaks(), 2)
+  TEST_EQUAL(exp.getChromatograms().size(), 0)
+  TEST_EQUAL(exp.getSpectrum(0).getName(), "spec1")
+  TEST_REAL_SIMILAR(exp.getRT(1), 15)
+}
+END_SECTION
+
+START_SECTION((void consumeChromatogram(ChromatogramType & c)))
+{
+  ArenaMSExperiment exp;
+  MSDataArenaConsumer consumer(exp);
+
+  MSChromatogram c;
+  c.setNativeID("testid");
+  consumer.consumeChromatogram(c);
+
+  TEST_EQUAL(exp.size(), 0)
+  TEST_EQUAL(exp.getChromatograms().size(), 1)
+  TEST_EQUAL(exp.getChromatograms()[0].getNativeID(), "testid")
+}
+END_SECTION
+
+START_SECTION((void setExpectedSize(Size, Size)))
+  NOT_TESTABLE // only reserves space
+END_SECTION
+
+START_SECTION((void setExperimentalSettings(const ExperimentalSettings&)))
+{
+  ArenaMSExperiment exp;
+  MSDataArenaConsumer consumer(exp);
+  consumer.setExpectedSize(1, 0);
+
+  MSSpectrum spec;
+  spec.setRT(5);
+  consumer.consumeSpectrum(spec);
+
+  ExperimentalSettings s;
+  s.setComment("mySettings");
+  consumer.setExperimentalSettings(s);
+
+  TEST_EQUAL(exp.size(), 1)
+  TEST_EQUAL(exp.getComment(), "mySettings")
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -199,6 +199,72 @@ START_SECTION(( void decodeNP(const String & in, std::vector<double> & out, bool
 }
 END_SECTION
 
+START_SECTION(( void decodeNP(const String & in, std::vector<float> & out, bool zlib_compression, const NumpressConfig & config) ))
+{
+  String in = "QMVagAAAAAAZxX3ivPP8/w==";
+
+  MSNumpressCoder::NumpressConfig config;
+  config.np_compression = MSNumpressCoder::SLOF;
+
+  std::vector<float> out;
+  std::vector<double> out_double;
+
+  bool zlib_compression = false;
+  MSNumpressCoder().decodeNP(in, out, zlib_compression, config);
+  MSNumpressCoder().decodeNP(in, out_double, zlib_compression, config);
+
+  TEST_EQUAL(out.size(), 4)
+  // decoding directly to float gives (up to float rounding) the same as decoding to double
+  TOLERANCE_RELATIVE(1.0 + 1e-6)
+  for (Size i = 0; i < out.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(out[i], out_double[i])
+  }
+
+  config.np_compression = MSNumpressCoder::PIC;
+  MSNumpressCoder().decodeNP("ZGaMXCFQkQ==", out, zlib_compression, config);
+  TEST_EQUAL(out.size(), 4)
+  TOLERANCE_ABSOLUTE(0.001)
+  TEST_REAL_SIMILAR(out[0], 100.0)
+  TEST_REAL_SIMILAR(out[3], 400.00010)
+}
+END_SECTION
+
+START_SECTION(( void decodeNPRaw(const std::string & in, std::vector<float> & out, const NumpressConfig & config) ))
+{
+  std::vector< double > in = setup_test_vec2();
+  String raw;
+
+  MSNumpressCoder::NumpressConfig config;
+  config.np_compression = MSNumpressCoder::SLOF;
+  config.estimate_fixed_point = true;
+  MSNumpressCoder().encodeNPRaw(in, raw, config);
+
+  std::vector<double> out_double;
+  std::vector<float> out;
+  MSNumpressCoder().decodeNPRaw(raw, out_double, config);
+  MSNumpressCoder().decodeNPRaw(raw, out, config);
+  TEST_EQUAL(out.size(), 100)
+  ABORT_IF(out.size() != out_double.size())
+  TOLERANCE_RELATIVE(1.0 + 1e-6)
+  for (Size i = 0; i < out.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(out[i], out_double[i])
+  }
+
+  config.np_compression = MSNumpressCoder::LINEAR;
+  MSNumpressCoder().encodeNPRaw(in, raw, config);
+  MSNumpressCoder().decodeNPRaw(raw, out_double, config);
+  MSNumpressCoder().decodeNPRaw(raw, out, config);
+  TEST_EQUAL(out.size(), 100)
+  ABORT_IF(out.size() != out_double.size())
+  for (Size i = 0; i < out.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(out[i], out_double[i])
+  }
+}
+END_SECTION
+
 START_SECTION(([MSNumpressCoder::NumpressConfig] NumpressConfig()))
 {
   MSNumpressCoder::NumpressConfig * config = new MSNumpressCoder::NumpressConfig();
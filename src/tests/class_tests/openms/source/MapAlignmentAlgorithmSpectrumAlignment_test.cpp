@@ -126,6 +126,52 @@ START_SECTION((virtual void align(std::vector<PeakMap >&, std::vector<Transforma
 }
 END_SECTION
 
+START_SECTION(([EXTRA] binned score and RT band))
+{
+  std::vector<PeakMap > input(2);
+  for (UInt i = 0; i < 15; ++i)
+  {
+    PeakSpectrum spectrum;
+    spectrum.setMSLevel(1);
+    for (float mz = 500.0; mz <= 900; mz += 100.0)
+    {
+      Peak1D peak;
+      peak.setMZ(mz + 3 * i);
+      peak.setIntensity(mz + i);
+      spectrum.push_back(peak);
+    }
+    spectrum.setRT(i);
+    input[0].addSpectrum(spectrum);
+    spectrum.setRT(i * 1.2 + 200);
+    input[1].addSpectrum(spectrum);
+  }
+
+  // the band has to cover the RT shift between the maps
+  Param p;
+  p.setValue("scorefunction", "BinnedSpectralContrastAngle");
+  p.setValue("rt_band", 250.0);
+  for (Size run = 0; run < 2; ++run)
+  {
+    MapAlignmentAlgorithmSpectrumAlignment ma;
+    ma.setParameters(p);
+    std::vector<PeakMap > maps = input;
+    std::vector<TransformationDescription> transformations;
+    ma.align(maps, transformations);
+    TEST_EQUAL(transformations.size(), 2)
+    Param params;
+    params.setValue("interpolation_type", "cspline");
+    transformations[1].fitModel("interpolated", params);
+    MapAlignmentTransformer::transformRetentionTimes(maps[1], transformations[1]);
+    for (Size i = 0; i < maps[0].size(); ++i)
+    {
+      TEST_REAL_SIMILAR(maps[0][i].getRT(), maps[1][i].getRT());
+    }
+    // the same alignment with the peak-based score
+    p.setValue("scorefunction", "SteinScottImproveScore");
+  }
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -41,6 +41,7 @@
 
 #include <OpenMS/FORMAT/FileTypes.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/KERNEL/ArenaMSExperiment.h>
 
 using namespace OpenMS;
 using namespace std;
@@ -897,6 +898,79 @@ START_SECTION((template <typename MapType> void load(const String& filename, Map
 }
 END_SECTION
 
+START_SECTION([EXTRA] load indexed mzML in parallel)
+{
+  // spectra only, spectra + chromatograms, and an index which does not match the content (sequential fallback)
+  for (const String& filename : {"OpenPepXL_input.mzML", "IndexedmzMLFile_1.mzML", "MzMLFile_4_indexed.mzML"})
+  {
+    MzMLFile file;
+    PeakMap exp_sequential, exp_parallel;
+    file.load(OPENMS_GET_TEST_DATA_PATH(filename), exp_sequential);
+    file.getOptions().setParallelIndexedLoad(true);
+    file.load(OPENMS_GET_TEST_DATA_PATH(filename), exp_parallel);
+
+    TEST_EQUAL(exp_parallel.size(), exp_sequential.size())
+    TEST_EQUAL(exp_parallel.getChromatograms().size(), exp_sequential.getChromatograms().size())
+    TEST_EQUAL(exp_parallel == exp_sequential, true)
+  }
+
+  // filters are applied by each block
+  MzMLFile file;
+  file.getOptions().setParallelIndexedLoad(true);
+  file.getOptions().addMSLevel(2);
+  PeakMap exp;
+  file.load(OPENMS_GET_TEST_DATA_PATH("OpenPepXL_input.mzML"), exp);
+  TEST_EQUAL(exp.size() > 0, true)
+  bool only_ms2 = true;
+  for (const MSSpectrum& s : exp)
+  {
+    only_ms2 &= (s.getMSLevel() == 2);
+  }
+  TEST_EQUAL(only_ms2, true)
+}
+END_SECTION
+
+START_SECTION(void load(const String& filename, ArenaMSExperiment& map))
+{
+  for (const String& filename : {"MzMLFile_1.mzML", "OpenPepXL_input.mzML"})
+  {
+    MzMLFile file;
+    PeakMap exp;
+    file.load(OPENMS_GET_TEST_DATA_PATH(filename), exp);
+    ArenaMSExperiment arena;
+    file.load(OPENMS_GET_TEST_DATA_PATH(filename), arena);
+
+    TEST_EQUAL(arena.size(), exp.size())
+    TEST_EQUAL(arena.getChromatograms().size(), exp.getChromatograms().size())
+    TEST_EQUAL(arena.getLoadedFilePath(), exp.getLoadedFilePath())
+    ABORT_IF(arena.size() != exp.size())
+    MSSpectrum s;
+    for (Size i = 0; i < exp.size(); ++i)
+    {
+      arena.getSpectrum(i, s);
+      TEST_EQUAL(s == exp[i], true)
+    }
+  }
+
+  // spectra share their meta data
+  MzMLFile file;
+  ArenaMSExperiment arena;
+  file.load(OPENMS_GET_TEST_DATA_PATH("OpenPepXL_input.mzML"), arena);
+  TEST_EQUAL(arena.getNrSharedSettings() < arena.size(), true)
+
+  // options are honored
+  file.getOptions().addMSLevel(2);
+  file.load(OPENMS_GET_TEST_DATA_PATH("OpenPepXL_input.mzML"), arena);
+  TEST_EQUAL(arena.size() > 0, true)
+  bool only_ms2 = true;
+  for (Size i = 0; i < arena.size(); ++i)
+  {
+    only_ms2 &= (arena.getMSLevel(i) == 2);
+  }
+  TEST_EQUAL(only_ms2, true)
+}
+END_SECTION
+
 START_SECTION([EXTRA] load only meta data)
 {
   MzMLFile file;
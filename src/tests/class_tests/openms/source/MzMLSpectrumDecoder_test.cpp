@@ -648,6 +648,81 @@ START_SECTION(( void domParseChromatogram(const std::string& in, OpenMS::Interfa
 }
 END_SECTION
 
+START_SECTION(( void setUseDOMParser(bool use_dom) ))
+{
+  // the tokenizer and the DOM parser need to give identical results, also for
+  // entities in attributes and input which makes the tokenizer fall back to DOM
+  std::vector<std::string> test_strings;
+  test_strings.push_back(MULTI_LINE_STRING(
+      <spectrum index="2" id="scan=2 &amp; file=&quot;a&quot;" defaultArrayLength="15">
+        <cvParam cvRef="MS" accession="MS:1000511" name="ms level" value="2"/>
+        <binaryDataArrayList count="3">
+          <binaryDataArray encodedLength="160" >
+            <cvParam cvRef="MS" accession="MS:1000523" name="64-bit float" value=""/>
+            <cvParam cvRef="MS" accession="MS:1000576" name="no compression" value=""/>
+            <cvParam cvRef="MS" accession="MS:1000514" name="m/z array" unitAccession="MS:1000040" unitName="m/z" unitCvRef="MS"/>
+            <binary>AAAAAAAAAAAAAAAAAADwPwAAAAAAAABAAAAAAAAACEAAAAAAAAAQQAAAAAAAABRAAAAAAAAAGEAAAAAAAAAcQAAAAAAAACBAAAAAAAAAIkAAAAAAAAAkQAAAAAAAACZAAAAAAAAAKEAAAAAAAAAqQAAAAAAAACxA</binary>
+          </binaryDataArray>
+          <binaryDataArray encodedLength="160" >
+            <cvParam cvRef="MS" accession="MS:1000523" name="64-bit float" value=""/>
+            <cvParam cvRef="MS" accession="MS:1000576" name="no compression" value=""/>
+            <cvParam cvRef="MS" accession="MS:1000515" name="intensity array" value="" unitAccession="MS:1000131" unitName="number of detector counts" unitCvRef="MS"/>
+            <binary>AAAAAAAALkAAAAAAAAAsQAAAAAAAACpAAAAAAAAAKEAAAAAAAAAmQAAAAAAAACRAAAAAAAAAIkAAAAAAAAAgQAAAAAAAABxAAAAAAAAAGEAAAAAAAAAUQAAAAAAAABBAAAAAAAAACEAAAAAAAAAAQAAAAAAAAPA/</binary>
+          </binaryDataArray>
+          <binaryDataArray encodedLength="160" >
+            <cvParam cvRef="MS" accession="MS:1000523" name="64-bit float" value=""/>
+            <cvParam cvRef="MS" accession="MS:1000576" name="no compression" value=""/>
+            <cvParam cvRef="MS" accession="MS:1000786" name="non-standard data array" value="Ion &lt;Mobility&gt;" />
+            <binary>AAAAAAAALkAAAAAAAAAsQAAAAAAAACpAAAAAAAAAKEAAAAAAAAAmQAAAAAAAACRAAAAAAAAAIkAAAAAAAAAgQAAAAAAAABxAAAAAAAAAGEAAAAAAAAAUQAAAAAAAABBAAAAAAAAACEAAAAAAAAAAQAAAAAAAAPA/</binary>
+          </binaryDataArray>
+        </binaryDataArrayList>
+      </spectrum>
+  ));
+  test_strings.push_back(MULTI_LINE_STRING(
+      <spectrum index="2" id="index=2" defaultArrayLength="15">
+        <!-- comments are handled by the DOM parser -->
+        <binaryDataArrayList count="2">
+          <binaryDataArray encodedLength="160" >
+            <cvParam cvRef="MS" accession="MS:1000523" name="64-bit float" value=""/>
+            <cvParam cvRef="MS" accession="MS:1000576" name="no compression" value=""/>
+            <cvParam cvRef="MS" accession="MS:1000514" name="m/z array" unitAccession="MS:1000040" unitName="m/z" unitCvRef="MS"/>
+            <binary>AAAAAAAAAAAAAAAAAADwPwAAAAAAAABAAAAAAAAACEAAAAAAAAAQQAAAAAAAABRAAAAAAAAAGEAAAAAAAAAcQAAAAAAAACBAAAAAAAAAIkAAAAAAAAAkQAAAAAAAACZAAAAAAAAAKEAAAAAAAAAqQAAAAAAAACxA</binary>
+          </binaryDataArray>
+          <binaryDataArray encodedLength="160" >
+            <cvParam cvRef="MS" accession="MS:1000523" name="64-bit float" value=""/>
+            <cvParam cvRef="MS" accession="MS:1000576" name="no compression" value=""/>
+            <cvParam cvRef="MS" accession="MS:1000515" name="intensity array" value="" unitAccession="MS:1000131" unitName="number of detector counts" unitCvRef="MS"/>
+            <binary>AAAAAAAALkAAAAAAAAAsQAAAAAAAACpAAAAAAAAAKEAAAAAAAAAmQAAAAAAAACRAAAAAAAAAIkAAAAAAAAAgQAAAAAAAABxAAAAAAAAAGEAAAAAAAAAUQAAAAAAAABBAAAAAAAAACEAAAAAAAAAAQAAAAAAAAPA/</binary>
+          </binaryDataArray>
+        </binaryDataArrayList>
+      </spectrum>
+  ));
+
+  for (const std::string& test_string : test_strings)
+  {
+    MzMLSpectrumDecoder fast_decoder, dom_decoder;
+    dom_decoder.setUseDOMParser(true);
+    MSSpectrum s_fast, s_dom;
+    fast_decoder.domParseSpectrum(test_string, s_fast);
+    dom_decoder.domParseSpectrum(test_string, s_dom);
+    TEST_EQUAL(s_fast.size(), 15)
+    TEST_EQUAL(s_fast == s_dom, true)
+    TEST_EQUAL(s_fast.getNativeID(), s_dom.getNativeID())
+  }
+  MSSpectrum s;
+  MzMLSpectrumDecoder().domParseSpectrum(test_strings[0], s);
+  TEST_EQUAL(s.getNativeID(), "scan=2 & file=\"a\"")
+  TEST_EQUAL(s.getFloatDataArrays().size(), 1)
+  TEST_EQUAL(s.getFloatDataArrays()[0].getName(), "Ion <Mobility>")
+
+  // indexed mzML provides everything up to the next spectrum, which is ignored
+  std::string with_trailing = test_strings[0] + "\n    </spectrumList>\n    <chromatogramList count=\"1\" defaultDataProcessingRef=\"dp\">\n      ";
+  MSSpectrum s_trailing;
+  MzMLSpectrumDecoder().domParseSpectrum(with_trailing, s_trailing);
+  TEST_EQUAL(s_trailing == s, true)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -39,6 +39,7 @@
 ///////////////////////////
 
 #include <OpenMS/FILTERING/TRANSFORMERS/NLargest.h>
+#include <OpenMS/KERNEL/SpectrumColumns.h>
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/FORMAT/DTAFile.h>
 
@@ -96,6 +97,23 @@ START_SECTION((template<typename SpectrumType> void filterSpectrum(SpectrumType&
 	TEST_EQUAL(spec.size(), 10)
 END_SECTION
 
+START_SECTION((void filterSpectrum(SpectrumColumns& spectrum)))
+	DTAFile dta_file;
+	PeakSpectrum spec;
+	dta_file.load(OPENMS_GET_TEST_DATA_PATH("Transformers_tests.dta"), spec);
+	SpectrumColumns sc(spec);
+
+	Param p(e_ptr->getParameters());
+	p.setValue("n", 10);
+	e_ptr->setParameters(p);
+	e_ptr->filterSpectrum(sc);
+	TEST_EQUAL(sc.size(), 10)
+
+	// same peaks in the same order as the template version
+	e_ptr->filterSpectrum(spec);
+	TEST_EQUAL(sc == SpectrumColumns(spec), true)
+END_SECTION
+
 START_SECTION((void filterPeakMap(PeakMap& exp)))
 	delete e_ptr;
 	e_ptr = new NLargest();
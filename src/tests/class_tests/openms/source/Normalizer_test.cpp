@@ -39,6 +39,7 @@
 ///////////////////////////
 
 #include <OpenMS/FILTERING/TRANSFORMERS/Normalizer.h>
+#include <OpenMS/KERNEL/SpectrumColumns.h>
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/FORMAT/DTAFile.h>
 
@@ -103,6 +104,24 @@ START_SECTION((template<typename SpectrumType> void filterSpectrum(SpectrumType&
 
 	TEST_REAL_SIMILAR(sum, 1.0);	
 END_SECTION
+
+START_SECTION((void filterSpectrum(SpectrumColumns& spectrum) const))
+	Normalizer normalizer;
+	PeakSpectrum spec = spec_ref;
+	SpectrumColumns sc(spec);
+	normalizer.filterSpectrum(sc);
+	TEST_EQUAL(sc.getIntensityArray().back(), 1)
+	normalizer.filterSpectrum(spec);
+	TEST_EQUAL(sc == SpectrumColumns(spec), true)
+
+	Param p(normalizer.getParameters());
+	p.setValue("method", "to_TIC");
+	normalizer.setParameters(p);
+	normalizer.filterSpectrum(sc);
+	TEST_REAL_SIMILAR(sc.calculateTIC(), 1.0);
+	normalizer.filterSpectrum(spec);
+	TEST_EQUAL(sc == SpectrumColumns(spec), true)
+END_SECTION
 	
 START_SECTION((void filterPeakMap(PeakMap& exp) const))
 	delete e_ptr;
@@ -150,6 +150,49 @@ START_SECTION(static std::vector<OPXLDataStructs::XLPrecursor> enumerateCrossLin
 
 END_SECTION
 
+START_SECTION(static void enumerateCrossLinksInWindow(const std::vector<OPXLDataStructs::AASeqWithMass>& peptides, double cross_link_mass, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, double precursor_mass, double allowed_error, std::vector<OPXLDataStructs::XLPrecursor>& candidates))
+  double allowed_error = first_mass * precursor_mass_tolerance * 1e-6;
+  std::vector<OPXLDataStructs::XLPrecursor> window_candidates;
+  OPXLHelper::enumerateCrossLinksInWindow(peptides, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, first_mass, allowed_error, window_candidates);
+
+  // compare the number of peptide pairs to a brute force enumeration
+  Size brute_force_pairs = 0;
+  for (Size p1 = 0; p1 < peptides.size(); ++p1)
+  {
+    for (Size p2 = p1; p2 < peptides.size(); ++p2)
+    {
+      if (std::fabs(peptides[p1].peptide_mass + peptides[p2].peptide_mass + cross_link_mass - first_mass) <= allowed_error)
+      {
+        ++brute_force_pairs;
+      }
+    }
+  }
+
+  Size pairs = 0;
+  bool all_in_window = true;
+  for (const OPXLDataStructs::XLPrecursor& precursor : window_candidates)
+  {
+    all_in_window &= std::fabs(precursor.precursor_mass - first_mass) <= allowed_error + 1e-3; // float precision of precursor_mass
+    if (precursor.beta_index < peptides.size())
+    {
+      ++pairs;
+      TEST_EQUAL(precursor.alpha_index <= precursor.beta_index, true)
+    }
+  }
+  TEST_EQUAL(all_in_window, true)
+  TEST_EQUAL(pairs, brute_force_pairs)
+  TEST_NOT_EQUAL(pairs, 0)
+
+  // appends to the given vector
+  Size old_size = window_candidates.size();
+  OPXLHelper::enumerateCrossLinksInWindow(peptides, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, first_mass, allowed_error, window_candidates);
+  TEST_EQUAL(window_candidates.size(), 2 * old_size)
+
+  std::vector<OPXLDataStructs::XLPrecursor> no_candidates;
+  OPXLHelper::enumerateCrossLinksInWindow(std::vector<OPXLDataStructs::AASeqWithMass>(), cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, first_mass, allowed_error, no_candidates);
+  TEST_EQUAL(no_candidates.empty(), true)
+END_SECTION
+
 // building more data structures required in the following test
 std::cout << std::endl;
 std::vector< int > spectrum_precursor_correction_positions;
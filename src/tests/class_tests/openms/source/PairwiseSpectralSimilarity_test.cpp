@@ -0,0 +1,166 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/COMPARISON/SPECTRA/PairwiseSpectralSimilarity.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+MSSpectrum makeSpectrum(double precursor_mz, const vector<double>& mz, const vector<double>& intensity)
+{
+  MSSpectrum s;
+  for (Size i = 0; i < mz.size(); ++i)
+  {
+    s.push_back(Peak1D(mz[i], intensity[i]));
+  }
+  Precursor p;
+  p.setMZ(precursor_mz);
+  s.getPrecursors().push_back(p);
+  return s;
+}
+
+START_TEST(PairwiseSpectralSimilarity, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+PairwiseSpectralSimilarity* ptr = nullptr;
+PairwiseSpectralSimilarity* null_ptr = nullptr;
+START_SECTION(PairwiseSpectralSimilarity())
+{
+  ptr = new PairwiseSpectralSimilarity();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+}
+END_SECTION
+
+START_SECTION(~PairwiseSpectralSimilarity())
+{
+  delete ptr;
+}
+END_SECTION
+
+const vector<double> ones(6, 1.0);
+vector<MSSpectrum> spectra;
+spectra.push_back(makeSpectrum(510.0, {100.01, 200.01, 300.01, 400.01, 500.01, 600.01}, ones)); // shifted copy of #3
+spectra.push_back(makeSpectrum(1200.0, {100.0, 200.0, 300.0, 400.0, 500.0, 600.0}, {1, 1, 1, 1, 1, 2})); // far away precursor
+spectra.push_back(makeSpectrum(505.0, {150.0, 250.0, 350.0, 450.0, 550.0, 650.0}, ones)); // no shared peaks
+spectra.push_back(makeSpectrum(500.0, {600.0, 500.0, 400.0, 300.0, 200.0, 100.0}, ones)); // unsorted
+
+START_SECTION(static double cosine(const MSSpectrum& a, const MSSpectrum& b, double tolerance, Size& matched_peaks))
+{
+  Size matched(0);
+  MSSpectrum sorted = spectra[3];
+  sorted.sortByPosition();
+  TEST_REAL_SIMILAR(PairwiseSpectralSimilarity::cosine(spectra[0], sorted, 0.02, matched), 1.0)
+  TEST_EQUAL(matched, 6)
+  TEST_REAL_SIMILAR(PairwiseSpectralSimilarity::cosine(spectra[0], sorted, 0.005, matched), 0.0)
+  TEST_EQUAL(matched, 0)
+  TEST_REAL_SIMILAR(PairwiseSpectralSimilarity::cosine(spectra[1], sorted, 0.02, matched), 7.0 / (sqrt(6.0) * 3.0))
+  TEST_EQUAL(matched, 6)
+  TEST_REAL_SIMILAR(PairwiseSpectralSimilarity::cosine(MSSpectrum(), sorted, 0.02, matched), 0.0)
+  TEST_EQUAL(matched, 0)
+
+  // unsorted input and peaks with intensity <= 0 are handled as in compute()
+  TEST_REAL_SIMILAR(PairwiseSpectralSimilarity::cosine(spectra[0], spectra[3], 0.02, matched), 1.0)
+  TEST_EQUAL(matched, 6)
+  MSSpectrum zeros = sorted;
+  zeros.push_back(Peak1D(700.0, 0.0f));
+  zeros.push_back(Peak1D(800.0, -1.0f));
+  MSSpectrum other = spectra[0];
+  other.push_back(Peak1D(700.0, 1.0f));
+  other.push_back(Peak1D(800.0, 1.0f));
+  TEST_REAL_SIMILAR(PairwiseSpectralSimilarity::cosine(zeros, spectra[0], 0.02, matched), 1.0)
+  TEST_EQUAL(matched, 6)
+  TEST_REAL_SIMILAR(PairwiseSpectralSimilarity::cosine(zeros, other, 0.02, matched), 6.0 / (sqrt(6.0) * sqrt(8.0)))
+  TEST_EQUAL(matched, 6)
+}
+END_SECTION
+
+START_SECTION(std::vector<Edge> compute(const std::vector<MSSpectrum>& spectra) const)
+{
+  PairwiseSpectralSimilarity sim;
+  vector<PairwiseSpectralSimilarity::Edge> edges = sim.compute(spectra);
+  TEST_EQUAL(edges.size(), 1)
+  ABORT_IF(edges.size() != 1)
+  TEST_EQUAL(edges[0].first, 0)
+  TEST_EQUAL(edges[0].second, 3)
+  TEST_REAL_SIMILAR(edges[0].score, 1.0)
+  TEST_EQUAL(edges[0].matched_peaks, 6)
+
+  // without precursor filter; results do not depend on the block size
+  for (int block_size : {1, 2, 256})
+  {
+    Param p = sim.getParameters();
+    p.setValue("max_precursor_mz_difference", -1.0);
+    p.setValue("block_size", block_size);
+    sim.setParameters(p);
+    edges = sim.compute(spectra);
+    TEST_EQUAL(edges.size(), 3)
+    ABORT_IF(edges.size() != 3)
+    TEST_EQUAL(edges[0].first, 0)
+    TEST_EQUAL(edges[0].second, 1)
+    TEST_REAL_SIMILAR(edges[0].score, 7.0 / (sqrt(6.0) * 3.0))
+    TEST_EQUAL(edges[1].first, 0)
+    TEST_EQUAL(edges[1].second, 3)
+    TEST_EQUAL(edges[2].first, 1)
+    TEST_EQUAL(edges[2].second, 3)
+  }
+
+  // thresholds
+  Param p = sim.getParameters();
+  p.setValue("min_score", 0.99);
+  sim.setParameters(p);
+  TEST_EQUAL(sim.compute(spectra).size(), 1)
+  p.setValue("min_matched_peaks", 7);
+  sim.setParameters(p);
+  TEST_EQUAL(sim.compute(spectra).size(), 0)
+
+  TEST_EQUAL(sim.compute(vector<MSSpectrum>()).size(), 0)
+
+  // spectra without precursor only work without precursor filter
+  vector<MSSpectrum> no_precursor(2, MSSpectrum());
+  TEST_EQUAL(sim.compute(no_precursor).size(), 0)
+  TEST_EXCEPTION(Exception::MissingInformation, PairwiseSpectralSimilarity().compute(no_precursor))
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
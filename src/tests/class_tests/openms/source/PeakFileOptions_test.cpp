@@ -246,6 +246,23 @@ START_SECTION(void setMaxDataPoolSize(Size size))
 }
 END_SECTION
 
+START_SECTION(bool getParallelIndexedLoad() const)
+{
+	PeakFileOptions tmp;
+	TEST_EQUAL(tmp.getParallelIndexedLoad(), false);
+}
+END_SECTION
+
+START_SECTION(void setParallelIndexedLoad(bool parallel))
+{
+	PeakFileOptions tmp;
+	tmp.setParallelIndexedLoad(true);
+	TEST_EQUAL(tmp.getParallelIndexedLoad(), true);
+	PeakFileOptions copy(tmp);
+	TEST_EQUAL(copy.getParallelIndexedLoad(), true);
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
@@ -369,6 +369,66 @@ START_SECTION((ExitCodes run(std::vector<FASTAFile::FASTAEntry>& proteins, std::
 }
 END_SECTION
 
+START_SECTION([EXTRA] backend 'suffix_array' yields the same peptide evidences as 'aho_corasick')
+{
+  std::vector<FASTAFile::FASTAEntry> proteins = toFASTAVec(QStringList() << "MKDPLMMLKPEPTIDERXXXBEBEAR" << "*MLT*EAXK" << "BEBEIBEBEL" << "PEPTLDEXXXXBEEEARKDPLMMLK" << "PEPTIDERK",
+                                                           QStringList() << "P1" << "P2" << "DECOY_P3" << "P4" << "DECOY_P5");
+  std::vector<PeptideIdentification> pep_ids = toPepVec(QStringList() << "PEPTIDER" << "MLTEAEK" << "NENEL" << "DENEI" << "KDPLMMLK" << "PEPTIDER" << "XXXBEBEAR" << "EEEAR" << "NOTFOUND");
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  for (int aaa = 0; aaa <= 3; ++aaa)
+  {
+    for (int mm = 0; mm <= 1; ++mm)
+    {
+      for (const String& il : {"true", "false"})
+      {
+        std::vector<PeptideIdentification> pep_ac = pep_ids, pep_sa = pep_ids;
+        std::vector<ProteinIdentification> prot_ac, prot_sa;
+        PeptideIndexing pi;
+        Param p = pi.getParameters();
+        p.setValue("decoy_string", "DECOY_");
+        p.setValue("missing_decoy_action", "silent");
+        p.setValue("unmatched_action", "warn");
+        p.setValue("enzyme:specificity", "semi");
+        p.setValue("aaa_max", aaa);
+        p.setValue("mismatches_max", mm);
+        p.setValue("IL_equivalent", il);
+        pi.setParameters(p);
+        std::vector<FASTAFile::FASTAEntry> proteins_local = proteins;
+        pi.run(proteins_local, prot_ac, pep_ac);
+
+        p.setValue("backend", "suffix_array");
+        p.setValue("suffix_array_file", tmp_filename); // written in the first iteration of each IL setting, rebuilt otherwise
+        pi.setParameters(p);
+        proteins_local = proteins;
+        pi.run(proteins_local, prot_sa, pep_sa);
+
+        for (Size i = 0; i < pep_ids.size(); ++i)
+        {
+          TEST_EQUAL(pep_ac[i].getHits()[0].getPeptideEvidences() == pep_sa[i].getHits()[0].getPeptideEvidences(), true)
+          TEST_EQUAL(pep_ac[i].getHits()[0].getMetaValue("target_decoy"), pep_sa[i].getHits()[0].getMetaValue("target_decoy"))
+          TEST_EQUAL(pep_ac[i].getHits()[0].getMetaValue("protein_references"), pep_sa[i].getHits()[0].getMetaValue("protein_references"))
+        }
+      }
+    }
+  }
+  // reuse the stored suffix array (same database and settings)
+  std::vector<PeptideIdentification> pep_sa = pep_ids;
+  std::vector<ProteinIdentification> prot_sa;
+  PeptideIndexing pi;
+  Param p = pi.getParameters();
+  p.setValue("decoy_string", "DECOY_");
+  p.setValue("IL_equivalent", "false");
+  p.setValue("backend", "suffix_array");
+  p.setValue("suffix_array_file", tmp_filename);
+  p.setValue("unmatched_action", "warn");
+  pi.setParameters(p);
+  pi.run(proteins, prot_sa, pep_sa);
+  TEST_EQUAL(pep_sa[0].getHits()[0].extractProteinAccessionsSet().size(), 2) // PEPTIDER in P1 and DECOY_P5
+  TEST_EQUAL(pep_sa[8].getHits()[0].extractProteinAccessionsSet().size(), 0) // NOTFOUND
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
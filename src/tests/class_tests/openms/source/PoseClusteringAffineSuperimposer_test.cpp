@@ -339,6 +339,94 @@ START_SECTION(([EXTRA]virtual void run(const std::vector<Peak2D> & map_model, co
 }
 END_SECTION
 
+START_SECTION((void prepareMap(const std::vector<Peak2D> & map, PreparedMap & prepared) const))
+{
+  std::vector<Peak2D> map;
+  double rt[] = {1.0, 5.0, 1.3, 2.2, 5.2};
+  double mz[] = {900, 5.0, 800, 1.0, 5.0};
+  double intensity[] = {20, 100, 41, 100, 50};
+  for (Size i = 0; i < 5; i++)
+  {
+    Peak2D p;
+    p.setRT(rt[i]);
+    p.setMZ(mz[i]);
+    p.setIntensity(intensity[i]);
+    map.push_back(p);
+  }
+
+  Param parameters;
+  parameters.setValue(String("num_used_points"), 3);
+  PoseClusteringAffineSuperimposer pcat;
+  pcat.setParameters(parameters);
+
+  PoseClusteringAffineSuperimposer::PreparedMap prepared;
+  pcat.prepareMap(map, prepared);
+  // the three most intense points, sorted by m/z
+  TEST_EQUAL(prepared.points.size(), 3)
+  TEST_REAL_SIMILAR(prepared.points[0].getMZ(), 1.0)
+  TEST_REAL_SIMILAR(prepared.points[1].getMZ(), 5.0)
+  TEST_REAL_SIMILAR(prepared.points[2].getMZ(), 5.0)
+  TEST_REAL_SIMILAR(prepared.total_intensity, 250.0)
+  // RT range of the complete map
+  TEST_REAL_SIMILAR(prepared.min_rt, 1.0)
+  TEST_REAL_SIMILAR(prepared.max_rt, 5.2)
+
+  pcat.prepareMap(std::vector<Peak2D>(), prepared);
+  TEST_EQUAL(prepared.points.empty(), true)
+}
+END_SECTION
+
+START_SECTION((void run(const PreparedMap & map_model, const PreparedMap & map_scene, TransformationDescription & transformation)))
+{
+  std::vector<Peak2D> map_model, map_scene;
+  double map1_rt[] = {1.0, 5.0, 1.3, 2.2, 5.2};
+  double map2_rt[] = {1.4, 5.4, 4.4, 4.4, 5.8};
+  double map1_mz[] = {1.0 , 5.0 , 800, 900, 5.0 };
+  double map2_mz[] = {1.02, 5.02, 800, 900, 5.02};
+  double map1_int[] = {100, 100, 41, 20, 50};
+  double map2_int[] = {100, 100, 40, 20, 50};
+  for (Size i = 0; i < 5; i++)
+  {
+    Peak2D p;
+    p.setRT(map1_rt[i]);
+    p.setMZ(map1_mz[i]);
+    p.setIntensity(map1_int[i]);
+    map_model.push_back(p);
+    p.setRT(map2_rt[i]);
+    p.setMZ(map2_mz[i]);
+    p.setIntensity(map2_int[i]);
+    map_scene.push_back(p);
+  }
+
+  Param parameters;
+  parameters.setValue(String("scaling_bucket_size"), 0.01);
+  parameters.setValue(String("shift_bucket_size"), 0.1);
+  parameters.setValue(String("num_used_points"), 3);
+  PoseClusteringAffineSuperimposer pcat;
+  pcat.setParameters(parameters);
+
+  // a prepared reference can be used several times and gives the same result as the unprepared maps
+  PoseClusteringAffineSuperimposer::PreparedMap prepared_model, prepared_scene;
+  pcat.prepareMap(map_model, prepared_model);
+  pcat.prepareMap(map_scene, prepared_scene);
+  TransformationDescription expected;
+  pcat.run(map_model, map_scene, expected);
+  for (Size repeat = 0; repeat < 2; ++repeat)
+  {
+    TransformationDescription transformation;
+    pcat.run(prepared_model, prepared_scene, transformation);
+    TEST_STRING_EQUAL(transformation.getModelType(), "linear")
+    TEST_REAL_SIMILAR(transformation.getModelParameters().getValue("slope"), expected.getModelParameters().getValue("slope"))
+    TEST_REAL_SIMILAR(transformation.getModelParameters().getValue("intercept"), expected.getModelParameters().getValue("intercept"))
+    TEST_REAL_SIMILAR(transformation.getModelParameters().getValue("slope"), 0.977273)
+    TEST_REAL_SIMILAR(transformation.getModelParameters().getValue("intercept"), -0.368182)
+  }
+
+  TransformationDescription transformation;
+  TEST_EXCEPTION(Exception::IllegalArgument, pcat.run(prepared_model, PoseClusteringAffineSuperimposer::PreparedMap(), transformation))
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
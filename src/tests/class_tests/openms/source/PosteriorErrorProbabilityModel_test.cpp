@@ -329,6 +329,52 @@ END_SECTION
         }
     END_SECTION
 
+START_SECTION([EXTRA] fit on a subsample of the scores (max_fit_scores))
+{
+  vector<double> rand_score_vector;
+  CsvFile gauss_mix (OPENMS_GET_TEST_DATA_PATH("GaussMix_2_1D.csv"), ';');
+  StringList gauss_mix_strings;
+  gauss_mix.getRow(0, gauss_mix_strings);
+  for (const String& s : gauss_mix_strings)
+  {
+    if (!s.empty())
+    {
+      rand_score_vector.push_back(s.toDouble());
+    }
+  }
+  sort(rand_score_vector.begin(), rand_score_vector.end());
+
+  Param param;
+  param.setValue("incorrectly_assigned", "Gauss");
+  PosteriorErrorProbabilityModel full_model;
+  full_model.setParameters(param);
+  vector<double> full_probabilities;
+  full_model.fit(rand_score_vector, full_probabilities, "none");
+
+  param.setValue("max_fit_scores", 500);
+  PosteriorErrorProbabilityModel sample_model;
+  sample_model.setParameters(param);
+  vector<double> sample_probabilities;
+  sample_model.fit(rand_score_vector, sample_probabilities, "none");
+
+  // probabilities are reported for all scores, the transformation uses the smallest of all scores
+  TEST_EQUAL(sample_probabilities.size(), rand_score_vector.size())
+  TEST_REAL_SIMILAR(sample_model.getSmallestScore(), full_model.getSmallestScore())
+
+  // the quantile subsample represents the score distribution well
+  TOLERANCE_ABSOLUTE(0.2)
+  TEST_REAL_SIMILAR(sample_model.getCorrectlyAssignedFitResult().x0, full_model.getCorrectlyAssignedFitResult().x0)
+  TEST_REAL_SIMILAR(sample_model.getCorrectlyAssignedFitResult().sigma, full_model.getCorrectlyAssignedFitResult().sigma)
+  TEST_REAL_SIMILAR(sample_model.getIncorrectlyAssignedFitResult().x0, full_model.getIncorrectlyAssignedFitResult().x0)
+  TEST_REAL_SIMILAR(sample_model.getNegativePrior(), full_model.getNegativePrior())
+  TOLERANCE_ABSOLUTE(0.05)
+  for (Size i = 0; i < rand_score_vector.size(); i += 100)
+  {
+    TEST_REAL_SIMILAR(sample_probabilities[i], full_probabilities[i])
+  }
+}
+END_SECTION
+
 START_SECTION((const String getBothGnuplotFormula(const GaussFitter::GaussFitResult& incorrect, const GaussFitter::GaussFitResult& correct) const))
 NOT_TESTABLE
 delete ptr;
@@ -0,0 +1,218 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/ID/ProteinSuffixArray.h>
+///////////////////////////
+
+#include <OpenMS/DATASTRUCTURES/ListUtils.h>
+
+#include <algorithm>
+
+using namespace OpenMS;
+using namespace std;
+
+/// all hits of @p peptide as sorted "protein:position" strings
+vector<String> findHits(const ProteinSuffixArray& psa, const string& peptide, uint32_t max_aaa, uint32_t max_mm)
+{
+  vector<ProteinSuffixArray::T> positions;
+  psa.findAll(peptide, max_aaa, max_mm, positions);
+  vector<String> hits;
+  for (auto pos : positions)
+  {
+    Size prot = psa.proteinIndex(pos);
+    hits.push_back(String(prot) + ":" + String(pos - psa.proteinStart(prot)));
+  }
+  sort(hits.begin(), hits.end());
+  return hits;
+}
+
+START_TEST(ProteinSuffixArray, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+ProteinSuffixArray* ptr = nullptr;
+ProteinSuffixArray* null_ptr = nullptr;
+START_SECTION(ProteinSuffixArray())
+{
+  ptr = new ProteinSuffixArray();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->isBuilt(), false)
+}
+END_SECTION
+
+START_SECTION(~ProteinSuffixArray())
+{
+  delete ptr;
+}
+END_SECTION
+
+ProteinSuffixArray psa;
+psa.addProtein("PEPTIDEKPEPTIDER");
+psa.addProtein("AXXKPEPBIDE");
+psa.addProtein("peptide");
+
+START_SECTION(void addProtein(const std::string& sequence))
+{
+  TEST_EQUAL(psa.size(), 3)
+  TEST_EQUAL(psa.textSize(), 16 + 11 + 7 + 3) // including separators
+  TEST_EQUAL(psa.isBuilt(), false)
+}
+END_SECTION
+
+START_SECTION(void build())
+{
+  psa.build();
+  TEST_EQUAL(psa.isBuilt(), true)
+}
+END_SECTION
+
+START_SECTION(Size size() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(Size textSize() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(bool isBuilt() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(void findAll(const std::string& peptide, uint32_t max_aaa, uint32_t max_mm, std::vector<T>& positions) const)
+{
+  // exact (case-insensitive)
+  TEST_EQUAL(ListUtils::concatenate(findHits(psa, "PEPTIDE", 0, 0), ","), "0:0,0:8,2:0")
+  TEST_EQUAL(ListUtils::concatenate(findHits(psa, "IDER", 0, 0), ","), "0:12")
+  TEST_EQUAL(findHits(psa, "", 0, 0).size(), 0)
+  TEST_EQUAL(findHits(psa, "NOTTHERE", 0, 0).size(), 0)
+  // peptides do not span protein boundaries
+  TEST_EQUAL(findHits(psa, "PEPTIDERA", 3, 0).size(), 0)
+  // ambiguous AAs in the protein ('B' = D|N, 'X' = anything)
+  TEST_EQUAL(ListUtils::concatenate(findHits(psa, "PEPDIDE", 1, 0), ","), "1:4")
+  TEST_EQUAL(ListUtils::concatenate(findHits(psa, "PEPNIDE", 1, 0), ","), "1:4")
+  TEST_EQUAL(findHits(psa, "PEPTIDE", 1, 0).size(), 3) // 'B' cannot stand for 'T'
+  TEST_EQUAL(findHits(psa, "AMMK", 1, 0).size(), 0)
+  TEST_EQUAL(ListUtils::concatenate(findHits(psa, "AMMK", 2, 0), ","), "1:0")
+  // the literal ambiguous AA is free
+  TEST_EQUAL(ListUtils::concatenate(findHits(psa, "AXXK", 0, 0), ","), "1:0")
+  // mismatches
+  TEST_EQUAL(ListUtils::concatenate(findHits(psa, "PEPTIDE", 0, 1), ","), "0:0,0:8,1:4,2:0")
+  TEST_EQUAL(ListUtils::concatenate(findHits(psa, "PEPTIDEK", 0, 1), ","), "0:0,0:8")
+  // exhausted ambiguous AA budget: the mismatch budget is used instead
+  TEST_EQUAL(ListUtils::concatenate(findHits(psa, "AMMK", 1, 1), ","), "1:0")
+
+  // positions are reported once
+  ProteinSuffixArray repeats;
+  repeats.addProtein("XXXXXXXX");
+  repeats.build();
+  TEST_EQUAL(findHits(repeats, "AA", 2, 0).size(), 7)
+  TEST_EQUAL(findHits(repeats, "AA", 1, 1).size(), 7)
+  TEST_EQUAL(findHits(repeats, "XX", 0, 0).size(), 7)
+}
+END_SECTION
+
+START_SECTION(Size proteinIndex(T pos) const)
+{
+  TEST_EQUAL(psa.proteinIndex(0), 0)
+  TEST_EQUAL(psa.proteinIndex(15), 0)
+  TEST_EQUAL(psa.proteinIndex(17), 1)
+  TEST_EQUAL(psa.proteinIndex(29), 2)
+}
+END_SECTION
+
+START_SECTION(T proteinStart(Size index) const)
+{
+  TEST_EQUAL(psa.proteinStart(0), 0)
+  TEST_EQUAL(psa.proteinStart(1), 17)
+  TEST_EQUAL(psa.proteinStart(2), 29)
+}
+END_SECTION
+
+START_SECTION(String proteinSequence(Size index) const)
+{
+  TEST_EQUAL(psa.proteinSequence(0), "PEPTIDEKPEPTIDER")
+  TEST_EQUAL(psa.proteinSequence(1), "AXXKPEPBIDE")
+  TEST_EQUAL(psa.proteinSequence(2), "peptide")
+}
+END_SECTION
+
+START_SECTION(void store(const String& filename) const)
+{
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  psa.store(tmp_filename);
+
+  ProteinSuffixArray loaded;
+  loaded.addProtein("PEPTIDEKPEPTIDER");
+  loaded.addProtein("AXXKPEPBIDE");
+  loaded.addProtein("peptide");
+  TEST_EQUAL(loaded.load(tmp_filename), true)
+  TEST_EQUAL(loaded.isBuilt(), true)
+  TEST_EQUAL(findHits(loaded, "PEPTIDE", 0, 1) == findHits(psa, "PEPTIDE", 0, 1), true)
+}
+END_SECTION
+
+START_SECTION(bool load(const String& filename))
+{
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  psa.store(tmp_filename);
+
+  // different database: not loaded
+  ProteinSuffixArray other;
+  other.addProtein("PEPTIDEKPEPTIDER");
+  other.addProtein("AXXKPEPBIDE");
+  other.addProtein("PEPTIDE");
+  TEST_EQUAL(other.load(tmp_filename), false)
+  TEST_EQUAL(other.isBuilt(), false)
+
+  TEST_EXCEPTION(Exception::FileNotFound, other.load("doesnotexist.bin"))
+  TEST_EXCEPTION(Exception::ParseError, other.load(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta")))
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,176 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/ReadAheadIfstream.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/GzipIfstream.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+using namespace OpenMS;
+
+START_TEST(ReadAheadIfstream, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+ReadAheadIfstream* ptr = nullptr;
+ReadAheadIfstream* nullPointer = nullptr;
+START_SECTION((ReadAheadIfstream()))
+  ptr = new ReadAheadIfstream;
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->isOpen(), false)
+  TEST_EQUAL(ptr->streamEnd(), true)
+END_SECTION
+
+START_SECTION((virtual ~ReadAheadIfstream()))
+  delete ptr;
+END_SECTION
+
+START_SECTION(ReadAheadIfstream(const char * filename, CompressionType type = AUTO))
+  TEST_EXCEPTION(Exception::FileNotFound, ReadAheadIfstream r(OPENMS_GET_TEST_DATA_PATH("ThisFileDoesNotExist")))
+
+  ReadAheadIfstream gzip(OPENMS_GET_TEST_DATA_PATH("GzipIfStream_1.gz"));
+  TEST_EQUAL(gzip.streamEnd(), false)
+  TEST_EQUAL(gzip.isOpen(), true)
+  char buffer[30];
+  buffer[29] = '\0';
+  TEST_EQUAL(gzip.read(buffer, 29), 29)
+  TEST_EQUAL(String(buffer), String("Was decompression successful?"))
+
+  ReadAheadIfstream bzip2(OPENMS_GET_TEST_DATA_PATH("Bzip2IfStream_1.bz2"), ReadAheadIfstream::BZIP2);
+  TEST_EQUAL(bzip2.isOpen(), true)
+  TEST_EQUAL(bzip2.read(buffer, 29), 29)
+  TEST_EQUAL(String(buffer), String("Was decompression successful?"))
+END_SECTION
+
+START_SECTION(void open(const char * filename, CompressionType type = AUTO))
+  ReadAheadIfstream r;
+  TEST_EXCEPTION(Exception::FileNotFound, r.open(OPENMS_GET_TEST_DATA_PATH("ThisFileDoesNotExist")))
+  TEST_EQUAL(r.isOpen(), false)
+
+  // bzip2 is detected from the magic bytes
+  r.open(OPENMS_GET_TEST_DATA_PATH("Bzip2IfStream_1.bz2"));
+  TEST_EQUAL(r.streamEnd(), false)
+  TEST_EQUAL(r.isOpen(), true)
+  char buffer[30];
+  buffer[29] = '\0';
+  TEST_EQUAL(r.read(buffer, 29), 29)
+  TEST_EQUAL(String(buffer), String("Was decompression successful?"))
+
+  // re-open while the previous file is not read completely
+  r.open(OPENMS_GET_TEST_DATA_PATH("GzipIfStream_1.gz"));
+  TEST_EQUAL(r.read(buffer, 29), 29)
+  TEST_EQUAL(String(buffer), String("Was decompression successful?"))
+END_SECTION
+
+START_SECTION(size_t read(char * s, size_t n))
+  char buffer[30];
+  ReadAheadIfstream r(OPENMS_GET_TEST_DATA_PATH("GzipIfStream_1.gz"));
+  TEST_EQUAL(r.read(buffer, 29), 29)
+  // 30 bytes in total: the rest is returned and the stream is closed
+  TEST_EQUAL(r.read(buffer, 10), 1)
+  TEST_EQUAL(r.isOpen(), false)
+  TEST_EQUAL(r.streamEnd(), true)
+  TEST_EXCEPTION(Exception::IllegalArgument, r.read(buffer, 10))
+
+  // errors of the background thread are reported by read()
+  r.open(OPENMS_GET_TEST_DATA_PATH("GzipIfStream_1_corrupt.gz"));
+  char large_buffer[1000];
+  TEST_EXCEPTION(Exception::ConversionError, while (r.isOpen()) r.read(large_buffer, 1000))
+  TEST_EQUAL(r.isOpen(), false)
+
+  // small chunks: data is passed through the queue in many pieces and matches GzipIfstream
+  r.setBufferSize(7, 2);
+  r.open(OPENMS_GET_TEST_DATA_PATH("MzMLFile_6_uncompressed.mzML.gz"));
+  GzipIfstream gzip(OPENMS_GET_TEST_DATA_PATH("MzMLFile_6_uncompressed.mzML.gz"));
+  std::string read_ahead, direct;
+  while (r.isOpen())
+  {
+    size_t n = r.read(large_buffer, 13);
+    read_ahead.append(large_buffer, n);
+  }
+  while (gzip.isOpen())
+  {
+    size_t n = gzip.read(large_buffer, 1000);
+    direct.append(large_buffer, n);
+  }
+  TEST_EQUAL(read_ahead.size(), direct.size())
+  TEST_EQUAL(read_ahead == direct, true)
+END_SECTION
+
+START_SECTION(bool streamEnd() const)
+  // tested above
+  NOT_TESTABLE
+END_SECTION
+
+START_SECTION(bool isOpen() const)
+  // tested above
+  NOT_TESTABLE
+END_SECTION
+
+START_SECTION(void close())
+  ReadAheadIfstream r;
+  r.setBufferSize(3, 1);
+  r.open(OPENMS_GET_TEST_DATA_PATH("MzMLFile_6_uncompressed.mzML.gz"));
+  char buffer[5];
+  r.read(buffer, 5);
+  // background thread is blocked on the full queue
+  r.close();
+  TEST_EQUAL(r.isOpen(), false)
+  TEST_EQUAL(r.streamEnd(), true)
+  r.close(); // closing twice is fine
+  TEST_EQUAL(r.isOpen(), false)
+END_SECTION
+
+START_SECTION(void setBufferSize(Size chunk_size, Size max_chunks))
+  // tested in read()
+  NOT_TESTABLE
+END_SECTION
+
+START_SECTION(static bool isCompressed(const char * filename))
+  TEST_EQUAL(ReadAheadIfstream::isCompressed(OPENMS_GET_TEST_DATA_PATH("GzipIfStream_1.gz")), true)
+  TEST_EQUAL(ReadAheadIfstream::isCompressed(OPENMS_GET_TEST_DATA_PATH("Bzip2IfStream_1.bz2")), true)
+  TEST_EQUAL(ReadAheadIfstream::isCompressed(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta")), false)
+  TEST_EQUAL(ReadAheadIfstream::isCompressed(OPENMS_GET_TEST_DATA_PATH("ThisFileDoesNotExist")), false)
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
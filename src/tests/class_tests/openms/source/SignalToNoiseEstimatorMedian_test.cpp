@@ -114,6 +114,40 @@ START_SECTION([EXTRA](virtual void init(const Container& c)))
 
 END_SECTION
 
+START_SECTION([EXTRA] median_search 'incremental' and 'scan' give identical results)
+  MSSpectrum raw_data;
+  DTAFile().load(OPENMS_GET_TEST_DATA_PATH("SignalToNoiseEstimator_test.dta"), raw_data);
+
+  for (int bin_count : {3, 30, 1000})
+  {
+    for (double win_len : {5.0, 40.0, 200.0})
+    {
+      Param p;
+      p.setValue("win_len", win_len);
+      p.setValue("bin_count", bin_count);
+      p.setValue("min_required_elements", 3);
+      p.setValue("write_log_messages", "false");
+
+      SignalToNoiseEstimatorMedian<> sne_scan, sne_incremental;
+      p.setValue("median_search", "scan");
+      sne_scan.setParameters(p);
+      sne_scan.init(raw_data);
+      p.setValue("median_search", "incremental");
+      sne_incremental.setParameters(p);
+      sne_incremental.init(raw_data);
+
+      Size mismatches = 0;
+      for (Size i = 0; i < raw_data.size(); ++i)
+      {
+        if (sne_scan.getSignalToNoise(i) != sne_incremental.getSignalToNoise(i)) ++mismatches;
+      }
+      TEST_EQUAL(mismatches, 0)
+      TEST_EQUAL(sne_scan.getSparseWindowPercent(), sne_incremental.getSparseWindowPercent())
+      TEST_EQUAL(sne_scan.getHistogramRightmostPercent(), sne_incremental.getHistogramRightmostPercent())
+    }
+  }
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
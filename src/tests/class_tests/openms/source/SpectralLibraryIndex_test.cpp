@@ -0,0 +1,204 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/COMPARISON/SPECTRA/SpectralLibraryIndex.h>
+///////////////////////////
+
+#include <OpenMS/KERNEL/MSSpectrum.h>
+
+using namespace OpenMS;
+using namespace std;
+
+MSSpectrum makeSpectrum(const vector<pair<double, double> >& peaks)
+{
+  MSSpectrum s;
+  for (const auto& p : peaks)
+  {
+    s.push_back(Peak1D(p.first, p.second));
+  }
+  return s;
+}
+
+START_TEST(SpectralLibraryIndex, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+SpectralLibraryIndex* ptr = nullptr;
+SpectralLibraryIndex* null_ptr = nullptr;
+START_SECTION(SpectralLibraryIndex(double bin_size = 1.0005, double bin_offset = 0.4))
+{
+  ptr = new SpectralLibraryIndex();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EXCEPTION(Exception::InvalidValue, SpectralLibraryIndex(0.0))
+}
+END_SECTION
+
+START_SECTION(~SpectralLibraryIndex())
+{
+  delete ptr;
+}
+END_SECTION
+
+// bin width 1, no offset: bin index == floor(m/z)
+SpectralLibraryIndex index(1.0, 0.0);
+MSSpectrum lib1 = makeSpectrum({{100.2, 3.0}, {200.5, 4.0}});
+MSSpectrum lib2 = makeSpectrum({{100.1, 1.0}, {100.7, 1.0}, {300.0, 0.0}}); // same bin merged, zero dropped
+MSSpectrum lib3 = makeSpectrum({{150.0, 2.0}, {250.0, 2.0}});
+
+START_SECTION(Size getBinIndex(double mz) const)
+{
+  TEST_EQUAL(index.getBinIndex(100.2), 100)
+  TEST_EQUAL(index.getBinIndex(0.5), 0)
+  TEST_EQUAL(index.getBinIndex(-1.0), 0)
+  TEST_EQUAL(SpectralLibraryIndex(1.0, 0.5).getBinIndex(100.6), 101)
+}
+END_SECTION
+
+START_SECTION(void addSpectrum(double precursor_mz, const MSSpectrum& spectrum))
+{
+  index.addSpectrum(400.0, lib1);
+  index.addSpectrum(500.0, lib2);
+  index.addSpectrum(500.0, lib3);
+  TEST_EQUAL(index.size(), 3)
+  TEST_EXCEPTION(Exception::IllegalArgument, index.addSpectrum(450.0, lib1))
+  TEST_EQUAL(index.size(), 3)
+}
+END_SECTION
+
+START_SECTION(void addPrecursor(double precursor_mz))
+{
+  SpectralLibraryIndex precursors_only;
+  precursors_only.addPrecursor(400.0);
+  precursors_only.addSpectrum(500.0, lib2);
+  precursors_only.addPrecursor(600.0);
+  TEST_EQUAL(precursors_only.size(), 3)
+  TEST_EXCEPTION(Exception::IllegalArgument, precursors_only.addPrecursor(450.0))
+  TEST_EQUAL(precursors_only.getPrecursorRange(350.0, 650.0).second, 3)
+  vector<float> dense, scores;
+  precursors_only.prepareQuery(lib2, dense);
+  precursors_only.scoreCandidates(dense, 0, 3, scores);
+  ABORT_IF(scores.size() != 3)
+  TEST_REAL_SIMILAR(scores[0], 0.0)
+  TEST_REAL_SIMILAR(scores[1], 1.0)
+  TEST_REAL_SIMILAR(scores[2], 0.0)
+}
+END_SECTION
+
+START_SECTION(Size size() const)
+{
+  TEST_EQUAL(index.size(), 3)
+}
+END_SECTION
+
+START_SECTION(double getPrecursorMZ(Size index) const)
+{
+  TEST_REAL_SIMILAR(index.getPrecursorMZ(0), 400.0)
+  TEST_REAL_SIMILAR(index.getPrecursorMZ(2), 500.0)
+}
+END_SECTION
+
+START_SECTION((std::pair<Size, Size> getPrecursorRange(double mz_low, double mz_high) const))
+{
+  pair<Size, Size> r = index.getPrecursorRange(399.0, 401.0);
+  TEST_EQUAL(r.first, 0)
+  TEST_EQUAL(r.second, 1)
+  r = index.getPrecursorRange(400.0, 500.0); // inclusive on both ends
+  TEST_EQUAL(r.first, 0)
+  TEST_EQUAL(r.second, 3)
+  r = index.getPrecursorRange(450.0, 460.0);
+  TEST_EQUAL(r.first, r.second)
+  r = index.getPrecursorRange(600.0, 700.0);
+  TEST_EQUAL(r.first, 3)
+  TEST_EQUAL(r.second, 3)
+}
+END_SECTION
+
+START_SECTION(void prepareQuery(const MSSpectrum& query, std::vector<float>& dense_query) const)
+{
+  vector<float> dense;
+  // peak at 900 lies beyond all library bins and is ignored for the dense vector
+  index.prepareQuery(makeSpectrum({{100.5, 3.0}, {200.1, 4.0}, {900.0, 1.0}}), dense);
+  TEST_EQUAL(dense.size(), 251)
+  float norm = sqrt(26.0f);
+  TEST_REAL_SIMILAR(dense[100], 3.0 / norm)
+  TEST_REAL_SIMILAR(dense[200], 4.0 / norm)
+  TEST_REAL_SIMILAR(dense[150], 0.0)
+}
+END_SECTION
+
+START_SECTION(void scoreCandidates(const std::vector<float>& dense_query, Size first, Size last, std::vector<float>& scores) const)
+{
+  vector<float> dense, scores;
+  index.prepareQuery(lib1, dense);
+  index.scoreCandidates(dense, 0, 3, scores);
+  TEST_EQUAL(scores.size(), 3)
+  TEST_REAL_SIMILAR(scores[0], 1.0)                // identical spectrum
+  TEST_REAL_SIMILAR(scores[1], 3.0 / 5.0)          // lib2 collapses to a single bin at 100
+  TEST_REAL_SIMILAR(scores[2], 0.0)                // no shared bins
+
+  index.scoreCandidates(dense, 1, 2, scores);
+  TEST_EQUAL(scores.size(), 1)
+  TEST_REAL_SIMILAR(scores[0], 3.0 / 5.0)
+
+  // 'last' is clipped to the library size
+  index.scoreCandidates(dense, 2, 10, scores);
+  TEST_EQUAL(scores.size(), 1)
+
+  vector<float> wrong_size(3, 0.0f);
+  TEST_EXCEPTION(Exception::InvalidSize, index.scoreCandidates(wrong_size, 0, 3, scores))
+}
+END_SECTION
+
+START_SECTION(void clear())
+{
+  index.clear();
+  TEST_EQUAL(index.size(), 0)
+  vector<float> dense;
+  index.prepareQuery(lib1, dense);
+  TEST_EQUAL(dense.size(), 1)
+  index.addSpectrum(100.0, lib3); // order check restarts after clear()
+  TEST_EQUAL(index.size(), 1)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
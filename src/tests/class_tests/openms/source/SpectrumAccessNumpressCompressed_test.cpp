@@ -0,0 +1,253 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessNumpressCompressed.h>
+///////////////////////////
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(SpectrumAccessNumpressCompressed, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+boost::shared_ptr<PeakMap> exp(new PeakMap);
+for (Size i = 0; i < 10; ++i)
+{
+  MSSpectrum s;
+  s.setRT(100.0 + i);
+  s.setMSLevel(1);
+  s.setNativeID(String("spectrum=") + i);
+  s.getFloatDataArrays().resize(2);
+  s.getFloatDataArrays()[0].setName("Ion Mobility");
+  s.getFloatDataArrays()[1].setName("mass error");
+  for (Size k = 0; k < 50; ++k)
+  {
+    s.push_back(Peak1D(400.0 + k * 1.0123 + i * 0.001, 1000.0 + k * 37.5 + i));
+    s.getFloatDataArrays()[0].push_back(1.2f - k * 0.01f);
+    s.getFloatDataArrays()[1].push_back(k * 0.1f - 2.0f); // negative values cannot be encoded using slof
+  }
+  exp->addSpectrum(s);
+}
+MSChromatogram c;
+c.setNativeID("chrom");
+for (Size k = 0; k < 20; ++k)
+{
+  c.push_back(ChromatogramPeak(100.0 + k * 0.5, 10.0 * k));
+}
+exp->addChromatogram(c);
+
+OpenSwath::SpectrumAccessPtr expptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+
+SpectrumAccessNumpressCompressed* ptr = nullptr;
+SpectrumAccessNumpressCompressed* nullPointer = nullptr;
+
+START_SECTION(SpectrumAccessNumpressCompressed(OpenSwath::ISpectrumAccess & origin, Size cache_size = 32, double linear_fp_mass_acc = -1))
+{
+  ptr = new SpectrumAccessNumpressCompressed(*expptr);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getNrSpectra(), 10)
+  TEST_EQUAL(ptr->getNrChromatograms(), 1)
+  TEST_EQUAL(ptr->getNrCachedSpectra(), 0)
+}
+END_SECTION
+
+START_SECTION(~SpectrumAccessNumpressCompressed())
+{
+  delete ptr;
+}
+END_SECTION
+
+SpectrumAccessNumpressCompressed compressed(*expptr, 3);
+
+START_SECTION(Size getCompressedSize() const)
+{
+  // 10 spectra with 50 peaks (m/z, intensity and two float arrays) and a chromatogram with 20 peaks as doubles
+  Size uncompressed = (10 * 50 * 4 + 20 * 2) * sizeof(double);
+  TEST_NOT_EQUAL(compressed.getCompressedSize(), 0)
+  TEST_EQUAL(compressed.getCompressedSize() < uncompressed / 2, true)
+}
+END_SECTION
+
+START_SECTION(OpenSwath::SpectrumPtr getSpectrumById(int id))
+{
+  OpenSwath::SpectrumPtr orig = expptr->getSpectrumById(4);
+  OpenSwath::SpectrumPtr spec = compressed.getSpectrumById(4);
+  TEST_EQUAL(spec->getMZArray()->data.size(), 50)
+  TEST_EQUAL(spec->getIntensityArray()->data.size(), 50)
+  ABORT_IF(spec->getMZArray()->data.size() != 50)
+  TOLERANCE_ABSOLUTE(1e-4)
+  for (Size k = 0; k < 50; ++k)
+  {
+    TEST_REAL_SIMILAR(spec->getMZArray()->data[k], orig->getMZArray()->data[k])
+  }
+  TOLERANCE_ABSOLUTE(1.0)
+  TOLERANCE_RELATIVE(1.0 + 5e-4)
+  for (Size k = 0; k < 50; ++k)
+  {
+    TEST_REAL_SIMILAR(spec->getIntensityArray()->data[k], orig->getIntensityArray()->data[k])
+  }
+
+  // additional arrays keep their description; they are encoded linear (ion mobility, negative values)
+  TEST_EQUAL(spec->getDataArrays().size(), 4)
+  ABORT_IF(spec->getDataArrays().size() != 4)
+  TOLERANCE_RELATIVE(1.0)
+  TOLERANCE_ABSOLUTE(1e-4)
+  for (Size a = 2; a < 4; ++a)
+  {
+    TEST_EQUAL(spec->getDataArrays()[a]->description, orig->getDataArrays()[a]->description)
+    TEST_EQUAL(spec->getDataArrays()[a]->data.size(), 50)
+    for (Size k = 0; k < spec->getDataArrays()[a]->data.size(); ++k)
+    {
+      TEST_REAL_SIMILAR(spec->getDataArrays()[a]->data[k], orig->getDataArrays()[a]->data[k])
+    }
+  }
+}
+END_SECTION
+
+START_SECTION(Size getNrCachedSpectra() const)
+{
+  SpectrumAccessNumpressCompressed access(*expptr, 3);
+  OpenSwath::SpectrumPtr first = access.getSpectrumById(0);
+  TEST_EQUAL(access.getNrCachedSpectra(), 1)
+  // cached: same object is returned
+  TEST_EQUAL(access.getSpectrumById(0) == first, true)
+  access.getSpectrumById(1);
+  access.getSpectrumById(2);
+  TEST_EQUAL(access.getNrCachedSpectra(), 3)
+  access.getSpectrumById(0); // 0 is now most recently used
+  access.getSpectrumById(3); // evicts 1
+  TEST_EQUAL(access.getNrCachedSpectra(), 3)
+  TEST_EQUAL(access.getSpectrumById(0) == first, true)
+  access.getSpectrumById(4); // evicts 2
+  access.getSpectrumById(5); // evicts 3
+  access.getSpectrumById(6); // evicts 0
+  TEST_EQUAL(access.getSpectrumById(0) == first, false)
+
+  // no caching
+  SpectrumAccessNumpressCompressed uncached(*expptr, 0);
+  first = uncached.getSpectrumById(0);
+  TEST_EQUAL(uncached.getNrCachedSpectra(), 0)
+  TEST_EQUAL(uncached.getSpectrumById(0) == first, false)
+}
+END_SECTION
+
+START_SECTION(boost::shared_ptr<OpenSwath::ISpectrumAccess> lightClone() const)
+{
+  compressed.getSpectrumById(1);
+  boost::shared_ptr<OpenSwath::ISpectrumAccess> clone = compressed.lightClone();
+  TEST_EQUAL(clone->getNrSpectra(), 10)
+  TEST_EQUAL(clone->getNrChromatograms(), 1)
+  // each clone has its own (empty) cache
+  TEST_EQUAL(boost::dynamic_pointer_cast<SpectrumAccessNumpressCompressed>(clone)->getNrCachedSpectra(), 0)
+  TEST_EQUAL(clone->getSpectrumById(1)->getMZArray()->data.size(), 50)
+}
+END_SECTION
+
+START_SECTION(SpectrumAccessNumpressCompressed(const SpectrumAccessNumpressCompressed & rhs))
+{
+  SpectrumAccessNumpressCompressed copy(compressed);
+  TEST_EQUAL(copy.getNrSpectra(), 10)
+  TEST_EQUAL(copy.getCompressedSize(), compressed.getCompressedSize())
+  TEST_EQUAL(copy.getNrCachedSpectra(), 0)
+}
+END_SECTION
+
+START_SECTION(OpenSwath::SpectrumMeta getSpectrumMetaById(int id) const)
+{
+  OpenSwath::SpectrumMeta meta = compressed.getSpectrumMetaById(3);
+  TEST_REAL_SIMILAR(meta.RT, 103.0)
+  TEST_EQUAL(meta.ms_level, 1)
+  TEST_EQUAL(meta.id, "spectrum=3")
+}
+END_SECTION
+
+START_SECTION(std::vector<std::size_t> getSpectraByRT(double RT, double deltaRT) const)
+{
+  std::vector<std::size_t> result = compressed.getSpectraByRT(104.0, 1.5);
+  TEST_EQUAL(result.size(), 3)
+  ABORT_IF(result.size() != 3)
+  TEST_EQUAL(result[0], 3)
+  TEST_EQUAL(result[2], 5)
+
+  // range at the end of the run
+  result = compressed.getSpectraByRT(109.0, 0.5);
+  TEST_EQUAL(result.size(), 1)
+  TEST_EQUAL(compressed.getSpectraByRT(200.0, 1.0).size(), 0)
+}
+END_SECTION
+
+START_SECTION(size_t getNrSpectra() const)
+{
+  TEST_EQUAL(compressed.getNrSpectra(), 10)
+}
+END_SECTION
+
+START_SECTION(OpenSwath::ChromatogramPtr getChromatogramById(int id))
+{
+  OpenSwath::ChromatogramPtr chrom = compressed.getChromatogramById(0);
+  TEST_EQUAL(chrom->getTimeArray()->data.size(), 20)
+  TEST_EQUAL(chrom->getIntensityArray()->data.size(), 20)
+  ABORT_IF(chrom->getTimeArray()->data.size() != 20)
+  TOLERANCE_ABSOLUTE(1e-3)
+  TEST_REAL_SIMILAR(chrom->getTimeArray()->data[3], 101.5)
+  TOLERANCE_ABSOLUTE(0.1)
+  TEST_REAL_SIMILAR(chrom->getIntensityArray()->data[3], 30.0)
+}
+END_SECTION
+
+START_SECTION(size_t getNrChromatograms() const)
+{
+  TEST_EQUAL(compressed.getNrChromatograms(), 1)
+}
+END_SECTION
+
+START_SECTION(std::string getChromatogramNativeID(int id) const)
+{
+  TEST_EQUAL(compressed.getChromatogramNativeID(0), "chrom")
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,313 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/KERNEL/SpectrumColumns.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(SpectrumColumns, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// spectrum with peaks (m/z, intensity): (500, 1), (501, 5), (502, 3), (503, 5), (504, 2) and one data array of each type
+MSSpectrum spec;
+spec.setRT(12.3);
+spec.setMSLevel(2);
+{
+  const float intensities[] = {1, 5, 3, 5, 2};
+  MSSpectrum::FloatDataArray fda;
+  fda.setName("f");
+  MSSpectrum::StringDataArray sda;
+  sda.setName("s");
+  MSSpectrum::IntegerDataArray ida;
+  ida.setName("i");
+  for (Size i = 0; i < 5; ++i)
+  {
+    spec.push_back(Peak1D(500.0 + i, intensities[i]));
+    fda.push_back(10.0f * i);
+    sda.push_back(String(i));
+    ida.push_back(Int(i));
+  }
+  spec.getFloatDataArrays().push_back(fda);
+  spec.getStringDataArrays().push_back(sda);
+  spec.getIntegerDataArrays().push_back(ida);
+}
+
+SpectrumColumns* ptr = nullptr;
+SpectrumColumns* null_ptr = nullptr;
+START_SECTION(SpectrumColumns())
+{
+  ptr = new SpectrumColumns();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->empty(), true)
+}
+END_SECTION
+
+START_SECTION(~SpectrumColumns())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(explicit SpectrumColumns(const MSSpectrum& spectrum))
+{
+  SpectrumColumns sc(spec);
+  TEST_EQUAL(sc.size(), 5)
+  TEST_REAL_SIMILAR(sc.getMZ(1), 501.0)
+  TEST_REAL_SIMILAR(sc.getIntensity(1), 5.0)
+  TEST_EQUAL(sc.getFloatDataArrays().size(), 1)
+  TEST_EQUAL(sc.getFloatDataArrays()[0].getName(), "f")
+  TEST_EQUAL(sc.getStringDataArrays()[0][3], "3")
+  TEST_EQUAL(sc.getIntegerDataArrays()[0][4], 4)
+}
+END_SECTION
+
+START_SECTION(bool operator==(const SpectrumColumns& rhs) const)
+{
+  SpectrumColumns a(spec), b(spec);
+  TEST_EQUAL(a == b, true)
+  b.getIntensityArray()[0] = 2;
+  TEST_EQUAL(a == b, false)
+}
+END_SECTION
+
+START_SECTION(bool operator!=(const SpectrumColumns& rhs) const)
+{
+  SpectrumColumns a(spec), b(spec);
+  TEST_EQUAL(a != b, false)
+  b.getFloatDataArrays().clear();
+  TEST_EQUAL(a != b, true)
+}
+END_SECTION
+
+START_SECTION(void assign(const MSSpectrum& spectrum))
+{
+  SpectrumColumns sc;
+  sc.push_back(1.0, 1.0f);
+  sc.assign(spec);
+  TEST_EQUAL(sc == SpectrumColumns(spec), true)
+  sc.assign(MSSpectrum());
+  TEST_EQUAL(sc.empty(), true)
+  TEST_EQUAL(sc.getFloatDataArrays().empty(), true)
+}
+END_SECTION
+
+START_SECTION(void exportTo(MSSpectrum& spectrum) const)
+{
+  SpectrumColumns sc(spec);
+  MSSpectrum out;
+  out.setRT(99.0);
+  out.push_back(Peak1D(1.0, 1.0f));
+  sc.exportTo(out);
+  TEST_REAL_SIMILAR(out.getRT(), 99.0) // meta data is kept
+  TEST_EQUAL(out.size(), 5)
+  for (Size i = 0; i < spec.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(out[i].getMZ(), spec[i].getMZ())
+    TEST_REAL_SIMILAR(out[i].getIntensity(), spec[i].getIntensity())
+  }
+  TEST_EQUAL(out.getFloatDataArrays() == spec.getFloatDataArrays(), true)
+  TEST_EQUAL(out.getStringDataArrays() == spec.getStringDataArrays(), true)
+  TEST_EQUAL(out.getIntegerDataArrays() == spec.getIntegerDataArrays(), true)
+}
+END_SECTION
+
+START_SECTION(void clear())
+{
+  SpectrumColumns sc(spec);
+  sc.clear();
+  TEST_EQUAL(sc.size(), 0)
+  TEST_EQUAL(sc.getStringDataArrays().size(), 0)
+}
+END_SECTION
+
+START_SECTION(void push_back(double mz, float intensity))
+{
+  SpectrumColumns sc;
+  sc.reserve(2);
+  sc.push_back(100.0, 2.0f);
+  sc.push_back(200.0, 4.0f);
+  TEST_EQUAL(sc.size(), 2)
+  TEST_REAL_SIMILAR(sc.getMZArray()[1], 200.0)
+  TEST_REAL_SIMILAR(sc.getIntensityArray()[1], 4.0)
+}
+END_SECTION
+
+START_SECTION(bool isSorted() const)
+{
+  SpectrumColumns sc(spec);
+  TEST_EQUAL(sc.isSorted(), true)
+  std::swap(sc.getMZArray()[0], sc.getMZArray()[1]);
+  TEST_EQUAL(sc.isSorted(), false)
+}
+END_SECTION
+
+START_SECTION(void sortByIntensity(bool reverse = false))
+{
+  // must match the (stable) MSSpectrum::sortByIntensity, including the data arrays
+  for (bool reverse : {false, true})
+  {
+    MSSpectrum s(spec);
+    s.sortByIntensity(reverse);
+    SpectrumColumns sc(spec);
+    sc.sortByIntensity(reverse);
+    TEST_EQUAL(sc == SpectrumColumns(s), true)
+  }
+  SpectrumColumns sc(spec);
+  sc.sortByIntensity(true);
+  ABORT_IF(sc.size() != 5)
+  TEST_REAL_SIMILAR(sc.getMZ(0), 501.0)
+  TEST_REAL_SIMILAR(sc.getMZ(1), 503.0)
+  TEST_EQUAL(sc.getIntegerDataArrays()[0][0], 1)
+  TEST_EQUAL(sc.getIntegerDataArrays()[0][1], 3)
+}
+END_SECTION
+
+START_SECTION(void sortByPosition())
+{
+  SpectrumColumns sc(spec);
+  sc.sortByIntensity();
+  sc.sortByPosition();
+  TEST_EQUAL(sc == SpectrumColumns(spec), true)
+}
+END_SECTION
+
+START_SECTION(void select(const std::vector<Size>& indices))
+{
+  SpectrumColumns sc(spec);
+  sc.select({4, 0});
+  ABORT_IF(sc.size() != 2)
+  TEST_REAL_SIMILAR(sc.getMZ(0), 504.0)
+  TEST_REAL_SIMILAR(sc.getIntensity(1), 1.0)
+  TEST_EQUAL(sc.getStringDataArrays()[0][0], "4")
+  TEST_REAL_SIMILAR(sc.getFloatDataArrays()[0][1], 0.0)
+  TEST_EQUAL(sc.getFloatDataArrays()[0].getName(), "f")
+
+  // data arrays of wrong size
+  SpectrumColumns sc2(spec);
+  sc2.getFloatDataArrays()[0].pop_back();
+  TEST_EXCEPTION(Exception::Precondition, sc2.select({0}))
+
+  // nothing is reordered if a later data array has the wrong size
+  SpectrumColumns sc3(spec);
+  sc3.getIntegerDataArrays()[0].pop_back();
+  TEST_EXCEPTION(Exception::Precondition, sc3.select({4, 0}))
+  TEST_EQUAL(sc3.size(), 5)
+  TEST_EQUAL(sc3.getFloatDataArrays()[0].size(), 5)
+  TEST_REAL_SIMILAR(sc3.getFloatDataArrays()[0][0], 0.0)
+  TEST_EQUAL(sc3.getStringDataArrays()[0][0], "0")
+}
+END_SECTION
+
+START_SECTION(Size MZBegin(double mz) const)
+{
+  SpectrumColumns sc(spec);
+  TEST_EQUAL(sc.MZBegin(400.0), 0)
+  TEST_EQUAL(sc.MZBegin(501.0), 1)
+  TEST_EQUAL(sc.MZBegin(501.5), 2)
+  TEST_EQUAL(sc.MZBegin(600.0), 5)
+  TEST_EQUAL(sc.MZBegin(501.5), spec.MZBegin(501.5) - spec.begin())
+}
+END_SECTION
+
+START_SECTION(Size MZEnd(double mz) const)
+{
+  SpectrumColumns sc(spec);
+  TEST_EQUAL(sc.MZEnd(501.0), 2)
+  TEST_EQUAL(sc.MZEnd(600.0), 5)
+  TEST_EQUAL(sc.MZEnd(501.0), spec.MZEnd(501.0) - spec.begin())
+}
+END_SECTION
+
+START_SECTION(Size findNearest(double mz) const)
+{
+  SpectrumColumns sc(spec);
+  for (double mz : {0.0, 500.4, 500.5, 500.6, 503.9, 1000.0})
+  {
+    TEST_EQUAL(sc.findNearest(mz), spec.findNearest(mz))
+  }
+  TEST_EXCEPTION(Exception::Precondition, SpectrumColumns().findNearest(500.0))
+}
+END_SECTION
+
+START_SECTION(Int findNearest(double mz, double tolerance) const)
+{
+  SpectrumColumns sc(spec);
+  TEST_EQUAL(sc.findNearest(502.3, 0.5), 2)
+  TEST_EQUAL(sc.findNearest(502.3, 0.2), -1)
+  TEST_EQUAL(sc.findNearest(1000.0, 0.2), -1)
+  TEST_EQUAL(SpectrumColumns().findNearest(500.0, 1.0), -1)
+}
+END_SECTION
+
+START_SECTION(Int findNearest(double mz, double tolerance_left, double tolerance_right) const)
+{
+  SpectrumColumns sc(spec);
+  for (double mz : {499.0, 500.3, 500.7, 502.5, 505.0})
+  {
+    TEST_EQUAL(sc.findNearest(mz, 0.4, 0.1), spec.findNearest(mz, 0.4, 0.1))
+    TEST_EQUAL(sc.findNearest(mz, 0.1, 0.4), spec.findNearest(mz, 0.1, 0.4))
+  }
+  TEST_EQUAL(SpectrumColumns().findNearest(500.0, 1.0, 1.0), -1)
+}
+END_SECTION
+
+START_SECTION(double calculateTIC() const)
+{
+  SpectrumColumns sc(spec);
+  TEST_REAL_SIMILAR(sc.calculateTIC(), 16.0)
+  TEST_REAL_SIMILAR(SpectrumColumns().calculateTIC(), 0.0)
+}
+END_SECTION
+
+START_SECTION(float getMaxIntensity() const)
+{
+  SpectrumColumns sc(spec);
+  TEST_REAL_SIMILAR(sc.getMaxIntensity(), 5.0)
+  TEST_REAL_SIMILAR(SpectrumColumns().getMaxIntensity(), 0.0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
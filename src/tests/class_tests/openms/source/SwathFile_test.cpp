@@ -206,6 +206,46 @@ START_SECTION(std::vector< OpenSwath::SwathMap > loadSplit(StringList file_list,
 }
 END_SECTION
 
+START_SECTION(OpenSwath::SwathMap loadSplitFile(const String& file, const String& tmp, const String& tmp_fname, const String& readoptions="normal"))
+{
+  std::vector<String> swath_filenames;
+  Size nr_swathes = 2;
+  swath_filenames.push_back("swathFile_4_ms1.tmp");
+  for (Size i = 0; i < nr_swathes; i++)
+  {
+    swath_filenames.push_back( String("swathFile_4_sw" ) + String(i) + ".tmp");
+  }
+  storeSplitSwathFile(swath_filenames);
+
+  OpenSwath::SwathMap ms1_map = SwathFile().loadSplitFile(swath_filenames[0], "./", "swathFile_4_ms1.cached");
+  TEST_EQUAL(ms1_map.ms1, true)
+  TEST_EQUAL(ms1_map.sptr->getNrSpectra(), 1)
+
+  for (Size i = 0; i < nr_swathes; i++)
+  {
+    OpenSwath::SwathMap map = SwathFile().loadSplitFile(swath_filenames[i+1], "./", "swathFile_4_sw.cached");
+    TEST_EQUAL(map.ms1, false)
+    TEST_EQUAL(map.sptr->getNrSpectra(), 1)
+    TEST_REAL_SIMILAR(map.sptr->getSpectrumById(0)->getMZArray()->data[0], 101.0+i)
+    TEST_REAL_SIMILAR(map.lower, 400+i*25.0)
+    TEST_REAL_SIMILAR(map.upper, 425+i*25.0)
+  }
+
+  TEST_EXCEPTION(Exception::IllegalArgument, SwathFile().loadSplitFile(swath_filenames[1], "./", "swathFile_4_sw.cached", "unknown"))
+}
+END_SECTION
+
+START_SECTION(boost::shared_ptr<ExperimentalSettings> loadMetaData(const String& file))
+{
+  std::vector<String> swath_filenames;
+  swath_filenames.push_back("swathFile_5_ms1.tmp");
+  swath_filenames.push_back("swathFile_5_sw0.tmp");
+  storeSplitSwathFile(swath_filenames);
+  boost::shared_ptr<ExperimentalSettings> meta = SwathFile().loadMetaData(swath_filenames[0]);
+  TEST_EQUAL(meta != nullptr, true)
+}
+END_SECTION
+
 // slow (7x slower than normal mzML)
 START_SECTION([EXTRA]std::vector< OpenSwath::SwathMap > loadSplit(StringList file_list, String tmp, boost::shared_ptr<ExperimentalSettings>& exp_meta, String readoptions="cache"))
 {
@@ -39,6 +39,7 @@
 ///////////////////////////
 
 #include <OpenMS/FILTERING/TRANSFORMERS/ThresholdMower.h>
+#include <OpenMS/KERNEL/SpectrumColumns.h>
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/FORMAT/DTAFile.h>
 
@@ -98,6 +99,22 @@ START_SECTION((template<typename SpectrumType> void filterSpectrum(SpectrumType&
   TEST_EQUAL(spec.size(), 14)
 END_SECTION
 
+START_SECTION((void filterSpectrum(SpectrumColumns& spectrum)))
+  DTAFile dta_file;
+  PeakSpectrum spec;
+  dta_file.load(OPENMS_GET_TEST_DATA_PATH("Transformers_tests.dta"), spec);
+  SpectrumColumns sc(spec);
+
+  Param p(e_ptr->getParameters());
+  p.setValue("threshold", 10.0);
+  e_ptr->setParameters(p);
+
+  e_ptr->filterSpectrum(sc);
+  TEST_EQUAL(sc.size(), 14)
+  e_ptr->filterSpectrum(spec);
+  TEST_EQUAL(sc == SpectrumColumns(spec), true)
+END_SECTION
+
 START_SECTION((void filterPeakMap(PeakMap& exp)))
   DTAFile dta_file;
   PeakSpectrum spec;
@@ -0,0 +1,196 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/SYSTEM/Tracer.h>
+
+#include <fstream>
+#include <sstream>
+
+/////////////////////////////////////////////////////////////
+
+using namespace OpenMS;
+
+START_TEST(Tracer, "$Id$")
+
+/////////////////////////////////////////////////////////////
+
+Tracer& tracer = Tracer::getInstance();
+
+START_SECTION((static Tracer& getInstance()))
+  TEST_EQUAL(&Tracer::getInstance(), &tracer)
+END_SECTION
+
+START_SECTION((static bool isEnabled()))
+  TEST_EQUAL(Tracer::isEnabled(), false)
+  {
+    OPENMS_TRACE_SCOPE("not recorded");
+  }
+  TEST_EQUAL(tracer.getRecords().size(), 0)
+END_SECTION
+
+START_SECTION((void setEnabled(bool enabled)))
+  tracer.setEnabled(true);
+  TEST_EQUAL(Tracer::isEnabled(), true)
+  {
+    OPENMS_TRACE_SCOPE("outer");
+    for (int i = 0; i < 2; ++i)
+    {
+      Tracer::Scope inner(String("inner"));
+      inner.addItems(5);
+    }
+  }
+  tracer.setEnabled(false);
+  {
+    OPENMS_TRACE_SCOPE("not recorded");
+  }
+  TEST_EQUAL(tracer.getRecords().size(), 3)
+END_SECTION
+
+START_SECTION((std::vector<Record> getRecords() const))
+  std::vector<Tracer::Record> records = tracer.getRecords();
+  ABORT_IF(records.size() != 3)
+  // records appear in order of completion
+  TEST_STRING_EQUAL(records[0].name, "inner")
+  TEST_STRING_EQUAL(records[0].path, "outer;inner")
+  TEST_EQUAL(records[0].depth, 1)
+  TEST_EQUAL(records[0].items, 5)
+  TEST_STRING_EQUAL(records[2].name, "outer")
+  TEST_STRING_EQUAL(records[2].path, "outer")
+  TEST_EQUAL(records[2].depth, 0)
+  TEST_EQUAL(records[2].items, 0)
+  TEST_EQUAL(records[2].start <= records[0].start, true)
+  TEST_EQUAL(records[2].wall_time >= records[0].wall_time + records[1].wall_time, true)
+  TEST_EQUAL(records[0].thread, records[2].thread)
+  // only top-level regions sample the peak memory
+  TEST_EQUAL(records[0].peak_memory, 0)
+END_SECTION
+
+START_SECTION((std::vector<Record> getSummary() const))
+  std::vector<Tracer::Record> summary = tracer.getSummary();
+  ABORT_IF(summary.size() != 2)
+  TEST_STRING_EQUAL(summary[0].path, "outer")
+  TEST_STRING_EQUAL(summary[1].path, "outer;inner")
+  TEST_EQUAL(summary[1].items, 10)
+END_SECTION
+
+START_SECTION((void storeChromeTrace(const String& filename) const))
+  String filename;
+  NEW_TMP_FILE(filename)
+  tracer.storeChromeTrace(filename);
+  std::ifstream is(filename.c_str());
+  std::stringstream ss;
+  ss << is.rdbuf();
+  String content = ss.str();
+  TEST_EQUAL(content.hasPrefix("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), true)
+  TEST_EQUAL(content.hasSubstring("\"name\":\"outer\""), true)
+  TEST_EQUAL(content.hasSubstring("\"ph\":\"X\""), true)
+  TEST_EXCEPTION(Exception::UnableToCreateFile, tracer.storeChromeTrace("/this/path/does/not/exist.json"))
+END_SECTION
+
+START_SECTION((void storeFoldedStacks(const String& filename) const))
+  String filename;
+  NEW_TMP_FILE(filename)
+  tracer.storeFoldedStacks(filename);
+  std::ifstream is(filename.c_str());
+  std::vector<String> lines;
+  std::string line;
+  while (std::getline(is, line)) lines.push_back(line);
+  ABORT_IF(lines.size() != 2)
+  TEST_EQUAL(lines[0].hasPrefix("outer "), true)
+  TEST_EQUAL(lines[1].hasPrefix("outer;inner "), true)
+END_SECTION
+
+START_SECTION((void store(const String& filename) const))
+  NOT_TESTABLE // dispatches to storeChromeTrace() or storeFoldedStacks()
+END_SECTION
+
+START_SECTION((String toString() const))
+  String s = tracer.toString();
+  TEST_EQUAL(s.hasPrefix("outer: "), true)
+  TEST_EQUAL(s.hasSubstring("\n  inner: "), true)
+  TEST_EQUAL(s.hasSubstring("10 items"), true)
+END_SECTION
+
+START_SECTION((void clear()))
+  tracer.clear();
+  TEST_EQUAL(tracer.getRecords().size(), 0)
+END_SECTION
+
+START_SECTION(([Tracer::Scope] void addItems(Size n)))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(([Tracer::Scope] void samplePeakMemory()))
+  NOT_TESTABLE // the peak memory is 0 on platforms where it cannot be determined
+END_SECTION
+
+START_SECTION((void setMaxRecords(Size max_records)))
+  TEST_EQUAL(tracer.getMaxRecords(), 100000)
+  tracer.setMaxRecords(2);
+  tracer.setEnabled(true);
+  for (int i = 0; i < 5; ++i)
+  {
+    Tracer::Scope batch("batch");
+    batch.addItems(1);
+  }
+  tracer.setEnabled(false);
+  TEST_EQUAL(tracer.getMaxRecords(), 2)
+  TEST_EQUAL(tracer.getRecords().size(), 2)
+  TEST_EQUAL(tracer.getNrDroppedRecords(), 3)
+  // the summary covers all regions
+  std::vector<Tracer::Record> summary = tracer.getSummary();
+  ABORT_IF(summary.size() != 1)
+  TEST_EQUAL(summary[0].items, 5)
+  tracer.clear();
+  TEST_EQUAL(tracer.getNrDroppedRecords(), 0)
+  TEST_EQUAL(tracer.getSummary().size(), 0)
+  tracer.setMaxRecords(100000);
+END_SECTION
+
+START_SECTION((Size getMaxRecords() const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION((Size getNrDroppedRecords() const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
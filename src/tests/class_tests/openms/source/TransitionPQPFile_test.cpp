@@ -34,10 +34,13 @@
 
 #include <OpenMS/CONCEPT/ClassTest.h>
 #include <OpenMS/test_config.h>
+#include <OpenMS/FORMAT/SqliteConnector.h>
 #include <OpenMS/FORMAT/TraMLFile.h>
 
 #include <boost/assign/std/vector.hpp>
 
+#include <set>
+
 ///////////////////////////
 #include <OpenMS/ANALYSIS/OPENSWATH/TransitionPQPFile.h>
 ///////////////////////////
@@ -80,6 +83,113 @@ START_SECTION( void convertPQPToTargetedExperiment(const char * filename, OpenMS
 }
 END_SECTION
 
+START_SECTION( void convertPQPToTargetedExperiment(const char * filename, OpenSwath::LightTargetedExperiment & targeted_exp, bool legacy_traml_id))
+{
+  TargetedExperiment targeted_exp;
+  TraMLFile().load(OPENMS_GET_TEST_DATA_PATH("OpenSwath_generic_input.TraML"), targeted_exp);
+  String pqp_file;
+  NEW_TMP_FILE(pqp_file)
+  TransitionPQPFile().convertTargetedExperimentToPQP(pqp_file.c_str(), targeted_exp);
+
+  OpenSwath::LightTargetedExperiment light_exp;
+  TransitionPQPFile().convertPQPToTargetedExperiment(pqp_file.c_str(), light_exp);
+  TEST_EQUAL(light_exp.getTransitions().size(), 5)
+  TEST_EQUAL(light_exp.getCompounds().size(), 2)
+  for (const auto& tr : light_exp.getTransitions())
+  {
+    TEST_EQUAL(light_exp.getCompoundByRef(tr.getPeptideRef()).id, tr.getPeptideRef())
+  }
+}
+END_SECTION
+
+START_SECTION( void convertPQPToTargetedExperiment(const char * filename, double lower_mz, double upper_mz, OpenSwath::LightTargetedExperiment & targeted_exp, bool legacy_traml_id))
+{
+  TargetedExperiment targeted_exp;
+  TraMLFile().load(OPENMS_GET_TEST_DATA_PATH("OpenSwath_generic_input.TraML"), targeted_exp);
+  String pqp_file;
+  NEW_TMP_FILE(pqp_file)
+  TransitionPQPFile().convertTargetedExperimentToPQP(pqp_file.c_str(), targeted_exp);
+
+  OpenSwath::LightTargetedExperiment full_exp;
+  TransitionPQPFile().convertPQPToTargetedExperiment(pqp_file.c_str(), full_exp);
+
+  // a window covering everything yields the complete library
+  OpenSwath::LightTargetedExperiment all_exp;
+  TransitionPQPFile().convertPQPToTargetedExperiment(pqp_file.c_str(), 0.0, 10000.0, all_exp);
+  TEST_EQUAL(all_exp.getTransitions().size(), full_exp.getTransitions().size())
+  TEST_EQUAL(all_exp.getCompounds().size(), full_exp.getCompounds().size())
+  TEST_EQUAL(all_exp.getProteins().size(), full_exp.getProteins().size())
+
+  // only transitions (and their compounds) inside the window are read
+  double lower = 499.5, upper = 500.5;
+  Size expected_transitions = 0;
+  std::set<std::string> expected_compounds;
+  for (const auto& tr : full_exp.getTransitions())
+  {
+    if (tr.getPrecursorMZ() > lower && tr.getPrecursorMZ() < upper)
+    {
+      ++expected_transitions;
+      expected_compounds.insert(tr.getPeptideRef());
+    }
+  }
+  TEST_EQUAL(expected_transitions > 0, true)
+
+  OpenSwath::LightTargetedExperiment window_exp;
+  TransitionPQPFile().convertPQPToTargetedExperiment(pqp_file.c_str(), lower, upper, window_exp);
+  TEST_EQUAL(window_exp.getTransitions().size(), expected_transitions)
+  TEST_EQUAL(window_exp.getCompounds().size(), expected_compounds.size())
+  for (const auto& tr : window_exp.getTransitions())
+  {
+    TEST_EQUAL(tr.getPrecursorMZ() > lower && tr.getPrecursorMZ() < upper, true)
+    TEST_EQUAL(expected_compounds.count(tr.getPeptideRef()), 1)
+  }
+
+  // empty window
+  OpenSwath::LightTargetedExperiment empty_exp;
+  TransitionPQPFile().convertPQPToTargetedExperiment(pqp_file.c_str(), 100.0, 200.0, empty_exp);
+  TEST_EQUAL(empty_exp.getTransitions().size(), 0)
+  TEST_EQUAL(empty_exp.getCompounds().size(), 0)
+  TEST_EQUAL(empty_exp.getProteins().size(), 0)
+}
+END_SECTION
+
+START_SECTION( void convertPQPToTargetedExperiment(SqliteConnector & conn, double lower_mz, double upper_mz, OpenSwath::LightTargetedExperiment & targeted_exp, bool legacy_traml_id))
+{
+  TargetedExperiment targeted_exp;
+  TraMLFile().load(OPENMS_GET_TEST_DATA_PATH("OpenSwath_generic_input.TraML"), targeted_exp);
+  String pqp_file;
+  NEW_TMP_FILE(pqp_file)
+  TransitionPQPFile().convertTargetedExperimentToPQP(pqp_file.c_str(), targeted_exp);
+
+  OpenSwath::LightTargetedExperiment full_exp;
+  TransitionPQPFile().convertPQPToTargetedExperiment(pqp_file.c_str(), full_exp);
+
+  // several windows through one connection, same result as opening the file per window
+  SqliteConnector conn(pqp_file, SqliteConnector::SqlOpenMode::READONLY);
+  Size nr_transitions = 0;
+  std::vector<std::pair<double, double> > windows = {{0.0, 499.5}, {499.5, 500.5}, {500.5, 10000.0}};
+  for (const auto& window : windows)
+  {
+    const double lower = window.first, upper = window.second;
+    OpenSwath::LightTargetedExperiment window_exp, window_exp_file;
+    TransitionPQPFile().convertPQPToTargetedExperiment(conn, lower, upper, window_exp);
+    TransitionPQPFile().convertPQPToTargetedExperiment(pqp_file.c_str(), lower, upper, window_exp_file);
+    TEST_EQUAL(window_exp.getTransitions().size(), window_exp_file.getTransitions().size())
+    TEST_EQUAL(window_exp.getCompounds().size(), window_exp_file.getCompounds().size())
+    nr_transitions += window_exp.getTransitions().size();
+
+    // the window restricted protein aggregation gives the same protein references as the full library
+    for (const auto& compound : window_exp.getCompounds())
+    {
+      TEST_EQUAL(ListUtils::concatenate(compound.protein_refs, ";"),
+                 ListUtils::concatenate(full_exp.getCompoundByRef(compound.id).protein_refs, ";"))
+    }
+  }
+  // no precursor lies exactly on a window boundary of this library
+  TEST_EQUAL(nr_transitions, full_exp.getTransitions().size())
+}
+END_SECTION
+
 START_SECTION( void validateTargetedExperiment(OpenMS::TargetedExperiment & targeted_exp))
 {
   NOT_TESTABLE
@@ -0,0 +1,223 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/VISUAL/IntensityPyramid.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(IntensityPyramid, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// 8 MS1 spectra (RT 0..7) with peaks at m/z 100..163 (intensity = RT * 100 + index), interleaved with MS2 spectra
+PeakMap exp;
+for (Size s = 0; s < 8; ++s)
+{
+  MSSpectrum spec;
+  spec.setRT(s);
+  spec.setMSLevel(1);
+  for (Size p = 0; p < 64; ++p)
+  {
+    spec.push_back(Peak1D(100.0 + p, float(s * 100 + p)));
+  }
+  exp.addSpectrum(spec);
+  MSSpectrum ms2;
+  ms2.setRT(s + 0.5);
+  ms2.setMSLevel(2);
+  ms2.push_back(Peak1D(120.0, 1e6));
+  exp.addSpectrum(ms2);
+}
+
+IntensityPyramid* ptr = nullptr;
+IntensityPyramid* null_ptr = nullptr;
+START_SECTION(IntensityPyramid())
+  ptr = new IntensityPyramid();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_EQUAL(ptr->getLevelCount(), 0)
+END_SECTION
+
+START_SECTION(~IntensityPyramid())
+  delete ptr;
+END_SECTION
+
+START_SECTION(IntensityPyramid(const PeakMap& map, Size finest_mz_bins = 16384, Size coarsest_mz_bins = 128))
+  IntensityPyramid py(exp, 64, 8);
+  TEST_EQUAL(py.empty(), false)
+  TEST_EQUAL(py.getLevelCount(), 4) // 64, 32, 16 and 8 bins
+  TEST_REAL_SIMILAR(py.getMinMZ(), 100.0)
+
+  // MS2 spectra are ignored
+  TEST_EQUAL(py.getLevel(0).rowCount(), 8)
+  TEST_EQUAL(py.getLevel(0).bins.size(), 8 * 64)
+  TEST_REAL_SIMILAR(py.getLevel(0).mz_bin_width, 63.0 / 64)
+  TEST_EQUAL(py.getLevel(3).rowCount(), 1)
+  TEST_EQUAL(py.getLevel(3).bins.size(), 8)
+  TEST_REAL_SIMILAR(py.getLevel(3).row_rt[0], 3.5)
+  TEST_REAL_SIMILAR(py.getLevel(3).mz_bin_width, 63.0 / 8)
+  TEST_REAL_SIMILAR(py.getLevel(3).intensities.back(), 763.0)
+
+  TEST_EXCEPTION(Exception::InvalidValue, IntensityPyramid(exp, 0))
+
+  // no MS1 spectra
+  PeakMap ms2_only;
+  ms2_only.addSpectrum(exp[1]);
+  TEST_EQUAL(IntensityPyramid(ms2_only).empty(), true)
+END_SECTION
+
+START_SECTION([IntensityPyramid::Builder] bool step(const PeakMap& map, Size max_peaks))
+  // same result as building in one go, even when processing a single spectrum per step
+  IntensityPyramid::Builder builder(64, 8);
+  Size steps = 1;
+  while (!builder.step(exp, 1)) ++steps;
+  TEST_EQUAL(steps > 8, true)
+  IntensityPyramid stepped = builder.finish();
+  IntensityPyramid direct(exp, 64, 8);
+  TEST_EQUAL(stepped.getLevelCount(), direct.getLevelCount())
+  TEST_REAL_SIMILAR(stepped.getMinMZ(), direct.getMinMZ())
+  for (Size l = 0; l < direct.getLevelCount(); ++l)
+  {
+    TEST_EQUAL(stepped.getLevel(l).row_rt == direct.getLevel(l).row_rt, true)
+    TEST_EQUAL(stepped.getLevel(l).row_begin == direct.getLevel(l).row_begin, true)
+    TEST_EQUAL(stepped.getLevel(l).bins == direct.getLevel(l).bins, true)
+    TEST_EQUAL(stepped.getLevel(l).intensities == direct.getLevel(l).intensities, true)
+  }
+
+  TEST_EXCEPTION(Exception::InvalidValue, IntensityPyramid::Builder(0))
+END_SECTION
+
+START_SECTION([IntensityPyramid::Builder] IntensityPyramid finish())
+  IntensityPyramid::Builder builder(64, 8);
+  TEST_EXCEPTION(Exception::Precondition, builder.finish())
+  TEST_EQUAL(builder.step(exp, 1000000), true)
+  TEST_EQUAL(builder.finish().getLevelCount(), 4)
+END_SECTION
+
+START_SECTION([IntensityPyramid::Builder] void cancel())
+  IntensityPyramid::Builder builder(64, 8);
+  builder.step(exp, 1000000);
+  builder.cancel();
+  IntensityPyramid cancelled = builder.finish();
+  TEST_EQUAL(cancelled.getLevelCount(), 1) // only level 0
+END_SECTION
+
+IntensityPyramid py(exp, 64, 8);
+
+START_SECTION(const Level& getLevel(Size level) const)
+  const IntensityPyramid::Level& level = py.getLevel(1);
+  TEST_EQUAL(level.rowCount(), 4)
+  TEST_EQUAL(level.row_begin.size(), 5)
+  TEST_EQUAL(level.bins.size(), 4 * 32)
+  TEST_REAL_SIMILAR(level.row_rt[1], 2.5)
+  TEST_EQUAL(level.bins[level.row_begin[1]], 0)
+  TEST_REAL_SIMILAR(level.intensities[level.row_begin[1]], 301.0) // max of the first two peaks of RT 2 and 3
+  TEST_EXCEPTION(Exception::IndexOverflow, py.getLevel(4))
+END_SECTION
+
+START_SECTION(bool empty() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(Size getLevelCount() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(double getMinMZ() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(SignedSize selectLevel(double rt_min, double rt_max, double mz_min, double mz_max, Size rt_pixel_count, Size mz_pixel_count) const)
+  // full map on few pixels: coarsest level
+  TEST_EQUAL(py.selectLevel(0, 7, 100, 163, 1, 8), 3)
+  // more pixels in m/z: finer levels
+  TEST_EQUAL(py.selectLevel(0, 7, 100, 163, 1, 16), 2)
+  TEST_EQUAL(py.selectLevel(0, 7, 100, 163, 1, 64), 0)
+  // more pixels in RT: finer levels (level 0 is always fine enough in RT)
+  TEST_EQUAL(py.selectLevel(0, 7, 100, 163, 4, 8), 1)
+  TEST_EQUAL(py.selectLevel(0, 7, 100, 163, 100, 8), 0)
+  // zoomed in too far
+  TEST_EQUAL(py.selectLevel(0, 7, 100, 110, 1, 64), -1)
+END_SECTION
+
+START_SECTION((template <typename Function> void forEachBin(Size level, double rt_min, double rt_max, double mz_min, double mz_max, Function f) const))
+  // compare with the raw peaks in the area
+  for (Size l = 0; l < py.getLevelCount(); ++l)
+  {
+    Size count = 0;
+    float max = -1;
+    py.forEachBin(l, 0, 7, 0, 1000, [&](double, double, float intensity) { ++count; max = std::max(max, intensity); });
+    TEST_EQUAL(count, py.getLevel(l).bins.size())
+    TEST_REAL_SIMILAR(max, 763.0)
+  }
+
+  Size count = 0;
+  float max = -1;
+  double min_rt = 100, max_rt = -1, min_mz = 1000, max_mz = -1;
+  py.forEachBin(0, 1, 2, 110.1, 119.9, [&](double rt, double mz, float intensity)
+  {
+    ++count;
+    max = std::max(max, intensity);
+    min_rt = std::min(min_rt, rt);
+    max_rt = std::max(max_rt, rt);
+    min_mz = std::min(min_mz, mz);
+    max_mz = std::max(max_mz, mz);
+  });
+  // bins overlapping the area are reported in full, i.e. the peaks at m/z 110 and 120 are included
+  TEST_EQUAL(count, 2 * 11)
+  TEST_REAL_SIMILAR(max, 220.0)
+  TEST_REAL_SIMILAR(min_rt, 1.0)
+  TEST_REAL_SIMILAR(max_rt, 2.0)
+  TEST_EQUAL(min_mz > 110.0 && max_mz < 121.0, true)
+
+  // outside of the data
+  count = 0;
+  py.forEachBin(0, 10, 20, 100, 200, [&](double, double, float) { ++count; });
+  py.forEachBin(0, 0, 7, 0, 50, [&](double, double, float) { ++count; });
+  TEST_EQUAL(count, 0)
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,242 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+
+///////////////////////////
+
+#include <OpenMS/VISUAL/TOPPASScene.h>
+
+///////////////////////////
+
+#include <OpenMS/VISUAL/TOPPASEdge.h>
+#include <OpenMS/VISUAL/TOPPASToolVertex.h>
+#include <OpenMS/DATASTRUCTURES/ListUtils.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <QApplication>
+
+using namespace OpenMS;
+using namespace std;
+
+/// Records the start of a tool (name and arguments), but does not finish it (done by the test via processFinished())
+class RecordingProcess :
+  public FakeProcess
+{
+public:
+  RecordingProcess(const String& name, StringList& log) :
+    name_(name),
+    log_(log)
+  {
+  }
+
+  void start(const QString& /*program*/, const QStringList& arguments, OpenMode /*mode*/ = ReadWrite) override
+  {
+    log_.push_back(arguments.empty() ? name_ : name_ + " " + String(arguments.join(" ")));
+  }
+
+private:
+  String name_;
+  StringList& log_;
+};
+
+START_TEST(TOPPASScene, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// TOPPASScene is a QGraphicsScene; no display is required for scheduling
+qputenv("QT_QPA_PLATFORM", "offscreen");
+QApplication app(argc, argv);
+
+TOPPASScene scene(nullptr, File::getTempDirectory().toQString(), false);
+
+// pipeline a -> b -> c, d -> e, f; i.e. the critical path of a is 3, of d 2 and of f 1
+// (the tools do not exist, they are never run)
+TOPPASToolVertex* a = new TOPPASToolVertex();
+TOPPASToolVertex* b = new TOPPASToolVertex();
+TOPPASToolVertex* c = new TOPPASToolVertex();
+TOPPASToolVertex* d = new TOPPASToolVertex();
+TOPPASToolVertex* e = new TOPPASToolVertex();
+TOPPASToolVertex* f = new TOPPASToolVertex();
+for (TOPPASToolVertex* v : {a, b, c, d, e, f})
+{
+  scene.addVertex(v);
+}
+auto addEdge = [&scene](TOPPASVertex* source, TOPPASVertex* target)
+{
+  TOPPASEdge* edge = new TOPPASEdge();
+  edge->setSourceVertex(source);
+  edge->setTargetVertex(target);
+  source->addOutEdge(edge);
+  target->addInEdge(edge);
+  scene.addEdge(edge);
+};
+addEdge(a, b);
+addEdge(b, c);
+addEdge(d, e);
+
+StringList log;
+
+START_SECTION(void enqueueProcess(const TOPPProcess & process))
+{
+  // one job at a time: processes are started in order of their critical path, FIFO among equals
+  scene.setAllowedThreads(1);
+  RecordingProcess pf("f", log), pd("d", log), pa("a", log), pe("e", log);
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&pf, "f", QStringList(), f));
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&pd, "d", QStringList(), d));
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&pa, "a", QStringList(), a));
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&pe, "e", QStringList(), e));
+  scene.runNextProcess();
+  TEST_EQUAL(ListUtils::concatenate(log, ","), "a")
+  scene.processFinished(&pa);
+  TEST_EQUAL(ListUtils::concatenate(log, ","), "a,d")
+  scene.processFinished(&pd);
+  TEST_EQUAL(ListUtils::concatenate(log, ","), "a,d,f")
+  scene.processFinished(&pf);
+  TEST_EQUAL(ListUtils::concatenate(log, ","), "a,d,f,e")
+  scene.processFinished(&pe);
+  log.clear();
+}
+END_SECTION
+
+START_SECTION(void runNextProcess())
+{
+  scene.setAllowedThreads(4);
+
+  // the thread count is capped at the budget and passed to the tool; tools without '-threads' count as one thread
+  RecordingProcess p1("a", log), p2("f", log);
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&p2, "f", QStringList(), f, 0));
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&p1, "a", QStringList(), a, 8));
+  scene.runNextProcess();
+  TEST_EQUAL(ListUtils::concatenate(log, ","), "a -threads 4")
+  scene.processFinished(&p1);
+  TEST_EQUAL(ListUtils::concatenate(log, ","), "a -threads 4,f")
+  scene.processFinished(&p2);
+  log.clear();
+
+  // a process which does not fit reserves its threads: the smaller one behind it has to wait
+  RecordingProcess p3("f", log), p4("a", log), p5("e", log);
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&p3, "f", QStringList(), f, 2));
+  scene.runNextProcess();
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&p4, "a", QStringList(), a, 4));
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&p5, "e", QStringList(), e, 1));
+  scene.runNextProcess();
+  TEST_EQUAL(ListUtils::concatenate(log, ","), "f -threads 2")
+  scene.processFinished(&p3);
+  TEST_EQUAL(ListUtils::concatenate(log, ","), "f -threads 2,a -threads 4")
+  scene.processFinished(&p4);
+  TEST_EQUAL(ListUtils::concatenate(log, ","), "f -threads 2,a -threads 4,e -threads 1")
+  scene.processFinished(&p5);
+  log.clear();
+}
+END_SECTION
+
+START_SECTION(void setAllowedThreads(int num_threads))
+{
+  // two single-threaded processes run in parallel
+  scene.setAllowedThreads(2);
+  RecordingProcess p1("a", log), p2("d", log), p3("f", log);
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&p1, "a", QStringList(), a));
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&p2, "d", QStringList(), d));
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&p3, "f", QStringList(), f));
+  scene.runNextProcess();
+  TEST_EQUAL(ListUtils::concatenate(log, ","), "a,d")
+  scene.processFinished(&p2);
+  TEST_EQUAL(ListUtils::concatenate(log, ","), "a,d,f")
+  scene.processFinished(&p1);
+  scene.processFinished(&p3);
+  log.clear();
+}
+END_SECTION
+
+START_SECTION(void setAllowedMemory(UInt memory_mb))
+{
+  scene.setAllowedThreads(4);
+  scene.setAllowedMemory(1000);
+
+  // 600 + 600 MB exceed the budget, 600 + 300 MB do not; the 300 MB process must not overtake the waiting 600 MB one
+  RecordingProcess p1("a", log), p2("d", log), p3("f", log);
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&p1, "a", QStringList(), a, 0, 600));
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&p2, "d", QStringList(), d, 0, 600));
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&p3, "f", QStringList(), f, 0, 300));
+  scene.runNextProcess();
+  TEST_EQUAL(ListUtils::concatenate(log, ","), "a")
+  scene.processFinished(&p1);
+  TEST_EQUAL(ListUtils::concatenate(log, ","), "a,d,f")
+
+  // a process exceeding the whole budget runs once nothing else is running
+  RecordingProcess p4("b", log);
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&p4, "b", QStringList(), b, 0, 2000));
+  scene.runNextProcess();
+  scene.processFinished(&p2);
+  TEST_EQUAL(ListUtils::concatenate(log, ","), "a,d,f")
+  scene.processFinished(&p3);
+  TEST_EQUAL(ListUtils::concatenate(log, ","), "a,d,f,b")
+  scene.processFinished(&p4);
+  log.clear();
+
+  // no memory budget: memory requirements are ignored
+  scene.setAllowedMemory(0);
+  RecordingProcess p5("a", log), p6("d", log);
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&p5, "a", QStringList(), a, 0, 2000));
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&p6, "d", QStringList(), d, 0, 2000));
+  scene.runNextProcess();
+  TEST_EQUAL(ListUtils::concatenate(log, ","), "a,d")
+  scene.processFinished(&p5);
+  scene.processFinished(&p6);
+  log.clear();
+}
+END_SECTION
+
+START_SECTION(void processFinished(QProcess * process))
+{
+  // unknown processes do not release anything
+  scene.setAllowedThreads(1);
+  RecordingProcess p1("a", log), p2("d", log), unknown("x", log);
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&p1, "a", QStringList(), a));
+  scene.enqueueProcess(TOPPASScene::TOPPProcess(&p2, "d", QStringList(), d));
+  scene.runNextProcess();
+  scene.processFinished(&unknown);
+  TEST_EQUAL(ListUtils::concatenate(log, ","), "a")
+  scene.processFinished(&p1);
+  TEST_EQUAL(ListUtils::concatenate(log, ","), "a,d")
+  scene.processFinished(&p2);
+  log.clear();
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -83,6 +83,13 @@ using namespace std;
 </PARAMETERS>
   \endcode
 
+  <B>Parallel execution</B>
+
+  Tool runs are scheduled within a budget of threads (<TT>-num_jobs</TT>) and memory (<TT>-memory_budget</TT>).
+  A run requires as many threads as the <TT>threads</TT> parameter of its tool node (limited to the budget, and passed on to the tool)
+  and the memory set for the node in TOPPAS (context menu: <TT>Set memory requirement</TT>).
+  Runs of tools with the longest chain of downstream tools are started first.
+
     <B>The command line parameters of this tool are:</B>
     @verbinclude TOPP_ExecutePipeline.cli
     <B>INI file documentation of this tool:</B>
@@ -110,8 +117,10 @@ protected:
     setValidFormats_("in", ListUtils::create<String>("toppas"));
     registerStringOption_("out_dir", "<directory>", "", "Directory for output files (default: user's home directory)", false);
     registerStringOption_("resource_file", "<file>", "", "A TOPPAS resource file (*.trf) specifying the files this workflow is to be applied to", false);
-    registerIntOption_("num_jobs", "<integer>", 1, "Maximum number of jobs running in parallel", false, false);
+    registerIntOption_("num_jobs", "<integer>", 1, "Maximum number of threads used by jobs running in parallel (a tool with '-threads N' counts N times)", false, false);
     setMinInt_("num_jobs", 1);
+    registerIntOption_("memory_budget", "<MB>", 0, "Maximum memory (in MB) used by jobs running in parallel, according to the memory requirements stored for the tool nodes (0 = unlimited)", false, true);
+    setMinInt_("memory_budget", 0);
   }
 
   ExitCodes main_(int argc, const char ** argv) override
@@ -120,6 +129,7 @@ protected:
     QString out_dir_name = getStringOption_("out_dir").toQString();
     QString resource_file = getStringOption_("resource_file").toQString();
     int num_jobs = getIntOption_("num_jobs");
+    int memory_budget = getIntOption_("memory_budget");
 
     QApplication a(argc, const_cast<char **>(argv), false);
 
@@ -145,6 +155,7 @@ protected:
     }
     ts.load(toppas_file);
     ts.setAllowedThreads(num_jobs);
+    ts.setAllowedMemory(memory_budget);
 
     if (resource_file != "")
     {
@@ -270,6 +270,7 @@ public:
     params.remove("debug");
     params.remove("threads");
     params.remove("no_progress");
+    params.remove("profile");
     params.remove("force");
     params.remove("test");
     algorithm.setParameters(params);
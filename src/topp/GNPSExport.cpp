@@ -36,6 +36,7 @@
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 #include <OpenMS/FORMAT/GNPSMGFFile.h>
 #include <OpenMS/ANALYSIS/ID/IonIdentityMolecularNetworking.h>
+#include <OpenMS/COMPARISON/SPECTRA/PairwiseSpectralSimilarity.h>
 #include <OpenMS/KERNEL/ConsensusMap.h>
 #include <OpenMS/FORMAT/ConsensusXMLFile.h>
 
@@ -89,6 +90,7 @@ A representative OpenMS-GNPS workflow would use the following OpenMS TOPP tools
 @code 
   	TextExporter -in FileFilter.consensusXML -out FeatureQuantificationTable.txt
 @endcode
+- Optionally, GNPSExport computes the molecular network itself (@p out_network): all pairs of exported spectra are compared by cosine similarity (see the 'network' parameters) and similar pairs are written as edge table, in the same format as the IIMN supplementary pairs table.
 - Upload your files to GNPS and run the Feature-Based Molecular Networking workflow. Instructions can be found here: https://ccms-ucsd.github.io/GNPSDocumentation/featurebasedmolecularnetworking/
 
 The GitHub page for the ProteoSAFe workflow and the OpenMS python wrappers is available here: https://github.com/Bioinformatic-squad-DorresteinLab/openms-gnps-workflow
@@ -136,9 +138,19 @@ protected:
     registerOutputFile_("out_pairs", "<file>", "", "Output supplementary pairs table for IIMN.", false);
     setValidFormats_("out_pairs", {"csv"});
 
+    registerOutputFile_("out_network", "<file>", "", "Output molecular network (pairs of similar MS2 spectra, computed with the 'network' parameters).", false);
+    setValidFormats_("out_network", {"csv"});
+
     addEmptyLine_();
 
     registerFullParam_(GNPSMGFFile().getDefaults());
+
+    registerSubsection_("network", "Spectral similarity options for the molecular network ('out_network')");
+  }
+
+  Param getSubsectionDefaults_(const String& /*section*/) const override
+  {
+    return PairwiseSpectralSimilarity().getDefaults();
   }
 
   // the main function is called after all parameters are read
@@ -152,6 +164,7 @@ protected:
     String out(getStringOption_("out"));
     String out_quantification(getStringOption_("out_quantification"));
     String out_pairs(getStringOption_("out_pairs"));
+    String out_network(getStringOption_("out_network"));
 
     // load ConsensusMap from file
     ConsensusMap cm;
@@ -170,10 +183,30 @@ protected:
     if (!out_pairs.empty()) IonIdentityMolecularNetworking::writeSupplementaryPairTable(cm, out_pairs);
     if (!out_quantification.empty()) IonIdentityMolecularNetworking::writeFeatureQuantificationTable(cm, out_quantification);
 
+    Param gnps_param = getParam_();
+    gnps_param.removeAll("network:");
+
     GNPSMGFFile gnps;
     gnps.setLogType(log_type_);
-    gnps.setParameters(getParam_()); // copy tool parameter to library class/algorithm
-    gnps.run(consensus_file_path, mzml_file_paths, out);
+    gnps.setParameters(gnps_param); // copy tool parameter to library class/algorithm
+
+    if (out_network.empty())
+    {
+      gnps.run(consensus_file_path, mzml_file_paths, out);
+    }
+    else
+    {
+      vector<MSSpectrum> spectra;
+      gnps.run(consensus_file_path, mzml_file_paths, out, &spectra);
+
+      PairwiseSpectralSimilarity similarity;
+      similarity.setLogType(log_type_);
+      similarity.setParameters(getParam_().copy("network:", true));
+      vector<PairwiseSpectralSimilarity::Edge> edges = similarity.compute(spectra);
+      writeDebug_(String("Molecular network: ") + edges.size() + " edges between " + spectra.size() + " spectra", 1);
+
+      IonIdentityMolecularNetworking::writeSpectralNetworkTable(spectra, edges, out_network);
+    }
 
     return EXECUTION_OK;
   }
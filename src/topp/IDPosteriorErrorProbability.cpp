@@ -37,6 +37,9 @@
 #include <OpenMS/MATH/STATISTICS/PosteriorErrorProbabilityModel.h>
 #include <OpenMS/FORMAT/IdXMLFile.h>
 
+#include <exception>
+#include <memory>
+
 using namespace OpenMS;
 using namespace Math; //PosteriorErrorProbabilityModel
 using namespace std;
@@ -168,8 +171,6 @@ protected:
     vector<ProteinIdentification> protein_ids;
     vector<PeptideIdentification> peptide_ids;
     file.load(inputfile_name, protein_ids, peptide_ids);
-    PosteriorErrorProbabilityModel PEP_model;
-    PEP_model.setParameters(fit_algorithm);
     //-------------------------------------------------------------
     // calculations
     //-------------------------------------------------------------
@@ -209,26 +210,63 @@ protected:
 
     String out_plot = String(fit_algorithm.getValue("out_plot").toString()).trim();
 
-    for (auto & score : all_scores)
+    // the models of all search engines (and charge states) are independent, so they are fitted in parallel.
+    // Plots of different models may share a file name, so plotting forces a serial fit.
+    vector<map<String, vector<vector<double> > >::iterator> fit_order;
+    for (auto it = all_scores.begin(); it != all_scores.end(); ++it)
     {
-      vector<String> engine_info;
-      score.first.split(',', engine_info);
-      String engine = engine_info[0];
-      Int charge = (engine_info.size() == 2) ? engine_info[1].toInt() : -1;
-
-      if (split_charge)
+      fit_order.push_back(it);
+    }
+    vector<unique_ptr<PosteriorErrorProbabilityModel> > PEP_models(fit_order.size());
+    vector<char> fit_results(fit_order.size(), false); // not vector<bool>, which cannot be written concurrently
+    vector<std::exception_ptr> fit_errors(fit_order.size());
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if(out_plot.empty())
+#endif
+    for (SignedSize i = 0; i < static_cast<SignedSize>(fit_order.size()); ++i)
+    {
+      Param model_param = fit_algorithm;
+      if (split_charge && !out_plot.empty())
       {
         // only adapt plot output if plot is requested (this badly violates the output rules and needs to change!)
         // one way to fix this: plot charges into a single file (no renaming of output file needed) - but this requires major code restructuring
-        if (!out_plot.empty()) fit_algorithm.setValue("out_plot", out_plot + "_charge_" + String(charge));
-        PEP_model.setParameters(fit_algorithm);
+        vector<String> engine_info;
+        fit_order[i]->first.split(',', engine_info);
+        Int charge = (engine_info.size() == 2) ? engine_info[1].toInt() : -1;
+        model_param.setValue("out_plot", out_plot + "_charge_" + String(charge));
       }
+      PEP_models[i] = make_unique<PosteriorErrorProbabilityModel>();
+      PEP_models[i]->setParameters(model_param);
 
       // fit to score vector
       //TODO choose outlier handling based on search engine? If not set by user?
       //XTandem is prone to accumulation at min values/censoring
       //OMSSA is prone to outliers
-      bool return_value = PEP_model.fit(score.second[0], outlier_handling);
+      try
+      {
+        fit_results[i] = PEP_models[i]->fit(fit_order[i]->second[0], outlier_handling);
+      }
+      catch (...)
+      { // exceptions must not leave the parallel region; they are rethrown in order below
+        fit_errors[i] = std::current_exception();
+      }
+    }
+
+    for (Size i = 0; i < fit_order.size(); ++i)
+    {
+      if (fit_errors[i])
+      {
+        std::rethrow_exception(fit_errors[i]);
+      }
+      auto& score = *fit_order[i];
+      PosteriorErrorProbabilityModel& PEP_model = *PEP_models[i];
+      vector<String> engine_info;
+      score.first.split(',', engine_info);
+      String engine = engine_info[0];
+      Int charge = (engine_info.size() == 2) ? engine_info[1].toInt() : -1;
+
+      bool return_value = fit_results[i];
 
       if (!return_value) 
       {
@@ -39,6 +39,7 @@
 #include <OpenMS/CONCEPT/VersionInfo.h>
 #include <OpenMS/FORMAT/XQuestResultXMLFile.h>
 #include <OpenMS/FORMAT/FASTAFile.h>
+#include <OpenMS/FORMAT/FASTAIndexFile.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/FORMAT/ConsensusXMLFile.h>
 #include <OpenMS/FORMAT/IdXMLFile.h>
@@ -197,14 +198,13 @@ protected:
 
     // load fasta database
     progresslogger.startProgress(0, 1, "Load database from FASTA file...");
-    FASTAFile fastaFile;
     vector<FASTAFile::FASTAEntry> fasta_db;
-    fastaFile.load(in_fasta, fasta_db);
+    FASTAIndexFile::load(in_fasta, fasta_db); // plain or compiled FASTA
 
     if (!in_decoy_fasta.empty())
     {
       vector<FASTAFile::FASTAEntry> fasta_decoys;
-      fastaFile.load(in_decoy_fasta, fasta_decoys);
+      FASTAIndexFile::load(in_decoy_fasta, fasta_decoys);
       fasta_db.reserve(fasta_db.size() + fasta_decoys.size());
       fasta_db.insert(fasta_db.end(), fasta_decoys.begin(), fasta_decoys.end());
     }
@@ -35,6 +35,7 @@
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 
 #include <OpenMS/ANALYSIS/ID/PeptideIndexing.h>
+#include <OpenMS/FORMAT/FASTAIndexFile.h>
 #include <OpenMS/FORMAT/IdXMLFile.h>
 #include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
@@ -117,7 +118,8 @@ protected:
     setValidFormats_("in", ListUtils::create<String>("idXML"));
     registerInputFile_("fasta", "<file>", "", "Input sequence database in FASTA format. "
                                               "Leave empty for using the same DB as used for the input idXML (this might fail). "
-                                              "Non-existing relative filenames are looked up via 'OpenMS.ini:id_db_dir'", false, false, { "skipexists" });
+                                              "Non-existing relative filenames are looked up via 'OpenMS.ini:id_db_dir'. "
+                                              "A database compiled into the binary format of FASTAIndexFile is memory-mapped instead of parsed.", false, false, { "skipexists" });
     setValidFormats_("fasta", { "fasta" }, false);
     registerOutputFile_("out", "<file>", "", "Output idXML file.");
     setValidFormats_("out", {"idXML"});
@@ -187,8 +189,17 @@ protected:
     param_pi.update(param, false, false, false, false, OpenMS_Log_debug); // suppress param. update message
     indexer.setParameters(param_pi);
     indexer.setLogType(this->log_type_);
-    FASTAContainer<TFI_File> proteins(db_name);
-    PeptideIndexing::ExitCodes indexer_exit = indexer.run(proteins, prot_ids, pep_ids);
+    PeptideIndexing::ExitCodes indexer_exit;
+    if (FASTAIndexFile::isCompiledFASTA(db_name))
+    { // compiled database (see FASTAIndexFile): mapped, no parsing required
+      FASTAContainer<TFI_MMap> proteins(db_name);
+      indexer_exit = indexer.run(proteins, prot_ids, pep_ids);
+    }
+    else
+    {
+      FASTAContainer<TFI_File> proteins(db_name);
+      indexer_exit = indexer.run(proteins, prot_ids, pep_ids);
+    }
 
     //-------------------------------------------------------------
     // calculate protein coverage
@@ -38,6 +38,7 @@
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/CONCEPT/Factory.h>
 #include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrum.h>
+#include <OpenMS/COMPARISON/SPECTRA/SpectralLibraryIndex.h>
 #include <OpenMS/COMPARISON/SPECTRA/SpectraSTSimilarityScore.h>
 #include <OpenMS/COMPARISON/SPECTRA/ZhangSimilarityScore.h>
 #include <OpenMS/FORMAT/IdXMLFile.h>
@@ -51,6 +52,12 @@
 #include <vector>
 #include <map>
 #include <cmath>
+#include <memory>
+#include <numeric>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 using namespace OpenMS;
 using namespace std;
 
@@ -150,6 +157,8 @@ protected:
     registerIntOption_("filter:min_peaks", "<number>", 5, "required minimum number of peaks for a query spectrum", false);
     registerIntOption_("filter:max_peaks", "<number>", 150, "Use only the top <number> of peaks.", false);
     registerIntOption_("filter:cut_peaks_below", "<number>", 1000, "Remove all peaks which are lower than 1/<number> of the highest peaks. Default equals all peaks which are lower than 0.001 of the maximum intensity peak", false);
+    registerIntOption_("filter:prefilter_candidates", "<number>", 0, "If > 0, only the <number> library spectra (per precursor window) with the highest binned cosine similarity to the query are scored with 'compare_function'. Speeds up searches against large libraries. 0 = score all candidates.", false, true);
+    setMinInt_("filter:prefilter_candidates", 0);
 
     registerTOPPSubsection_("modifications", "Modifications Options");
     vector<String> all_mods;
@@ -297,6 +306,7 @@ protected:
     UInt min_peaks = getIntOption_("filter:min_peaks");
     UInt max_peaks = getIntOption_("filter:max_peaks");
     Int cut_peaks_below = getIntOption_("filter:cut_peaks_below");
+    Size prefilter_candidates = getIntOption_("filter:prefilter_candidates");
 
     StringList fixed_modifications = getStringList_("modifications:fixed");
     StringList variable_modifications = getStringList_("modifications:variable");
@@ -355,16 +365,41 @@ protected:
 
     MapLibraryPrecursorToLibrarySpectrum mslib = annotateIdentificationsToSpectra_(ids, library, variable_modifications, fixed_modifications, remove_peaks_below_threshold);
 
+    // precursor-sorted index of the library (same order as mslib); peaks are only binned if the prefilter needs them
+    SpectralLibraryIndex lib_index;
+    vector<MapLibraryPrecursorToLibrarySpectrum::const_iterator> lib_entries;
+    lib_entries.reserve(mslib.size());
+    for (auto it = mslib.cbegin(); it != mslib.cend(); ++it)
+    {
+      if (prefilter_candidates > 0)
+      {
+        lib_index.addSpectrum(it->first, it->second);
+      }
+      else
+      {
+        lib_index.addPrecursor(it->first);
+      }
+      lib_entries.push_back(it);
+    }
+
     time_t end_build_time = time(nullptr);
     OPENMS_LOG_INFO << "Time needed for preprocessing data: " << (end_build_time - start_build_time) << "\n";
 
-    //compare function
-    std::unique_ptr<PeakSpectrumCompareFunctor> comparator(Factory<PeakSpectrumCompareFunctor>::create(compare_function));
+    // compare function: one per thread (some keep internal state)
+#ifdef _OPENMP
+    const Size num_threads = omp_get_max_threads();
+#else
+    const Size num_threads = 1;
+#endif
+    vector<std::unique_ptr<PeakSpectrumCompareFunctor>> comparators;
+    for (Size t = 0; t < num_threads; ++t)
+    {
+      comparators.emplace_back(Factory<PeakSpectrumCompareFunctor>::create(compare_function));
+    }
  
    //-------------------------------------------------------------
     // calculations
     //-------------------------------------------------------------
-    double score;
     StringList::iterator in, out_file;
     for (in  = in_spec.begin(), out_file  = out.begin(); in < in_spec.end(); ++in, ++out_file)
     {
@@ -402,15 +437,24 @@ protected:
 
 
       /***********SEARCH**********/
-      for (UInt j = 0; j < query.size(); ++j)
+      // queries are searched in parallel; results are collected in query order below
+      vector<PeptideIdentification> query_ids(query.size());
+      vector<char> query_reported(query.size(), 0);
+      vector<char> missing_precursor(query.size(), 0);
+
+#pragma omp parallel for schedule(dynamic, 16)
+      for (SignedSize j = 0; j < (SignedSize)query.size(); ++j)
       {
+#ifdef _OPENMP
+        PeakSpectrumCompareFunctor& comparator = *comparators[omp_get_thread_num()];
+#else
+        PeakSpectrumCompareFunctor& comparator = *comparators[0];
+#endif
         //Set identifier for each identifications
-        PeptideIdentification pid;
+        PeptideIdentification& pid = query_ids[j];
         pid.setIdentifier("test");
         pid.setScoreType(compare_function);
-        ProteinHit pr_hit;
-        pr_hit.setAccession(j);
-        prot_id.insertHit(pr_hit);
+        const String accession(j);
 
         // proper MS2?
         if (query[j].empty() || query[j].getMSLevel() != 2)
@@ -420,7 +464,7 @@ protected:
 
         if (query[j].getPrecursors().empty())
         {
-          writeLog_("Warning MS2 spectrum without precursor information");
+          missing_precursor[j] = 1;
           continue;
         }
 
@@ -459,6 +503,13 @@ protected:
           continue;
         }
 
+        // binned query for the candidate prefilter
+        vector<float> dense_query;
+        if (prefilter_candidates > 0)
+        {
+          lib_index.prepareQuery(filtered_query, dense_query);
+        }
+
         const double& query_rt = query[j].getRT();
         const int& query_charge = query[j].getPrecursors()[0].getCharge();
         const double query_mz = query[j].getPrecursors()[0].getMZ();
@@ -508,20 +559,36 @@ protected:
 
 
           // determine MS2 precursors that match to the current peptide mass
-          MapLibraryPrecursorToLibrarySpectrum::const_iterator low_it, up_it;
-        
-          low_it = mslib.lower_bound(ic_query_mz - 0.5 * precursor_mass_tolerance_mz);
-          up_it = mslib.upper_bound(ic_query_mz + 0.5 * precursor_mass_tolerance_mz);
-        
+          const pair<Size, Size> range = lib_index.getPrecursorRange(ic_query_mz - 0.5 * precursor_mass_tolerance_mz,
+                                                                     ic_query_mz + 0.5 * precursor_mass_tolerance_mz);
+
           // no matching precursor in data
-          if (low_it == up_it)
+          if (range.first == range.second)
           { 
             continue;
           }
-       
-          for (; low_it != up_it; ++low_it)
+
+          vector<Size> candidates(range.second - range.first);
+          iota(candidates.begin(), candidates.end(), range.first);
+
+          // keep only the candidates with the highest binned cosine similarity (in library order)
+          if (prefilter_candidates > 0 && candidates.size() > prefilter_candidates)
           {
-            const PeakSpectrum& lib_spec = low_it->second;;
+            vector<float> cosine;
+            lib_index.scoreCandidates(dense_query, range.first, range.second, cosine);
+            nth_element(candidates.begin(), candidates.begin() + prefilter_candidates, candidates.end(),
+              [&cosine, &range](Size a, Size b)
+              {
+                const float sa = cosine[a - range.first], sb = cosine[b - range.first];
+                return sa > sb || (sa == sb && a < b);
+              });
+            candidates.resize(prefilter_candidates);
+            sort(candidates.begin(), candidates.end());
+          }
+
+          for (Size candidate : candidates)
+          {
+            const PeakSpectrum& lib_spec = lib_entries[candidate]->second;
             PeptideHit hit = lib_spec.getPeptideIdentifications()[0].getHits()[0];
             const int& lib_charge = hit.getCharge();  
 
@@ -532,9 +599,10 @@ protected:
             }
 
             // Special treatment for SpectraST score as it computes a score based on the whole library
+            double score;
             if (compare_function == "SpectraSTSimilarityScore")
             {
-              auto& sp = dynamic_cast<SpectraSTSimilarityScore&>(*comparator);
+              auto& sp = dynamic_cast<SpectraSTSimilarityScore&>(comparator);
               BinnedSpectrum quer_bin_spec = sp.transform(filtered_query);
               BinnedSpectrum lib_bin_spec = sp.transform(lib_spec);
               score = sp(filtered_query, lib_spec); //(*sp)(quer_bin,librar_bin);
@@ -543,7 +611,7 @@ protected:
             }
             else
             {
-              score = (*comparator)(filtered_query, lib_spec);
+              score = comparator(filtered_query, lib_spec);
             }
 
             DataValue RT(lib_spec.getRT());
@@ -553,7 +621,7 @@ protected:
             hit.setMetaValue(Constants::UserParam::ISOTOPE_ERROR, iso);
             hit.setScore(score);
             PeptideEvidence pe;
-            pe.setProteinAccession(pr_hit.getAccession());
+            pe.setProteinAccession(accession);
             hit.addPeptideEvidence(pe);
             pid.insertHit(hit);
           }
@@ -568,7 +636,7 @@ protected:
           {
             vector<PeptideHit> final_hits;
             final_hits.resize(pid.getHits().size());
-            auto& sp = dynamic_cast<SpectraSTSimilarityScore&>(*comparator);
+            auto& sp = dynamic_cast<SpectraSTSimilarityScore&>(comparator);
             Size runner_up = 1;
             for (; runner_up < pid.getHits().size(); ++runner_up)
             {
@@ -597,7 +665,23 @@ protected:
         {
           pid.getHits().resize(top_hits);
         }
-        peptide_ids.push_back(pid);
+        query_reported[j] = 1;
+      }
+
+      for (Size j = 0; j < query.size(); ++j)
+      {
+        ProteinHit pr_hit;
+        pr_hit.setAccession(String(j));
+        prot_id.insertHit(pr_hit);
+
+        if (missing_precursor[j])
+        {
+          writeLog_("Warning MS2 spectrum without precursor information");
+        }
+        if (query_reported[j])
+        {
+          peptide_ids.push_back(std::move(query_ids[j]));
+        }
       }
       protein_ids.push_back(prot_id);
 
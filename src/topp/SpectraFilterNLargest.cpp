@@ -38,6 +38,7 @@
 #include <OpenMS/FILTERING/TRANSFORMERS/NLargest.h>
 
 #include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/KERNEL/SpectrumColumns.h>
 
 #include <typeinfo>
 
@@ -91,6 +92,8 @@ protected:
     registerOutputFile_("out", "<file>", "", "output file ");
     setValidFormats_("out", ListUtils::create<String>("mzML"));
 
+    registerFlag_("columnar", "Filter on the column-wise layout (contiguous m/z and intensity arrays, see SpectrumColumns). Same result, less memory traffic.", true);
+
     // register one section for each algorithm
     registerSubsection_("algorithm", "Algorithm parameter subsection.");
 
@@ -136,7 +139,19 @@ protected:
 
     NLargest filter;
     filter.setParameters(filter_param);
-    filter.filterPeakMap(exp);
+    if (getFlag_("columnar"))
+    {
+      for (MSSpectrum& spectrum : exp)
+      {
+        SpectrumColumns columns(spectrum);
+        filter.filterSpectrum(columns);
+        columns.exportTo(spectrum);
+      }
+    }
+    else
+    {
+      filter.filterPeakMap(exp);
+    }
 
     //-------------------------------------------------------------
     // writing output
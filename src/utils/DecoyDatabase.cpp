@@ -33,6 +33,7 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/FORMAT/FASTAFile.h>
+#include <OpenMS/FORMAT/FASTAIndexFile.h>
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
 #include <OpenMS/CHEMISTRY/ProteaseDigestion.h>
@@ -75,6 +76,10 @@ using namespace std;
   Also the tool automatically checks for decoys already in the input files (based on most common pre-/suffixes)
   and terminates the program if decoys are found.
 
+  Optionally (@p out_index), the resulting database is additionally written in the compiled binary format of FASTAIndexFile.
+  PeptideIndexer recognizes such a file when given as its @p fasta input and maps it instead of parsing the FASTA text,
+  which pays off when the same (large) database is indexed repeatedly.
+
   <B>The command line parameters of this tool are:</B>
   @verbinclude UTILS_DecoyDatabase.cli
   <B>INI file documentation of this tool:</B>
@@ -100,6 +105,7 @@ protected:
     setValidFormats_("in", ListUtils::create<String>("fasta"));
     registerOutputFile_("out", "<file>", "", "Output FASTA file where the decoy database will be written to.");
     setValidFormats_("out", ListUtils::create<String>("fasta"));
+    registerOutputFile_("out_index", "<file>", "", "Optional output: the database from 'out' in compiled binary format (see FASTAIndexFile), which PeptideIndexer maps and SimpleSearchEngine, OpenPepXL, OpenPepXLLF and NucleicAcidSearchEngine read without parsing.", false, true);
     registerStringOption_("decoy_string", "<string>", "DECOY_", "String that is combined with the accession of the protein identifier to indicate a decoy protein.", false);
     registerStringOption_("decoy_string_position", "<choice>", "prefix", "Should the 'decoy_string' be prepended (prefix) or appended (suffix) to the protein accession?", false);
     setValidStrings_("decoy_string_position", ListUtils::create<String>("prefix,suffix"));
@@ -145,6 +151,7 @@ protected:
     enum SeqType {protein, RNA};
     StringList in = getStringList_("in");
     String out = getStringOption_("out");
+    String out_index = getStringOption_("out_index");
     bool append = !getFlag_("only_decoy");
     bool shuffle = (getStringOption_("method") == "shuffle");
     String decoy_string = getStringOption_("decoy_string");
@@ -349,6 +356,13 @@ protected:
         f.writeNext(entry);
       } // next protein
     } // input files
+    f.writeEnd();
+
+    if (!out_index.empty())
+    {
+      Size n = FASTAIndexFile::compile(out, out_index);
+      OPENMS_LOG_INFO << "Wrote compiled database with " << n << " entries to '" << out_index << "'." << endl;
+    }
 
     return EXECUTION_OK;
   }
@@ -0,0 +1,181 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/APPLICATIONS/TOPPBase.h>
+#include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedian.h>
+#include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedianRapid.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+using namespace OpenMS;
+using namespace std;
+
+//-------------------------------------------------------------
+//Doxygen docu
+//-------------------------------------------------------------
+
+/**
+  @page UTILS_NoiseEstimatorBenchmark NoiseEstimatorBenchmark
+
+  @brief Benchmarks the signal-to-noise estimators on the spectra of a file.
+
+  Estimates the signal-to-noise ratio of every data point of every spectrum with
+  one of the following methods and reports the time needed (loading the file is
+  not included):
+  - median_incremental: SignalToNoiseEstimatorMedian with 'median_search' = 'incremental'
+  - median_scan: SignalToNoiseEstimatorMedian with 'median_search' = 'scan'
+  - median_rapid: SignalToNoiseEstimatorMedianRapid
+
+  The two 'median' methods give identical results, which can be checked via the
+  reported mean S/N. Run the tool once per method on the same file (and with the
+  same 'win_len' and 'bin_count') to compare them.
+
+  <B>The command line parameters of this tool are:</B>
+  @verbinclude UTILS_NoiseEstimatorBenchmark.cli
+  <B>INI file documentation of this tool:</B>
+  @htmlinclude UTILS_NoiseEstimatorBenchmark.html
+
+*/
+
+// We do not want this class to show up in the docu:
+/// @cond TOPPCLASSES
+
+class TOPPNoiseEstimatorBenchmark :
+  public TOPPBase
+{
+public:
+  TOPPNoiseEstimatorBenchmark() :
+    TOPPBase("NoiseEstimatorBenchmark", "Benchmarks the signal-to-noise estimators on the spectra of a file.", false)
+  {
+  }
+
+protected:
+
+  void registerOptionsAndFlags_() override
+  {
+    registerInputFile_("in", "<file>", "", "Input file (profile or centroided spectra).");
+    setValidFormats_("in", ListUtils::create<String>("mzML"));
+
+    registerStringOption_("method", "<method>", "median_incremental", "Signal-to-noise estimator to run", false);
+    setValidStrings_("method", ListUtils::create<String>("median_incremental,median_scan,median_rapid"));
+
+    registerDoubleOption_("win_len", "<Th>", 200.0, "Window length in Thomson", false);
+    setMinFloat_("win_len", 1.0);
+    registerIntOption_("bin_count", "<number>", 30, "Number of intensity bins (median_incremental and median_scan only)", false);
+    setMinInt_("bin_count", 3);
+    registerIntOption_("repeats", "<number>", 1, "Number of times all spectra are processed", false);
+    setMinInt_("repeats", 1);
+  }
+
+  ExitCodes main_(int, const char**) override
+  {
+    String in = getStringOption_("in");
+    String method = getStringOption_("method");
+    double win_len = getDoubleOption_("win_len");
+    Int bin_count = getIntOption_("bin_count");
+    Int repeats = getIntOption_("repeats");
+
+    PeakMap exp;
+    MzMLFile mzml;
+    mzml.setLogType(log_type_);
+    mzml.load(in, exp);
+
+    SignalToNoiseEstimatorMedian<MSSpectrum> sne;
+    Param p = sne.getParameters();
+    p.setValue("win_len", win_len);
+    p.setValue("bin_count", bin_count);
+    p.setValue("median_search", method == "median_scan" ? "scan" : "incremental");
+    p.setValue("write_log_messages", "false");
+    sne.setParameters(p);
+    SignalToNoiseEstimatorMedianRapid rapid(win_len);
+
+    Size nr_spectra(0), nr_points(0);
+    double sum_sn(0);
+    vector<double> mz, intensity;
+    StopWatch sw;
+    sw.start();
+    for (Int r = 0; r < repeats; ++r)
+    {
+      for (const MSSpectrum& spectrum : exp)
+      {
+        // the rapid estimator needs at least three data points
+        if (spectrum.size() < 3) continue;
+        ++nr_spectra;
+        nr_points += spectrum.size();
+        if (method == "median_rapid")
+        {
+          mz.clear();
+          intensity.clear();
+          for (const Peak1D& peak : spectrum)
+          {
+            mz.push_back(peak.getMZ());
+            intensity.push_back(peak.getIntensity());
+          }
+          SignalToNoiseEstimatorMedianRapid::NoiseEstimator noise = rapid.estimateNoise(mz, intensity);
+          for (const Peak1D& peak : spectrum)
+          {
+            sum_sn += peak.getIntensity() / noise.get_noise_value(peak.getMZ());
+          }
+        }
+        else
+        {
+          sne.init(spectrum);
+          for (Size i = 0; i < spectrum.size(); ++i)
+          {
+            sum_sn += sne.getSignalToNoise(i);
+          }
+        }
+      }
+    }
+    sw.stop();
+
+    std::cout << "Method: " << method << std::endl;
+    std::cout << "There are " << nr_spectra << " spectra and " << nr_points << " data points (" << repeats << " repeat(s))." << std::endl;
+    std::cout << "The mean S/N is " << (nr_points == 0 ? 0.0 : sum_sn / nr_points) << std::endl;
+    std::cout << " Estimation time " << sw.toString() << std::endl;
+
+    return EXECUTION_OK;
+  }
+
+};
+
+int main(int argc, const char** argv)
+{
+  TOPPNoiseEstimatorBenchmark tool;
+  return tool.main(argc, argv);
+}
+
+/// @endcond
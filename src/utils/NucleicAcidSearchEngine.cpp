@@ -49,6 +49,7 @@
 
 // file types
 #include <OpenMS/FORMAT/FASTAFile.h>
+#include <OpenMS/FORMAT/FASTAIndexFile.h>
 #include <OpenMS/FORMAT/IdXMLFile.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/FORMAT/MzTabFile.h>
@@ -1057,7 +1058,7 @@ protected:
 
       progresslogger.startProgress(0, 1, "loading database from FASTA file...");
       vector<FASTAFile::FASTAEntry> fasta_db;
-      FASTAFile().load(in_db, fasta_db);
+      FASTAIndexFile::load(in_db, fasta_db); // plain or compiled FASTA
       progresslogger.endProgress();
 
       OPENMS_LOG_INFO << "Performing in-silico digestion..." << endl;
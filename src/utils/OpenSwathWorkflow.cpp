@@ -37,8 +37,10 @@
 #include <OpenMS/FORMAT/DATAACCESS/MSDataSqlConsumer.h>
 
 // Files
+#include <OpenMS/FORMAT/CheckpointCache.h>
 #include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/FORMAT/FileTypes.h>
+#include <OpenMS/FORMAT/SqliteConnector.h>
 #include <OpenMS/FORMAT/TraMLFile.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
@@ -58,6 +60,7 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMS.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessTransforming.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMSInMemory.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessNumpressCompressed.h>
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/SwathMap.h>
 
 // Helpers
@@ -76,6 +79,8 @@
 
 #include <cassert>
 #include <limits>
+#include <memory>
+#include <mutex>
 
 // #define OPENSWATH_WORKFLOW_DEBUG
 
@@ -138,7 +143,11 @@ using namespace OpenMS;
   Since the file size can become rather large, it is recommended to not load the
   whole file into memory but rather cache it somewhere on the disk using a
   fast-access data format. This can be specified using the -readOptions cache
-  parameter (this is recommended!).
+  parameter (this is recommended!). Alternatively, -readOptions workingInMemoryCompressed
+  keeps the data in memory, but numpress compressed (spectra are decoded when they
+  are accessed), which needs only a fraction of the memory of workingInMemory. The
+  data is cached to the temporary directory first and compressed from there. Note
+  that numpress compression is lossy (intensities have a relative error of about 2e-4).
 
   The assay library (transition list) is provided through the @p -tr parameter and can be in one of the following formats:
   
@@ -516,9 +525,15 @@ protected:
 
     registerFlag_("split_file_input", "The input files each contain one single SWATH (alternatively: all SWATH are in separate files)", true);
     registerFlag_("use_elution_model_score", "Turn on elution model score (EMG fit to peak)", true);
+    registerFlag_("pipeline_swath_loading", "Only for split input (one file per SWATH window, MS1 file first): extract and score each SWATH window as soon as its file has been read while the remaining files are loaded, keeping only a few windows in memory. Requires rt_norm (or no RT normalization); not available with tr_irt, swath_windows_file, out_qc, SONAR, PASEF or matching_window_only data. The window sanity checks are skipped.", true);
+    registerFlag_("load_library_per_window", "Only for PQP assay libraries: load the assays of each SWATH window when it is processed instead of loading the whole library up front. Reduces memory usage for very large libraries. Not available for SONAR, PASEF or matching_window_only data.", true);
+    registerStringOption_("checkpoint_dir", "<directory>", "", "Directory for checkpoints of intermediate results (currently the RT normalization computed from tr_irt / tr_irt_nonlinear). "
+                                                                "Checkpoints are identified by the content of their input files and the parameters used to compute them. "
+                                                                "Not used if mz_correction_function or ion mobility calibration modify the SWATH data. Empty = no checkpoints.", false, true);
+    registerFlag_("resume", "Reuse the checkpoints in 'checkpoint_dir' whose input files and parameters did not change.", true);
 
-    registerStringOption_("readOptions", "<name>", "normal", "Whether to run OpenSWATH directly on the input data, cache data to disk first or to perform a datareduction step first. If you choose cache, make sure to also set tempDirectory", false, true);
-    setValidStrings_("readOptions", ListUtils::create<String>("normal,cache,cacheWorkingInMemory,workingInMemory"));
+    registerStringOption_("readOptions", "<name>", "normal", "Whether to run OpenSWATH directly on the input data, cache data to disk first or to perform a datareduction step first. If you choose cache, make sure to also set tempDirectory. 'workingInMemoryCompressed' caches the data to tempDirectory and keeps it numpress compressed (lossy) in memory.", false, true);
+    setValidStrings_("readOptions", ListUtils::create<String>("normal,cache,cacheWorkingInMemory,workingInMemory,workingInMemoryCompressed"));
 
     registerStringOption_("mz_correction_function", "<name>", "none", "Use the retention time normalization peptide MS2 masses to perform a mass correction (linear, weighted by intensity linear or quadratic) of all spectra.", false, true);
     setValidStrings_("mz_correction_function", ListUtils::create<String>("none,regression_delta_ppm,unweighted_regression,weighted_regression,quadratic_regression,weighted_quadratic_regression,weighted_quadratic_regression_delta_ppm,quadratic_regression_delta_ppm"));
@@ -713,6 +728,7 @@ protected:
     ///////////////////////////////////
 
     bool load_into_memory = false;
+    bool compress_in_memory = false;
     if (readoptions == "cacheWorkingInMemory")
     {
       readoptions = "cache";
@@ -723,9 +739,16 @@ protected:
       readoptions = "normal";
       load_into_memory = true;
     }
+    else if (readoptions == "workingInMemoryCompressed")
+    {
+      // the maps are first cached to disk and then compressed spectrum by spectrum from the cached files (see
+      // below), so the uncompressed data is never held in memory completely
+      readoptions = "cache";
+      compress_in_memory = true;
+    }
 
     bool is_sqmass_input  = (FileHandler::getTypeByFileName(file_list[0]) == FileTypes::SQMASS);
-    if (is_sqmass_input && !load_into_memory)
+    if (is_sqmass_input && !load_into_memory && !compress_in_memory)
     {
       std::cout << "When using sqMass input files, it is highly recommended to use the workingInMemory option as otherwise data access will be very slow." << std::endl;
     }
@@ -763,6 +786,25 @@ protected:
     double min_upper_edge_dist = getDoubleOption_("min_upper_edge_dist");
     bool use_ms1_im = getStringOption_("use_ms1_ion_mobility") == "true";
     bool prm = getStringOption_("matching_window_only") == "true";
+    bool load_library_per_window = getFlag_("load_library_per_window");
+    bool pipeline_swath_loading = getFlag_("pipeline_swath_loading");
+    if (pipeline_swath_loading && (file_list.size() < 2 || !irt_tr_file.empty() || !nonlinear_irt_tr_file.empty() ||
+                                   !swath_windows_file.empty() || !out_qc.empty() || sonar || pasef || prm))
+    {
+      OPENMS_LOG_ERROR << "Parameter 'pipeline_swath_loading' requires split input files and is not available with tr_irt, tr_irt_nonlinear, swath_windows_file, out_qc, SONAR, PASEF or matching_window_only data." << std::endl;
+      return ILLEGAL_PARAMETERS;
+    }
+    if (load_library_per_window && (tr_type != FileTypes::PQP || sonar || pasef || prm))
+    {
+      OPENMS_LOG_ERROR << "Parameter 'load_library_per_window' requires a PQP assay library and is not available for SONAR, PASEF or matching_window_only data." << std::endl;
+      return ILLEGAL_PARAMETERS;
+    }
+
+    if (getFlag_("resume") && getStringOption_("checkpoint_dir").empty())
+    {
+      OPENMS_LOG_ERROR << "Error: 'resume' requires a 'checkpoint_dir'." << std::endl;
+      return ILLEGAL_PARAMETERS;
+    }
 
     ChromExtractParams cp;
     cp.min_upper_edge_dist   = min_upper_edge_dist;
@@ -807,9 +849,17 @@ protected:
     ///////////////////////////////////
     // Load the transitions
     ///////////////////////////////////
-    OpenSwath::LightTargetedExperiment transition_exp = loadTransitionList(tr_type, tr_file, tsv_reader_param);
-    OPENMS_LOG_INFO << "Loaded " << transition_exp.getProteins().size() << " proteins, " <<
-      transition_exp.getCompounds().size() << " compounds with " << transition_exp.getTransitions().size() << " transitions." << std::endl;
+    OpenSwath::LightTargetedExperiment transition_exp;
+    if (load_library_per_window)
+    {
+      OPENMS_LOG_INFO << "Assays will be loaded per SWATH window from " << tr_file << "." << std::endl;
+    }
+    else
+    {
+      transition_exp = loadTransitionList(tr_type, tr_file, tsv_reader_param);
+      OPENMS_LOG_INFO << "Loaded " << transition_exp.getProteins().size() << " proteins, " <<
+        transition_exp.getCompounds().size() << " compounds with " << transition_exp.getTransitions().size() << " transitions." << std::endl;
+    }
 
     if (tr_type == FileTypes::PQP)
     {
@@ -827,8 +877,13 @@ protected:
     boost::shared_ptr<ExperimentalSettings> exp_meta(new ExperimentalSettings);
     std::vector< OpenSwath::SwathMap > swath_maps;
 
+    if (pipeline_swath_loading)
+    {
+      // the files are read one by one during extraction (see below)
+      exp_meta = SwathFile().loadMetaData(file_list[0]);
+    }
     // collect some QC data
-    if (!out_qc.empty())
+    else if (!out_qc.empty())
     {
       OpenSwath::SwathQC qc(30, 0.04);
       MSDataTransformingConsumer qc_consumer; // apply some transformation
@@ -852,6 +907,25 @@ protected:
       }
     }
 
+    if (compress_in_memory)
+    {
+      // replace each (disk-cached) map by a compressed in-memory copy
+      Size compressed_bytes(0);
+      for (OpenSwath::SwathMap& swath_map : swath_maps)
+      {
+        boost::shared_ptr<SpectrumAccessNumpressCompressed> compressed(new SpectrumAccessNumpressCompressed(*swath_map.sptr));
+        compressed_bytes += compressed->getCompressedSize();
+        swath_map.sptr = compressed;
+      }
+      OPENMS_LOG_INFO << "Compressed SWATH data in memory: " << compressed_bytes / 1024 / 1024 << " MiB" << std::endl;
+    }
+
+    // MS1-only data is scored against the complete library
+    if (load_library_per_window && swath_maps.size() == 1 && swath_maps[0].ms1)
+    {
+      load_library_per_window = false;
+      transition_exp = loadTransitionList(tr_type, tr_file, tsv_reader_param);
+    }
 
     ///////////////////////////////////
     // Get the transformation information (using iRT peptides)
@@ -865,63 +939,104 @@ protected:
     calibration_param.setValue("im_extraction_window", cp_irt.im_extraction_window);
     calibration_param.setValue("mz_correction_function", mz_correction_function);
     TransformationDescription trafo_rtnorm;
-    if (nonlinear_irt_tr_file.empty())
+    TransformationDescription im_trafo_inv; // theoretical -> experimental ion mobility
+    bool calibrate_library_im = false;
+
+    // The RT normalization can be reused from a checkpoint if computing it has no side effects on the SWATH data
+    // (m/z and ion mobility calibration correct the SWATH maps in place).
+    CheckpointCache checkpoints(getStringOption_("checkpoint_dir"), getFlag_("resume"));
+    const bool checkpoint_calibration = checkpoints.isEnabled() && trafo_in.empty() && !irt_tr_file.empty() &&
+                                        mz_correction_function == "none" && cp_irt.im_extraction_window < 0;
+    CheckpointCache::Key calibration_checkpoint("rt_normalization");
+    if (checkpoint_calibration)
     {
-      trafo_rtnorm = performCalibration(trafo_in, irt_tr_file, swath_maps,
-                                        min_rsq, min_coverage, feature_finder_param,
-                                        cp_irt, irt_detection_param, calibration_param,
-                                        debug_level, sonar, load_into_memory,
-                                        irt_trafo_out, irt_mzml_out);
+      for (const String& file : file_list) { calibration_checkpoint.add("in", checkpoints.hashFile(file)); }
+      calibration_checkpoint.add("tr_irt", checkpoints.hashFile(irt_tr_file));
+      if (!nonlinear_irt_tr_file.empty()) calibration_checkpoint.add("tr_irt_nonlinear", checkpoints.hashFile(nonlinear_irt_tr_file));
+      if (!swath_windows_file.empty()) calibration_checkpoint.add("swath_windows_file", checkpoints.hashFile(swath_windows_file));
+      calibration_checkpoint.add("RTNormalization", irt_detection_param)
+                            .add("Calibration", calibration_param)
+                            .add("Scoring", feature_finder_param)
+                            .add("Library", tsv_reader_param)
+                            .add("rt_extraction_window", String(cp_irt.rt_extraction_window))
+                            .add("extra_rt_extraction_window", String(cp_irt.extra_rt_extract))
+                            .add("extraction_function", cp_irt.extraction_function)
+                            .add("min_upper_edge_dist", String(min_upper_edge_dist))
+                            .add("min_rsq", String(min_rsq))
+                            .add("min_coverage", String(min_coverage))
+                            .add("sonar", sonar ? "true" : "false")
+                            .add("pasef", pasef ? "true" : "false")
+                            .add("matching_window_only", prm ? "true" : "false")
+                            .add("split_file_input", split_file ? "true" : "false")
+                            .add("sort_swath_maps", sort_swath_maps ? "true" : "false");
     }
-    else
-    {
-      ///////////////////////////////////
-      // First perform a simple linear transform, then do a second, nonlinear one
-      ///////////////////////////////////
-
-      Param linear_irt = irt_detection_param;
-      linear_irt.setValue("alignmentMethod", "linear");
-      Param no_calibration = calibration_param;
-      no_calibration.setValue("mz_correction_function", "none");
-      trafo_rtnorm = performCalibration(trafo_in, irt_tr_file, swath_maps,
-                                        min_rsq, min_coverage, feature_finder_param,
-                                        cp_irt, linear_irt, no_calibration,
-                                        debug_level, sonar, load_into_memory,
-                                        irt_trafo_out, irt_mzml_out);
-
-      cp_irt.rt_extraction_window = 900; // extract some substantial part of the RT range (should be covered by linear correction)
-      cp_irt.rt_extraction_window = 600; // extract some substantial part of the RT range (should be covered by linear correction)
-
-      ///////////////////////////////////
-      // Get the secondary transformation (nonlinear)
-      ///////////////////////////////////
-      OpenSwath::LightTargetedExperiment transition_exp_nl;
-      transition_exp_nl = loadTransitionList(FileHandler::getType(nonlinear_irt_tr_file), nonlinear_irt_tr_file, tsv_reader_param);
-
-      std::vector< OpenMS::MSChromatogram > chromatograms;
-      OpenSwathCalibrationWorkflow wf;
-      wf.setLogType(log_type_);
-      wf.simpleExtractChromatograms_(swath_maps, transition_exp_nl, chromatograms,
-                                    trafo_rtnorm, cp_irt, sonar, load_into_memory);
-
-      // always use estimateBestPeptides for the nonlinear approach
-      Param nonlinear_irt = irt_detection_param;
-      nonlinear_irt.setValue("estimateBestPeptides", "true");
-
-      TransformationDescription im_trafo; // exp -> theoretical
-      trafo_rtnorm = wf.doDataNormalization_(transition_exp_nl, chromatograms, im_trafo, swath_maps,
-                                             min_rsq, min_coverage,
-                                             feature_finder_param, nonlinear_irt, calibration_param);
 
-      TransformationDescription im_trafo_inv = im_trafo;
-      im_trafo_inv.invert(); // theoretical -> experimental
-
-      // We now modify the library as this is the easiest thing to do
-      for (auto & p : transition_exp.getCompounds())
+    // no ion mobility calibration if the checkpoint is used (see above), so the identity transformation applies to the library
+    if (!checkpoint_calibration || !checkpoints.load<TransformationXMLFile>(calibration_checkpoint, "trafoXML", trafo_rtnorm))
+    {
+      if (nonlinear_irt_tr_file.empty())
       {
-        p.drift_time = im_trafo_inv.apply(p.drift_time);
+        trafo_rtnorm = performCalibration(trafo_in, irt_tr_file, swath_maps,
+                                          min_rsq, min_coverage, feature_finder_param,
+                                          cp_irt, irt_detection_param, calibration_param,
+                                          debug_level, sonar, load_into_memory,
+                                          irt_trafo_out, irt_mzml_out);
       }
+      else
+      {
+        ///////////////////////////////////
+        // First perform a simple linear transform, then do a second, nonlinear one
+        ///////////////////////////////////
+
+        Param linear_irt = irt_detection_param;
+        linear_irt.setValue("alignmentMethod", "linear");
+        Param no_calibration = calibration_param;
+        no_calibration.setValue("mz_correction_function", "none");
+        trafo_rtnorm = performCalibration(trafo_in, irt_tr_file, swath_maps,
+                                          min_rsq, min_coverage, feature_finder_param,
+                                          cp_irt, linear_irt, no_calibration,
+                                          debug_level, sonar, load_into_memory,
+                                          irt_trafo_out, irt_mzml_out);
+
+        cp_irt.rt_extraction_window = 900; // extract some substantial part of the RT range (should be covered by linear correction)
+        cp_irt.rt_extraction_window = 600; // extract some substantial part of the RT range (should be covered by linear correction)
+
+        ///////////////////////////////////
+        // Get the secondary transformation (nonlinear)
+        ///////////////////////////////////
+        OpenSwath::LightTargetedExperiment transition_exp_nl;
+        transition_exp_nl = loadTransitionList(FileHandler::getType(nonlinear_irt_tr_file), nonlinear_irt_tr_file, tsv_reader_param);
+
+        std::vector< OpenMS::MSChromatogram > chromatograms;
+        OpenSwathCalibrationWorkflow wf;
+        wf.setLogType(log_type_);
+        wf.simpleExtractChromatograms_(swath_maps, transition_exp_nl, chromatograms,
+                                      trafo_rtnorm, cp_irt, sonar, load_into_memory);
+
+        // always use estimateBestPeptides for the nonlinear approach
+        Param nonlinear_irt = irt_detection_param;
+        nonlinear_irt.setValue("estimateBestPeptides", "true");
+
+        TransformationDescription im_trafo; // exp -> theoretical
+        trafo_rtnorm = wf.doDataNormalization_(transition_exp_nl, chromatograms, im_trafo, swath_maps,
+                                               min_rsq, min_coverage,
+                                               feature_finder_param, nonlinear_irt, calibration_param);
+
+        im_trafo_inv = im_trafo;
+        im_trafo_inv.invert(); // theoretical -> experimental
+        calibrate_library_im = true;
+
+        // We now modify the library as this is the easiest thing to do
+        for (auto & p : transition_exp.getCompounds())
+        {
+          p.drift_time = im_trafo_inv.apply(p.drift_time);
+        }
 
+      }
+      if (checkpoint_calibration)
+      {
+        checkpoints.store<TransformationXMLFile>(calibration_checkpoint, "trafoXML", trafo_rtnorm);
+      }
     }
 
     ///////////////////////////////////
@@ -953,8 +1068,53 @@ protected:
     {
       OpenSwathWorkflow wf(use_ms1_traces, use_ms1_im, prm, pasef, outer_loop_threads);
       wf.setLogType(log_type_);
-      wf.performExtraction(swath_maps, trafo_rtnorm, cp, cp_ms1, feature_finder_param, transition_exp,
-          out_featureFile, !out.empty(), tsvwriter, oswwriter, chromatogramConsumer, batchSize, ms1_isotopes, load_into_memory);
+      if (load_library_per_window)
+      {
+        // one connection for all windows; the loader is called from several threads, which take turns reading
+        auto library_db = std::make_shared<SqliteConnector>(tr_file, SqliteConnector::SqlOpenMode::READONLY);
+        auto library_db_mutex = std::make_shared<std::mutex>();
+        wf.setWindowLibraryLoader([library_db, library_db_mutex, &im_trafo_inv, calibrate_library_im]
+          (double lower, double upper, OpenSwath::LightTargetedExperiment& window_exp)
+          {
+            TransitionPQPFile pqp_reader;
+            pqp_reader.setLogType(ProgressLogger::NONE);
+            {
+              std::lock_guard<std::mutex> lock(*library_db_mutex);
+              pqp_reader.convertPQPToTargetedExperiment(*library_db, lower, upper, window_exp);
+            }
+            if (calibrate_library_im)
+            {
+              for (auto & p : window_exp.getCompounds())
+              {
+                p.drift_time = im_trafo_inv.apply(p.drift_time);
+              }
+            }
+          });
+      }
+      if (pipeline_swath_loading)
+      {
+        SwathFile swath_file;
+        swath_file.setLogType(ProgressLogger::NONE);
+        auto load_swath_map = [&](Size i)
+        {
+          OpenSwath::SwathMap swath_map = swath_file.loadSplitFile(file_list[i], tmp_dir, "openswath_tmpfile_" + String(i) + ".mzML", readoptions);
+          if (compress_in_memory)
+          {
+            swath_map.sptr = boost::shared_ptr<SpectrumAccessNumpressCompressed>(new SpectrumAccessNumpressCompressed(*swath_map.sptr));
+          }
+          return swath_map;
+        };
+        // keep one window in memory per scoring thread plus one read ahead
+        Size max_windows_in_flight = Size(std::max(1, getIntOption_("threads"))) + 1;
+        wf.performExtractionPipelined(file_list.size(), load_swath_map, max_windows_in_flight, trafo_rtnorm, cp, cp_ms1,
+            feature_finder_param, transition_exp, out_featureFile, !out.empty(), tsvwriter, oswwriter,
+            chromatogramConsumer, batchSize, ms1_isotopes, load_into_memory);
+      }
+      else
+      {
+        wf.performExtraction(swath_maps, trafo_rtnorm, cp, cp_ms1, feature_finder_param, transition_exp,
+            out_featureFile, !out.empty(), tsvwriter, oswwriter, chromatogramConsumer, batchSize, ms1_isotopes, load_into_memory);
+      }
     }
 
     if (!out.empty())
@@ -59,6 +59,7 @@
 #include <OpenMS/FILTERING/DATAREDUCTION/MassTraceDetection.h>
 #include <OpenMS/FILTERING/ID/IDFilter.h>
 #include <OpenMS/FILTERING/TRANSFORMERS/ThresholdMower.h>
+#include <OpenMS/FORMAT/CheckpointCache.h>
 #include <OpenMS/FORMAT/ConsensusXMLFile.h>
 #include <OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>
 #include <OpenMS/FORMAT/ExperimentalDesignFile.h>
@@ -78,10 +79,17 @@
 #include <OpenMS/METADATA/ExperimentalDesign.h>
 #include <OpenMS/METADATA/SpectrumMetaDataLookup.h>
 #include <OpenMS/SYSTEM/File.h>
+#include <OpenMS/SYSTEM/Tracer.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderIdentificationAlgorithm.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderMultiplexAlgorithm.h>
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
 
+#include <QFileInfo>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 using Internal::IDBoostGraph;
@@ -147,6 +155,9 @@ public:
   }
 
 protected:  
+  /// checkpoints of intermediate results (see -checkpoint_dir and -resume)
+  CheckpointCache checkpoints_;
+
   void registerOptionsAndFlags_() override
   {
     registerInputFileList_("in", "<file list>", StringList(), "Input files");
@@ -238,6 +249,21 @@ protected:
                                                                      " sequence as a candidate per feature in the same file.", false, true);
     setValidStrings_("keep_feature_top_psm_only", ListUtils::create<String>("true,false"));
 
+    registerIntOption_("parallel_runs", "<number>", 1, "Number of MS runs of a fraction that are quantified concurrently. "
+                                                       "The available threads (see -threads) are split evenly between the concurrent runs.", false, true);
+    setMinInt_("parallel_runs", 1);
+
+    registerIntOption_("memory_limit", "<MB>", 0, "Upper bound on the memory (in MB) used by concurrently quantified MS runs. "
+                                                 "The memory needed per run is estimated from the size of its mzML file. "
+                                                 "Fewer runs than requested by -parallel_runs are processed at the same time if the limit would be exceeded "
+                                                 "(at least one run is always processed). 0 = no limit.", false, true);
+    setMinInt_("memory_limit", 0);
+
+    registerStringOption_("checkpoint_dir", "<directory>", "", "Directory for checkpoints of intermediate results (features of each MS run, "
+                                                                "alignment and linking of each fraction, protein inference). "
+                                                                "Checkpoints are identified by the content of their input files and the parameters used to compute them. Empty = no checkpoints.", false, true);
+    registerFlag_("resume", "Reuse the checkpoints in 'checkpoint_dir' of all processing stages whose input files and parameters did not change.", true);
+
     registerTOPPSubsection_("Seeding", "Parameters for seeding of untargeted features");
     registerDoubleOption_("Seeding:intThreshold", "<threshold>", 1e4, "Peak intensity threshold applied in seed detection.", false, true);
     registerStringOption_("Seeding:charge", "<minChg:maxChg>", "2:5", "Charge range considered for untargeted feature seeds.", false, true); //TODO infer from IDs?
@@ -351,7 +377,11 @@ protected:
     mzML_file.setLogType(log_type_);
 
     PeakMap ms_raw;
-    mzML_file.load(mz_file, ms_raw);
+    {
+      Tracer::Scope trace("loading mzML");
+      mzML_file.load(mz_file, ms_raw);
+      trace.addItems(ms_raw.size());
+    }
     ms_raw.clearMetaDataArrays();
 
     if (ms_raw.empty())
@@ -377,10 +407,13 @@ protected:
     //-------------------------------------------------------------
     // Centroiding of MS1
     //-------------------------------------------------------------
-    PeakPickerHiRes pp;
-    pp.setLogType(log_type_);
-    pp.setParameters(pp_param);
-    pp.pickExperiment(ms_raw, ms_centroided, true);
+    {
+      OPENMS_TRACE_SCOPE("centroiding");
+      PeakPickerHiRes pp;
+      pp.setLogType(log_type_);
+      pp.setParameters(pp_param);
+      pp.pickExperiment(ms_raw, ms_centroided, true);
+    }
       
     //-------------------------------------------------------------
     // HighRes Precursor Mass Correction
@@ -416,6 +449,20 @@ protected:
     return EXECUTION_OK;
   }
 
+  /// Set the (process-wide) RANSAC parameters and coefficient limits of MZTrafoModel used by recalibrateMasses_().
+  /// Must be called before runs are recalibrated concurrently, since MZTrafoModel::train() reads them.
+  void setupMassRecalibration_() const
+  {
+    Math::RANSACParam p(2, 70, 10, 30, true); // LINEAR model: 2 initial points. TODO: check defaults (taken from tool)
+    MZTrafoModel::setRANSACParams(p);
+    if (test_mode_)
+    {
+      MZTrafoModel::setRANSACSeed(0);
+    }
+    // these limits are a little loose, but should prevent grossly wrong models without burdening the user with yet another parameter.
+    MZTrafoModel::setCoefficientLimits(25.0, 25.0, 0.5); 
+  }
+
   void recalibrateMasses_(MSExperiment & ms_centroided, vector<PeptideIdentification>& peptide_ids, const String & id_file_abs_path)
   {
     InternalCalibration ic;
@@ -429,15 +476,10 @@ protected:
     //MZTrafoModel::MODELTYPE md = (ic.getCalibrationPoints().size() == 2) ? MZTrafoModel::LINEAR : MZTrafoModel::QUADRATIC;
     //bool use_RANSAC = (md == MZTrafoModel::LINEAR || md == MZTrafoModel::QUADRATIC);
 
+    // RANSAC parameters and coefficient limits are set once in setupMassRecalibration_()
     MZTrafoModel::MODELTYPE md = MZTrafoModel::LINEAR;
     bool use_RANSAC = true;
 
-    Size RANSAC_initial_points = (md == MZTrafoModel::LINEAR) ? 2 : 3;
-    Math::RANSACParam p(RANSAC_initial_points, 70, 10, 30, true); // TODO: check defaults (taken from tool)
-    MZTrafoModel::setRANSACParams(p);
-    // these limits are a little loose, but should prevent grossly wrong models without burdening the user with yet another parameter.
-    MZTrafoModel::setCoefficientLimits(25.0, 25.0, 0.5); 
-
     IntList ms_level = {1};
     double rt_chunk = 300.0; // 5 minutes
     String qc_residual_path, qc_residual_png_path;
@@ -692,10 +734,13 @@ protected:
 
     if (feature_maps.size() > 1)
     {
-      max_alignment_diff = align_(feature_maps, transformations);
-
-      transform_(feature_maps, transformations);
+      {
+        OPENMS_TRACE_SCOPE("alignment");
+        max_alignment_diff = align_(feature_maps, transformations);
+        transform_(feature_maps, transformations);
+      }
 
+      OPENMS_TRACE_SCOPE("linking");
       link_(feature_maps,
         median_fwhm, 
         max_alignment_diff, 
@@ -991,135 +1036,236 @@ protected:
     return EXECUTION_OK;
   }
  
-  ExitCodes quantifyFraction_(
-    const pair<unsigned int, std::vector<String> > & ms_files, 
-    const map<String, String>& mzfile2idfile, 
-    double median_fwhm,
-    const multimap<Size, PeptideIdentification> & transfered_ids,
-    ConsensusMap & consensus_fraction,
-    vector<TransformationDescription> & transformations,
-    double& max_alignment_diff,
-    set<String>& fixed_modifications,
-    set<String>& variable_modifications)
+  /// Quantification result of a single MS run (see quantifyRun_)
+  struct RunQuantification_
   {
-    vector<FeatureMap> feature_maps;
-    const Size fraction = ms_files.first;
+    ExitCodes exit_code = EXECUTION_OK;
+    FeatureMap features; ///< features detected in the run
+    String id_ms_run_ref; ///< primary MS run path annotated in the ID file of the run
+    double median_fwhm = 0.0; ///< estimated median chromatographic FWHM of the run
+    set<String> fixed_modifications; ///< fixed modifications found in the ID file of the run
+    set<String> variable_modifications; ///< variable modifications found in the ID file of the run
+  };
+
+  /// Rough estimate of the peak memory (in bytes) needed to quantify the MS run stored in @p mz_file
+  static double estimateRunMemory_(const String& mz_file)
+  {
+    // the spectra are held in memory twice (profile and centroided data) while picking
+    // and the extracted chromatograms of FeatureFinderIdentification add to that
+    return 3.0 * static_cast<double>(QFileInfo(mz_file.toQString()).size());
+  }
 
-    const bool is_already_aligned = !transformations.empty();
+  /// Number of MS runs in @p mz_files that are quantified concurrently (respects -parallel_runs and -memory_limit)
+  int concurrentRuns_(const StringList& mz_files) const
+  {
+    int n = std::min(getIntOption_("parallel_runs"), static_cast<int>(mz_files.size()));
+    const double memory_limit = getIntOption_("memory_limit") * 1024.0 * 1024.0;
+    if (memory_limit > 0 && n > 1)
+    {
+      // be conservative and assume that the largest runs are processed at the same time
+      vector<double> estimates;
+      for (const String& mz_file : mz_files) { estimates.push_back(estimateRunMemory_(mz_file)); }
+      std::sort(estimates.rbegin(), estimates.rend());
+      double memory = estimates[0];
+      int fitting = 1;
+      while (fitting < n && memory + estimates[fitting] <= memory_limit)
+      {
+        memory += estimates[fitting];
+        ++fitting;
+      }
+      n = fitting;
+    }
+    return std::max(1, n);
+  }
 
-    // debug output
-    writeDebug_("Processing fraction number: " + String(fraction) + "\nFiles: ",  1);
-    for (String const & mz_file : ms_files.second) { writeDebug_(mz_file,  1); }
+  /**
+    @brief Key of the checkpoint for the features of a single MS run
 
-    // for sanity checks we collect the primary MS run basenames as well as the ones stored in the ID files (below)
-    StringList id_MS_run_ref;
-    StringList in_MS_run = ms_files.second;
+    @p transfer_source is the checkpoint of the fraction the transferred IDs and transformations were derived from (if any).
+  */
+  CheckpointCache::Key runCheckpointKey_(
+    const String& mz_file,
+    const Size fraction,
+    const Size fraction_group,
+    const map<String, String>& mzfile2idfile,
+    const CheckpointCache::Key* transfer_source)
+  {
+    CheckpointCache::Key key("features");
+    if (!checkpoints_.isEnabled()) return key; // no need to hash the input files
+
+    key.add("in", checkpoints_.hashFile(mz_file))
+       .add("ids", checkpoints_.hashFile(mzfile2idfile.at(File::absolutePath(mz_file))))
+       .add("run", File::basename(mz_file))
+       .add("fraction", String(fraction))
+       .add("fraction_group", String(fraction_group))
+       .add("Centroiding", getParam_().copy("Centroiding:", true))
+       .add("Seeding", getParam_().copy("Seeding:", true))
+       .add("PeptideQuantification", getParam_().copy("PeptideQuantification:", true));
+    for (const String& option : {"targeted_only", "mass_recalibration", "keep_feature_top_psm_only"})
+    {
+      key.add(option, getStringOption_(option));
+    }
+    if (transfer_source != nullptr) key.add(*transfer_source);
+    return key;
+  }
 
-    // for each MS file of current fraction (e.g., all MS files that measured the n-th fraction) 
-    Size fraction_group{1};
-    for (String const & mz_file : ms_files.second)
+  /// Store the features of a run together with the information needed to continue from them as checkpoint
+  void storeRunCheckpoint_(const CheckpointCache::Key& key, RunQuantification_& run) const
+  {
+    if (!checkpoints_.isEnabled()) return;
+    FeatureMap& features = run.features;
+    features.setMetaValue("checkpoint:median_fwhm", run.median_fwhm);
+    features.setMetaValue("checkpoint:id_ms_run_ref", run.id_ms_run_ref);
+    features.setMetaValue("checkpoint:fixed_modifications", StringList(run.fixed_modifications.begin(), run.fixed_modifications.end()));
+    features.setMetaValue("checkpoint:variable_modifications", StringList(run.variable_modifications.begin(), run.variable_modifications.end()));
+    checkpoints_.store<FeatureXMLFile>(key, "featureXML", features);
+    for (const String& name : {"checkpoint:median_fwhm", "checkpoint:id_ms_run_ref", "checkpoint:fixed_modifications", "checkpoint:variable_modifications"})
     {
-      writeDebug_("Processing file: " + mz_file,  1);
-      // centroid spectra (if in profile mode) and correct precursor masses
-      MSExperiment ms_centroided;    
+      features.removeMetaValue(name);
+    }
+  }
 
-      {
-        ExitCodes e = centroidAndCorrectPrecursors_(mz_file, ms_centroided);
-        if (e != EXECUTION_OK) { return e; }
-      }
+  /// Load the features of a run from its checkpoint (if available for reuse)
+  bool loadRunCheckpoint_(const CheckpointCache::Key& key, RunQuantification_& run) const
+  {
+    FeatureMap& features = run.features;
+    if (!checkpoints_.load<FeatureXMLFile>(key, "featureXML", features)) return false;
+    run.median_fwhm = features.getMetaValue("checkpoint:median_fwhm");
+    run.id_ms_run_ref = features.getMetaValue("checkpoint:id_ms_run_ref").toString();
+    for (const String& mod : features.getMetaValue("checkpoint:fixed_modifications").toStringList())
+    {
+      if (!mod.empty()) run.fixed_modifications.insert(mod);
+    }
+    for (const String& mod : features.getMetaValue("checkpoint:variable_modifications").toStringList())
+    {
+      if (!mod.empty()) run.variable_modifications.insert(mod);
+    }
+    for (const String& name : {"checkpoint:median_fwhm", "checkpoint:id_ms_run_ref", "checkpoint:fixed_modifications", "checkpoint:variable_modifications"})
+    {
+      features.removeMetaValue(name);
+    }
+    return true;
+  }
 
-      // load and clean identification data associated with MS run
-      vector<ProteinIdentification> protein_ids;
-      vector<PeptideIdentification> peptide_ids;
-      const String& mz_file_abs_path = File::absolutePath(mz_file);
-      const String& id_file_abs_path = File::absolutePath(mzfile2idfile.at(mz_file_abs_path));
+  /// Centroid, calibrate and quantify a single MS run (or reuse its checkpoint).
+  /// Several runs may be quantified concurrently, if setupMassRecalibration_() was called before (when recalibrating).
+  ExitCodes quantifyRun_(
+    const String& mz_file,
+    const Size fraction,
+    const Size fraction_group,
+    const map<String, String>& mzfile2idfile,
+    const multimap<Size, PeptideIdentification>& transfered_ids,
+    const vector<TransformationDescription>& transformations,
+    const CheckpointCache::Key& checkpoint,
+    RunQuantification_& result)
+  {
+    if (loadRunCheckpoint_(checkpoint, result)) return EXECUTION_OK;
 
-      {
-        ExitCodes e = loadAndCleanupIDFile_(id_file_abs_path, mz_file, fraction_group, fraction, protein_ids, peptide_ids, fixed_modifications, variable_modifications);
-        if (e != EXECUTION_OK) return e;
-      }
+    writeDebug_("Processing file: " + mz_file,  1);
+    // centroid spectra (if in profile mode) and correct precursor masses
+    MSExperiment ms_centroided;    
 
-      StringList id_msfile_ref;
-      protein_ids[0].getPrimaryMSRunPath(id_msfile_ref);
-      id_MS_run_ref.push_back(id_msfile_ref[0]);
-     
-      //-------------------------------------------------------------
-      // Internal Calibration of spectra peaks and precursor peaks with high-confidence IDs
-      //-------------------------------------------------------------
-      if (getStringOption_("mass_recalibration") == "true")
-      {
-        recalibrateMasses_(ms_centroided, peptide_ids, id_file_abs_path);
-      }
+    {
+      ExitCodes e = centroidAndCorrectPrecursors_(mz_file, ms_centroided);
+      if (e != EXECUTION_OK) { return e; }
+    }
 
-      vector<ProteinIdentification> ext_protein_ids;
-      vector<PeptideIdentification> ext_peptide_ids;
+    // load and clean identification data associated with MS run
+    vector<ProteinIdentification> protein_ids;
+    vector<PeptideIdentification> peptide_ids;
+    const String& mz_file_abs_path = File::absolutePath(mz_file);
+    const String& id_file_abs_path = File::absolutePath(mzfile2idfile.at(mz_file_abs_path));
 
-      //////////////////////////////////////////////////////
-      // Transfer aligned IDs
-      //////////////////////////////////////////////////////
-      if (!transfered_ids.empty())
-      {
-        OPENMS_PRECONDITION(is_already_aligned, "Data has not been aligned.")
+    {
+      ExitCodes e = loadAndCleanupIDFile_(id_file_abs_path, mz_file, fraction_group, fraction, protein_ids, peptide_ids, result.fixed_modifications, result.variable_modifications);
+      if (e != EXECUTION_OK) return e;
+    }
 
-        // transform observed IDs and spectra
-        MapAlignmentTransformer::transformRetentionTimes(peptide_ids, transformations[fraction_group - 1]);
-        MapAlignmentTransformer::transformRetentionTimes(ms_centroided, transformations[fraction_group - 1]);
+    StringList id_msfile_ref;
+    protein_ids[0].getPrimaryMSRunPath(id_msfile_ref);
+    result.id_ms_run_ref = id_msfile_ref[0];
 
-        // copy the (already) aligned, consensus feature derived ids that are to be transferred to this map to peptide_ids
-        auto range = transfered_ids.equal_range(fraction_group - 1);
-        for (auto& it = range.first; it != range.second; ++it)
-        {
-           PeptideIdentification trans = it->second;
-           trans.setIdentifier(protein_ids[0].getIdentifier());
-           peptide_ids.push_back(trans);
-        }
+    //-------------------------------------------------------------
+    // Internal Calibration of spectra peaks and precursor peaks with high-confidence IDs
+    //-------------------------------------------------------------
+    if (getStringOption_("mass_recalibration") == "true")
+    {
+      recalibrateMasses_(ms_centroided, peptide_ids, id_file_abs_path);
+    }
+
+    vector<ProteinIdentification> ext_protein_ids;
+    vector<PeptideIdentification> ext_peptide_ids;
+
+    //////////////////////////////////////////////////////
+    // Transfer aligned IDs
+    //////////////////////////////////////////////////////
+    if (!transfered_ids.empty())
+    {
+      OPENMS_PRECONDITION(!transformations.empty(), "Data has not been aligned.")
+
+      // transform observed IDs and spectra
+      MapAlignmentTransformer::transformRetentionTimes(peptide_ids, transformations[fraction_group - 1]);
+      MapAlignmentTransformer::transformRetentionTimes(ms_centroided, transformations[fraction_group - 1]);
+
+      // copy the (already) aligned, consensus feature derived ids that are to be transferred to this map to peptide_ids
+      auto range = transfered_ids.equal_range(fraction_group - 1);
+      for (auto& it = range.first; it != range.second; ++it)
+      {
+         PeptideIdentification trans = it->second;
+         trans.setIdentifier(protein_ids[0].getIdentifier());
+         peptide_ids.push_back(trans);
       }
+    }
 
-      //////////////////////////////////////////
-      // Chromatographic parameter estimation
-      //////////////////////////////////////////
-      median_fwhm = estimateMedianChromatographicFWHM_(ms_centroided);
+    //////////////////////////////////////////
+    // Chromatographic parameter estimation
+    //////////////////////////////////////////
+    const double median_fwhm = estimateMedianChromatographicFWHM_(ms_centroided);
+    result.median_fwhm = median_fwhm;
 
-      //-------------------------------------------------------------
-      // Feature detection
-      //-------------------------------------------------------------   
-      ///////////////////////////////////////////////
+    //-------------------------------------------------------------
+    // Feature detection
+    //-------------------------------------------------------------   
+    ///////////////////////////////////////////////
 
-      // Run MTD before FFM
+    // Run MTD before FFM
 
-      // create empty feature map and annotate MS file
-      FeatureMap seeds;
-      seeds.setPrimaryMSRunPath({mz_file});
+    // create empty feature map and annotate MS file
+    FeatureMap seeds;
+    seeds.setPrimaryMSRunPath({mz_file});
 
-      if (getStringOption_("targeted_only") == "false")
+    if (getStringOption_("targeted_only") == "false")
+    {
+      OPENMS_TRACE_SCOPE("seeding");
+      calculateSeeds_(ms_centroided, seeds, median_fwhm);
+      if (debug_level_ > 666)
       {
-        calculateSeeds_(ms_centroided, seeds, median_fwhm);
-        if (debug_level_ > 666)
-        {
-          FeatureXMLFile().store("debug_seeds_fraction_" + String(ms_files.first) + "_" + String(fraction_group) + ".featureXML", seeds);
-        }
+        FeatureXMLFile().store("debug_seeds_fraction_" + String(fraction) + "_" + String(fraction_group) + ".featureXML", seeds);
       }
+    }
 
-      /////////////////////////////////////////////////
-      // Run FeatureFinderIdentification
+    /////////////////////////////////////////////////
+    // Run FeatureFinderIdentification
 
-      FeatureMap fm;
+    FeatureMap fm;
 
-      FeatureFinderIdentificationAlgorithm ffi;
-      ffi.getMSData().swap(ms_centroided);
-      ffi.getProgressLogger().setLogType(log_type_);
+    FeatureFinderIdentificationAlgorithm ffi;
+    ffi.getMSData().swap(ms_centroided);
+    ffi.getProgressLogger().setLogType(log_type_);
 
-      Param ffi_param = getParam_().copy("PeptideQuantification:", true);
-      ffi_param.setValue("detect:peak_width", 5.0 * median_fwhm);
-      ffi_param.setValue("EMGScoring:init_mom", "true");
-      ffi_param.setValue("EMGScoring:max_iteration", 100);
-      ffi_param.setValue("debug", debug_level_); // pass down debug level
+    Param ffi_param = getParam_().copy("PeptideQuantification:", true);
+    ffi_param.setValue("detect:peak_width", 5.0 * median_fwhm);
+    ffi_param.setValue("EMGScoring:init_mom", "true");
+    ffi_param.setValue("EMGScoring:max_iteration", 100);
+    ffi_param.setValue("debug", debug_level_); // pass down debug level
 
-      ffi.setParameters(ffi_param);
-      writeDebug_("Parameters passed to FeatureFinderIdentification algorithm", ffi_param, 3);
+    ffi.setParameters(ffi_param);
+    writeDebug_("Parameters passed to FeatureFinderIdentification algorithm", ffi_param, 3);
 
-      FeatureMap tmp = fm;
+    FeatureMap tmp = fm;
 
+    {
+      Tracer::Scope trace("FeatureFinderIdentification");
       ffi.run(peptide_ids, 
         protein_ids, 
         ext_peptide_ids, 
@@ -1127,34 +1273,254 @@ protected:
         tmp,
         seeds,
         mz_file);
+      trace.addItems(tmp.size());
+    }
+
+    // TODO: consider moving this to FFid
+    // free parts of feature map not needed for further processing (e.g., subfeatures...)
+    for (auto & f : tmp)
+    {
+      //TODO keep FWHM meta value for QC
+      f.clearMetaInfo();
+      f.setSubordinates({});
+      f.setConvexHulls({});
+    }
+
+    IDConflictResolverAlgorithm::resolve(tmp,
+        getStringOption_("keep_feature_top_psm_only") == "false"); // keep only best peptide per feature per file
+
+    result.features.swap(tmp);
+    storeRunCheckpoint_(checkpoint, result);
+
+    if (debug_level_ > 666)
+    {
+      FeatureXMLFile().store("debug_fraction_" + String(fraction) + "_" + String(fraction_group) + ".featureXML", result.features);
+    }
+
+    if (debug_level_ > 670)
+    {
+      MzMLFile().store("debug_fraction_" + String(fraction) + "_" + String(fraction_group) + "_chroms.mzML", ffi.getChromatograms());
+    }
+
+    return EXECUTION_OK;
+  }
 
-      // TODO: consider moving this to FFid
-      // free parts of feature map not needed for further processing (e.g., subfeatures...)
-      for (auto & f : tmp)
+  /// Key of the checkpoint for the consensus map of a fraction (computed from the keys of its runs, see runCheckpointKey_)
+  CheckpointCache::Key fractionCheckpointKey_(const vector<CheckpointCache::Key>& run_checkpoints)
+  {
+    CheckpointCache::Key key("fraction");
+    if (!checkpoints_.isEnabled()) return key;
+
+    for (const CheckpointCache::Key& run_checkpoint : run_checkpoints) { key.add(run_checkpoint); }
+    key.add("Alignment", getParam_().copy("Alignment:", true))
+       .add("Linking", getParam_().copy("Linking:", true))
+       .add("alignment_order", getStringOption_("alignment_order"))
+       .add("force", getFlag_("force") ? "true" : "false")
+       .add("normalize", getStringOption_("out_msstats").empty() && getStringOption_("out_triqler").empty() ? "true" : "false");
+    return key;
+  }
+
+  /// Keys of the checkpoints of all runs of a fraction (see runCheckpointKey_)
+  vector<CheckpointCache::Key> runCheckpointKeys_(
+    const pair<unsigned int, std::vector<String> >& ms_files,
+    const map<String, String>& mzfile2idfile,
+    const CheckpointCache::Key* transfer_source)
+  {
+    vector<CheckpointCache::Key> keys;
+    Size fraction_group{1};
+    for (String const& mz_file : ms_files.second)
+    {
+      keys.push_back(runCheckpointKey_(mz_file, ms_files.first, fraction_group, mzfile2idfile, transfer_source));
+      ++fraction_group;
+    }
+    return keys;
+  }
+
+  /// Key of the checkpoint for the RT transformation of run @p run_index of a fraction
+  static CheckpointCache::Key transformationCheckpointKey_(const CheckpointCache::Key& fraction_checkpoint, Size run_index)
+  {
+    CheckpointCache::Key key("transformation");
+    key.add(fraction_checkpoint).add("run_index", String(run_index));
+    return key;
+  }
+
+  /// Store the quantified fraction (and the RT transformations determined by its alignment, if any) as checkpoint
+  void storeFractionCheckpoint_(
+    const CheckpointCache::Key& key,
+    ConsensusMap& consensus_fraction,
+    const vector<TransformationDescription>& transformations,
+    const double max_alignment_diff,
+    const set<String>& fixed_modifications,
+    const set<String>& variable_modifications) const
+  {
+    if (!checkpoints_.isEnabled()) return;
+    for (Size i = 0; i < transformations.size(); ++i)
+    {
+      checkpoints_.store<TransformationXMLFile>(transformationCheckpointKey_(key, i), "trafoXML", transformations[i]);
+    }
+    consensus_fraction.setMetaValue("checkpoint:transformations", transformations.size());
+    consensus_fraction.setMetaValue("checkpoint:max_alignment_diff", max_alignment_diff);
+    consensus_fraction.setMetaValue("checkpoint:fixed_modifications", StringList(fixed_modifications.begin(), fixed_modifications.end()));
+    consensus_fraction.setMetaValue("checkpoint:variable_modifications", StringList(variable_modifications.begin(), variable_modifications.end()));
+    checkpoints_.store<ConsensusXMLFile>(key, "consensusXML", consensus_fraction);
+    for (const String& name : {"checkpoint:transformations", "checkpoint:max_alignment_diff", "checkpoint:fixed_modifications", "checkpoint:variable_modifications"})
+    {
+      consensus_fraction.removeMetaValue(name);
+    }
+  }
+
+  /**
+    @brief Load a quantified fraction from its checkpoint (if available for reuse)
+
+    The RT transformations and the maximum alignment difference are only loaded if @p load_alignment is true
+    (i.e. if the data was not aligned before).
+  */
+  bool loadFractionCheckpoint_(
+    const CheckpointCache::Key& key,
+    const bool load_alignment,
+    ConsensusMap& consensus_fraction,
+    vector<TransformationDescription>& transformations,
+    double& max_alignment_diff,
+    set<String>& fixed_modifications,
+    set<String>& variable_modifications) const
+  {
+    ConsensusMap consensus;
+    if (!checkpoints_.load<ConsensusXMLFile>(key, "consensusXML", consensus)) return false;
+
+    if (load_alignment)
+    {
+      const Size n_transformations = consensus.getMetaValue("checkpoint:transformations");
+      for (Size i = 0; i < n_transformations; ++i)
+      { // all or nothing
+        if (!checkpoints_.contains(transformationCheckpointKey_(key, i), "trafoXML")) return false;
+      }
+      transformations.resize(n_transformations);
+      for (Size i = 0; i < n_transformations; ++i)
       {
-        //TODO keep FWHM meta value for QC
-        f.clearMetaInfo();
-        f.setSubordinates({});
-        f.setConvexHulls({});
+        checkpoints_.load<TransformationXMLFile>(transformationCheckpointKey_(key, i), "trafoXML", transformations[i]);
       }
+      max_alignment_diff = consensus.getMetaValue("checkpoint:max_alignment_diff");
+    }
+    for (const String& mod : consensus.getMetaValue("checkpoint:fixed_modifications").toStringList())
+    {
+      if (!mod.empty()) fixed_modifications.insert(mod);
+    }
+    for (const String& mod : consensus.getMetaValue("checkpoint:variable_modifications").toStringList())
+    {
+      if (!mod.empty()) variable_modifications.insert(mod);
+    }
+    for (const String& name : {"checkpoint:transformations", "checkpoint:max_alignment_diff", "checkpoint:fixed_modifications", "checkpoint:variable_modifications"})
+    {
+      consensus.removeMetaValue(name);
+    }
+    consensus_fraction.swap(consensus);
+    return true;
+  }
+
+  ExitCodes quantifyFraction_(
+    const pair<unsigned int, std::vector<String> > & ms_files, 
+    const map<String, String>& mzfile2idfile, 
+    double median_fwhm,
+    const multimap<Size, PeptideIdentification> & transfered_ids,
+    const CheckpointCache::Key* transfer_source,
+    ConsensusMap & consensus_fraction,
+    vector<TransformationDescription> & transformations,
+    double& max_alignment_diff,
+    set<String>& fixed_modifications,
+    set<String>& variable_modifications)
+  {
+    vector<FeatureMap> feature_maps;
+    const Size fraction = ms_files.first;
 
-      IDConflictResolverAlgorithm::resolve(tmp,
-          getStringOption_("keep_feature_top_psm_only") == "false"); // keep only best peptide per feature per file
+    const bool is_already_aligned = !transformations.empty();
 
-      feature_maps.push_back(tmp);
-      
-      if (debug_level_ > 666)
+    // reuse the complete fraction if nothing changed
+    const vector<CheckpointCache::Key> run_checkpoints = runCheckpointKeys_(ms_files, mzfile2idfile, transfer_source);
+    const CheckpointCache::Key checkpoint = fractionCheckpointKey_(run_checkpoints);
+    if (loadFractionCheckpoint_(checkpoint, !is_already_aligned, consensus_fraction, transformations, max_alignment_diff, fixed_modifications, variable_modifications))
+    {
+      return EXECUTION_OK;
+    }
+    // modifications found in the runs of this fraction (stored with the checkpoint)
+    set<String> fraction_fixed_modifications, fraction_variable_modifications;
+
+    // debug output
+    writeDebug_("Processing fraction number: " + String(fraction) + "\nFiles: ",  1);
+    for (String const & mz_file : ms_files.second) { writeDebug_(mz_file,  1); }
+
+    // for sanity checks we collect the primary MS run basenames as well as the ones stored in the ID files (below)
+    StringList id_MS_run_ref;
+    StringList in_MS_run = ms_files.second;
+
+    // quantify each MS file of current fraction (e.g., all MS files that measured the n-th fraction).
+    // Runs are independent of each other until alignment, so several of them may be processed at the same
+    // time. The results are merged in input order and thus don't depend on the number of concurrent runs.
+    const int parallel_runs = concurrentRuns_(ms_files.second);
+    if (parallel_runs > 1)
+    {
+      OPENMS_LOG_INFO << "Quantifying up to " << parallel_runs << " MS runs concurrently." << endl;
+    }
+
+    if (getStringOption_("mass_recalibration") == "true")
+    {
+      setupMassRecalibration_(); // not thread-safe, so before the runs are processed
+    }
+
+    vector<RunQuantification_> runs(ms_files.second.size());
+    vector<std::exception_ptr> run_errors(ms_files.second.size());
+#ifdef _OPENMP
+    const int total_nr_threads = omp_get_max_threads(); // store total number of threads we are allowed to use
+#ifdef MT_ENABLE_NESTED_OPENMP
+    const int previous_nested = omp_get_nested();
+    const int previous_dynamic = omp_get_dynamic();
+    if (parallel_runs > 1)
+    {
+      omp_set_nested(1);
+      omp_set_dynamic(0);
+    }
+#endif
+#pragma omp parallel for schedule(dynamic,1) num_threads(parallel_runs)
+#endif
+    for (SignedSize i = 0; i < static_cast<SignedSize>(ms_files.second.size()); ++i)
+    {
+#ifdef _OPENMP
+      // split the available threads evenly between the concurrent runs (used by nested parallel regions)
+      omp_set_num_threads(std::max(1, total_nr_threads / parallel_runs));
+#endif
+      OPENMS_TRACE_SCOPE("quantifying run");
+      try
       {
-        FeatureXMLFile().store("debug_fraction_" + String(ms_files.first) + "_" + String(fraction_group) + ".featureXML", feature_maps.back());
+        runs[i].exit_code = quantifyRun_(ms_files.second[i], fraction, i + 1, mzfile2idfile, transfered_ids, transformations, run_checkpoints[i], runs[i]);
       }
-
-      if (debug_level_ > 670)
+      catch (...)
       {
-        MzMLFile().store("debug_fraction_" + String(ms_files.first) + "_" + String(fraction_group) + "_chroms.mzML", ffi.getChromatograms());
+        run_errors[i] = std::current_exception();
       }
+    }
+#ifdef _OPENMP
+    omp_set_num_threads(total_nr_threads); // set number of available threads back to initial value
+#ifdef MT_ENABLE_NESTED_OPENMP
+    omp_set_nested(previous_nested);
+    omp_set_dynamic(previous_dynamic);
+#endif
+#endif
 
-      ++fraction_group;
+    for (Size i = 0; i < runs.size(); ++i)
+    {
+      if (run_errors[i]) { std::rethrow_exception(run_errors[i]); }
+      if (runs[i].exit_code != EXECUTION_OK) { return runs[i].exit_code; }
+    }
+
+    for (RunQuantification_& run : runs)
+    {
+      id_MS_run_ref.push_back(run.id_ms_run_ref);
+      fraction_fixed_modifications.insert(run.fixed_modifications.begin(), run.fixed_modifications.end());
+      fraction_variable_modifications.insert(run.variable_modifications.begin(), run.variable_modifications.end());
+      median_fwhm = run.median_fwhm; // as before, the estimate of the last run is used for linking
+      feature_maps.push_back(std::move(run.features));
     }
+    fixed_modifications.insert(fraction_fixed_modifications.begin(), fraction_fixed_modifications.end());
+    variable_modifications.insert(fraction_variable_modifications.begin(), fraction_variable_modifications.end());
 
     // Check for common mistake that order of input files have been switched.
     // This is the case if basenames are identical but the order does not match.
@@ -1177,6 +1543,7 @@ protected:
     }
     else // Data already aligned. Link with previously determined alignment difference
     {
+      OPENMS_TRACE_SCOPE("linking");
       link_(feature_maps,
         median_fwhm,
         max_alignment_diff,
@@ -1238,19 +1605,69 @@ protected:
         "");
     }
 
-
+    storeFractionCheckpoint_(checkpoint, consensus_fraction, is_already_aligned ? vector<TransformationDescription>() : transformations,
+      max_alignment_diff, fraction_fixed_modifications, fraction_variable_modifications);
 
     // max_alignment_diff returned by reference
     return EXECUTION_OK;
   }
 
 
+  /// Key of the checkpoint for the (FDR filtered) protein inference result
+  CheckpointCache::Key inferenceCheckpointKey_(const StringList& in_ids, const String& in_db, const map<String, String>& idfile2mzfile)
+  {
+    CheckpointCache::Key key("inference");
+    if (!checkpoints_.isEnabled()) return key; // no need to hash the input files
+
+    for (const String& idfile : in_ids)
+    {
+      key.add("ids", checkpoints_.hashFile(idfile)).add("run", File::basename(idfile2mzfile.at(idfile)));
+    }
+    if (!in_db.empty()) key.add("fasta", checkpoints_.hashFile(in_db));
+    for (const String& option : {"protein_inference", "protein_quantification", "picked_proteinFDR"})
+    {
+      key.add(option, getStringOption_(option));
+    }
+    for (const String& option : {"proteinFDR", "psmFDR"})
+    {
+      key.add(option, String(getDoubleOption_(option)));
+    }
+    key.add("quantify_decoys", getFlag_("PeptideQuantification:quantify_decoys") ? "true" : "false");
+    return key;
+  }
+
   ExitCodes inferProteinGroups_(const StringList in_ids,
     const String& in_db,
     const map<String, String>& idfile2mzfile,
     const set<String>& fixed_modifications, 
     vector<ProteinIdentification>& inferred_protein_ids, 
     vector<PeptideIdentification>& inferred_peptide_ids)
+  {
+    OPENMS_TRACE_SCOPE("protein inference");
+    const CheckpointCache::Key checkpoint = inferenceCheckpointKey_(in_ids, in_db, idfile2mzfile);
+    if (!checkpoints_.load<IdXMLFile>(checkpoint, "idXML", inferred_protein_ids, inferred_peptide_ids))
+    {
+      ExitCodes e = mergeAndInferProteins_(in_ids, in_db, idfile2mzfile, inferred_protein_ids, inferred_peptide_ids);
+      if (e != EXECUTION_OK) return e;
+      checkpoints_.store<IdXMLFile>(checkpoint, "idXML", inferred_protein_ids, inferred_peptide_ids);
+    }
+
+    // compute coverage (sequence was annotated during PeptideIndexing)
+    inferred_protein_ids[0].computeCoverage(inferred_peptide_ids);
+
+    // TODO: this might not be correct if only the best peptidoform is kept
+    // determine observed modifications (exclude fixed mods)
+    inferred_protein_ids[0].computeModifications(inferred_peptide_ids, StringList(fixed_modifications.begin(), fixed_modifications.end()));
+
+    return EXECUTION_OK;
+  }
+
+  /// Merge the IDs of all runs, reindex them, infer proteins and filter by FDR
+  ExitCodes mergeAndInferProteins_(const StringList& in_ids,
+    const String& in_db,
+    const map<String, String>& idfile2mzfile,
+    vector<ProteinIdentification>& inferred_protein_ids, 
+    vector<PeptideIdentification>& inferred_peptide_ids)
   {
     // load the IDs again and merge
     IDMergerAlgorithm merger{String("all_merged")};
@@ -1484,13 +1901,6 @@ protected:
       }
     }
 
-    // compute coverage (sequence was annotated during PeptideIndexing)
-    inferred_protein_ids[0].computeCoverage(inferred_peptide_ids);
-
-    // TODO: this might not be correct if only the best peptidoform is kept
-    // determine observed modifications (exclude fixed mods)
-    inferred_protein_ids[0].computeModifications(inferred_peptide_ids, StringList(fixed_modifications.begin(), fixed_modifications.end()));
-
     return EXECUTION_OK;
   }
 
@@ -1546,6 +1956,13 @@ protected:
     String design_file = getStringOption_("design");
     String in_db = getStringOption_("fasta");
 
+    if (getFlag_("resume") && getStringOption_("checkpoint_dir").empty())
+    {
+      OPENMS_LOG_ERROR << "Error: 'resume' requires a 'checkpoint_dir'." << endl;
+      return ILLEGAL_PARAMETERS;
+    }
+    checkpoints_ = CheckpointCache(getStringOption_("checkpoint_dir"), getFlag_("resume"));
+
     // Validate parameters
     if (in.size() != in_ids.size())
     {
@@ -1713,6 +2130,7 @@ protected:
           mzfile2idfile,
           median_fwhm, 
           multimap<Size, PeptideIdentification>(),
+          nullptr, // no IDs transferred
           consensus_fraction, 
           transformations,  // transformations are empty, will be filled by alignment
           max_alignment_diff,  // max_alignment_diff not yet determined, will be filled by alignment
@@ -1729,6 +2147,9 @@ protected:
           multimap<Size, PeptideIdentification> transfered_ids = transferIDsBetweenSameFraction_(consensus_fraction, min_occurrance);
           consensus_fraction.clear();
 
+          // checkpoints of the re-quantification depend on the first pass (transferred IDs and transformations)
+          const CheckpointCache::Key first_pass = fractionCheckpointKey_(runCheckpointKeys_(ms_files, mzfile2idfile, nullptr));
+
           // The transferred IDs were calculated on the aligned data
           // So we make sure we use the aligned IDs and peak maps in the re-quantification step
           e = quantifyFraction_(
@@ -1736,6 +2157,7 @@ protected:
             mzfile2idfile, 
             median_fwhm, 
             transfered_ids, 
+            &first_pass,
             consensus_fraction, 
             transformations,  // transformations as determined by alignment
             max_alignment_diff, // max_alignment_error as determined by alignment
@@ -0,0 +1,196 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/APPLICATIONS/TOPPBase.h>
+#include <OpenMS/FILTERING/TRANSFORMERS/NLargest.h>
+#include <OpenMS/FILTERING/TRANSFORMERS/Normalizer.h>
+#include <OpenMS/FILTERING/TRANSFORMERS/ThresholdMower.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/KERNEL/SpectrumColumns.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+using namespace OpenMS;
+using namespace std;
+
+//-------------------------------------------------------------
+//Doxygen docu
+//-------------------------------------------------------------
+
+/**
+  @page UTILS_SpectrumColumnsBenchmark SpectrumColumnsBenchmark
+
+  @brief Benchmarks spectrum filtering on the peak-wise (MSSpectrum) and the column-wise (SpectrumColumns) layout.
+
+  Every spectrum of the input file is copied and filtered by ThresholdMower, Normalizer ('to_one')
+  and NLargest, i.e. the preprocessing of many search engines. With 'layout' = 'peaks' the filters
+  work on MSSpectrum (m/z and intensity interleaved), with 'layout' = 'columns' on SpectrumColumns
+  (contiguous m/z and intensity arrays). For 'columns', the one-time conversion of all spectra is
+  timed separately. Loading the file is not included.
+
+  Both layouts give identical results, which can be checked via the reported TIC after filtering.
+  Run the tool once per layout on the same file to compare them.
+
+  <B>The command line parameters of this tool are:</B>
+  @verbinclude UTILS_SpectrumColumnsBenchmark.cli
+  <B>INI file documentation of this tool:</B>
+  @htmlinclude UTILS_SpectrumColumnsBenchmark.html
+
+*/
+
+// We do not want this class to show up in the docu:
+/// @cond TOPPCLASSES
+
+class TOPPSpectrumColumnsBenchmark :
+  public TOPPBase
+{
+public:
+  TOPPSpectrumColumnsBenchmark() :
+    TOPPBase("SpectrumColumnsBenchmark", "Benchmarks spectrum filtering on the peak-wise and the column-wise layout.", false)
+  {
+  }
+
+protected:
+
+  void registerOptionsAndFlags_() override
+  {
+    registerInputFile_("in", "<file>", "", "Input file");
+    setValidFormats_("in", ListUtils::create<String>("mzML"));
+
+    registerStringOption_("layout", "<layout>", "peaks", "Spectrum layout the filters work on", false);
+    setValidStrings_("layout", ListUtils::create<String>("peaks,columns"));
+
+    registerDoubleOption_("threshold", "<intensity>", 0.0, "Peaks with an intensity below this value are removed (ThresholdMower)", false);
+    registerIntOption_("n", "<number>", 100, "Number of most intense peaks kept (NLargest)", false);
+    setMinInt_("n", 1);
+    registerIntOption_("repeats", "<number>", 1, "Number of times all spectra are filtered", false);
+    setMinInt_("repeats", 1);
+  }
+
+  ExitCodes main_(int, const char**) override
+  {
+    String in = getStringOption_("in");
+    String layout = getStringOption_("layout");
+    Int repeats = getIntOption_("repeats");
+
+    PeakMap exp;
+    MzMLFile mzml;
+    mzml.setLogType(log_type_);
+    mzml.load(in, exp);
+
+    ThresholdMower threshold_mower;
+    Param p = threshold_mower.getParameters();
+    p.setValue("threshold", getDoubleOption_("threshold"));
+    threshold_mower.setParameters(p);
+    Normalizer normalizer;
+    p = normalizer.getParameters();
+    p.setValue("method", "to_one");
+    normalizer.setParameters(p);
+    NLargest nlargest(getIntOption_("n"));
+
+    Size nr_peaks(0);
+    for (const MSSpectrum& spectrum : exp)
+    {
+      nr_peaks += spectrum.size();
+    }
+
+    double tic(0);
+    StopWatch sw;
+    if (layout == "columns")
+    {
+      StopWatch sw_convert;
+      sw_convert.start();
+      vector<SpectrumColumns> columns;
+      columns.reserve(exp.size());
+      for (const MSSpectrum& spectrum : exp)
+      {
+        columns.emplace_back(spectrum);
+      }
+      sw_convert.stop();
+      std::cout << " Conversion time " << sw_convert.toString() << std::endl;
+
+      sw.start();
+      for (Int r = 0; r < repeats; ++r)
+      {
+        tic = 0;
+        for (const SpectrumColumns& spectrum : columns)
+        {
+          SpectrumColumns filtered(spectrum);
+          threshold_mower.filterSpectrum(filtered);
+          normalizer.filterSpectrum(filtered);
+          nlargest.filterSpectrum(filtered);
+          tic += filtered.calculateTIC();
+        }
+      }
+      sw.stop();
+    }
+    else
+    {
+      sw.start();
+      for (Int r = 0; r < repeats; ++r)
+      {
+        tic = 0;
+        for (const MSSpectrum& spectrum : exp)
+        {
+          MSSpectrum filtered(spectrum);
+          threshold_mower.filterSpectrum(filtered);
+          normalizer.filterSpectrum(filtered);
+          nlargest.filterSpectrum(filtered);
+          for (const Peak1D& peak : filtered)
+          {
+            tic += peak.getIntensity(); // summed in double, like SpectrumColumns::calculateTIC()
+          }
+        }
+      }
+      sw.stop();
+    }
+
+    std::cout << "Layout: " << layout << std::endl;
+    std::cout << "There are " << exp.size() << " spectra and " << nr_peaks << " peaks (" << repeats << " repeat(s))." << std::endl;
+    std::cout << "The TIC after filtering is " << tic << std::endl;
+    std::cout << " Filter time " << sw.toString() << std::endl;
+
+    return EXECUTION_OK;
+  }
+
+};
+
+int main(int argc, const char** argv)
+{
+  TOPPSpectrumColumnsBenchmark tool;
+  return tool.main(argc, argv);
+}
+
+/// @endcond
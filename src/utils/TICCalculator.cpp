@@ -45,7 +45,9 @@
 #include <OpenMS/FORMAT/IndexedMzMLFileLoader.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/INTERFACES/IMSDataConsumer.h>
+#include <OpenMS/KERNEL/ArenaMSExperiment.h>
 #include <OpenMS/KERNEL/OnDiscMSExperiment.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
 #include <OpenMS/SYSTEM/SysInfo.h>
 
 #include <numeric>
@@ -68,6 +70,10 @@ using namespace OpenSwath;
   different methods as well as benchmarking external tools. Of course you can
   also calculate the TIC with this tool.
 
+  The methods 'regular' and 'arena' additionally report the time needed to
+  load and to free the map, which allows to compare MSExperiment with the
+  memory-compact ArenaMSExperiment.
+
   <B>The command line parameters of this tool are:</B>
   @verbinclude UTILS_TICCalculator.cli
   <B>INI file documentation of this tool:</B>
@@ -170,7 +176,7 @@ protected:
     setValidStrings_("in_type", ListUtils::create<String>(formats));
     
     registerStringOption_("read_method", "<method>", "regular", "Method to read the file", false);
-    String method("regular,indexed,indexed_parallel,streaming,cached,cached_parallel");
+    String method("regular,arena,indexed,indexed_parallel,streaming,cached,cached_parallel");
     setValidStrings_("read_method", ListUtils::create<String>(method));
 
     registerStringOption_("loadData", "<method>", "true", "Whether to actually load and decode the binary data (or whether to skip decoding the binary data)", false);
@@ -222,8 +228,11 @@ protected:
       opt.setFillData(load_data); // whether to actually load any data
       opt.setSkipXMLChecks(true); // save time by not checking base64 strings for whitespaces 
       mzml.setOptions(opt);
+      StopWatch sw;
+      sw.start();
       PeakMap map;
       mzml.load(in, map);
+      sw.stop();
       double TIC = 0.0;
       long int nr_peaks = 0;
       for (Size i =0; i < map.size(); i++)
@@ -240,6 +249,53 @@ protected:
       size_t after;
       SysInfo::getProcessMemoryConsumption(after);
       std::cout << " Memory consumption after " << after << std::endl;
+      std::cout << " Load time " << sw.toString() << std::endl;
+      sw.reset();
+      sw.start();
+      map.clear(true);
+      sw.stop();
+      SysInfo::getProcessMemoryConsumption(after);
+      std::cout << " Memory consumption after free " << after << std::endl;
+      std::cout << " Free time " << sw.toString() << std::endl;
+    }
+    else if (read_method == "arena")
+    {
+      std::cout << "Read method: arena" << std::endl;
+
+      MzMLFile mzml;
+      mzml.setLogType(log_type_);
+      PeakFileOptions opt = mzml.getOptions();
+      opt.setFillData(load_data); // whether to actually load any data
+      opt.setSkipXMLChecks(true); // save time by not checking base64 strings for whitespaces 
+      mzml.setOptions(opt);
+      StopWatch sw;
+      sw.start();
+      ArenaMSExperiment map;
+      mzml.load(in, map);
+      sw.stop();
+      double TIC = 0.0;
+      long int nr_peaks = map.getNrPeaks();
+      for (Size i =0; i < map.size(); i++)
+      {
+        for (const Peak1D& p : map.getPeaks(i))
+        {
+          TIC += p.getIntensity();
+        }
+      }
+
+      std::cout << "There are " << map.size() << " spectra and " << nr_peaks << " peaks in the input file." << std::endl;
+      std::cout << "The total ion current is " << TIC << std::endl;
+      size_t after;
+      SysInfo::getProcessMemoryConsumption(after);
+      std::cout << " Memory consumption after " << after << std::endl;
+      std::cout << " Load time " << sw.toString() << std::endl;
+      sw.reset();
+      sw.start();
+      map.clear();
+      sw.stop();
+      SysInfo::getProcessMemoryConsumption(after);
+      std::cout << " Memory consumption after free " << after << std::endl;
+      std::cout << " Free time " << sw.toString() << std::endl;
     }
     else if (read_method == "indexed")
     {
@@ -34,6 +34,7 @@ MSSimulator
 MSstatsConverter
 MultiplexResolver
 MzMLSplitter
+NoiseEstimatorBenchmark
 NovorAdapter
 NucleicAcidSearchEngine
 OpenMSDatabasesInfo
@@ -59,6 +60,7 @@ SimpleSearchEngine
 SiriusAdapter
 SpecLibCreator
 SpectraSTSearchAdapter
+SpectrumColumnsBenchmark
 StaticModification
 SvmTheoreticalSpectrumGeneratorTrainer
 TICCalculator